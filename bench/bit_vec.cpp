@@ -0,0 +1,71 @@
+#include <bit_vec.hpp>
+
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  auto random_bits(const usize length, const u64 seed) -> crab::BitVec {
+    std::mt19937_64 rng{seed};
+    Vec<u64> words((length + 63) / 64);
+    for (u64 &word: words) word = rng() & rng();
+    return crab::BitVec::from_words(std::move(words), length);
+  }
+}
+
+TEST_CASE("BitVec set operations", "[bit_vec][!benchmark]") {
+  for (const usize length: {usize{1} << 20, usize{1'000'000'000}}) {
+    crab::BitVec a = random_bits(length, 1);
+    const crab::BitVec b = random_bits(length, 2);
+    const String name = " bits=" + std::to_string(length);
+
+    BENCHMARK("BitVec &=" + name) { return (a &= b).words()[0]; };
+    BENCHMARK("BitVec |=" + name) { return (a |= b).words()[0]; };
+    BENCHMARK("BitVec ^=" + name) { return (a ^= b).words()[0]; };
+    BENCHMARK("BitVec and_not" + name) { return a.and_not(b).words()[0]; };
+    BENCHMARK("BitVec count_ones" + name) { return b.count_ones(); };
+
+    BENCHMARK("BitVec iterate ones" + name) {
+      usize sum = 0;
+      for (const usize i: b.ones()) sum += i;
+      return sum;
+    };
+
+    const crab::RankSelect index = b.rank_select();
+    std::mt19937_64 rng{3};
+    Vec<usize> probes(1 << 16);
+    for (usize &probe: probes) probe = rng() % length;
+
+    BENCHMARK("RankSelect::rank" + name) {
+      usize sum = 0;
+      for (const usize i: probes) sum += index.rank(i);
+      return sum;
+    };
+
+    BENCHMARK("RankSelect::select" + name) {
+      usize sum = 0;
+      for (const usize i: probes) sum += index.select(i % index.count_ones()).take_unchecked();
+      return sum;
+    };
+
+    if (length > usize{1} << 20) continue;
+
+    // std::vector<bool> has no bulk operations, every bit goes through a proxy
+    std::vector<bool> va(length), vb(length);
+    for (usize i = 0; i < length; i++) {
+      va[i] = a.get(i);
+      vb[i] = b.get(i);
+    }
+
+    BENCHMARK("Vec<bool> &= (per bit)" + name) {
+      for (usize i = 0; i < length; i++) va[i] = va[i] and vb[i];
+      return static_cast<bool>(va[0]);
+    };
+
+    BENCHMARK("Vec<bool> count (per bit)" + name) {
+      usize count = 0;
+      for (const bool bit: vb) count += bit;
+      return count;
+    };
+  }
+}
@@ -0,0 +1,91 @@
+#include <btree.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  auto random_keys(const usize n, const u64 seed) -> Vec<u64> {
+    std::mt19937_64 rng{seed};
+    Vec<u64> keys(n);
+    for (u64 &key: keys) key = rng();
+    return keys;
+  }
+}
+
+TEST_CASE("BTreeMap vs std::map", "[btree][!benchmark]") {
+  // 100M keys is left out of the default run as std::map alone needs ~6GB at that size
+  for (const usize n: {1'000ul, 100'000ul, 1'000'000ul, 10'000'000ul}) {
+    const Vec<u64> keys = random_keys(n, 1);
+    Vec<u64> probes = keys;
+    std::shuffle(probes.begin(), probes.end(), std::mt19937_64{2});
+    probes.resize(std::min<usize>(n, 100'000));
+
+    Vec<u64> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    Vec<std::pair<u64, u64>> entries;
+    entries.reserve(sorted.size());
+    for (const u64 key: sorted) entries.emplace_back(key, key);
+
+    const auto tree = crab::BTreeMap<u64, u64>::from_sorted(std::move(entries));
+    std::map<u64, u64> ordered;
+    for (const u64 key: sorted) ordered.emplace_hint(ordered.end(), key, key);
+
+    const String size = " n=" + std::to_string(n);
+
+    BENCHMARK("BTreeMap::get" + size) {
+      u64 sum = 0;
+      for (const u64 key: probes) sum += *tree.get(key).take_unchecked();
+      return sum;
+    };
+
+    BENCHMARK("std::map::find" + size) {
+      u64 sum = 0;
+      for (const u64 key: probes) sum += ordered.find(key)->second;
+      return sum;
+    };
+
+    BENCHMARK("BTreeMap iterate" + size) {
+      u64 sum = 0;
+      for (const auto [key, value]: tree) sum += value;
+      return sum;
+    };
+
+    BENCHMARK("std::map iterate" + size) {
+      u64 sum = 0;
+      for (const auto &[key, value]: ordered) sum += value;
+      return sum;
+    };
+
+    BENCHMARK("BTreeMap range (1/16)" + size) {
+      u64 sum = 0;
+      for (const auto [key, value]: tree.range(0, ~0ul / 16)) sum += value;
+      return sum;
+    };
+
+    BENCHMARK("std::map range (1/16)" + size) {
+      u64 sum = 0;
+      const auto last = ordered.lower_bound(~0ul / 16);
+      for (auto it = ordered.begin(); it != last; ++it) sum += it->second;
+      return sum;
+    };
+
+    if (n > 1'000'000) continue;
+
+    BENCHMARK("BTreeMap::insert (random)" + size) {
+      crab::BTreeMap<u64, u64> map;
+      for (const u64 key: keys) map.insert(key, key);
+      return map.length();
+    };
+
+    BENCHMARK("std::map::insert (random)" + size) {
+      std::map<u64, u64> map;
+      for (const u64 key: keys) map.emplace(key, key);
+      return map.size();
+    };
+  }
+}
@@ -0,0 +1,208 @@
+#include <bytes.hpp>
+
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  /**
+   * @brief A market data style order update: a fixed big endian header, a little endian timestamp, varint ids &
+   * quantities, a zigzag price delta & a length prefixed symbol
+   */
+  struct Update {
+    u16 kind;
+    u64 timestamp;
+    u8 side;
+    u64 order;
+    i64 price_delta;
+    u64 quantity;
+    Span<const u8> symbol;
+  };
+
+  constexpr StringView SYMBOLS[]{"AAPL", "MSFT", "CRAB", "BRK.B", "SHELLFISH"};
+
+  auto make_updates(const usize count) -> Vec<Update> {
+    std::mt19937_64 rng{117};
+    Vec<Update> updates;
+    for (usize i = 0; i < count; i++) {
+      const StringView symbol = SYMBOLS[rng() % std::size(SYMBOLS)];
+      updates.push_back(Update{
+        .kind = static_cast<u16>(1 + rng() % 4),
+        .timestamp = 1'700'000'000'000'000'000 + i * 1'000,
+        .side = static_cast<u8>(rng() % 2),
+        .order = 1'000'000 + rng() % 100'000'000,
+        .price_delta = static_cast<i64>(rng() % 2'001) - 1'000,
+        .quantity = rng() % 2 == 0 ? rng() % 100 : rng() % 100'000,
+        .symbol = Span{reinterpret_cast<const u8 *>(symbol.data()), symbol.size()},
+      });
+    }
+    return updates;
+  }
+
+  auto encode(const Vec<Update> &updates) -> Vec<u8> {
+    crab::ByteWriter writer;
+    for (const Update &update: updates) {
+      writer.write_be(update.kind);
+      writer.write_le(update.timestamp);
+      writer.write(update.side);
+      writer.write_varint(update.order);
+      writer.write_zigzag(update.price_delta);
+      writer.write_varint(update.quantity);
+      writer.write_varint(update.symbol.size());
+      writer.write_bytes(update.symbol);
+    }
+    return writer.take();
+  }
+
+  auto checksum(const Update &update) -> u64 {
+    return update.kind + update.timestamp + update.side + update.order + static_cast<u64>(update.price_delta)
+      + update.quantity + update.symbol.size();
+  }
+
+  /**
+   * @brief The value of a read, clearing 'ok' if it failed, so that decoding checks every field like a real one
+   */
+  template<typename T>
+  __always_inline auto get(Result<T, crab::DecodeError> result, bool &ok) -> T {
+    ok &= result.is_ok();
+    return result.is_ok() ? result.take_unchecked() : T{};
+  }
+
+  /**
+   * @brief What hand written decoders do: a bounds check & memcpy per field, varints a byte at a time
+   */
+  class Manual {
+    const u8 *data;
+    usize len;
+    usize position = 0;
+
+  public:
+    explicit Manual(const Span<const u8> bytes) : data{bytes.data()}, len{bytes.size()} {}
+
+    [[nodiscard]] auto is_empty() const -> bool { return position == len; }
+
+    template<typename T>
+    auto fixed(T &value, const bool big_endian) -> bool {
+      if (len - position < sizeof(T)) return false;
+      std::memcpy(&value, data + position, sizeof(T));
+      if (big_endian and sizeof(T) > 1) value = std::byteswap(value);
+      position += sizeof(T);
+      return true;
+    }
+
+    auto slice(Span<const u8> &value, const usize count) -> bool {
+      if (len - position < count) return false;
+      value = Span{data + position, count};
+      position += count;
+      return true;
+    }
+
+    auto varint(u64 &value) -> bool {
+      value = 0;
+      for (usize shift = 0; shift < 64 and position < len; shift += 7) {
+        const u8 byte = data[position++];
+        value |= u64{byte & 0x7fu} << shift;
+        if (byte < 0x80) return true;
+      }
+      return false;
+    }
+  };
+
+  /**
+   * @brief An ITCH style fixed layout "add order": every field big endian at a known offset, 37 bytes
+   */
+  auto make_add_orders(const usize count) -> Vec<u8> {
+    std::mt19937_64 rng{118};
+    crab::ByteWriter writer{count * 37};
+    for (usize i = 0; i < count; i++) {
+      writer.write_be(static_cast<u16>(rng() % 8'000));
+      writer.write_be(static_cast<u16>(i));
+      writer.write_be(34'200'000'000'000 + i * 1'000);
+      writer.write_be(rng());
+      writer.write(static_cast<u8>(rng() % 2 == 0 ? 'B' : 'S'));
+      writer.write_be(static_cast<u32>(rng() % 10'000));
+      writer.write_bytes(Span{reinterpret_cast<const u8 *>("CRAB    "), 8});
+      writer.write_be(static_cast<u32>(rng() % 1'000'000));
+    }
+    return writer.take();
+  }
+}
+
+TEST_CASE("ByteCursor decoding", "[bytes][!benchmark]") {
+  const Vec<Update> updates = make_updates(100'000);
+  const Vec<u8> stream = encode(updates);
+  const String suffix = " (" + std::to_string(stream.size() >> 10) + " KiB)";
+
+  BENCHMARK("Manual memcpy + byte at a time varints" + suffix) {
+    Manual manual{stream};
+    u64 total = 0;
+    while (not manual.is_empty()) {
+      Update update{};
+      u64 zigzag = 0, length = 0;
+      const bool ok = manual.fixed(update.kind, true) and manual.fixed(update.timestamp, false)
+        and manual.fixed(update.side, false) and manual.varint(update.order) and manual.varint(zigzag)
+        and manual.varint(update.quantity) and manual.varint(length) and manual.slice(update.symbol, length);
+      if (not ok) return u64{0};
+      update.price_delta = static_cast<i64>(zigzag >> 1) ^ -static_cast<i64>(zigzag & 1);
+      total += checksum(update);
+    }
+    return total;
+  };
+
+  BENCHMARK("crab::ByteCursor" + suffix) {
+    crab::ByteCursor cursor{stream};
+    u64 total = 0;
+    while (not cursor.is_empty()) {
+      Update update{};
+      bool ok = true;
+      update.kind = get(cursor.read_be<u16>(), ok);
+      update.timestamp = get(cursor.read_le<u64>(), ok);
+      update.side = get(cursor.read<u8>(), ok);
+      update.order = get(cursor.read_varint(), ok);
+      update.price_delta = get(cursor.read_zigzag(), ok);
+      update.quantity = get(cursor.read_varint(), ok);
+      update.symbol = get(cursor.read_slice(get(cursor.read_varint(), ok)), ok);
+      if (not ok) return u64{0};
+      total += checksum(update);
+    }
+    return total;
+  };
+
+  BENCHMARK("crab::ByteWriter" + suffix) {
+    return encode(updates).size();
+  };
+}
+
+TEST_CASE("ByteCursor fixed layout decoding", "[bytes][!benchmark]") {
+  const Vec<u8> stream = make_add_orders(100'000);
+  const String suffix = " (" + std::to_string(stream.size() >> 10) + " KiB)";
+
+  BENCHMARK("crab::ByteCursor checked reads" + suffix) {
+    crab::ByteCursor cursor{stream};
+    u64 total = 0;
+    while (not cursor.is_empty()) {
+      bool ok = true;
+      total += get(cursor.read_be<u16>(), ok) + get(cursor.read_be<u16>(), ok);
+      total += get(cursor.read_be<u64>(), ok) + get(cursor.read_be<u64>(), ok);
+      total += get(cursor.read<u8>(), ok);
+      total += get(cursor.read_be<u32>(), ok) + get(cursor.read_slice(8), ok).size() + get(cursor.read_be<u32>(), ok);
+      if (not ok) return u64{0};
+    }
+    return total;
+  };
+
+  BENCHMARK("crab::ByteCursor::unchecked per message" + suffix) {
+    crab::ByteCursor cursor{stream};
+    u64 total = 0;
+    while (not cursor.is_empty()) {
+      auto checked = cursor.unchecked(37);
+      if (checked.is_err()) return u64{0};
+      auto message = checked.take_unchecked();
+      total += message.read_be<u16>() + message.read_be<u16>();
+      total += message.read_be<u64>() + message.read_be<u64>();
+      total += message.read<u8>();
+      total += message.read_be<u32>() + message.read_slice(8).size() + message.read_be<u32>();
+    }
+    return total;
+  };
+}
@@ -0,0 +1,66 @@
+#include <encoding.hpp>
+
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize SIZE = 4 << 20;
+
+  auto random_bytes(const u64 seed) -> Vec<u8> {
+    std::mt19937_64 rng{seed};
+    Vec<u8> bytes(SIZE);
+    for (u8 &byte: bytes) byte = static_cast<u8>(rng());
+    return bytes;
+  }
+}
+
+TEST_CASE("Hex vs scalar", "[encoding][!benchmark]") {
+  const Vec<u8> bytes = random_bytes(125);
+  Vec<u8> text(crab::encoding::hex_encoded_length(SIZE));
+  Vec<u8> decoded(SIZE);
+  crab::encoding::hex_encode(bytes, text);
+
+  BENCHMARK("crab::encoding::hex_encode (4 MiB)") {
+    return crab::encoding::hex_encode(bytes, text);
+  };
+
+  BENCHMARK("scalar hex encode (4 MiB)") {
+    crab::encoding::helper::scalar_hex_encode(bytes.data(), SIZE, text.data(), crab::encoding::Case::Lower);
+    return text[0];
+  };
+
+  BENCHMARK("crab::encoding::hex_decode (8 MiB of digits)") {
+    return crab::encoding::hex_decode(Span<const u8>{text}, decoded).is_ok();
+  };
+
+  BENCHMARK("scalar hex decode (8 MiB of digits)") {
+    return crab::encoding::helper::scalar_hex_decode(text.data(), text.size(), decoded.data()).is_ok();
+  };
+}
+
+TEST_CASE("Base64 vs scalar", "[encoding][!benchmark]") {
+  const Vec<u8> bytes = random_bytes(125);
+  for (const auto variant: {crab::encoding::Base64::Standard, crab::encoding::Base64::Url}) {
+    const String suffix = variant == crab::encoding::Base64::Standard ? " (4 MiB)" : " (4 MiB, url)";
+    Vec<u8> text(crab::encoding::base64_encoded_length(SIZE, variant));
+    crab::encoding::base64_encode(bytes, text, variant);
+    Vec<u8> decoded(crab::encoding::base64_decoded_length(text));
+
+    BENCHMARK("crab::encoding::base64_encode" + suffix) {
+      return crab::encoding::base64_encode(bytes, text, variant);
+    };
+
+    BENCHMARK("scalar base64 encode" + suffix) {
+      return crab::encoding::helper::scalar_base64_encode(bytes.data(), SIZE, text.data(), variant);
+    };
+
+    BENCHMARK("crab::encoding::base64_decode" + suffix) {
+      return crab::encoding::base64_decode(Span<const u8>{text}, decoded, variant).is_ok();
+    };
+
+    BENCHMARK("scalar base64 decode" + suffix) {
+      return crab::encoding::helper::scalar_base64_decode(text.data(), text.size(), decoded.data(), variant).is_ok();
+    };
+  }
+}
@@ -0,0 +1,63 @@
+#include <filter.hpp>
+
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Set lookups that mostly miss, with & without a filter", "[filter][!benchmark]") {
+  constexpr usize STORED = 4'000'000;
+  constexpr usize QUERIES = 1'000'000;
+  // one in a hundred queries is stored
+  constexpr usize HIT_EVERY = 100;
+
+  std::mt19937_64 rng{121};
+  Set<u64> stored;
+  stored.reserve(STORED);
+  Vec<u64> keys;
+  while (keys.size() < STORED) {
+    if (const u64 key = rng(); stored.insert(key).second) keys.push_back(key);
+  }
+  Vec<u64> queries(QUERIES);
+  for (usize i = 0; i < QUERIES; i++) queries[i] = i % HIT_EVERY == 0 ? keys[rng() % STORED] : rng();
+
+  crab::BloomFilter<u64> bloom{STORED, 0.01};
+  crab::CuckooFilter<u64> cuckoo{STORED};
+  for (const u64 key: keys) {
+    bloom.insert(key);
+    cuckoo.insert(key);
+  }
+
+  BENCHMARK("Set::contains") {
+    usize found = 0;
+    for (const u64 key: queries) found += stored.contains(key);
+    return found;
+  };
+
+  BENCHMARK("BloomFilter (1%) then Set") {
+    usize found = 0;
+    for (const u64 key: queries) found += bloom.contains(key) and stored.contains(key);
+    return found;
+  };
+
+  BENCHMARK("BloomFilter::contains_many then Set") {
+    Vec<u8> maybe(QUERIES);
+    bloom.contains_many(queries, Span{reinterpret_cast<bool*>(maybe.data()), QUERIES});
+    usize found = 0;
+    for (usize i = 0; i < QUERIES; i++) found += maybe[i] and stored.contains(queries[i]);
+    return found;
+  };
+
+  BENCHMARK("CuckooFilter (16 bit) then Set") {
+    usize found = 0;
+    for (const u64 key: queries) found += cuckoo.contains(key) and stored.contains(key);
+    return found;
+  };
+
+  BENCHMARK("CuckooFilter::contains_many then Set") {
+    Vec<u8> maybe(QUERIES);
+    cuckoo.contains_many(queries, Span{reinterpret_cast<bool*>(maybe.data()), QUERIES});
+    usize found = 0;
+    for (usize i = 0; i < QUERIES; i++) found += maybe[i] and stored.contains(queries[i]);
+    return found;
+  };
+}
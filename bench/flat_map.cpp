@@ -0,0 +1,66 @@
+#include <flat_map.hpp>
+
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("FlatMap vs std::unordered_map & std::map", "[flat_map][!benchmark]") {
+  for (const usize n: {4ul, 8ul, 16ul, 32ul, 64ul, 256ul}) {
+    std::mt19937 rng{3};
+
+    Vec<std::pair<u32, u32>> entries;
+    for (usize i = 0; i < n; i++) {
+      entries.emplace_back(rng(), static_cast<u32>(i));
+    }
+
+    crab::FlatMap<u32, u32> flat;
+    flat.insert_batch(entries);
+    const std::unordered_map<u32, u32> hashed{entries.begin(), entries.end()};
+    const std::map<u32, u32> ordered{entries.begin(), entries.end()};
+
+    // half hits & half misses
+    Vec<u32> probes;
+    for (usize i = 0; i < 4'096; i++) {
+      probes.push_back(i % 2 == 0 ? entries[rng() % n].first : rng());
+    }
+
+    const String size = " n=" + std::to_string(n);
+
+    BENCHMARK("FlatMap::get" + size) {
+      u32 sum = 0;
+      for (const u32 key: probes) {
+        if (auto value = flat.get(key)) sum += *value.take_unchecked();
+      }
+      return sum;
+    };
+
+    BENCHMARK("std::unordered_map::find" + size) {
+      u32 sum = 0;
+      for (const u32 key: probes) {
+        if (const auto it = hashed.find(key); it != hashed.end()) sum += it->second;
+      }
+      return sum;
+    };
+
+    BENCHMARK("std::map::find" + size) {
+      u32 sum = 0;
+      for (const u32 key: probes) {
+        if (const auto it = ordered.find(key); it != ordered.end()) sum += it->second;
+      }
+      return sum;
+    };
+
+    BENCHMARK("FlatMap::insert_batch" + size) {
+      crab::FlatMap<u32, u32> map;
+      map.insert_batch(entries);
+      return map.length();
+    };
+
+    BENCHMARK("std::unordered_map build" + size) {
+      std::unordered_map<u32, u32> map{entries.begin(), entries.end()};
+      return map.size();
+    };
+  }
+}
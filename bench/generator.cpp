@@ -0,0 +1,114 @@
+#include <generator.hpp>
+#include <range.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr u64 COUNT = 1 << 20;
+
+  auto iota(const u64 max) -> crab::Generator<u64> {
+    for (u64 i = 0; i < max; i++) co_yield i;
+  }
+
+  auto collatz_lengths(const u64 max) -> crab::Generator<u64> {
+    for (u64 start = 1; start < max; start++) {
+      u64 steps = 0;
+      for (u64 n = start; n != 1; steps++) n = n % 2 == 0 ? n / 2 : 3 * n + 1;
+      co_yield steps;
+    }
+  }
+
+  /**
+   * @brief Hand written equivalent of collatz_lengths
+   */
+  class CollatzLengths {
+    u64 max;
+
+  public:
+    struct Iterator {
+      using iterator_category = std::input_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = u64;
+
+      u64 start;
+
+      [[nodiscard]] auto operator*() const -> u64 {
+        u64 steps = 0;
+        for (u64 n = start; n != 1; steps++) n = n % 2 == 0 ? n / 2 : 3 * n + 1;
+        return steps;
+      }
+
+      auto operator++() -> Iterator& {
+        start++;
+        return *this;
+      }
+
+      [[nodiscard]] friend auto operator==(const Iterator &a, const Iterator &b) -> bool { return a.start == b.start; }
+    };
+
+    explicit CollatzLengths(const u64 max) : max{max} {}
+
+    [[nodiscard]] auto begin() const -> Iterator { return Iterator{1}; }
+
+    [[nodiscard]] auto end() const -> Iterator { return Iterator{max}; }
+  };
+
+  auto collatz_lengths_vec(const u64 max) -> Vec<u64> {
+    Vec<u64> lengths;
+    for (u64 start = 1; start < max; start++) {
+      u64 steps = 0;
+      for (u64 n = start; n != 1; steps++) n = n % 2 == 0 ? n / 2 : 3 * n + 1;
+      lengths.push_back(steps);
+    }
+    return lengths;
+  }
+}
+
+TEST_CASE("Generator vs hand written iterators & Vec", "[generator][!benchmark]") {
+  BENCHMARK("Range iterator sum") {
+    u64 sum = 0;
+    for (const u64 i: crab::range(COUNT)) sum += i;
+    return sum;
+  };
+
+  BENCHMARK("Generator sum") {
+    u64 sum = 0;
+    for (const u64 i: iota(COUNT)) sum += i;
+    return sum;
+  };
+
+  BENCHMARK("Vec materialized sum") {
+    Vec<u64> values;
+    for (u64 i = 0; i < COUNT; i++) values.push_back(i);
+    u64 sum = 0;
+    for (const u64 i: values) sum += i;
+    return sum;
+  };
+
+  // per element work dominates, what's left is the resume / yield overhead
+  BENCHMARK("Hand written iterator collatz") {
+    u64 longest = 0;
+    for (const u64 steps: CollatzLengths{COUNT / 8}) longest = std::max(longest, steps);
+    return longest;
+  };
+
+  BENCHMARK("Generator collatz") {
+    u64 longest = 0;
+    for (const u64 steps: collatz_lengths(COUNT / 8)) longest = std::max(longest, steps);
+    return longest;
+  };
+
+  BENCHMARK("Vec materialized collatz") {
+    u64 longest = 0;
+    for (const u64 steps: collatz_lengths_vec(COUNT / 8)) longest = std::max(longest, steps);
+    return longest;
+  };
+
+  // frame allocation from the pool, the cost of setting up a generator that yields once
+  BENCHMARK("Generator construction") {
+    u64 sum = 0;
+    for (u64 i = 0; i < 1'000; i++) sum += iota(1).next().take_unchecked();
+    return sum;
+  };
+}
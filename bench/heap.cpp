@@ -0,0 +1,156 @@
+#include <heap.hpp>
+
+#include <queue>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  /**
+   * @brief Random graph in compressed sparse rows, the out edges of 'v' are [offsets[v], offsets[v + 1])
+   */
+  struct Graph {
+    Vec<u32> offsets;
+    Vec<u32> targets;
+    Vec<u32> weights;
+  };
+
+  auto make_graph(const usize vertices, const usize degree, const u64 seed) -> Graph {
+    std::mt19937_64 rng{seed};
+    Graph graph;
+    graph.offsets.reserve(vertices + 1);
+    for (usize v = 0; v <= vertices; v++) graph.offsets.push_back(static_cast<u32>(v * degree));
+    for (usize i = 0; i < vertices * degree; i++) {
+      graph.targets.push_back(static_cast<u32>(rng() % vertices));
+      graph.weights.push_back(static_cast<u32>(1 + rng() % 1'000));
+    }
+    return graph;
+  }
+
+  using Pending = std::pair<u64, u32>;
+
+  /**
+   * @brief Dijkstra with lazy deletion, stale entries are skipped when popped
+   */
+  template<typename Push, typename Pop>
+  auto lazy_dijkstra(const Graph &graph, Push push, Pop pop) -> u64 {
+    Vec<u64> distances(graph.offsets.size() - 1, std::numeric_limits<u64>::max());
+    distances[0] = 0;
+    push(Pending{0, 0});
+    for (auto next = pop(); next.is_some(); next = pop()) {
+      const auto [distance, vertex] = next.take_unchecked();
+      if (distance != distances[vertex]) continue;
+      for (u32 e = graph.offsets[vertex]; e < graph.offsets[vertex + 1]; e++) {
+        if (const u64 through = distance + graph.weights[e]; through < distances[graph.targets[e]]) {
+          distances[graph.targets[e]] = through;
+          push(Pending{through, graph.targets[e]});
+        }
+      }
+    }
+    u64 total = 0;
+    for (const u64 distance: distances) total += distance;
+    return total;
+  }
+}
+
+TEST_CASE("Dijkstra single source shortest paths", "[heap][!benchmark]") {
+  constexpr usize VERTICES = 200'000;
+  const Graph graph = make_graph(VERTICES, 8, 122);
+
+  BENCHMARK("std::priority_queue (lazy)") {
+    std::priority_queue<Pending, Vec<Pending>, std::greater<>> queue;
+    return lazy_dijkstra(
+      graph,
+      [&](const Pending entry) { queue.push(entry); },
+      [&]() -> Option<Pending> {
+        if (queue.empty()) return crab::none;
+        const Pending top = queue.top();
+        queue.pop();
+        return crab::some(top);
+      }
+    );
+  };
+
+  BENCHMARK("DaryHeap<4> (lazy)") {
+    crab::DaryHeap<Pending> heap;
+    return lazy_dijkstra(graph, [&](const Pending entry) { heap.push(entry); }, [&] { return heap.pop(); });
+  };
+
+  BENCHMARK("DaryHeap<8> (lazy)") {
+    crab::DaryHeap<Pending, 8> heap;
+    return lazy_dijkstra(graph, [&](const Pending entry) { heap.push(entry); }, [&] { return heap.pop(); });
+  };
+
+  BENCHMARK("IndexedDaryHeap<4> (decrease_key)") {
+    Vec<u64> distances(VERTICES, std::numeric_limits<u64>::max());
+    crab::IndexedDaryHeap<u64> frontier{VERTICES};
+    distances[0] = 0;
+    frontier.push(0, 0);
+    for (auto next = frontier.pop(); next.is_some(); next = frontier.pop()) {
+      const auto [vertex, distance] = next.take_unchecked();
+      for (u32 e = graph.offsets[vertex]; e < graph.offsets[vertex + 1]; e++) {
+        if (const u64 through = distance + graph.weights[e]; through < distances[graph.targets[e]]) {
+          distances[graph.targets[e]] = through;
+          frontier.push_or_decrease(graph.targets[e], through);
+        }
+      }
+    }
+    u64 total = 0;
+    for (const u64 distance: distances) total += distance;
+    return total;
+  };
+
+  BENCHMARK("RadixHeap (lazy)") {
+    crab::RadixHeap<u64, u32> heap;
+    return lazy_dijkstra(
+      graph,
+      [&](const Pending entry) { heap.push(entry.first, entry.second); },
+      [&] { return heap.pop(); }
+    );
+  };
+}
+
+TEST_CASE("Event scheduling (hold model)", "[heap][!benchmark]") {
+  // a steady population of pending events, each fired one schedules another a random delay later
+  constexpr usize PENDING = 100'000;
+  constexpr usize FIRED = 1'000'000;
+
+  std::mt19937_64 rng{122};
+  Vec<u64> delays(FIRED);
+  for (u64 &delay: delays) delay = 1 + rng() % 10'000;
+  Vec<u64> initial(PENDING);
+  for (u64 &time: initial) time = rng() % 10'000;
+
+  BENCHMARK("std::priority_queue") {
+    std::priority_queue<u64, Vec<u64>, std::greater<>> queue{std::greater<>{}, Vec<u64>{initial}};
+    for (const u64 delay: delays) {
+      const u64 now = queue.top();
+      queue.pop();
+      queue.push(now + delay);
+    }
+    return queue.top();
+  };
+
+  BENCHMARK("DaryHeap<4>") {
+    crab::DaryHeap<u64> heap;
+    heap.reserve(PENDING);
+    for (const u64 time: initial) heap.push(time);
+    for (const u64 delay: delays) heap.push(heap.pop().take_unchecked() + delay);
+    return heap.pop().take_unchecked();
+  };
+
+  BENCHMARK("DaryHeap<8>") {
+    crab::DaryHeap<u64, 8> heap;
+    heap.reserve(PENDING);
+    for (const u64 time: initial) heap.push(time);
+    for (const u64 delay: delays) heap.push(heap.pop().take_unchecked() + delay);
+    return heap.pop().take_unchecked();
+  };
+
+  BENCHMARK("RadixHeap") {
+    crab::RadixHeap<u64> heap;
+    for (const u64 time: initial) heap.push(time);
+    for (const u64 delay: delays) heap.push(heap.pop().take_unchecked().first + delay);
+    return heap.pop().take_unchecked().first;
+  };
+}
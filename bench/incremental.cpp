@@ -0,0 +1,97 @@
+#include <incremental.hpp>
+
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize FILES = 2'000;
+  constexpr usize FILES_PER_MODULE = 20;
+  constexpr usize MODULES = FILES / FILES_PER_MODULE;
+
+  /**
+   * @brief What parsing a file yields, whitespace does not change it
+   */
+  struct Summary {
+    u64 symbols = 0;
+    u64 hash = 0;
+
+    auto operator==(const Summary &) const -> bool = default;
+  };
+
+  auto make_files(const u64 seed) -> Vec<String> {
+    std::mt19937_64 rng{seed};
+    constexpr StringView words[]{"fn", "let", "crab", "shell", "(", ")", "{", "}", "return", "reef", "=", ";"};
+    Vec<String> files(FILES);
+    for (String &file: files) {
+      for (usize i = 0; i < 200; i++) file += String{words[rng() % std::size(words)]} + (i % 12 == 11 ? "\n" : " ");
+    }
+    return files;
+  }
+
+  auto parse(const StringView text) -> Summary {
+    Summary summary;
+    u64 hash = 0xcbf2'9ce4'8422'2325;
+    for (const char c: text) {
+      if (c == ' ' or c == '\n') {
+        summary.symbols++;
+        continue;
+      }
+      hash = (hash ^ static_cast<u8>(c)) * 0x100'0000'01b3;
+    }
+    summary.hash = hash;
+    return summary;
+  }
+
+  auto combine(const u64 total, const Summary &summary) -> u64 { return total * 31 + summary.hash + summary.symbols; }
+}
+
+TEST_CASE("incremental recomputation after small edits", "[incremental][!benchmark]") {
+  Vec<String> files = make_files(119);
+  const String edited = files[FILES / 2] + "edit ";
+  const String original = files[FILES / 2];
+
+  BENCHMARK("From scratch, every file parsed") {
+    files[FILES / 2] = files[FILES / 2] == original ? edited : original;
+    u64 program = 0;
+    for (usize module = 0; module < MODULES; module++) {
+      u64 total = 0;
+      for (usize i = 0; i < FILES_PER_MODULE; i++) total = combine(total, parse(files[module * FILES_PER_MODULE + i]));
+      program += total;
+    }
+    return program;
+  };
+
+  crab::incremental::Database db;
+  Vec<crab::incremental::Input<String>> inputs;
+  for (const String &file: make_files(119)) inputs.push_back(db.input(file));
+
+  const auto parsed = db.query<usize>([=](const usize file) { return parse(*inputs[file].get()); });
+  const auto module = db.query<usize>([=](const usize index) {
+    u64 total = 0;
+    for (usize i = 0; i < FILES_PER_MODULE; i++) total = combine(total, *parsed(index * FILES_PER_MODULE + i));
+    return total;
+  });
+  const auto program = db.query<u8>([=](u8) {
+    u64 total = 0;
+    for (usize index = 0; index < MODULES; index++) total += *module(index);
+    return total;
+  });
+  REQUIRE(*program(0) != 0);
+
+  BENCHMARK("crab::incremental, one file edited") {
+    const auto &file = inputs[FILES / 2];
+    file.set(*file.get() == original ? edited : original);
+    return *program(0);
+  };
+
+  BENCHMARK("crab::incremental, whitespace edit (early cutoff)") {
+    const auto &file = inputs[FILES / 2];
+    file.set(file.get()->ends_with("\n") ? original : original + "\n");
+    return *program(0);
+  };
+
+  BENCHMARK("crab::incremental, nothing edited") {
+    return *program(0);
+  };
+}
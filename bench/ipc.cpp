@@ -0,0 +1,126 @@
+#include <ipc.hpp>
+
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize LARGE = 4096;
+  constexpr usize SMALL = 64;
+  constexpr usize BURST = 256;
+
+  // first byte of every message
+  constexpr u8 DATA = 0;
+  constexpr u8 PING = 1;
+  constexpr u8 EXIT = 2;
+
+  /**
+   * @brief Reads every byte, so both transports pay for looking at the payload
+   */
+  auto checksum(const Span<const u8> bytes) -> u64 {
+    u64 sum = 0;
+    for (usize i = 0; i + sizeof(u64) <= bytes.size(); i += sizeof(u64)) {
+      u64 word;
+      std::memcpy(&word, bytes.data() + i, sizeof(word));
+      sum += word;
+    }
+    return sum;
+  }
+
+  [[noreturn]] auto serve_channel(const crab::ipc::Channel &requests, const crab::ipc::Channel &replies) -> void {
+    crab::ipc::Consumer consumer = requests.consumer();
+    const crab::ipc::Producer producer = replies.producer();
+
+    u64 sum = 0;
+    while (true) {
+      auto received = consumer.receive();
+      if (received.is_err()) ::_exit(1);
+
+      const crab::ipc::Message message = received.take_unchecked();
+      sum += checksum(message.bytes());
+      if (message.bytes()[0] == EXIT) ::_exit(0);
+      if (message.bytes()[0] == PING) (void) producer.send({reinterpret_cast<const u8*>(&sum), sizeof(sum)});
+    }
+  }
+
+  [[noreturn]] auto serve_socket(const i32 fd) -> void {
+    Vec<u8> buffer(LARGE);
+    u64 sum = 0;
+    while (true) {
+      const ssize_t received = ::recv(fd, buffer.data(), buffer.size(), 0);
+      if (received <= 0) ::_exit(1);
+
+      sum += checksum({buffer.data(), static_cast<usize>(received)});
+      if (buffer[0] == EXIT) ::_exit(0);
+      if (buffer[0] == PING) (void) ::send(fd, &sum, sizeof(sum), 0);
+    }
+  }
+
+  auto send_channel(const crab::ipc::Producer &producer, const usize size, const u8 kind) -> void {
+    crab::ipc::Reservation reservation = producer.reserve(size).take_unchecked();
+    // written in place, straight into the shared ring
+    std::memset(reservation.bytes().data(), kind, size);
+    reservation.commit();
+  }
+
+  auto send_socket(const i32 fd, Vec<u8> &buffer, const usize size, const u8 kind) -> void {
+    std::memset(buffer.data(), kind, size);
+    (void) ::send(fd, buffer.data(), size, 0);
+  }
+}
+
+TEST_CASE("ipc::Channel vs UNIX socket between processes", "[ipc][!benchmark]") {
+  const auto requests = crab::ipc::Channel::anonymous(1 << 20).take_unchecked();
+  const auto replies = crab::ipc::Channel::anonymous(1 << 12).take_unchecked();
+
+  const pid_t channel_server = ::fork();
+  if (channel_server == 0) serve_channel(requests, replies);
+
+  i32 sockets[2];
+  REQUIRE(::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) == 0);
+  const pid_t socket_server = ::fork();
+  if (socket_server == 0) {
+    ::close(sockets[0]);
+    serve_socket(sockets[1]);
+  }
+  ::close(sockets[1]);
+
+  const crab::ipc::Producer producer = requests.producer();
+  crab::ipc::Consumer consumer = replies.consumer();
+  Vec<u8> buffer(LARGE);
+
+  BENCHMARK("Channel throughput (256 x 4 KiB)") {
+    for (usize i = 0; i < BURST; i++) send_channel(producer, LARGE, DATA);
+    send_channel(producer, SMALL, PING);
+    return checksum(consumer.receive().take_unchecked().bytes());
+  };
+
+  BENCHMARK("UNIX socket throughput (256 x 4 KiB)") {
+    for (usize i = 0; i < BURST; i++) send_socket(sockets[0], buffer, LARGE, DATA);
+    send_socket(sockets[0], buffer, SMALL, PING);
+    u64 reply = 0;
+    (void) ::recv(sockets[0], &reply, sizeof(reply), 0);
+    return reply;
+  };
+
+  BENCHMARK("Channel round trip (64 B)") {
+    send_channel(producer, SMALL, PING);
+    return checksum(consumer.receive().take_unchecked().bytes());
+  };
+
+  BENCHMARK("UNIX socket round trip (64 B)") {
+    send_socket(sockets[0], buffer, SMALL, PING);
+    u64 reply = 0;
+    (void) ::recv(sockets[0], &reply, sizeof(reply), 0);
+    return reply;
+  };
+
+  send_channel(producer, SMALL, EXIT);
+  send_socket(sockets[0], buffer, SMALL, EXIT);
+  ::waitpid(channel_server, nullptr, 0);
+  ::waitpid(socket_server, nullptr, 0);
+  ::close(sockets[0]);
+}
@@ -0,0 +1,81 @@
+#include <json.hpp>
+
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#if CRAB_BENCH_NLOHMANN
+#include <nlohmann/json.hpp>
+#endif
+
+namespace {
+  /**
+   * @brief About 1 MiB of event payloads: an array of objects with ids, timestamps, nested user objects, tag arrays
+   * & free text, some of it escaped
+   */
+  auto make_events(const u64 seed) -> String {
+    std::mt19937_64 rng{seed};
+    constexpr StringView words[]{"crab", "shell", "tide", "reef", "claw", "sand", "κάβουρας", "螃蟹", "\\\"quoted\\\""};
+    const auto sentence = [&](const usize length) {
+      String text;
+      for (usize i = 0; i < length; i++) text += String{words[rng() % std::size(words)]} + " ";
+      return text;
+    };
+
+    String text = "[\n";
+    for (usize id = 0; text.size() < (1 << 20); id++) {
+      if (id > 0) text += ",\n";
+      text += "  {\"id\": " + std::to_string(id);
+      text += ", \"timestamp\": " + std::to_string(1'700'000'000'000 + rng() % 1'000'000'000);
+      text += ", \"score\": " + std::to_string(static_cast<double>(rng() % 100'000) / 1000.0);
+      text += ", \"user\": {\"name\": \"" + sentence(2) + "\", \"verified\": " + (rng() % 2 == 0 ? "true" : "false");
+      text += ", \"followers\": " + std::to_string(rng() % 100'000) + "}";
+      text += ", \"tags\": [";
+      for (usize tag = rng() % 5; tag > 0; tag--) {
+        text += "\"" + String{words[rng() % 6]} + "\"" + (tag > 1 ? ", " : "");
+      }
+      text += "], \"text\": \"" + sentence(4 + rng() % 20) + "\", \"reply_to\": null}";
+    }
+    return text + "\n]\n";
+  }
+}
+
+TEST_CASE("crab::json vs nlohmann::json", "[json][!benchmark]") {
+  const String text = make_events(1);
+  const String suffix = " (" + std::to_string(text.size() >> 10) + " KiB)";
+
+  BENCHMARK("crab::json::parse" + suffix) {
+    return crab::json::parse(text).is_ok();
+  };
+
+  #if CRAB_BENCH_NLOHMANN
+  BENCHMARK("nlohmann::json::parse" + suffix) {
+    return nlohmann::json::parse(text).size();
+  };
+  #endif
+
+  // what a consumer of the events does: a few fields of every one
+  BENCHMARK("crab::json parse + read fields" + suffix) {
+    const auto document = crab::json::parse(text).take_unchecked();
+    u64 total = 0;
+    for (const crab::json::Value event: document.root().elements()) {
+      total += event["timestamp"].take_unchecked().as<u64>().take_unchecked();
+      total += event["user"].take_unchecked()["followers"].take_unchecked().as<u32>().take_unchecked();
+      total += event["tags"].take_unchecked().length();
+    }
+    return total;
+  };
+
+  #if CRAB_BENCH_NLOHMANN
+  BENCHMARK("nlohmann::json parse + read fields" + suffix) {
+    const auto document = nlohmann::json::parse(text);
+    u64 total = 0;
+    for (const auto &event: document) {
+      total += event["timestamp"].get<u64>();
+      total += event["user"]["followers"].get<u32>();
+      total += event["tags"].size();
+    }
+    return total;
+  };
+  #endif
+}
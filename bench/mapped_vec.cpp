@@ -0,0 +1,74 @@
+#include <mapped_vec.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize COUNT = 1 << 22;
+
+  struct Record {
+    u64 key;
+    f32 score;
+    u32 flags;
+  };
+}
+
+TEST_CASE("MappedVec restart vs reload from serialized", "[mapped_vec][!benchmark]") {
+  const auto directory = std::filesystem::temp_directory_path();
+  const auto mapped_path = directory / ("crab-bench-mapped-" + std::to_string(::getpid()));
+  const auto serialized_path = directory / ("crab-bench-serialized-" + std::to_string(::getpid()));
+
+  Vec<Record> records(COUNT);
+  for (usize i = 0; i < COUNT; i++) records[i] = Record{i * 7, static_cast<f32>(i) * .5f, static_cast<u32>(i % 3)};
+
+  {
+    std::filesystem::remove(mapped_path);
+    auto vec = crab::MappedVec<Record>::open(mapped_path).take_unchecked();
+    (void) vec.extend(records);
+    (void) vec.flush();
+
+    std::ofstream stream{serialized_path, std::ios::binary | std::ios::trunc};
+    const u64 length = records.size();
+    stream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    stream.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(COUNT * sizeof(Record)));
+  }
+
+  // both files are in the page cache, this measures the work a restart does on top of the IO
+  BENCHMARK("Reload from serialized file") {
+    std::ifstream stream{serialized_path, std::ios::binary};
+    u64 length = 0;
+    stream.read(reinterpret_cast<char*>(&length), sizeof(length));
+    Vec<Record> loaded(length);
+    stream.read(reinterpret_cast<char*>(loaded.data()), static_cast<std::streamsize>(length * sizeof(Record)));
+    return loaded.size();
+  };
+
+  BENCHMARK("Reopen MappedVec") {
+    return crab::MappedVec<Record>::open(mapped_path).take_unchecked().length();
+  };
+
+  BENCHMARK("Reload from serialized file & scan") {
+    std::ifstream stream{serialized_path, std::ios::binary};
+    u64 length = 0;
+    stream.read(reinterpret_cast<char*>(&length), sizeof(length));
+    Vec<Record> loaded(length);
+    stream.read(reinterpret_cast<char*>(loaded.data()), static_cast<std::streamsize>(length * sizeof(Record)));
+
+    u64 sum = 0;
+    for (const Record &record: loaded) sum += record.key;
+    return sum;
+  };
+
+  BENCHMARK("Reopen MappedVec & scan") {
+    const auto vec = crab::MappedVec<Record>::open(mapped_path).take_unchecked();
+    u64 sum = 0;
+    for (const Record &record: vec) sum += record.key;
+    return sum;
+  };
+
+  std::filesystem::remove(mapped_path);
+  std::filesystem::remove(serialized_path);
+}
@@ -0,0 +1,87 @@
+#include <ndarray.hpp>
+
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize SIDE = 1024;
+
+  auto random_matrix(const u64 seed) -> crab::NDArray<f32, 2> {
+    std::mt19937_64 rng{seed};
+    crab::NDArray<f32, 2> matrix{{SIDE, SIDE}};
+    for (f32 &x: matrix.as_span()) x = static_cast<f32>(rng() % 10'000) / 100.f;
+    return matrix;
+  }
+
+  /**
+   * @brief An element wise operation the way it is written without expression templates, a new array per operator
+   */
+  template<typename Op>
+  auto apply(const Vec<f32> &left, const Vec<f32> &right, const Op op) -> Vec<f32> {
+    Vec<f32> result(left.size());
+    for (usize i = 0; i < left.size(); i++) result[i] = op(left[i], right[i]);
+    return result;
+  }
+
+  auto to_vec(const crab::NDArray<f32, 2> &matrix) -> Vec<f32> { return {matrix.data(), matrix.data() + matrix.size()}; }
+}
+
+TEST_CASE("NDArray fused expressions", "[ndarray][!benchmark]") {
+  const auto a = random_matrix(1), b = random_matrix(2), c = random_matrix(3), d = random_matrix(4);
+  const Vec<f32> va = to_vec(a), vb = to_vec(b), vc = to_vec(c), vd = to_vec(d);
+  crab::NDArray<f32, 2> out{{SIDE, SIDE}};
+
+  BENCHMARK("a * b + c * 2 - d, temporaries per operator") {
+    const Vec<f32> twice(vc.size(), 2);
+    const Vec<f32> result = apply(
+      apply(apply(va, vb, std::multiplies<>{}), apply(vc, twice, std::multiplies<>{}), std::plus<>{}),
+      vd,
+      std::minus<>{}
+    );
+    return result[SIDE];
+  };
+
+  BENCHMARK("a * b + c * 2 - d, hand fused loop") {
+    f32 *to = out.data();
+    for (usize i = 0; i < out.size(); i++) to[i] = va[i] * vb[i] + vc[i] * 2 - vd[i];
+    return out.data()[SIDE];
+  };
+
+  BENCHMARK("a * b + c * 2 - d, crab::nd") {
+    out.assign(a * b + c * 2 - d);
+    return out.data()[SIDE];
+  };
+
+  // per column statistics, broadcast down the rows
+  const auto mean = crab::NDArray<f32, 1>{{SIDE}, 50.f}, scale = crab::NDArray<f32, 1>{{SIDE}, 0.02f};
+
+  BENCHMARK("(x - mean) * scale, materialised broadcast + temporaries") {
+    Vec<f32> means(va.size()), scales(va.size());
+    for (usize i = 0; i < SIDE; i++) {
+      std::copy_n(mean.data(), SIDE, means.data() + i * SIDE);
+      std::copy_n(scale.data(), SIDE, scales.data() + i * SIDE);
+    }
+    return apply(apply(va, means, std::minus<>{}), scales, std::multiplies<>{})[SIDE];
+  };
+
+  BENCHMARK("(x - mean) * scale, crab::nd broadcast_to") {
+    const auto means = mean.view().broadcast_to(a.shape()).take_unchecked();
+    const auto scales = scale.view().broadcast_to(a.shape()).take_unchecked();
+    out.assign((a - means) * scales);
+    return out.data()[SIDE];
+  };
+
+  BENCHMARK("a + b^T, transposed copy + temporary") {
+    Vec<f32> transposed(vb.size());
+    for (usize i = 0; i < SIDE; i++) {
+      for (usize j = 0; j < SIDE; j++) transposed[j * SIDE + i] = vb[i * SIDE + j];
+    }
+    return apply(va, transposed, std::plus<>{})[SIDE];
+  };
+
+  BENCHMARK("a + b^T, crab::nd transpose view") {
+    out.assign(a + b.view().transpose());
+    return out.data()[SIDE];
+  };
+}
@@ -0,0 +1,103 @@
+#include <num.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize COUNT = 1 << 16;
+
+  template<typename T>
+  auto random_values(const u64 seed) -> Vec<T> {
+    std::mt19937_64 rng{seed};
+    Vec<T> values(COUNT);
+    for (T &value: values) value = static_cast<T>(rng());
+    return values;
+  }
+
+  /**
+   * @brief What one writes by hand without the builtins, a branch on the widened result
+   */
+  template<typename T>
+  __always_inline auto hand_saturating_add(const T a, const T b) -> T {
+    using Wide = std::conditional_t<std::is_signed_v<T>, i64, u64>;
+    const Wide sum = static_cast<Wide>(a) + static_cast<Wide>(b);
+    if (sum > static_cast<Wide>(std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+    if (sum < static_cast<Wide>(std::numeric_limits<T>::min())) return std::numeric_limits<T>::min();
+    return static_cast<T>(sum);
+  }
+
+  template<typename T>
+  auto bulk_benchmarks(const StringView name) -> void {
+    const Vec<T> a = random_values<T>(1);
+    const Vec<T> b = random_values<T>(2);
+    Vec<T> dst(COUNT);
+
+    BENCHMARK(String{"scalar loop saturating_add "} + String{name}) {
+      for (usize i = 0; i < COUNT; i++) dst[i] = crab::saturating_add(a[i], b[i]);
+      return dst[COUNT / 2];
+    };
+
+    BENCHMARK(String{"bulk saturating_add "} + String{name}) {
+      std::copy(a.begin(), a.end(), dst.begin());
+      crab::saturating_add<T>(dst, b);
+      return dst[COUNT / 2];
+    };
+
+    BENCHMARK(String{"copy only "} + String{name}) {
+      std::copy(a.begin(), a.end(), dst.begin());
+      return dst[COUNT / 2];
+    };
+  }
+}
+
+TEST_CASE("Scalar overflow arithmetic vs hand written", "[num][!benchmark]") {
+  const Vec<u32> a = random_values<u32>(1);
+  const Vec<u32> b = random_values<u32>(2);
+  const Vec<i32> c = random_values<i32>(3);
+
+  BENCHMARK("checked_add u32 (count overflows)") {
+    usize overflows = 0;
+    for (usize i = 0; i < COUNT; i++) overflows += crab::checked_add(a[i], b[i]).is_none();
+    return overflows;
+  };
+
+  BENCHMARK("hand written u32 overflow check") {
+    usize overflows = 0;
+    for (usize i = 0; i < COUNT; i++) overflows += static_cast<u32>(a[i] + b[i]) < a[i];
+    return overflows;
+  };
+
+  BENCHMARK("Wrapping<i32> polynomial hash") {
+    crab::Wrapping<i32> hash{17};
+    for (usize i = 0; i < COUNT; i++) hash = hash * crab::Wrapping<i32>{31} + crab::Wrapping<i32>{c[i]};
+    return hash.get();
+  };
+
+  BENCHMARK("u32 cast polynomial hash") {
+    u32 hash = 17;
+    for (usize i = 0; i < COUNT; i++) hash = hash * 31 + static_cast<u32>(c[i]);
+    return static_cast<i32>(hash);
+  };
+
+  BENCHMARK("Saturating<i32> sum") {
+    crab::Saturating<i32> sum{0};
+    for (usize i = 0; i < COUNT; i++) sum += crab::Saturating<i32>{c[i] >> 4};
+    return sum.get();
+  };
+
+  BENCHMARK("hand written i32 saturating sum") {
+    i32 sum = 0;
+    for (usize i = 0; i < COUNT; i++) sum = hand_saturating_add(sum, c[i] >> 4);
+    return sum;
+  };
+}
+
+TEST_CASE("Bulk saturating add vs scalar loop", "[num][!benchmark]") {
+  bulk_benchmarks<u8>("u8");
+  bulk_benchmarks<i16>("i16");
+  bulk_benchmarks<u32>("u32");
+  bulk_benchmarks<i64>("i64");
+}
@@ -0,0 +1,92 @@
+#include <box.hpp>
+#include <packed_vec.hpp>
+
+#include <iostream>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize COUNT = 1 << 22;
+}
+
+TEST_CASE("PackedVec decode vs Box<u32[]>", "[packed_vec][!benchmark]") {
+  for (const u32 bits: {11u, 16u, 20u}) {
+    std::mt19937_64 rng{bits};
+    Vec<u32> values(COUNT);
+    for (u32 &value: values) value = static_cast<u32>(rng() & ((u64{1} << bits) - 1));
+
+    Box<u32[]> boxed = crab::make_boxxed_array<u32>(COUNT);
+    std::copy(values.begin(), values.end(), boxed.as_ptr());
+    const auto packed = crab::PackedVec<>::from_values(values, bits);
+
+    std::cout << bits << " bits: PackedVec " << packed.memory_bytes() << " bytes, Box<u32[]> "
+      << COUNT * sizeof(u32) << " bytes\n";
+
+    const String name = " bits=" + std::to_string(bits);
+    Vec<u32> out(COUNT);
+
+    BENCHMARK("Box<u32[]> copy out" + name) {
+      std::copy_n(boxed.as_ptr(), COUNT, out.data());
+      return out[COUNT / 2];
+    };
+
+    BENCHMARK("PackedVec unpack" + name) {
+      packed.unpack(0, out);
+      return out[COUNT / 2];
+    };
+
+    BENCHMARK("Box<u32[]> sum" + name) {
+      u64 sum = 0;
+      for (usize i = 0; i < COUNT; i++) sum += boxed[i];
+      return sum;
+    };
+
+    BENCHMARK("PackedVec sum (iterator)" + name) {
+      u64 sum = 0;
+      for (const u32 value: packed) sum += value;
+      return sum;
+    };
+
+    Vec<usize> probes(1 << 16);
+    for (usize &probe: probes) probe = rng() % COUNT;
+
+    BENCHMARK("Box<u32[]> random get" + name) {
+      u64 sum = 0;
+      for (const usize i: probes) sum += boxed[i];
+      return sum;
+    };
+
+    BENCHMARK("PackedVec random get" + name) {
+      u64 sum = 0;
+      for (const usize i: probes) sum += packed.get(i);
+      return sum;
+    };
+
+    BENCHMARK("PackedVec pack" + name) { return crab::PackedVec<>::from_values(values, bits).length(); };
+  }
+}
+
+TEST_CASE("PackedFrameVec & PackedDeltaVec decode", "[packed_vec][!benchmark]") {
+  std::mt19937_64 rng{5};
+  Vec<u32> sorted(COUNT);
+  u32 current = 0;
+  for (u32 &value: sorted) value = current += static_cast<u32>(rng() % 64);
+
+  const auto frame = crab::PackedFrameVec::from_values(sorted);
+  const auto delta = crab::PackedDeltaVec::from_values(sorted);
+  std::cout << "sorted: PackedFrameVec " << frame.memory_bytes() << " bytes, PackedDeltaVec " << delta.memory_bytes()
+    << " bytes, Box<u32[]> " << COUNT * sizeof(u32) << " bytes\n";
+
+  Vec<u32> out(COUNT);
+
+  BENCHMARK("PackedFrameVec unpack") {
+    frame.unpack(0, out);
+    return out[COUNT / 2];
+  };
+
+  BENCHMARK("PackedDeltaVec unpack") {
+    delta.unpack(0, out);
+    return out[COUNT / 2];
+  };
+}
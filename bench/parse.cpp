@@ -0,0 +1,108 @@
+#include <parse.hpp>
+
+#include <charconv>
+#include <cstdlib>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize COUNT = 10'000;
+
+  /**
+   * @brief Column of texts kept alive in one buffer, with '\0' after each for strtod
+   */
+  struct Column {
+    String buffer;
+    Vec<StringView> fields;
+  };
+
+  template<typename Generate>
+  auto make_column(Generate generate) -> Column {
+    Column column;
+    Vec<usize> offsets;
+    for (usize i = 0; i < COUNT; i++) {
+      offsets.push_back(column.buffer.size());
+      column.buffer += generate();
+      column.buffer.push_back('\0');
+    }
+    offsets.push_back(column.buffer.size());
+    for (usize i = 0; i < COUNT; i++) {
+      column.fields.emplace_back(column.buffer.data() + offsets[i], offsets[i + 1] - offsets[i] - 1);
+    }
+    return column;
+  }
+
+  auto double_column(const u64 seed) -> Column {
+    std::mt19937_64 rng{seed};
+    std::uniform_real_distribution<double> distribution{-1e6, 1e6};
+    return make_column([&] {
+      char buffer[32];
+      return String{buffer, std::to_chars(buffer, buffer + sizeof(buffer), distribution(rng)).ptr};
+    });
+  }
+
+  auto integer_column(const u64 seed, const u32 max_bits) -> Column {
+    std::mt19937_64 rng{seed};
+    return make_column([&] { return std::to_string(rng() >> (64 - max_bits)); });
+  }
+}
+
+TEST_CASE("crab::parse<double> vs strtod & from_chars", "[parse][!benchmark]") {
+  const Column column = double_column(1);
+
+  BENCHMARK("crab::parse<double>") {
+    double sum = 0;
+    for (const StringView field: column.fields) sum += crab::parse<double>(field).take_unchecked();
+    return sum;
+  };
+
+  BENCHMARK("std::from_chars double") {
+    double sum = 0;
+    for (const StringView field: column.fields) {
+      double value;
+      std::from_chars(field.data(), field.data() + field.size(), value);
+      sum += value;
+    }
+    return sum;
+  };
+
+  BENCHMARK("strtod") {
+    double sum = 0;
+    for (const StringView field: column.fields) sum += std::strtod(field.data(), nullptr);
+    return sum;
+  };
+
+  BENCHMARK("crab::parse_column<double>") {
+    return crab::parse_column<double>(column.fields).take_unchecked()[COUNT / 2];
+  };
+}
+
+TEST_CASE("crab::parse<u64> vs strtoull & from_chars", "[parse][!benchmark]") {
+  for (const u32 bits: {20u, 64u}) {
+    const Column column = integer_column(bits, bits);
+    const String suffix = " (" + std::to_string(bits) + " bit values)";
+
+    BENCHMARK("crab::parse<u64>" + suffix) {
+      u64 sum = 0;
+      for (const StringView field: column.fields) sum += crab::parse<u64>(field).take_unchecked();
+      return sum;
+    };
+
+    BENCHMARK("std::from_chars u64" + suffix) {
+      u64 sum = 0;
+      for (const StringView field: column.fields) {
+        u64 value;
+        std::from_chars(field.data(), field.data() + field.size(), value);
+        sum += value;
+      }
+      return sum;
+    };
+
+    BENCHMARK("strtoull" + suffix) {
+      u64 sum = 0;
+      for (const StringView field: column.fields) sum += std::strtoull(field.data(), nullptr, 10);
+      return sum;
+    };
+  }
+}
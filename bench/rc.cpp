@@ -0,0 +1,107 @@
+#include <rc.hpp>
+
+#include <iostream>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  /**
+   * @brief A small object of which a model holds many equal copies, a handful of key value pairs
+   */
+  struct Attributes {
+    Vec<std::pair<String, String>> entries;
+
+    auto operator==(const Attributes &) const -> bool = default;
+  };
+
+  /**
+   * @brief Heap bytes of one Rc<Attributes> on its own, the value & its counts included
+   */
+  auto footprint(const Attributes &attributes) -> usize {
+    // the value, its reference counts & data pointer, & its entries
+    usize bytes = sizeof(Attributes) + 3 * sizeof(usize);
+    bytes += attributes.entries.capacity() * sizeof(std::pair<String, String>);
+    for (const auto &[key, value]: attributes.entries) {
+      // strings past the small string buffer have their own allocation
+      for (const String *text: {&key, &value}) bytes += text->capacity() > 15 ? text->capacity() + 1 : 0;
+    }
+    return bytes;
+  }
+}
+
+template<>
+struct std::hash<Attributes> {
+  auto operator()(const Attributes &attributes) const -> usize {
+    usize hash = 0;
+    for (const auto &[key, value]: attributes.entries) {
+      hash = (hash * 31 + std::hash<String>{}(key)) * 31 + std::hash<String>{}(value);
+    }
+    return hash;
+  }
+};
+
+TEST_CASE("Interned Rc, deduplication heavy model", "[rc][!benchmark]") {
+  // 1M objects, all copies of 5'000 distinct attribute sets
+  constexpr usize OBJECTS = 1'000'000;
+  constexpr usize DISTINCT = 5'000;
+
+  std::mt19937_64 rng{124};
+  Vec<Attributes> distinct(DISTINCT);
+  for (usize i = 0; i < DISTINCT; i++) {
+    for (usize j = 0; j < 4; j++) {
+      distinct[i].entries.emplace_back(
+        "attribute-name-" + std::to_string(j),
+        "attribute-value-" + std::to_string(i % (j + 2)) + "-" + std::to_string(i)
+      );
+    }
+  }
+  Vec<u32> picks(OBJECTS);
+  for (u32 &pick: picks) pick = static_cast<u32>(rng() % DISTINCT);
+
+  Vec<Rc<Attributes>> plain;
+  plain.reserve(OBJECTS);
+  usize plain_bytes = 0;
+  for (const u32 pick: picks) {
+    plain.push_back(crab::make_rc<Attributes>(distinct[pick]));
+    plain_bytes += footprint(distinct[pick]);
+  }
+
+  crab::rc::InternTable<Attributes> table;
+  Vec<Rc<Attributes>> interned;
+  interned.reserve(OBJECTS);
+  for (const u32 pick: picks) interned.push_back(table.intern(distinct[pick]));
+  usize interned_bytes = table.memory();
+  for (const Attributes &attributes: distinct) interned_bytes += footprint(attributes);
+
+  std::cout << OBJECTS << " objects, " << DISTINCT << " distinct: make_rc " << plain_bytes
+    << " bytes, make_rc_interned " << interned_bytes << " bytes (" << table.size() << " entries)\n";
+
+  BENCHMARK("make_rc") {
+    Vec<Rc<Attributes>> built;
+    built.reserve(OBJECTS);
+    for (const u32 pick: picks) built.push_back(crab::make_rc<Attributes>(distinct[pick]));
+    return built.size();
+  };
+
+  BENCHMARK("InternTable::intern") {
+    crab::rc::InternTable<Attributes> fresh;
+    Vec<Rc<Attributes>> built;
+    built.reserve(OBJECTS);
+    for (const u32 pick: picks) built.push_back(fresh.intern(distinct[pick]));
+    return built.size();
+  };
+
+  // neighbours compared, most of them are distinct values, as an equality check on real data would find
+  BENCHMARK("== on values") {
+    usize equal = 0;
+    for (usize i = 1; i < OBJECTS; i++) equal += *plain[i - 1] == *plain[i];
+    return equal;
+  };
+
+  BENCHMARK("Rc::ptr_eq on interned") {
+    usize equal = 0;
+    for (usize i = 1; i < OBJECTS; i++) equal += interned[i - 1].ptr_eq(interned[i]);
+    return equal;
+  };
+}
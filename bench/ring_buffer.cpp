@@ -0,0 +1,116 @@
+#include <deque.hpp>
+#include <ring_buffer.hpp>
+
+#include <deque>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize WINDOW = 1024;
+
+  auto samples(const usize count) -> Vec<f32> {
+    std::mt19937 rng{11};
+    std::uniform_real_distribution<f32> dist{0.f, 1.f};
+    Vec<f32> values(count);
+    for (f32 &value: values) value = dist(rng);
+    return values;
+  }
+
+  /**
+   * @brief Sum of the window, split into its contiguous pieces so each loop vectorises
+   */
+  auto window_sum(const std::pair<Span<const f32>, Span<const f32>> pieces) -> f32 {
+    f32 sum = 0.f;
+    for (const f32 value: pieces.first) sum += value;
+    for (const f32 value: pieces.second) sum += value;
+    return sum;
+  }
+}
+
+TEST_CASE("RingBuffer & Deque vs std::deque sliding window", "[ring_buffer][deque][!benchmark]") {
+  const Vec<f32> stream = samples(1 << 16);
+
+  BENCHMARK("RingBuffer push_overwrite") {
+    crab::RingBuffer<f32, WINDOW> window;
+    f32 total = 0.f;
+    for (const f32 value: stream) {
+      if (auto evicted = window.push_overwrite(value)) total -= evicted.take_unchecked();
+      total += value;
+    }
+    return total;
+  };
+
+  BENCHMARK("Deque push_back & pop_front") {
+    crab::Deque<f32> window;
+    f32 total = 0.f;
+    for (const f32 value: stream) {
+      window.push_back(value);
+      total += value;
+      if (window.length() > WINDOW) total -= window.pop_front().take_unchecked();
+    }
+    return total;
+  };
+
+  BENCHMARK("std::deque push_back & pop_front") {
+    std::deque<f32> window;
+    f32 total = 0.f;
+    for (const f32 value: stream) {
+      window.push_back(value);
+      total += value;
+      if (window.size() > WINDOW) {
+        total -= window.front();
+        window.pop_front();
+      }
+    }
+    return total;
+  };
+
+  // full rescans of the window every 64 samples, dominated by iteration locality
+  crab::RingBuffer<f32, WINDOW> ring;
+  crab::Deque<f32> deque;
+  std::deque<f32> std_deque;
+
+  BENCHMARK("RingBuffer window rescan (spans)") {
+    f32 total = 0.f;
+    for (usize i = 0; i < stream.size(); i++) {
+      (void) ring.push_overwrite(stream[i]);
+      if (i % 64 == 0) total += window_sum(ring.as_spans());
+    }
+    return total;
+  };
+
+  BENCHMARK("Deque window rescan (spans)") {
+    f32 total = 0.f;
+    for (usize i = 0; i < stream.size(); i++) {
+      deque.push_back(stream[i]);
+      if (deque.length() > WINDOW) (void) deque.pop_front();
+      if (i % 64 == 0) total += window_sum(deque.as_spans());
+    }
+    return total;
+  };
+
+  BENCHMARK("Deque window rescan (iterator)") {
+    f32 total = 0.f;
+    for (usize i = 0; i < stream.size(); i++) {
+      deque.push_back(stream[i]);
+      if (deque.length() > WINDOW) (void) deque.pop_front();
+      if (i % 64 == 0) {
+        for (const f32 value: deque) total += value;
+      }
+    }
+    return total;
+  };
+
+  BENCHMARK("std::deque window rescan") {
+    f32 total = 0.f;
+    for (usize i = 0; i < stream.size(); i++) {
+      std_deque.push_back(stream[i]);
+      if (std_deque.size() > WINDOW) std_deque.pop_front();
+      if (i % 64 == 0) {
+        for (const f32 value: std_deque) total += value;
+      }
+    }
+    return total;
+  };
+}
@@ -0,0 +1,109 @@
+#include <roaring.hpp>
+
+#include <iostream>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  struct Workload {
+    const char *name;
+    // ids are drawn from [0, universe)
+    u64 universe;
+    usize count;
+  };
+
+  auto random_ids(const Workload &workload, const u64 seed) -> Vec<u32> {
+    std::mt19937_64 rng{seed};
+    Vec<u32> ids(workload.count);
+    for (u32 &id: ids) id = static_cast<u32>(rng() % workload.universe);
+    std::ranges::sort(ids);
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+  }
+
+  /**
+   * @brief Rough footprint of a libstdc++ unordered_set: one bucket pointer per bucket & one heap node (next pointer
+   * + value, rounded up by malloc to 32 bytes) per element
+   */
+  auto hash_set_bytes(const Set<u32> &set) -> usize {
+    return sizeof(set) + set.bucket_count() * sizeof(void*) + set.size() * 32;
+  }
+}
+
+TEST_CASE("RoaringBitmap vs Set<u32>", "[roaring][!benchmark]") {
+  for (const Workload workload: {
+         Workload{"sparse", u64{1} << 32, 1'000'000},
+         Workload{"medium", u64{1} << 26, 1'000'000},
+         Workload{"dense", u64{1} << 21, 1'000'000},
+       }) {
+    const Vec<u32> ids_a = random_ids(workload, 1);
+    const Vec<u32> ids_b = random_ids(workload, 2);
+
+    crab::RoaringBitmap a = crab::RoaringBitmap::from_sorted(ids_a);
+    crab::RoaringBitmap b = crab::RoaringBitmap::from_sorted(ids_b);
+    a.optimize();
+    b.optimize();
+
+    const Set<u32> set_a{ids_a.begin(), ids_a.end()};
+    const Set<u32> set_b{ids_b.begin(), ids_b.end()};
+
+    std::cout << workload.name << ": " << ids_a.size() << " ids, RoaringBitmap " << a.memory_usage()
+      << " bytes, Set<u32> ~" << hash_set_bytes(set_a) << " bytes\n";
+
+    const String name = String{" "} + workload.name;
+
+    BENCHMARK("RoaringBitmap &" + name) { return (a & b).cardinality(); };
+
+    BENCHMARK("Set<u32> intersection" + name) {
+      Set<u32> out;
+      for (const u32 id: set_a) {
+        if (set_b.contains(id)) out.insert(id);
+      }
+      return out.size();
+    };
+
+    BENCHMARK("RoaringBitmap |" + name) { return (a | b).cardinality(); };
+
+    BENCHMARK("Set<u32> union" + name) {
+      Set<u32> out = set_a;
+      out.insert(set_b.begin(), set_b.end());
+      return out.size();
+    };
+
+    BENCHMARK("RoaringBitmap contains" + name) {
+      usize hits = 0;
+      for (usize i = 0; i < ids_b.size(); i += 16) hits += a.contains(ids_b[i]);
+      return hits;
+    };
+
+    BENCHMARK("Set<u32> contains" + name) {
+      usize hits = 0;
+      for (usize i = 0; i < ids_b.size(); i += 16) hits += set_a.contains(ids_b[i]);
+      return hits;
+    };
+
+    BENCHMARK("RoaringBitmap for_each" + name) {
+      u64 sum = 0;
+      a.for_each([&sum](const u32 id) { sum += id; });
+      return sum;
+    };
+
+    BENCHMARK("RoaringBitmap iterate" + name) {
+      u64 sum = 0;
+      for (const u32 id: a) sum += id;
+      return sum;
+    };
+
+    BENCHMARK("Set<u32> iterate" + name) {
+      u64 sum = 0;
+      for (const u32 id: set_a) sum += id;
+      return sum;
+    };
+
+    const Vec<u8> bytes = a.serialize();
+    BENCHMARK("RoaringView::from_bytes" + name) {
+      return crab::RoaringView::from_bytes(bytes).take_unchecked().container_count();
+    };
+  }
+}
@@ -0,0 +1,83 @@
+#include <skip_list.hpp>
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr u64 OPS_PER_THREAD = 50'000;
+
+  /**
+   * @brief Every thread does 90% inserts of increasing (time ordered) keys & 10% scans of the 64 newest entries
+   */
+  template<typename Insert, typename Scan>
+  auto run_mixed(const usize threads, Insert insert, Scan scan) -> u64 {
+    std::atomic<u64> clock{0};
+    std::atomic<u64> checksum{0};
+
+    Vec<std::thread> workers;
+    for (usize t = 0; t < threads; t++) {
+      workers.emplace_back([&, t] {
+        std::mt19937 rng{static_cast<u32>(t)};
+        u64 sum = 0;
+        for (u64 i = 0; i < OPS_PER_THREAD; i++) {
+          const u64 now = clock.fetch_add(1, std::memory_order_relaxed);
+          if (rng() % 10 == 0) {
+            sum += scan(now > 64 ? now - 64 : 0, now);
+          } else {
+            insert(now);
+          }
+        }
+        checksum.fetch_add(sum, std::memory_order_relaxed);
+      });
+    }
+    for (std::thread &worker: workers) worker.join();
+
+    return checksum.load();
+  }
+}
+
+TEST_CASE("ConcurrentSkipList vs locked std::map", "[skip_list][!benchmark]") {
+  for (const usize threads: {1ul, 2ul, 4ul, 8ul}) {
+    const String name = " threads=" + std::to_string(threads);
+
+    BENCHMARK_ADVANCED("ConcurrentSkipList mixed insert/scan" + name)(Catch::Benchmark::Chronometer meter) {
+      meter.measure([threads] {
+        crab::ConcurrentSkipList<u64, u64> list;
+        return run_mixed(
+          threads,
+          [&](const u64 key) { list.insert(key, key); },
+          [&](const u64 min, const u64 max) {
+            u64 sum = 0;
+            for (const auto [key, value]: list.range(min, max)) sum += *value;
+            return sum;
+          }
+        );
+      });
+    };
+
+    BENCHMARK_ADVANCED("std::map + shared_mutex mixed insert/scan" + name)(Catch::Benchmark::Chronometer meter) {
+      meter.measure([threads] {
+        std::map<u64, u64> map;
+        std::shared_mutex lock;
+        return run_mixed(
+          threads,
+          [&](const u64 key) {
+            const std::unique_lock guard{lock};
+            map.emplace(key, key);
+          },
+          [&](const u64 min, const u64 max) {
+            const std::shared_lock guard{lock};
+            u64 sum = 0;
+            for (auto it = map.lower_bound(min); it != map.end() and it->first < max; ++it) sum += it->second;
+            return sum;
+          }
+        );
+      });
+    };
+  }
+}
@@ -0,0 +1,45 @@
+#include <static_search_index.hpp>
+
+#include <algorithm>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize QUERIES = 1 << 16;
+}
+
+TEST_CASE("StaticSearchIndex vs std::lower_bound", "[static_search_index][!benchmark]") {
+  // 4 KiB (L1) up to 256 MiB (DRAM) of u32 keys
+  for (const usize size: {1uz << 10, 1uz << 15, 1uz << 18, 1uz << 22, 1uz << 26}) {
+    std::mt19937_64 rng{size};
+    Vec<u32> sorted(size);
+    for (u32 &value: sorted) value = static_cast<u32>(rng());
+    std::sort(sorted.begin(), sorted.end());
+
+    Vec<u32> keys(QUERIES);
+    for (u32 &key: keys) key = static_cast<u32>(rng());
+
+    const crab::StaticSearchIndex<u32> index{sorted};
+    Vec<usize> out(QUERIES);
+
+    const String name = " n=" + std::to_string(size);
+
+    BENCHMARK("std::lower_bound" + name) {
+      usize sum = 0;
+      for (const u32 key: keys) sum += static_cast<usize>(std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin());
+      return sum;
+    };
+
+    BENCHMARK("StaticSearchIndex lower_bound" + name) {
+      usize sum = 0;
+      for (const u32 key: keys) sum += index.lower_bound(key);
+      return sum;
+    };
+
+    BENCHMARK("StaticSearchIndex lower_bound_batch" + name) {
+      index.lower_bound_batch(keys, out);
+      return out[QUERIES / 2];
+    };
+  }
+}
@@ -0,0 +1,95 @@
+#include <strings.hpp>
+
+#include <random>
+#include <sstream>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  /**
+   * @brief About 1 MiB of CSV like rows, 'width' bytes per field on average
+   */
+  auto make_rows(const u64 seed, const usize width) -> String {
+    std::mt19937_64 rng{seed};
+    String text;
+    while (text.size() < (1 << 20)) {
+      for (usize field = 0; field < 8; field++) {
+        text.append(1 + rng() % (2 * width), static_cast<char>('a' + rng() % 26));
+        text.push_back(field == 7 ? '\n' : ',');
+      }
+    }
+    return text;
+  }
+}
+
+TEST_CASE("crab::split vs std::getline", "[strings][!benchmark]") {
+  for (const usize width: {8u, 64u}) {
+    const String text = make_rows(width, width);
+    const String suffix = " (1 MiB, ~" + std::to_string(width) + " byte fields)";
+
+    BENCHMARK("crab::lines + crab::split" + suffix) {
+      usize total = 0;
+      for (const StringView line: crab::lines(text)) {
+        for (const StringView field: crab::split(line, ',')) total += field.size();
+      }
+      return total;
+    };
+
+    BENCHMARK("std::getline + std::getline" + suffix) {
+      usize total = 0;
+      std::istringstream rows{text};
+      for (String line; std::getline(rows, line);) {
+        std::istringstream fields{line};
+        for (String field; std::getline(fields, field, ',');) total += field.size();
+      }
+      return total;
+    };
+
+    BENCHMARK("std::string_view::find loop" + suffix) {
+      usize total = 0;
+      const StringView view = text;
+      for (usize start = 0, at; start < view.size(); start = at + 1) {
+        at = view.find_first_of(",\n", start);
+        if (at == StringView::npos) at = view.size();
+        total += at - start;
+      }
+      return total;
+    };
+
+    BENCHMARK("crab::split_any" + suffix) {
+      usize total = 0;
+      for (const StringView field: crab::split_any(text, ",\n")) total += field.size();
+      return total;
+    };
+
+    BENCHMARK("crab::split_whitespace" + suffix) {
+      usize total = 0;
+      for (const StringView line: crab::split_whitespace(text)) total += line.size();
+      return total;
+    };
+  }
+}
+
+TEST_CASE("crab::find vs std::string::find", "[strings][!benchmark]") {
+  std::mt19937_64 rng{3};
+  String text(1 << 20, '\0');
+  for (char &c: text) c = static_cast<char>('a' + rng() % 26);
+  const String needle = "needle in the haystack";
+  text.replace(text.size() - needle.size(), needle.size(), needle);
+
+  BENCHMARK("crab::find substring (1 MiB)") {
+    return crab::find(text, needle).take_unchecked();
+  };
+
+  BENCHMARK("std::string::find substring (1 MiB)") {
+    return text.find(needle);
+  };
+
+  BENCHMARK("crab::find byte (1 MiB)") {
+    return crab::find(text, '!').is_some();
+  };
+
+  BENCHMARK("std::string::find byte (1 MiB)") {
+    return text.find('!');
+  };
+}
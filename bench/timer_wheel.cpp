@@ -0,0 +1,63 @@
+#include <timer_wheel.hpp>
+
+#include <map>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Request timeouts, most cancelled before they expire", "[timer_wheel][!benchmark]") {
+  // 10M timeouts of up to 30s started over 100s of 1ms ticks, 9 in 10 cancelled early (the request completed)
+  constexpr usize TICKS = 100'000;
+  constexpr usize PER_TICK = 100;
+  constexpr usize TIMERS = TICKS * PER_TICK;
+
+  std::mt19937_64 rng{123};
+  Vec<u32> timeouts(TIMERS);
+  Vec<Vec<u32>> cancel_at(TICKS);
+  for (u32 id = 0; id < TIMERS; id++) {
+    timeouts[id] = static_cast<u32>(1 + rng() % 30'000);
+    if (rng() % 10 != 0) {
+      if (const usize tick = id / PER_TICK + rng() % timeouts[id]; tick < TICKS) cancel_at[tick].push_back(id);
+    }
+  }
+  // the timers cancelled at tick t are cancelled[cancel_offsets[t]] to cancelled[cancel_offsets[t + 1] - 1]
+  Vec<u32> cancel_offsets{0};
+  Vec<u32> cancelled;
+  for (const Vec<u32> &ids: cancel_at) {
+    cancelled.insert(cancelled.end(), ids.begin(), ids.end());
+    cancel_offsets.push_back(static_cast<u32>(cancelled.size()));
+  }
+  cancel_at = {};
+
+  BENCHMARK("std::multimap") {
+    std::multimap<u64, u32> timers;
+    Vec<std::multimap<u64, u32>::iterator> handles(TIMERS);
+    usize fired = 0;
+    for (usize tick = 0; tick < TICKS; tick++) {
+      for (usize id = tick * PER_TICK; id < (tick + 1) * PER_TICK; id++) {
+        handles[id] = timers.emplace(tick + timeouts[id], static_cast<u32>(id));
+      }
+      for (u32 i = cancel_offsets[tick]; i < cancel_offsets[tick + 1]; i++) timers.erase(handles[cancelled[i]]);
+      while (not timers.empty() and timers.begin()->first <= tick) {
+        fired += timers.begin()->second & 1;
+        timers.erase(timers.begin());
+      }
+    }
+    return fired;
+  };
+
+  BENCHMARK("TimerWheel") {
+    crab::TimerWheel<u32> timers;
+    Vec<crab::TimerWheel<u32>::Handle> handles;
+    handles.reserve(TIMERS);
+    usize fired = 0;
+    for (usize tick = 0; tick < TICKS; tick++) {
+      for (usize id = tick * PER_TICK; id < (tick + 1) * PER_TICK; id++) {
+        handles.push_back(timers.schedule(tick + timeouts[id], static_cast<u32>(id)));
+      }
+      for (u32 i = cancel_offsets[tick]; i < cancel_offsets[tick + 1]; i++) timers.cancel(handles[cancelled[i]]);
+      timers.advance(tick, [&](const u32 id) { fired += id & 1; });
+    }
+    return fired;
+  };
+}
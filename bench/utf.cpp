@@ -0,0 +1,97 @@
+#include <utf.hpp>
+
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  constexpr usize SIZE = 1 << 20;
+
+  /**
+   * @brief About 1 MiB of text, 'ascii_percent' of the code points ASCII & the rest 2 to 4 bytes
+   */
+  auto make_text(const u64 seed, const u32 ascii_percent) -> String {
+    std::mt19937_64 rng{seed};
+    String text;
+    while (text.size() < SIZE) {
+      u32 point = 0x20 + rng() % 0x5f;
+      if (rng() % 100 >= ascii_percent) {
+        switch (rng() % 3) {
+          case 0: point = 0x80 + rng() % (0x800 - 0x80);
+            break;
+          case 1: point = 0xe000 + rng() % (0x10000 - 0xe000);
+            break;
+          default: point = 0x10000 + rng() % (0x110000 - 0x10000);
+        }
+      }
+      char buffer[4];
+      char *cursor = buffer;
+      crab::utf::helper::encode(point, cursor);
+      text.append(buffer, cursor);
+    }
+    return text;
+  }
+
+  /**
+   * @brief Code point at a time transcoding, what the SIMD paths are measured against
+   */
+  auto scalar_to_utf32(const String &text, Vec<char32> &out) -> usize {
+    const auto *data = reinterpret_cast<const u8*>(text.data());
+    usize written = 0;
+    for (usize i = 0; i < text.size();) out[written++] = crab::utf::helper::decode(data, text.size(), i);
+    return written;
+  }
+}
+
+TEST_CASE("utf::validate vs scalar", "[utf][!benchmark]") {
+  for (const u32 ascii_percent: {100u, 90u, 0u}) {
+    const String text = make_text(ascii_percent, ascii_percent);
+    const auto *data = reinterpret_cast<const u8*>(text.data());
+    const String suffix = " (1 MiB, " + std::to_string(ascii_percent) + "% ascii)";
+
+    BENCHMARK("crab::utf::validate" + suffix) {
+      return crab::utf::is_valid(text);
+    };
+
+    BENCHMARK("scalar validation" + suffix) {
+      return crab::utf::helper::scalar_valid_up_to(data, text.size());
+    };
+  }
+}
+
+TEST_CASE("utf transcoding vs scalar", "[utf][!benchmark]") {
+  for (const u32 ascii_percent: {100u, 90u, 0u}) {
+    const String text = make_text(ascii_percent, ascii_percent);
+    const String suffix = " (1 MiB, " + std::to_string(ascii_percent) + "% ascii)";
+
+    Vec<char32> utf32(crab::utf::utf32_length(text));
+    Vec<char16> utf16(crab::utf::utf16_length(text));
+    String back(text.size(), '\0');
+
+    BENCHMARK("crab::utf::utf8_to_utf32" + suffix) {
+      return crab::utf::utf8_to_utf32(text, utf32).take_unchecked();
+    };
+
+    BENCHMARK("scalar utf8 -> utf32" + suffix) {
+      return scalar_to_utf32(text, utf32);
+    };
+
+    BENCHMARK("crab::utf::utf8_to_utf16" + suffix) {
+      return crab::utf::utf8_to_utf16(text, utf16).take_unchecked();
+    };
+
+    BENCHMARK("crab::utf::utf16_to_utf8" + suffix) {
+      return crab::utf::utf16_to_utf8(utf16, back).take_unchecked();
+    };
+
+    BENCHMARK("scalar utf32 -> utf8" + suffix) {
+      char *cursor = back.data();
+      for (const char32 point: utf32) crab::utf::helper::encode(point, cursor);
+      return cursor - back.data();
+    };
+
+    BENCHMARK("crab::utf::utf32_to_utf8" + suffix) {
+      return crab::utf::utf32_to_utf8(utf32, back).take_unchecked();
+    };
+  }
+}
@@ -0,0 +1,389 @@
+#pragma once
+
+#include <bit>
+#include <iterator>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/simd.hpp"
+#include "option.hpp"
+#include "ref.hpp"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace crab {
+  class RankSelect;
+
+  /**
+   * @brief Growable, densely packed vector of bits.
+   *
+   * Replacement for Vec<bool> (std::vector<bool>) that works on whole 64 bit words: bulk set operations
+   * are vectorised, counting uses SIMD popcount & set bits can be iterated with a find-next-set scan
+   * rather than testing every index.
+   *
+   * Bits past length() in the last word are always kept zero.
+   */
+  class BitVec {
+    static constexpr usize WORD_BITS = 64;
+
+    Vec<u64> data;
+    usize len = 0;
+
+    [[nodiscard]] __always_inline static constexpr auto words_for(const usize bits) -> usize {
+      return (bits + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    __always_inline auto clear_tail() -> void {
+      if (len % WORD_BITS != 0) {
+        data.back() &= (u64{1} << (len % WORD_BITS)) - 1;
+      }
+    }
+
+  public:
+    /**
+     * @brief Iterates the indices of every set bit in ascending order
+     */
+    class Ones {
+      const u64 *words;
+      usize word_count;
+
+    public:
+      class Iterator {
+        const u64 *words = nullptr;
+        usize word_count = 0;
+        usize word_index = 0;
+        u64 current = 0;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = usize;
+        using reference = usize;
+
+        Iterator() = default;
+
+        __always_inline Iterator(const u64 *words, const usize word_count, const usize word_index)
+          : words{words}, word_count{word_count}, word_index{word_index},
+            current{word_index < word_count ? words[word_index] : 0} {
+          skip_empty();
+        }
+
+        [[nodiscard]] __always_inline auto operator*() const -> reference {
+          return word_index * WORD_BITS + static_cast<usize>(std::countr_zero(current));
+        }
+
+        __always_inline auto operator++() -> Iterator& {
+          current &= current - 1;
+          skip_empty();
+          return *this;
+        }
+
+        __always_inline auto operator++(int) -> Iterator {
+          Iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        [[nodiscard]] __always_inline friend auto operator==(const Iterator &a, const Iterator &b) -> bool {
+          return a.word_index == b.word_index and a.current == b.current;
+        }
+
+      private:
+        __always_inline auto skip_empty() -> void {
+          while (current == 0 and word_index < word_count) {
+            if (++word_index < word_count) current = words[word_index];
+          }
+        }
+      };
+
+      Ones(const u64 *words, const usize word_count) : words{words}, word_count{word_count} {}
+
+      [[nodiscard]] auto begin() const -> Iterator { return Iterator{words, word_count, 0}; }
+
+      [[nodiscard]] auto end() const -> Iterator { return Iterator{words, word_count, word_count}; }
+    };
+
+    BitVec() = default;
+
+    /**
+     * @brief Creates a vector of 'length' bits all set to 'value'
+     */
+    explicit BitVec(const usize length, const bool value = false)
+      : data(words_for(length), value ? ~u64{0} : u64{0}), len{length} {
+      clear_tail();
+    }
+
+    /**
+     * @brief Takes ownership of raw words, bit i lives in words[i / 64] at bit (i % 64)
+     */
+    [[nodiscard]] static auto from_words(Vec<u64> words, const usize length) -> BitVec {
+      debug_assert(words.size() == words_for(length), "Word count does not match the bit length");
+      BitVec bits;
+      bits.data = std::move(words);
+      bits.len = length;
+      bits.clear_tail();
+      return bits;
+    }
+
+    /**
+     * @brief Amount of bits
+     */
+    [[nodiscard]] __always_inline auto length() const -> usize { return len; }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return len == 0; }
+
+    [[nodiscard]] __always_inline auto get(const usize index) const -> bool {
+      debug_assert(index < len, "Index out of Bounds");
+      return (data[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+    }
+
+    __always_inline auto set(const usize index, const bool value = true) -> void {
+      debug_assert(index < len, "Index out of Bounds");
+      const u64 mask = u64{1} << (index % WORD_BITS);
+      u64 &word = data[index / WORD_BITS];
+      word = value ? word | mask : word & ~mask;
+    }
+
+    __always_inline auto reset(const usize index) -> void { set(index, false); }
+
+    __always_inline auto push(const bool value) -> void {
+      if (len % WORD_BITS == 0) data.push_back(0);
+      len++;
+      set(len - 1, value);
+    }
+
+    auto resize(const usize length, const bool value = false) -> void {
+      const usize old = len;
+      if (value and old % WORD_BITS != 0 and length > old) {
+        data.back() |= ~u64{0} << (old % WORD_BITS);
+      }
+      data.resize(words_for(length), value ? ~u64{0} : u64{0});
+      len = length;
+      clear_tail();
+    }
+
+    auto fill(const bool value) -> void {
+      std::fill(data.begin(), data.end(), value ? ~u64{0} : u64{0});
+      clear_tail();
+    }
+
+    /**
+     * @brief Flips every bit
+     */
+    auto invert() -> void {
+      for (u64 &word: data) word = ~word;
+      clear_tail();
+    }
+
+    /**
+     * @brief Amount of set bits
+     */
+    [[nodiscard]] auto count_ones() const -> usize { return simd::popcount(data.data(), data.size()); }
+
+    [[nodiscard]] auto count_zeros() const -> usize { return len - count_ones(); }
+
+    /**
+     * @brief Index of the first set bit at or after 'from'
+     */
+    [[nodiscard]] auto find_next_set(const usize from) const -> Option<usize> {
+      if (from >= len) return crab::none;
+
+      usize word_index = from / WORD_BITS;
+      u64 word = data[word_index] & (~u64{0} << (from % WORD_BITS));
+      while (word == 0) {
+        if (++word_index == data.size()) return crab::none;
+        word = data[word_index];
+      }
+      return crab::some(word_index * WORD_BITS + static_cast<usize>(std::countr_zero(word)));
+    }
+
+    [[nodiscard]] auto first_set() const -> Option<usize> { return find_next_set(0); }
+
+    /**
+     * @brief Indices of every set bit in ascending order
+     */
+    [[nodiscard]] auto ones() const -> Ones { return Ones{data.data(), data.size()}; }
+
+    /**
+     * @brief Underlying words, bit i lives in words()[i / 64] at bit (i % 64)
+     */
+    [[nodiscard]] auto words() const -> Span<const u64> { return data; }
+
+    /**
+     * @brief Underlying words, bits past length() in the last word must be left zero
+     */
+    [[nodiscard]] auto words_mut() -> Span<u64> { return data; }
+
+    auto operator&=(const BitVec &other) -> BitVec& {
+      debug_assert(len == other.len, "Bitwise operations require BitVecs of the same length");
+      simd::zip_words(data.data(), other.data.data(), data.size(), [](auto a, auto b) { return a & b; });
+      return *this;
+    }
+
+    auto operator|=(const BitVec &other) -> BitVec& {
+      debug_assert(len == other.len, "Bitwise operations require BitVecs of the same length");
+      simd::zip_words(data.data(), other.data.data(), data.size(), [](auto a, auto b) { return a | b; });
+      return *this;
+    }
+
+    auto operator^=(const BitVec &other) -> BitVec& {
+      debug_assert(len == other.len, "Bitwise operations require BitVecs of the same length");
+      simd::zip_words(data.data(), other.data.data(), data.size(), [](auto a, auto b) { return a ^ b; });
+      return *this;
+    }
+
+    /**
+     * @brief Clears every bit that is set in 'other' (set difference)
+     */
+    auto and_not(const BitVec &other) -> BitVec& {
+      debug_assert(len == other.len, "Bitwise operations require BitVecs of the same length");
+      simd::zip_words(data.data(), other.data.data(), data.size(), [](auto a, auto b) { return a & ~b; });
+      return *this;
+    }
+
+    [[nodiscard]] friend auto operator&(BitVec lhs, const BitVec &rhs) -> BitVec { return std::move(lhs &= rhs); }
+
+    [[nodiscard]] friend auto operator|(BitVec lhs, const BitVec &rhs) -> BitVec { return std::move(lhs |= rhs); }
+
+    [[nodiscard]] friend auto operator^(BitVec lhs, const BitVec &rhs) -> BitVec { return std::move(lhs ^= rhs); }
+
+    [[nodiscard]] friend auto operator==(const BitVec &a, const BitVec &b) -> bool {
+      return a.len == b.len and a.data == b.data;
+    }
+
+    /**
+     * @brief Builds a rank / select index over the current contents, see RankSelect
+     */
+    [[nodiscard]] auto rank_select() const -> RankSelect;
+  };
+
+  /**
+   * @brief Succinct rank / select index over a BitVec (rank9 layout, ~25% space overhead).
+   *
+   * Every 512 bit block stores its absolute rank plus seven 9-bit ranks of its words relative to the block,
+   * so rank() is two lookups & a popcount. select() narrows down the block with sampled positions of every
+   * 4096th set bit before a short binary search.
+   *
+   * The index borrows the BitVec & is invalidated by any modification of it.
+   */
+  class RankSelect {
+    static constexpr usize WORD_BITS = 64;
+    static constexpr usize BLOCK_WORDS = 8;
+    static constexpr usize SELECT_SAMPLE = 4096;
+
+    Ref<BitVec> bits;
+    // 2 entries per block, absolute rank & packed relative ranks
+    Vec<u64> counts;
+    // block holding every SELECT_SAMPLE'th set bit
+    Vec<usize> samples;
+    usize ones = 0;
+
+    [[nodiscard]] __always_inline auto block_count() const -> usize { return counts.size() / 2; }
+
+    [[nodiscard]] __always_inline auto relative(const usize block, const usize word) const -> usize {
+      if (word == 0) return 0;
+      return static_cast<usize>((counts[block * 2 + 1] >> (9 * (word - 1))) & 0x1ff);
+    }
+
+    [[nodiscard]] __always_inline static auto select_in_word(u64 word, usize nth) -> usize {
+      #if defined(__BMI2__)
+      return static_cast<usize>(std::countr_zero(_pdep_u64(u64{1} << nth, word)));
+      #else
+      for (; nth != 0; nth--) word &= word - 1;
+      return static_cast<usize>(std::countr_zero(word));
+      #endif
+    }
+
+  public:
+    explicit RankSelect(const BitVec &bits) : bits{bits} {
+      const Span<const u64> words = bits.words();
+      const usize blocks = (words.size() + BLOCK_WORDS - 1) / BLOCK_WORDS;
+      counts.reserve(blocks * 2);
+
+      for (usize block = 0; block < blocks; block++) {
+        counts.push_back(ones);
+
+        u64 packed = 0;
+        usize local = 0;
+        for (usize word = 0; word < BLOCK_WORDS; word++) {
+          const usize index = block * BLOCK_WORDS + word;
+          if (word != 0) packed |= static_cast<u64>(local) << (9 * (word - 1));
+
+          if (index >= words.size()) continue;
+          const usize popcount = static_cast<usize>(std::popcount(words[index]));
+
+          // record the block whenever this word crosses a multiple of SELECT_SAMPLE
+          const usize before = ones + local;
+          for (usize next = (before + SELECT_SAMPLE - 1) / SELECT_SAMPLE * SELECT_SAMPLE;
+               next < before + popcount;
+               next += SELECT_SAMPLE) {
+            samples.push_back(block);
+          }
+
+          local += popcount;
+        }
+        counts.push_back(packed);
+        ones += local;
+      }
+    }
+
+    /**
+     * @brief Amount of set bits in the whole vector
+     */
+    [[nodiscard]] auto count_ones() const -> usize { return ones; }
+
+    /**
+     * @brief Amount of set bits in [0, index)
+     */
+    [[nodiscard]] auto rank(const usize index) const -> usize {
+      debug_assert(index <= bits->length(), "Index out of Bounds");
+      if (index == bits->length()) return ones;
+
+      const usize word_index = index / WORD_BITS;
+      const usize block = word_index / BLOCK_WORDS;
+      const u64 below = bits->words()[word_index] & ((u64{1} << (index % WORD_BITS)) - 1);
+
+      return static_cast<usize>(counts[block * 2]) + relative(block, word_index % BLOCK_WORDS) +
+             static_cast<usize>(std::popcount(below));
+    }
+
+    /**
+     * @brief Amount of unset bits in [0, index)
+     */
+    [[nodiscard]] auto rank_zero(const usize index) const -> usize { return index - rank(index); }
+
+    /**
+     * @brief Index of the nth (starting at 0) set bit, None if there are not that many set bits
+     */
+    [[nodiscard]] auto select(const usize nth) const -> Option<usize> {
+      if (nth >= ones) return crab::none;
+
+      // last block whose absolute rank is <= nth, bounded by the sampled blocks around it
+      usize low = samples[nth / SELECT_SAMPLE];
+      usize high = nth / SELECT_SAMPLE + 1 < samples.size() ? samples[nth / SELECT_SAMPLE + 1] + 1 : block_count();
+      while (high - low > 1) {
+        const usize mid = low + (high - low) / 2;
+        if (counts[mid * 2] <= nth) {
+          low = mid;
+        } else {
+          high = mid;
+        }
+      }
+
+      const usize block = low;
+      usize remaining = nth - static_cast<usize>(counts[block * 2]);
+
+      usize word = 1;
+      while (word < BLOCK_WORDS and relative(block, word) <= remaining) word++;
+      word--;
+      remaining -= relative(block, word);
+
+      const usize word_index = block * BLOCK_WORDS + word;
+      return crab::some(word_index * WORD_BITS + select_in_word(bits->words()[word_index], remaining));
+    }
+  };
+
+  inline auto BitVec::rank_select() const -> RankSelect { return RankSelect{*this}; }
+}
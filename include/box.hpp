@@ -205,16 +205,12 @@ public:
 
 private:
   __always_inline auto raw_ptr() -> MutPtr {
-    #if DEBUG
-    debug_assert(obj != nullptr, "Invalid Use of Moved Box<T>.");
-    #endif
+    debug_assume(obj != nullptr, "Invalid Use of Moved Box<T>.");
     return obj;
   }
 
   __always_inline auto raw_ptr() const -> ConstPtr {
-    #if DEBUG
-    debug_assert(obj != nullptr, "Invalid Use of Moved Box<T>.");
-    #endif
+    debug_assume(obj != nullptr, "Invalid Use of Moved Box<T>.");
     return obj;
   }
 };
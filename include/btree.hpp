@@ -0,0 +1,877 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/simd.hpp"
+#include "option.hpp"
+#include "range.hpp"
+#include "ref.hpp"
+
+namespace crab::btree {
+  /**
+   * @brief Amount of bytes worth of keys held in a single node, four cache lines worth of keys
+   * keeps the in-node search to a few vector compares while keeping the tree shallow.
+   */
+  inline constexpr usize NODE_KEY_BYTES = 256;
+
+  /**
+   * @brief Maximum amount of keys that a node can hold for a given key type
+   */
+  template<typename K>
+  [[nodiscard]] constexpr auto node_capacity() -> usize {
+    return std::clamp<usize>(NODE_KEY_BYTES / sizeof(K), 8, 64);
+  }
+
+  namespace helper {
+    /**
+     * @brief Uninitialised storage for N instances of T, lifetimes are managed by the owning node
+     */
+    template<typename T, usize N>
+    struct Slots {
+      alignas(T) std::byte storage[sizeof(T) * N];
+
+      [[nodiscard]] __always_inline auto data() -> T* { return std::launder(reinterpret_cast<T*>(storage)); }
+
+      [[nodiscard]] __always_inline auto data() const -> const T* {
+        return std::launder(reinterpret_cast<const T*>(storage));
+      }
+
+      [[nodiscard]] __always_inline auto operator[](const usize i) -> T& { return data()[i]; }
+
+      [[nodiscard]] __always_inline auto operator[](const usize i) const -> const T& { return data()[i]; }
+    };
+
+    /**
+     * @brief Moves the object at 'from' into the uninitialised slot 'to' and ends the lifetime of 'from'
+     */
+    template<typename T>
+    __always_inline auto relocate(T *from, T *to) -> void {
+      std::construct_at(to, std::move(*from));
+      std::destroy_at(from);
+    }
+
+    /**
+     * @brief Relocates 'n' objects into non-overlapping uninitialised storage
+     */
+    template<typename T>
+    __always_inline auto relocate_n(T *from, const usize n, T *to) -> void {
+      if constexpr (std::is_trivially_copyable_v<T>) {
+        if (n != 0) std::memcpy(static_cast<void*>(to), from, n * sizeof(T));
+      } else {
+        for (usize i = 0; i < n; i++) relocate(from + i, to + i);
+      }
+    }
+
+    /**
+     * @brief Opens an uninitialised hole at 'pos' by moving [pos, len) one slot to the right
+     */
+    template<typename T>
+    __always_inline auto shift_right(T *base, const usize pos, const usize len) -> void {
+      if constexpr (std::is_trivially_copyable_v<T>) {
+        if (len != pos) std::memmove(static_cast<void*>(base + pos + 1), base + pos, (len - pos) * sizeof(T));
+      } else {
+        for (usize i = len; i > pos; i--) relocate(base + i - 1, base + i);
+      }
+    }
+
+    /**
+     * @brief Closes the (already destroyed) hole at 'pos' by moving [pos + 1, len) one slot to the left
+     */
+    template<typename T>
+    __always_inline auto shift_left(T *base, const usize pos, const usize len) -> void {
+      if constexpr (std::is_trivially_copyable_v<T>) {
+        if (len != pos + 1) std::memmove(static_cast<void*>(base + pos), base + pos + 1, (len - pos - 1) * sizeof(T));
+      } else {
+        for (usize i = pos + 1; i < len; i++) relocate(base + i, base + i - 1);
+      }
+    }
+
+    struct Node {
+      u16 len;
+      bool leaf;
+
+      explicit Node(const bool leaf) : len{0}, leaf{leaf} {}
+    };
+
+    template<typename K, typename V, usize CAP>
+    struct alignas(64) Leaf final : Node {
+      Slots<K, CAP> keys;
+      Slots<V, CAP> values;
+      Leaf *prev = nullptr;
+      Leaf *next = nullptr;
+
+      Leaf() : Node{true} {}
+    };
+
+    template<typename K, usize CAP>
+    struct alignas(64) Internal final : Node {
+      Slots<K, CAP> keys;
+      Node *children[CAP + 1];
+
+      Internal() : Node{false} {}
+    };
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Ordered key-value collection stored as a B+ tree.
+   *
+   * Unlike std::map (a red-black tree with one allocation per entry), every node holds a cache line
+   * sized run of keys that is searched with SIMD compares, and all entries live in a doubly linked
+   * list of leaves so that ordered iteration & range queries walk contiguous memory.
+   *
+   * Keys must be copyable as separator keys are copied into the interior nodes.
+   */
+  template<typename K, typename V, typename Compare = std::less<K>>
+    requires std::copyable<K> and std::is_move_constructible_v<V>
+  class BTreeMap {
+    static constexpr usize CAP = btree::node_capacity<K>();
+    static constexpr usize MIN = CAP / 2 - 1;
+
+    using Node = btree::helper::Node;
+    using Leaf = btree::helper::Leaf<K, V, CAP>;
+    using Internal = btree::helper::Internal<K, CAP>;
+    using Split = Option<std::pair<K, Node*>>;
+
+    static constexpr bool USE_SIMD = simd::searchable<K> and (std::same_as<Compare, std::less<K>> or
+                                                              std::same_as<Compare, std::less<>>);
+
+  public:
+    /**
+     * @brief Cursor over the entries of a BTreeMap in ascending key order
+     */
+    template<bool IS_CONST>
+    class Iterator {
+      friend class BTreeMap;
+
+      using LeafPtr = std::conditional_t<IS_CONST, const Leaf*, Leaf*>;
+      using ValueRef = std::conditional_t<IS_CONST, const V&, V&>;
+
+      LeafPtr leaf = nullptr;
+      usize index = 0;
+
+      __always_inline Iterator(LeafPtr leaf, const usize index) : leaf{leaf}, index{index} {
+        if (this->leaf != nullptr and this->index == this->leaf->len) {
+          this->leaf = this->leaf->next;
+          this->index = 0;
+        }
+      }
+
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = std::pair<const K&, ValueRef>;
+      using reference = value_type;
+
+      Iterator() = default;
+
+      // ReSharper disable once CppNonExplicitConvertingConstructor
+      template<bool FROM_CONST> requires (IS_CONST and not FROM_CONST)
+      __always_inline Iterator(const Iterator<FROM_CONST> &from) // NOLINT(*-explicit-constructor)
+        : leaf{from.leaf}, index{from.index} {}
+
+      [[nodiscard]] __always_inline auto operator*() const -> reference {
+        return {leaf->keys[index], leaf->values[index]};
+      }
+
+      __always_inline auto operator++() -> Iterator& {
+        if (++index == leaf->len) {
+          leaf = leaf->next;
+          index = 0;
+        }
+        return *this;
+      }
+
+      __always_inline auto operator++(int) -> Iterator {
+        Iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator==(const Iterator &a, const Iterator &b) -> bool {
+        return a.leaf == b.leaf and a.index == b.index;
+      }
+
+      template<bool>
+      friend class Iterator;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+  private:
+    Node *root = nullptr;
+    usize count = 0;
+    [[no_unique_address]] Compare comp{};
+
+  public:
+    BTreeMap() = default;
+
+    explicit BTreeMap(Compare comp) : comp{std::move(comp)} {}
+
+    BTreeMap(std::initializer_list<std::pair<K, V>> entries) requires std::copy_constructible<V> {
+      for (const auto &[key, value]: entries) {
+        insert(key, value);
+      }
+    }
+
+    BTreeMap(const BTreeMap &) = delete;
+
+    BTreeMap(BTreeMap &&from) noexcept
+      : root{std::exchange(from.root, nullptr)}, count{std::exchange(from.count, 0)}, comp{std::move(from.comp)} {}
+
+    auto operator=(const BTreeMap &) -> BTreeMap& = delete;
+
+    auto operator=(BTreeMap &&from) noexcept -> BTreeMap& {
+      if (&from == this) return *this;
+      clear();
+      root = std::exchange(from.root, nullptr);
+      count = std::exchange(from.count, 0);
+      comp = std::move(from.comp);
+      return *this;
+    }
+
+    ~BTreeMap() { clear(); }
+
+    /**
+     * @brief Builds a map from entries that are already sorted by key (with no duplicates) in O(n), without
+     * any of the splitting that repeated insertion would do.
+     */
+    [[nodiscard]] static auto from_sorted(Vec<std::pair<K, V>> entries, Compare comp = Compare{}) -> BTreeMap {
+      BTreeMap map{std::move(comp)};
+      const usize n = entries.size();
+      if (n == 0) return map;
+
+      #if DEBUG
+      for (usize i = 1; i < n; i++) {
+        debug_assert(
+          map.comp(entries[i - 1].first, entries[i].first),
+          "BTreeMap::from_sorted requires strictly ascending keys"
+        );
+      }
+      #endif
+
+      Vec<Node*> level;
+      Vec<K> mins;
+
+      const usize leaves = (n + CAP - 1) / CAP;
+      level.reserve(leaves);
+      mins.reserve(leaves);
+
+      usize offset = 0;
+      Leaf *prev = nullptr;
+      for (usize l = 0; l < leaves; l++) {
+        const usize take = n / leaves + (l < n % leaves ? 1 : 0);
+        Leaf *leaf = new Leaf{};
+        for (usize j = 0; j < take; j++) {
+          std::construct_at(&leaf->keys[j], std::move(entries[offset + j].first));
+          std::construct_at(&leaf->values[j], std::move(entries[offset + j].second));
+        }
+        leaf->len = static_cast<u16>(take);
+        leaf->prev = prev;
+        if (prev) prev->next = leaf;
+        prev = leaf;
+        offset += take;
+
+        level.push_back(leaf);
+        mins.push_back(leaf->keys[0]);
+      }
+
+      while (level.size() > 1) {
+        const usize c = level.size();
+        const usize nodes = (c + CAP) / (CAP + 1);
+
+        Vec<Node*> next_level;
+        Vec<K> next_mins;
+        next_level.reserve(nodes);
+        next_mins.reserve(nodes);
+
+        offset = 0;
+        for (usize m = 0; m < nodes; m++) {
+          const usize take = c / nodes + (m < c % nodes ? 1 : 0);
+          Internal *node = new Internal{};
+          for (usize j = 0; j < take; j++) {
+            node->children[j] = level[offset + j];
+            if (j != 0) std::construct_at(&node->keys[j - 1], std::move(mins[offset + j]));
+          }
+          node->len = static_cast<u16>(take - 1);
+
+          next_level.push_back(node);
+          next_mins.push_back(std::move(mins[offset]));
+          offset += take;
+        }
+
+        level = std::move(next_level);
+        mins = std::move(next_mins);
+      }
+
+      map.root = level.front();
+      map.count = n;
+      return map;
+    }
+
+    /**
+     * @brief Amount of entries in the map
+     */
+    [[nodiscard]] __always_inline auto length() const -> usize { return count; }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return count == 0; }
+
+    /**
+     * @brief Inserts a key-value pair into the map, if the key was already present its value is replaced and the
+     * previous value is returned.
+     */
+    auto insert(K key, V value) -> Option<V> {
+      if (root == nullptr) {
+        root = new Leaf{};
+      }
+
+      Option<V> previous{};
+      Split split = insert_into(root, std::move(key), std::move(value), previous);
+
+      if (split.is_some()) {
+        auto [separator, right] = split.take_unchecked();
+        Internal *new_root = new Internal{};
+        std::construct_at(&new_root->keys[0], std::move(separator));
+        new_root->children[0] = root;
+        new_root->children[1] = right;
+        new_root->len = 1;
+        root = new_root;
+      }
+
+      if (previous.is_none()) {
+        count++;
+      }
+      return previous;
+    }
+
+    /**
+     * @brief Removes a key from the map, returning the value it held if it was present
+     */
+    auto remove(const K &key) -> Option<V> {
+      if (root == nullptr) return crab::none;
+
+      Option<V> removed = remove_from(root, key);
+      if (removed.is_some()) {
+        count--;
+      }
+
+      if (root->leaf and root->len == 0) {
+        delete static_cast<Leaf*>(root);
+        root = nullptr;
+      } else if (not root->leaf and root->len == 0) {
+        Internal *old = static_cast<Internal*>(root);
+        root = old->children[0];
+        delete old;
+      }
+
+      return removed;
+    }
+
+    /**
+     * @brief Gets a reference to the value with the given key, if it exists
+     */
+    [[nodiscard]] auto get(const K &key) const -> Option<Ref<V>> {
+      const auto [leaf, index] = find(key);
+      if (leaf == nullptr) return crab::none;
+      return crab::some(Ref<V>{leaf->values[index]});
+    }
+
+    /**
+     * @brief Gets a mutable reference to the value with the given key, if it exists
+     */
+    [[nodiscard]] auto get_mut(const K &key) -> Option<RefMut<V>> {
+      const auto [leaf, index] = find(key);
+      if (leaf == nullptr) return crab::none;
+      return crab::some(RefMut<V>{const_cast<Leaf*>(leaf)->values[index]});
+    }
+
+    [[nodiscard]] auto contains(const K &key) const -> bool {
+      return find(key).first != nullptr;
+    }
+
+    /**
+     * @brief Smallest key in the map
+     */
+    [[nodiscard]] auto first_key() const -> Option<Ref<K>> {
+      if (is_empty()) return crab::none;
+      return crab::some(Ref<K>{leftmost()->keys[0]});
+    }
+
+    /**
+     * @brief Largest key in the map
+     */
+    [[nodiscard]] auto last_key() const -> Option<Ref<K>> {
+      if (is_empty()) return crab::none;
+      const Leaf *leaf = rightmost();
+      return crab::some(Ref<K>{leaf->keys[leaf->len - 1]});
+    }
+
+    /**
+     * @brief Cursor to the first entry whose key is not less than 'key'
+     */
+    [[nodiscard]] auto lower_bound(const K &key) -> iterator {
+      const auto [leaf, index] = seek(key);
+      return iterator{const_cast<Leaf*>(leaf), index};
+    }
+
+    [[nodiscard]] auto lower_bound(const K &key) const -> const_iterator {
+      const auto [leaf, index] = seek(key);
+      return const_iterator{leaf, index};
+    }
+
+    /**
+     * @brief All entries with keys in [min, max), in ascending order
+     */
+    [[nodiscard]] auto range(const K &min, const K &max) -> std::ranges::subrange<iterator> {
+      if (not comp(min, max)) return {end(), end()};
+      return {lower_bound(min), lower_bound(max)};
+    }
+
+    [[nodiscard]] auto range(const K &min, const K &max) const -> std::ranges::subrange<const_iterator> {
+      if (not comp(min, max)) return {end(), end()};
+      return {lower_bound(min), lower_bound(max)};
+    }
+
+    /**
+     * @brief All entries with keys inside of the given Range, in ascending order
+     */
+    template<std::same_as<K> T>
+    [[nodiscard]] auto range(const Range<T> bounds) -> std::ranges::subrange<iterator> {
+      return range(bounds.lower_bound(), bounds.upper_bound());
+    }
+
+    template<std::same_as<K> T>
+    [[nodiscard]] auto range(const Range<T> bounds) const -> std::ranges::subrange<const_iterator> {
+      return range(bounds.lower_bound(), bounds.upper_bound());
+    }
+
+    [[nodiscard]] auto begin() -> iterator { return iterator{is_empty() ? nullptr : leftmost(), 0}; }
+
+    [[nodiscard]] auto begin() const -> const_iterator {
+      return const_iterator{is_empty() ? nullptr : leftmost(), 0};
+    }
+
+    [[nodiscard]] auto end() -> iterator { return iterator{}; }
+
+    [[nodiscard]] auto end() const -> const_iterator { return const_iterator{}; }
+
+    /**
+     * @brief Removes all entries & frees every node
+     */
+    auto clear() -> void {
+      if (root != nullptr) {
+        free_node(root);
+        root = nullptr;
+      }
+      count = 0;
+    }
+
+  private:
+    [[nodiscard]] __always_inline auto lower_index(const K *keys, const usize len, const K &key) const -> usize {
+      if constexpr (USE_SIMD) {
+        return simd::count_less(keys, len, key);
+      } else {
+        return static_cast<usize>(std::lower_bound(keys, keys + len, key, comp) - keys);
+      }
+    }
+
+    [[nodiscard]] __always_inline auto upper_index(const K *keys, const usize len, const K &key) const -> usize {
+      if constexpr (USE_SIMD) {
+        return simd::count_less_equal(keys, len, key);
+      } else {
+        return static_cast<usize>(std::upper_bound(keys, keys + len, key, comp) - keys);
+      }
+    }
+
+    [[nodiscard]] auto descend(const K &key) const -> Leaf* {
+      Node *node = root;
+      while (not node->leaf) {
+        const Internal *internal = static_cast<const Internal*>(node);
+        node = internal->children[upper_index(internal->keys.data(), internal->len, key)];
+      }
+      return static_cast<Leaf*>(node);
+    }
+
+    [[nodiscard]] auto find(const K &key) const -> std::pair<const Leaf*, usize> {
+      if (root == nullptr) return {nullptr, 0};
+
+      const Leaf *leaf = descend(key);
+      const usize index = lower_index(leaf->keys.data(), leaf->len, key);
+      if (index < leaf->len and not comp(key, leaf->keys[index])) {
+        return {leaf, index};
+      }
+      return {nullptr, 0};
+    }
+
+    [[nodiscard]] auto seek(const K &key) const -> std::pair<const Leaf*, usize> {
+      if (root == nullptr) return {nullptr, 0};
+      const Leaf *leaf = descend(key);
+      return {leaf, lower_index(leaf->keys.data(), leaf->len, key)};
+    }
+
+    [[nodiscard]] auto leftmost() const -> Leaf* {
+      Node *node = root;
+      while (not node->leaf) node = static_cast<Internal*>(node)->children[0];
+      return static_cast<Leaf*>(node);
+    }
+
+    [[nodiscard]] auto rightmost() const -> Leaf* {
+      Node *node = root;
+      while (not node->leaf) node = static_cast<Internal*>(node)->children[node->len];
+      return static_cast<Leaf*>(node);
+    }
+
+    static auto leaf_insert_at(Leaf *leaf, const usize pos, K &&key, V &&value) -> void {
+      btree::helper::shift_right(leaf->keys.data(), pos, leaf->len);
+      btree::helper::shift_right(leaf->values.data(), pos, leaf->len);
+      std::construct_at(&leaf->keys[pos], std::move(key));
+      std::construct_at(&leaf->values[pos], std::move(value));
+      leaf->len++;
+    }
+
+    static auto internal_insert_at(Internal *node, const usize pos, K &&key, Node *child) -> void {
+      btree::helper::shift_right(node->keys.data(), pos, node->len);
+      btree::helper::shift_right(node->children, pos + 1, node->len + 1);
+      std::construct_at(&node->keys[pos], std::move(key));
+      node->children[pos + 1] = child;
+      node->len++;
+    }
+
+    auto insert_into(Node *node, K &&key, V &&value, Option<V> &previous) -> Split {
+      if (node->leaf) {
+        Leaf *leaf = static_cast<Leaf*>(node);
+        const usize pos = lower_index(leaf->keys.data(), leaf->len, key);
+
+        if (pos < leaf->len and not comp(key, leaf->keys[pos])) {
+          previous = std::exchange(leaf->values[pos], std::move(value));
+          return crab::none;
+        }
+
+        if (leaf->len < CAP) {
+          leaf_insert_at(leaf, pos, std::move(key), std::move(value));
+          return crab::none;
+        }
+
+        constexpr usize mid = CAP / 2;
+        Leaf *right = new Leaf{};
+        btree::helper::relocate_n(&leaf->keys[mid], CAP - mid, right->keys.data());
+        btree::helper::relocate_n(&leaf->values[mid], CAP - mid, right->values.data());
+        right->len = static_cast<u16>(CAP - mid);
+        leaf->len = static_cast<u16>(mid);
+
+        right->next = leaf->next;
+        if (right->next) right->next->prev = right;
+        right->prev = leaf;
+        leaf->next = right;
+
+        if (pos <= mid) {
+          leaf_insert_at(leaf, pos, std::move(key), std::move(value));
+        } else {
+          leaf_insert_at(right, pos - mid, std::move(key), std::move(value));
+        }
+
+        return crab::some(std::pair<K, Node*>{right->keys[0], right});
+      }
+
+      Internal *internal = static_cast<Internal*>(node);
+      const usize index = upper_index(internal->keys.data(), internal->len, key);
+
+      Split split = insert_into(internal->children[index], std::move(key), std::move(value), previous);
+      if (split.is_none()) return crab::none;
+
+      auto [separator, child] = split.take_unchecked();
+
+      if (internal->len < CAP) {
+        internal_insert_at(internal, index, std::move(separator), child);
+        return crab::none;
+      }
+
+      constexpr usize mid = CAP / 2;
+      Internal *right = new Internal{};
+      btree::helper::relocate_n(&internal->keys[mid + 1], CAP - mid - 1, right->keys.data());
+      std::copy_n(internal->children + mid + 1, CAP - mid, right->children);
+      right->len = static_cast<u16>(CAP - mid - 1);
+
+      K promoted{std::move(internal->keys[mid])};
+      std::destroy_at(&internal->keys[mid]);
+      internal->len = static_cast<u16>(mid);
+
+      if (index <= mid) {
+        internal_insert_at(internal, index, std::move(separator), child);
+      } else {
+        internal_insert_at(right, index - mid - 1, std::move(separator), child);
+      }
+
+      return crab::some(std::pair<K, Node*>{std::move(promoted), right});
+    }
+
+    auto remove_from(Node *node, const K &key) -> Option<V> {
+      if (node->leaf) {
+        Leaf *leaf = static_cast<Leaf*>(node);
+        const usize pos = lower_index(leaf->keys.data(), leaf->len, key);
+        if (pos >= leaf->len or comp(key, leaf->keys[pos])) {
+          return crab::none;
+        }
+
+        V value{std::move(leaf->values[pos])};
+        std::destroy_at(&leaf->keys[pos]);
+        std::destroy_at(&leaf->values[pos]);
+        btree::helper::shift_left(leaf->keys.data(), pos, leaf->len);
+        btree::helper::shift_left(leaf->values.data(), pos, leaf->len);
+        leaf->len--;
+        return crab::some(std::move(value));
+      }
+
+      Internal *internal = static_cast<Internal*>(node);
+      const usize index = upper_index(internal->keys.data(), internal->len, key);
+
+      Option<V> removed = remove_from(internal->children[index], key);
+      if (removed.is_some() and internal->children[index]->len < MIN) {
+        rebalance(internal, index);
+      }
+      return removed;
+    }
+
+    auto rebalance(Internal *parent, const usize index) -> void {
+      if (index > 0 and parent->children[index - 1]->len > MIN) {
+        borrow_from_left(parent, index);
+      } else if (index < parent->len and parent->children[index + 1]->len > MIN) {
+        borrow_from_right(parent, index);
+      } else if (index > 0) {
+        merge(parent, index - 1);
+      } else {
+        merge(parent, index);
+      }
+    }
+
+    static auto borrow_from_left(Internal *parent, const usize index) -> void {
+      Node *child = parent->children[index];
+      Node *sibling = parent->children[index - 1];
+
+      if (child->leaf) {
+        Leaf *leaf = static_cast<Leaf*>(child);
+        Leaf *left = static_cast<Leaf*>(sibling);
+        btree::helper::shift_right(leaf->keys.data(), 0, leaf->len);
+        btree::helper::shift_right(leaf->values.data(), 0, leaf->len);
+        btree::helper::relocate(&left->keys[left->len - 1], &leaf->keys[0]);
+        btree::helper::relocate(&left->values[left->len - 1], &leaf->values[0]);
+        left->len--;
+        leaf->len++;
+        parent->keys[index - 1] = leaf->keys[0];
+        return;
+      }
+
+      Internal *node = static_cast<Internal*>(child);
+      Internal *left = static_cast<Internal*>(sibling);
+      btree::helper::shift_right(node->keys.data(), 0, node->len);
+      btree::helper::shift_right(node->children, 0, node->len + 1);
+      std::construct_at(&node->keys[0], std::move(parent->keys[index - 1]));
+      node->children[0] = left->children[left->len];
+      parent->keys[index - 1] = std::move(left->keys[left->len - 1]);
+      std::destroy_at(&left->keys[left->len - 1]);
+      left->len--;
+      node->len++;
+    }
+
+    static auto borrow_from_right(Internal *parent, const usize index) -> void {
+      Node *child = parent->children[index];
+      Node *sibling = parent->children[index + 1];
+
+      if (child->leaf) {
+        Leaf *leaf = static_cast<Leaf*>(child);
+        Leaf *right = static_cast<Leaf*>(sibling);
+        btree::helper::relocate(&right->keys[0], &leaf->keys[leaf->len]);
+        btree::helper::relocate(&right->values[0], &leaf->values[leaf->len]);
+        btree::helper::shift_left(right->keys.data(), 0, right->len);
+        btree::helper::shift_left(right->values.data(), 0, right->len);
+        right->len--;
+        leaf->len++;
+        parent->keys[index] = right->keys[0];
+        return;
+      }
+
+      Internal *node = static_cast<Internal*>(child);
+      Internal *right = static_cast<Internal*>(sibling);
+      std::construct_at(&node->keys[node->len], std::move(parent->keys[index]));
+      node->children[node->len + 1] = right->children[0];
+      parent->keys[index] = std::move(right->keys[0]);
+      std::destroy_at(&right->keys[0]);
+      btree::helper::shift_left(right->keys.data(), 0, right->len);
+      btree::helper::shift_left(right->children, 0, right->len + 1);
+      right->len--;
+      node->len++;
+    }
+
+    /**
+     * @brief Merges children[index + 1] into children[index] and removes the separator between them
+     */
+    static auto merge(Internal *parent, const usize index) -> void {
+      Node *left_node = parent->children[index];
+      Node *right_node = parent->children[index + 1];
+
+      if (left_node->leaf) {
+        Leaf *left = static_cast<Leaf*>(left_node);
+        Leaf *right = static_cast<Leaf*>(right_node);
+        btree::helper::relocate_n(right->keys.data(), right->len, &left->keys[left->len]);
+        btree::helper::relocate_n(right->values.data(), right->len, &left->values[left->len]);
+        left->len += right->len;
+        left->next = right->next;
+        if (left->next) left->next->prev = left;
+        delete right;
+      } else {
+        Internal *left = static_cast<Internal*>(left_node);
+        Internal *right = static_cast<Internal*>(right_node);
+        std::construct_at(&left->keys[left->len], std::move(parent->keys[index]));
+        btree::helper::relocate_n(right->keys.data(), right->len, &left->keys[left->len + 1]);
+        std::copy_n(right->children, right->len + 1, left->children + left->len + 1);
+        left->len += right->len + 1;
+        delete right;
+      }
+
+      std::destroy_at(&parent->keys[index]);
+      btree::helper::shift_left(parent->keys.data(), index, parent->len);
+      btree::helper::shift_left(parent->children, index + 1, parent->len + 1);
+      parent->len--;
+    }
+
+    static auto free_node(Node *node) -> void {
+      if (node->leaf) {
+        Leaf *leaf = static_cast<Leaf*>(node);
+        std::destroy_n(leaf->keys.data(), leaf->len);
+        std::destroy_n(leaf->values.data(), leaf->len);
+        delete leaf;
+        return;
+      }
+
+      Internal *internal = static_cast<Internal*>(node);
+      for (usize i = 0; i <= internal->len; i++) {
+        free_node(internal->children[i]);
+      }
+      std::destroy_n(internal->keys.data(), internal->len);
+      delete internal;
+    }
+  };
+
+  /**
+   * @brief Ordered set stored as a B+ tree, see BTreeMap
+   */
+  template<typename K, typename Compare = std::less<K>>
+    requires std::copyable<K>
+  class BTreeSet {
+    using Map = BTreeMap<K, unit, Compare>;
+
+    Map map;
+
+  public:
+    /**
+     * @brief Cursor over the keys of a BTreeSet in ascending order
+     */
+    class Iterator {
+      typename Map::const_iterator inner;
+
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = K;
+      using reference = const K&;
+
+      Iterator() = default;
+
+      __always_inline explicit Iterator(typename Map::const_iterator inner) : inner{inner} {}
+
+      [[nodiscard]] __always_inline auto operator*() const -> reference { return (*inner).first; }
+
+      __always_inline auto operator++() -> Iterator& {
+        ++inner;
+        return *this;
+      }
+
+      __always_inline auto operator++(int) -> Iterator {
+        Iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator==(const Iterator &a, const Iterator &b) -> bool {
+        return a.inner == b.inner;
+      }
+    };
+
+    BTreeSet() = default;
+
+    BTreeSet(std::initializer_list<K> keys) {
+      for (const K &key: keys) {
+        insert(key);
+      }
+    }
+
+    /**
+     * @brief Builds a set from keys that are already sorted (with no duplicates) in O(n)
+     */
+    [[nodiscard]] static auto from_sorted(const Span<const K> keys) -> BTreeSet {
+      Vec<std::pair<K, unit>> entries;
+      entries.reserve(keys.size());
+      for (const K &key: keys) {
+        entries.emplace_back(key, unit{});
+      }
+
+      BTreeSet set;
+      set.map = Map::from_sorted(std::move(entries));
+      return set;
+    }
+
+    [[nodiscard]] __always_inline auto length() const -> usize { return map.length(); }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return map.is_empty(); }
+
+    /**
+     * @brief Inserts a key, returns false if the key was already in the set
+     */
+    auto insert(K key) -> bool { return map.insert(std::move(key), unit{}).is_none(); }
+
+    /**
+     * @brief Removes a key, returns whether the key was in the set
+     */
+    auto remove(const K &key) -> bool { return map.remove(key).is_some(); }
+
+    [[nodiscard]] auto contains(const K &key) const -> bool { return map.contains(key); }
+
+    [[nodiscard]] auto first() const -> Option<Ref<K>> { return map.first_key(); }
+
+    [[nodiscard]] auto last() const -> Option<Ref<K>> { return map.last_key(); }
+
+    /**
+     * @brief All keys in [min, max), in ascending order
+     */
+    [[nodiscard]] auto range(const K &min, const K &max) const -> std::ranges::subrange<Iterator> {
+      const auto inner = map.range(min, max);
+      return {Iterator{inner.begin()}, Iterator{inner.end()}};
+    }
+
+    /**
+     * @brief All keys inside of the given Range, in ascending order
+     */
+    template<std::same_as<K> T>
+    [[nodiscard]] auto range(const Range<T> bounds) const -> std::ranges::subrange<Iterator> {
+      return range(bounds.lower_bound(), bounds.upper_bound());
+    }
+
+    [[nodiscard]] auto begin() const -> Iterator { return Iterator{map.begin()}; }
+
+    [[nodiscard]] auto end() const -> Iterator { return Iterator{map.end()}; }
+
+    auto clear() -> void { map.clear(); }
+  };
+}
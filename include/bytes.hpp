@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "preamble.hpp"
+#include "result.hpp"
+#include "crab/debug.hpp"
+
+namespace crab {
+  /**
+   * @brief A ByteCursor read that the input cannot satisfy, offset() is where the read started
+   */
+  class DecodeError final : public Error {
+  public:
+    enum class Kind : u8 {
+      // fewer bytes left than the read needs
+      UnexpectedEnd,
+      // a varint longer than its type allows or whose value does not fit it
+      Overflow,
+      // a value the format does not allow (a wrong magic number, an unknown version...)
+      Invalid,
+    };
+
+  private:
+    Kind error_kind;
+    usize byte;
+
+  public:
+    DecodeError(const Kind kind, const usize position) : error_kind{kind}, byte{position} {}
+
+    [[nodiscard]] auto kind() const -> Kind { return error_kind; }
+
+    [[nodiscard]] auto offset() const -> usize { return byte; }
+
+    [[nodiscard]] auto what() const -> String override {
+      constexpr StringView descriptions[]{"unexpected end of input", "varint overflow", "invalid value"};
+      return std::format("{} at byte {}", descriptions[static_cast<u8>(error_kind)], byte);
+    }
+  };
+}
+
+namespace crab::bytes {
+  /**
+   * @brief Anything read & written as its bytes
+   */
+  template<typename T>
+  concept plain = std::is_trivially_copyable_v<T>;
+
+  /**
+   * @brief Types with an explicit byte order, integers & floats
+   */
+  template<typename T>
+  concept number = (std::is_integral_v<T> and not std::same_as<T, bool>) or std::is_floating_point_v<T>;
+
+  namespace helper {
+    template<plain T>
+    [[nodiscard]] __always_inline auto load(const u8 *from) -> T {
+      T value;
+      std::memcpy(&value, from, sizeof(T));
+      return value;
+    }
+
+    template<plain T>
+    __always_inline auto store(u8 *to, const T value) -> void { std::memcpy(to, &value, sizeof(T)); }
+
+    template<usize size>
+    using unsigned_of = std::conditional_t<size == 1, u8,
+      std::conditional_t<size == 2, u16, std::conditional_t<size == 4, u32, u64>>>;
+
+    /**
+     * @brief 'value' converted between native order & 'order', which is the same operation both ways
+     */
+    template<std::endian order, number T>
+    [[nodiscard]] __always_inline constexpr auto swap_to(const T value) -> T {
+      if constexpr (order == std::endian::native or sizeof(T) == 1) {
+        return value;
+      } else {
+        using U = unsigned_of<sizeof(T)>;
+        return std::bit_cast<T>(std::byteswap(std::bit_cast<U>(value)));
+      }
+    }
+
+    /**
+     * @brief Bytes an unsigned LEB128 varint of a T can take
+     */
+    template<std::unsigned_integral T>
+    inline constexpr usize MAX_VARINT = (std::numeric_limits<T>::digits + 6) / 7;
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Reads a binary format front to back out of a Span of bytes, never past its end.
+   *
+   * Every read returns a Result that is a DecodeError (leaving the cursor where it was) if there are not enough
+   * bytes left, reads of slices hand out Spans into the input instead of copying. When a run of fixed size fields
+   * follows, unchecked(n) checks the length once & returns a reader for those n bytes whose reads cannot fail.
+   *
+   * @code
+   * crab::ByteCursor cursor{packet};
+   * auto header = cursor.unchecked(6).take_unchecked();
+   * const u16 kind = header.read_be<u16>();
+   * const u32 length = header.read_be<u32>();
+   * const u64 id = cursor.read_varint<u64>().take_unchecked();
+   * const Span<const u8> payload = cursor.read_slice(length).take_unchecked();
+   * @endcode
+   */
+  class ByteCursor {
+    const u8 *data;
+    usize len;
+    usize position = 0;
+
+    [[nodiscard]] auto end_error() const -> DecodeError {
+      return DecodeError{DecodeError::Kind::UnexpectedEnd, position};
+    }
+
+    /**
+     * @brief Checks for the end at every byte, for varints near the end of the input & for the ones that overflow
+     */
+    template<std::unsigned_integral T>
+    [[nodiscard]] [[gnu::noinline]] auto read_varint_slow() -> Result<T, DecodeError> {
+      u64 value = 0;
+      for (usize i = 0; i < bytes::helper::MAX_VARINT<T>; i++) {
+        if (position + i == len) return end_error();
+        const u8 byte = data[position + i];
+        value |= u64{byte & 0x7fu} << (7 * i);
+        if (byte < 0x80) {
+          // the bits of the last byte that do not fit
+          const bool overflow = i == bytes::helper::MAX_VARINT<T> - 1
+            and (byte >> (std::numeric_limits<T>::digits - 7 * i)) != 0;
+          if (overflow or value > std::numeric_limits<T>::max()) {
+            return DecodeError{DecodeError::Kind::Overflow, position};
+          }
+          position += i + 1;
+          return static_cast<T>(value);
+        }
+      }
+      return DecodeError{DecodeError::Kind::Overflow, position};
+    }
+
+  public:
+    /**
+     * @brief Reader of a range whose length was checked up front, see ByteCursor::unchecked
+     */
+    class Unchecked {
+      const u8 *cursor;
+      const u8 *end;
+
+    public:
+      Unchecked(const u8 *cursor, const usize len) : cursor{cursor}, end{cursor + len} {}
+
+      [[nodiscard]] auto remaining() const -> usize { return static_cast<usize>(end - cursor); }
+
+      template<bytes::plain T>
+      [[nodiscard]] __always_inline auto read() -> T {
+        debug_assert(remaining() >= sizeof(T), "Read past the end of an unchecked range");
+        const T value = bytes::helper::load<T>(cursor);
+        cursor += sizeof(T);
+        return value;
+      }
+
+      template<bytes::number T>
+      [[nodiscard]] __always_inline auto read_le() -> T {
+        return bytes::helper::swap_to<std::endian::little>(read<T>());
+      }
+
+      template<bytes::number T>
+      [[nodiscard]] __always_inline auto read_be() -> T { return bytes::helper::swap_to<std::endian::big>(read<T>()); }
+
+      [[nodiscard]] __always_inline auto read_slice(const usize count) -> Span<const u8> {
+        debug_assert(remaining() >= count, "Read past the end of an unchecked range");
+        const Span<const u8> slice{cursor, count};
+        cursor += count;
+        return slice;
+      }
+    };
+
+    explicit ByteCursor(const Span<const u8> bytes) : data{bytes.data()}, len{bytes.size()} {}
+
+    /**
+     * @brief Bytes read so far
+     */
+    [[nodiscard]] auto offset() const -> usize { return position; }
+
+    [[nodiscard]] auto remaining() const -> usize { return len - position; }
+
+    [[nodiscard]] auto is_empty() const -> bool { return position == len; }
+
+    /**
+     * @brief The next sizeof(T) bytes as a T, in native byte order
+     */
+    template<bytes::plain T>
+    [[nodiscard]] auto read() -> Result<T, DecodeError> {
+      if (remaining() < sizeof(T)) return end_error();
+      const T value = bytes::helper::load<T>(data + position);
+      position += sizeof(T);
+      return value;
+    }
+
+    template<bytes::number T>
+    [[nodiscard]] auto read_le() -> Result<T, DecodeError> {
+      if (remaining() < sizeof(T)) return end_error();
+      const T value = bytes::helper::load<T>(data + position);
+      position += sizeof(T);
+      return bytes::helper::swap_to<std::endian::little>(value);
+    }
+
+    template<bytes::number T>
+    [[nodiscard]] auto read_be() -> Result<T, DecodeError> {
+      if (remaining() < sizeof(T)) return end_error();
+      const T value = bytes::helper::load<T>(data + position);
+      position += sizeof(T);
+      return bytes::helper::swap_to<std::endian::big>(value);
+    }
+
+    /**
+     * @brief The next 'count' bytes as a view into the input
+     */
+    [[nodiscard]] auto read_slice(const usize count) -> Result<Span<const u8>, DecodeError> {
+      if (remaining() < count) return end_error();
+      const Span<const u8> slice{data + position, count};
+      position += count;
+      return slice;
+    }
+
+    [[nodiscard]] auto skip(const usize count) -> Result<unit, DecodeError> {
+      if (remaining() < count) return end_error();
+      position += count;
+      return unit{};
+    }
+
+    /**
+     * @brief An unsigned LEB128 varint (protobuf's encoding), Overflow if it does not fit a T. Away from the end of
+     * the input the length is checked once for the longest possible varint instead of at every byte.
+     */
+    template<std::unsigned_integral T = u64>
+    [[nodiscard]] __always_inline auto read_varint() -> Result<T, DecodeError> {
+      if (remaining() >= bytes::helper::MAX_VARINT<T>) {
+        const u8 *from = data + position;
+        u64 value = 0;
+        for (usize i = 0; i < bytes::helper::MAX_VARINT<T>; i++) {
+          const u8 byte = from[i];
+          value |= u64{byte & 0x7fu} << (7 * i);
+          if (byte < 0x80) {
+            // the last byte may carry bits that do not fit, left to the slow path to tell
+            if (i == bytes::helper::MAX_VARINT<T> - 1 or value > std::numeric_limits<T>::max()) break;
+            position += i + 1;
+            return static_cast<T>(value);
+          }
+        }
+      }
+      return read_varint_slow<T>();
+    }
+
+    /**
+     * @brief A zigzag encoded varint (protobuf's sint32 / sint64), small negative numbers take few bytes
+     */
+    template<std::signed_integral T = i64>
+    [[nodiscard]] auto read_zigzag() -> Result<T, DecodeError> {
+      using U = std::make_unsigned_t<T>;
+      auto encoded = read_varint<U>();
+      if (encoded.is_err()) return encoded.take_err_unchecked();
+      const U value = encoded.take_unchecked();
+      return static_cast<T>(static_cast<U>(value >> 1) ^ static_cast<U>(U{0} - (value & 1)));
+    }
+
+    /**
+     * @brief Checks once that 'count' bytes are left & consumes them, the returned reader reads them without
+     * checking (bounds are only debug asserted)
+     */
+    [[nodiscard]] auto unchecked(const usize count) -> Result<Unchecked, DecodeError> {
+      if (remaining() < count) return end_error();
+      const Unchecked reader{data + position, count};
+      position += count;
+      return reader;
+    }
+  };
+
+  /**
+   * @brief Appends a binary format to a growable buffer, the writing counterpart of ByteCursor
+   */
+  class ByteWriter {
+    // written bytes are the first 'used', the rest is room to write into without growing
+    Vec<u8> buffer;
+    usize used = 0;
+
+    __always_inline auto room(const usize count) -> u8 * {
+      if (buffer.size() - used < count) [[unlikely]] buffer.resize(std::max(2 * buffer.size(), used + count));
+      return buffer.data() + used;
+    }
+
+    __always_inline auto append(const void *from, const usize count) -> void {
+      std::memcpy(room(count), from, count);
+      used += count;
+    }
+
+  public:
+    ByteWriter() = default;
+
+    explicit ByteWriter(const usize capacity) { buffer.resize(capacity); }
+
+    [[nodiscard]] auto length() const -> usize { return used; }
+
+    [[nodiscard]] auto bytes() const -> Span<const u8> { return Span{buffer}.first(used); }
+
+    [[nodiscard]] auto take() -> Vec<u8> {
+      buffer.resize(used);
+      used = 0;
+      return std::exchange(buffer, {});
+    }
+
+    auto clear() -> void { used = 0; }
+
+    auto reserve(const usize additional) -> void { room(additional); }
+
+    template<bytes::plain T>
+    auto write(const T value) -> void { append(&value, sizeof(T)); }
+
+    template<bytes::number T>
+    auto write_le(const T value) -> void { write(bytes::helper::swap_to<std::endian::little>(value)); }
+
+    template<bytes::number T>
+    auto write_be(const T value) -> void { write(bytes::helper::swap_to<std::endian::big>(value)); }
+
+    auto write_bytes(const Span<const u8> bytes) -> void { append(bytes.data(), bytes.size()); }
+
+    template<std::unsigned_integral T>
+    auto write_varint(T value) -> void {
+      u8 *to = room(bytes::helper::MAX_VARINT<T>);
+      usize length = 0;
+      for (; value >= 0x80; value >>= 7) to[length++] = static_cast<u8>(value | 0x80);
+      to[length++] = static_cast<u8>(value);
+      used += length;
+    }
+
+    template<std::signed_integral T>
+    auto write_zigzag(const T value) -> void {
+      using U = std::make_unsigned_t<T>;
+      // sign spread over every bit, shifted in separately so that the shift stays defined
+      const auto sign = static_cast<U>(value < 0 ? ~U{0} : U{0});
+      write_varint(static_cast<U>(static_cast<U>(static_cast<U>(value) << 1) ^ sign));
+    }
+  };
+}
@@ -23,7 +23,10 @@ namespace crab::debug {
     const char *what() const noexcept override;
   };
 
-  unit dbg_assert(
+  /**
+   * @brief Throws an AssertionFailedError, never returns & is laid out away from the code that checks the assertion
+   */
+  [[noreturn]] [[gnu::cold]] unit dbg_assert(
     StringView function,
     StringView source,
     StringView assertion_line,
@@ -31,15 +34,35 @@ namespace crab::debug {
     StringView msg
   );
 }
+/**
+ * @brief Tells the optimizer 'condition' holds, undefined behaviour if it does not. Compilers drop a [[assume]] or
+ * __builtin_assume whose condition calls a function (like Option::is_some()), a branch to unreachable code is kept
+ * & inlined away instead.
+ */
+#if defined(__GNUC__) or defined(__clang__)
+#define crab_assume(condition) if (!static_cast<bool>(condition)) __builtin_unreachable()
+#elif defined(_MSC_VER)
+#define crab_assume(condition) __assume(static_cast<bool>(condition))
+#else
+#define crab_assume(condition) [[assume(static_cast<bool>(condition))]]
+#endif
+
 #if DEBUG
-#define debug_assert(condition, message) if (!static_cast<bool>(condition)) crab::debug::dbg_assert(\
+#define debug_assert(condition, message) if (!static_cast<bool>(condition)) [[unlikely]] crab::debug::dbg_assert(\
   __FUNCTION__, \
   __FILE__, \
   #condition, \
   __LINE__, \
   (message))
+
+/**
+ * @brief debug_assert in debug builds, a precondition the optimizer may assume (see crab_assume) in release builds
+ */
+#define debug_assume(condition, message) debug_assert(condition, message)
 #else
 
 #define debug_assert(...)
 
+#define debug_assume(condition, message) crab_assume(condition)
+
 #endif
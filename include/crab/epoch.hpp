@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../preamble.hpp"
+
+namespace crab::epoch {
+  /**
+   * @brief Function that destroys & frees an object once no thread can observe it anymore
+   */
+  using Dropper = void (*)(void *);
+
+  /**
+   * @brief Pins the current thread into the global epoch for its lifetime (epoch based memory reclamation).
+   *
+   * While any Guard is alive on a thread, objects that were retired after the guard was created are not freed,
+   * so pointers read from a lock-free structure stay valid until the guard is dropped.
+   *
+   * Guards can be nested, only the outermost one pins & unpins.
+   */
+  class Guard {
+  public:
+    Guard();
+
+    Guard(const Guard &) = delete;
+
+    Guard(Guard &&) = delete;
+
+    auto operator=(const Guard &) -> Guard& = delete;
+
+    auto operator=(Guard &&) -> Guard& = delete;
+
+    ~Guard();
+
+    /**
+     * @brief Schedules 'object' to be destroyed by 'drop' once every thread that might still see it has unpinned.
+     * The object must already be unreachable for threads that pin after this call.
+     */
+    auto retire(void *object, Dropper drop) const -> void;
+  };
+
+  /**
+   * @brief Pins the current thread, see Guard
+   */
+  [[nodiscard]] inline auto pin() -> Guard { return {}; }
+
+  /**
+   * @brief Frees everything the calling thread has retired that is already safe to free, without waiting
+   * for the next automatic collection.
+   */
+  auto collect() -> void;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <filesystem>
+
+#include "../preamble.hpp"
+#include "../result.hpp"
+
+namespace crab::mapped {
+  /**
+   * @brief Failed system call, 'operation' names what was attempted & 'code' is the errno it failed with
+   */
+  class IoError final : public Error {
+    StringView operation;
+    i32 error_code;
+
+  public:
+    IoError(StringView operation, i32 error_code);
+
+    [[nodiscard]] auto code() const -> i32 { return error_code; }
+
+    [[nodiscard]] auto what() const -> String override;
+  };
+
+  /**
+   * @brief Read / write shared mapping of an entire file, writes through the mapping end up in the file (once the
+   * kernel writes the pages back, or on flush())
+   */
+  class File {
+    i32 fd = -1;
+    u8 *address = nullptr;
+    usize bytes = 0;
+
+    explicit File(i32 fd);
+
+    auto unmap() -> void;
+
+  public:
+    /**
+     * @brief Opens (or creates) the file at 'path' & maps its current contents
+     */
+    [[nodiscard]] static auto open(const std::filesystem::path &path) -> Result<File, IoError>;
+
+    File(const File &) = delete;
+
+    File(File &&from) noexcept;
+
+    auto operator=(const File &) -> File& = delete;
+
+    auto operator=(File &&from) noexcept -> File&;
+
+    ~File();
+
+    [[nodiscard]] auto data() const -> u8* { return address; }
+
+    [[nodiscard]] auto size() const -> usize { return bytes; }
+
+    /**
+     * @brief Grows / shrinks the file to 'new_bytes' & maps it again, the mapping may move
+     */
+    auto resize(usize new_bytes) -> Result<unit, IoError>;
+
+    /**
+     * @brief Blocks until every modified page was written back to the file
+     */
+    auto flush() const -> Result<unit, IoError>;
+  };
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../preamble.hpp"
+
+namespace crab::pool {
+  /**
+   * @brief Blocks up to this size are recycled through the per-thread caches, bigger ones go straight to the heap
+   */
+  inline constexpr usize MAX_POOLED_SIZE = 1024;
+
+  /**
+   * @brief Granularity of the pooled size classes
+   */
+  inline constexpr usize SIZE_CLASS = 16;
+
+  /**
+   * @brief Allocates a block of at least 'bytes' (aligned to __STDCPP_DEFAULT_NEW_ALIGNMENT__), reusing a
+   * block that was previously freed on the calling thread when one is available.
+   */
+  [[nodiscard]] auto allocate(usize bytes) -> void*;
+
+  /**
+   * @brief Returns a block from allocate() to the calling thread's cache, 'bytes' must be the size it was
+   * allocated with. Blocks may be freed on a different thread than the one that allocated them.
+   */
+  auto deallocate(void *block, usize bytes) -> void;
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <bit>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "../preamble.hpp"
+#include "debug.hpp"
+#include "../option.hpp"
+#include "../ref.hpp"
+
+namespace crab::ring {
+  /**
+   * @brief Shared implementation of RingBuffer & Deque, a circular buffer whose capacity is a power of two so
+   * wrapping an index is a single mask.
+   *
+   * Derived must provide 'slots()' (pointer to capacity() uninitialised or live slots), 'capacity()' and
+   * 'reserve_one()' which makes room for one more element or asserts that there is some.
+   */
+  template<typename T, typename Derived>
+  class Ring {
+  protected:
+    // slot of the front element
+    usize head = 0;
+    usize len = 0;
+
+    Ring() = default;
+
+    [[nodiscard]] __always_inline auto self() -> Derived& { return static_cast<Derived&>(*this); }
+
+    [[nodiscard]] __always_inline auto self() const -> const Derived& { return static_cast<const Derived&>(*this); }
+
+    [[nodiscard]] __always_inline auto mask() const -> usize { return self().capacity() - 1; }
+
+    [[nodiscard]] __always_inline auto slot(const usize index) -> T* {
+      return self().slots() + ((head + index) & mask());
+    }
+
+    [[nodiscard]] __always_inline auto slot(const usize index) const -> const T* {
+      return self().slots() + ((head + index) & mask());
+    }
+
+    /**
+     * @brief Move constructs every element in order into 'out', the elements of this ring are left moved from
+     */
+    auto relocate_into(T *out) -> void {
+      for (usize i = 0; i < len; i++) {
+        std::construct_at(out + i, std::move(*slot(i)));
+        std::destroy_at(slot(i));
+      }
+    }
+
+  public:
+    template<bool IS_CONST>
+    class Iterator {
+      using RingPtr = std::conditional_t<IS_CONST, const Ring*, Ring*>;
+
+      RingPtr ring = nullptr;
+      usize index = 0;
+
+    public:
+      using iterator_category = std::random_access_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = T;
+      using reference = std::conditional_t<IS_CONST, const T&, T&>;
+      using pointer = std::conditional_t<IS_CONST, const T*, T*>;
+
+      Iterator() = default;
+
+      __always_inline Iterator(RingPtr ring, const usize index) : ring{ring}, index{index} {}
+
+      template<bool FROM_CONST> requires (IS_CONST and not FROM_CONST)
+      __always_inline Iterator(const Iterator<FROM_CONST> &other) : ring{other.ring}, index{other.index} {}
+
+      [[nodiscard]] __always_inline auto operator*() const -> reference { return *ring->slot(index); }
+
+      [[nodiscard]] __always_inline auto operator->() const -> pointer { return ring->slot(index); }
+
+      [[nodiscard]] __always_inline auto operator[](const difference_type offset) const -> reference {
+        return *ring->slot(static_cast<usize>(static_cast<difference_type>(index) + offset));
+      }
+
+      __always_inline auto operator++() -> Iterator& {
+        ++index;
+        return *this;
+      }
+
+      __always_inline auto operator++(int) -> Iterator {
+        Iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      __always_inline auto operator--() -> Iterator& {
+        --index;
+        return *this;
+      }
+
+      __always_inline auto operator--(int) -> Iterator {
+        Iterator tmp = *this;
+        --*this;
+        return tmp;
+      }
+
+      __always_inline auto operator+=(const difference_type offset) -> Iterator& {
+        index = static_cast<usize>(static_cast<difference_type>(index) + offset);
+        return *this;
+      }
+
+      __always_inline auto operator-=(const difference_type offset) -> Iterator& { return *this += -offset; }
+
+      [[nodiscard]] __always_inline friend auto operator+(Iterator it, const difference_type offset) -> Iterator {
+        return it += offset;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator+(const difference_type offset, Iterator it) -> Iterator {
+        return it += offset;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator-(Iterator it, const difference_type offset) -> Iterator {
+        return it -= offset;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator-(const Iterator &a, const Iterator &b) -> difference_type {
+        return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+      }
+
+      [[nodiscard]] __always_inline friend auto operator==(const Iterator &a, const Iterator &b) -> bool {
+        return a.index == b.index;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator<=>(const Iterator &a, const Iterator &b) {
+        return a.index <=> b.index;
+      }
+
+      friend class Iterator<not IS_CONST>;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /**
+     * @brief Amount of elements
+     */
+    [[nodiscard]] __always_inline auto length() const -> usize { return len; }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return len == 0; }
+
+    [[nodiscard]] __always_inline auto is_full() const -> bool { return len == self().capacity(); }
+
+    /**
+     * @brief Element 'index' positions after the front
+     */
+    [[nodiscard]] __always_inline auto operator[](const usize index) -> T& {
+      debug_assert(index < len, "Index out of Bounds");
+      return *slot(index);
+    }
+
+    [[nodiscard]] __always_inline auto operator[](const usize index) const -> const T& {
+      debug_assert(index < len, "Index out of Bounds");
+      return *slot(index);
+    }
+
+    [[nodiscard]] auto front() const -> Option<Ref<T>> {
+      if (is_empty()) return crab::none;
+      return crab::some(Ref<T>{*slot(0)});
+    }
+
+    [[nodiscard]] auto back() const -> Option<Ref<T>> {
+      if (is_empty()) return crab::none;
+      return crab::some(Ref<T>{*slot(len - 1)});
+    }
+
+    template<typename... Args>
+    auto emplace_back(Args &&... args) -> T& {
+      self().reserve_one();
+      T *item = std::construct_at(slot(len), std::forward<Args>(args)...);
+      len++;
+      return *item;
+    }
+
+    template<typename... Args>
+    auto emplace_front(Args &&... args) -> T& {
+      self().reserve_one();
+      head = (head - 1) & mask();
+      len++;
+      return *std::construct_at(slot(0), std::forward<Args>(args)...);
+    }
+
+    auto push_back(T value) -> void { emplace_back(std::move(value)); }
+
+    auto push_front(T value) -> void { emplace_front(std::move(value)); }
+
+    /**
+     * @brief Removes & returns the first element, None if empty
+     */
+    auto pop_front() -> Option<T> {
+      if (is_empty()) return crab::none;
+
+      T *item = slot(0);
+      Option<T> value = crab::some(std::move(*item));
+      std::destroy_at(item);
+      head = (head + 1) & mask();
+      len--;
+      return value;
+    }
+
+    /**
+     * @brief Removes & returns the last element, None if empty
+     */
+    auto pop_back() -> Option<T> {
+      if (is_empty()) return crab::none;
+
+      T *item = slot(len - 1);
+      Option<T> value = crab::some(std::move(*item));
+      std::destroy_at(item);
+      len--;
+      return value;
+    }
+
+    auto clear() -> void {
+      if constexpr (not std::is_trivially_destructible_v<T>) {
+        for (usize i = 0; i < len; i++) std::destroy_at(slot(i));
+      }
+      head = 0;
+      len = 0;
+    }
+
+    /**
+     * @brief Contents in order as at most two contiguous pieces (the second is empty unless the contents wrap
+     * around the end of the buffer), meant for processing the elements with vectorised loops.
+     */
+    [[nodiscard]] auto as_spans() const -> std::pair<Span<const T>, Span<const T>> {
+      if (is_empty()) return {};
+      const usize first = std::min(len, self().capacity() - head);
+      return {Span<const T>{self().slots() + head, first}, Span<const T>{self().slots(), len - first}};
+    }
+
+    [[nodiscard]] auto as_spans_mut() -> std::pair<Span<T>, Span<T>> {
+      if (is_empty()) return {};
+      const usize first = std::min(len, self().capacity() - head);
+      return {Span<T>{self().slots() + head, first}, Span<T>{self().slots(), len - first}};
+    }
+
+    [[nodiscard]] auto begin() -> iterator { return iterator{this, 0}; }
+
+    [[nodiscard]] auto end() -> iterator { return iterator{this, len}; }
+
+    [[nodiscard]] auto begin() const -> const_iterator { return const_iterator{this, 0}; }
+
+    [[nodiscard]] auto end() const -> const_iterator { return const_iterator{this, len}; }
+  };
+}
@@ -0,0 +1,438 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <limits>
+#include <type_traits>
+
+#include "../preamble.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace crab::simd {
+  /**
+   * @brief Integer types that have a vectorised comparison path
+   */
+  template<typename T>
+  concept searchable = std::is_integral_v<T> and not std::same_as<T, bool> and (sizeof(T) == 4 or sizeof(T) == 8);
+
+  namespace helper {
+    /**
+     * @brief Maps an unsigned lane to the signed domain so that the signed SIMD compares give unsigned ordering
+     */
+    template<typename T>
+    __always_inline constexpr auto bias() -> T {
+      if constexpr (std::is_signed_v<T>) {
+        return T{0};
+      } else {
+        return static_cast<T>(T{1} << (sizeof(T) * 8 - 1));
+      }
+    }
+
+    template<typename T>
+    __always_inline auto scalar_count_less(const T *data, const usize len, const T &key) -> usize {
+      usize count = 0;
+      for (usize i = 0; i < len; i++) {
+        count += static_cast<usize>(data[i] < key);
+      }
+      return count;
+    }
+  }
+
+  /**
+   * @brief Counts how many of the elements in [data, data + len) are strictly less than 'key'.
+   *
+   * For sorted input this is the index std::lower_bound would return, computed without
+   * branches so that a whole node of keys can be compared with a handful of instructions.
+   */
+  template<searchable T>
+  [[nodiscard]] __always_inline auto count_less(const T *data, const usize len, const T key) -> usize {
+    usize count = 0;
+    usize i = 0;
+
+    #if defined(__AVX2__)
+    if constexpr (sizeof(T) == 4) {
+      const __m256i flip = _mm256_set1_epi32(static_cast<i32>(helper::bias<T>()));
+      const __m256i needle = _mm256_xor_si256(_mm256_set1_epi32(static_cast<i32>(key)), flip);
+      for (; i + 8 <= len; i += 8) {
+        const __m256i lanes = _mm256_xor_si256(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+          flip
+        );
+        const __m256i less = _mm256_cmpgt_epi32(needle, lanes);
+        count += static_cast<usize>(std::popcount(static_cast<u32>(_mm256_movemask_ps(_mm256_castsi256_ps(less)))));
+      }
+    } else {
+      const __m256i flip = _mm256_set1_epi64x(static_cast<i64>(helper::bias<T>()));
+      const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<i64>(key)), flip);
+      for (; i + 4 <= len; i += 4) {
+        const __m256i lanes = _mm256_xor_si256(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+          flip
+        );
+        const __m256i less = _mm256_cmpgt_epi64(needle, lanes);
+        count += static_cast<usize>(std::popcount(static_cast<u32>(_mm256_movemask_pd(_mm256_castsi256_pd(less)))));
+      }
+    }
+    #elif defined(__SSE2__)
+    if constexpr (sizeof(T) == 4) {
+      const __m128i flip = _mm_set1_epi32(static_cast<i32>(helper::bias<T>()));
+      const __m128i needle = _mm_xor_si128(_mm_set1_epi32(static_cast<i32>(key)), flip);
+      for (; i + 4 <= len; i += 4) {
+        const __m128i lanes = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), flip);
+        const __m128i less = _mm_cmpgt_epi32(needle, lanes);
+        count += static_cast<usize>(std::popcount(static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(less)))));
+      }
+    }
+    #endif
+
+    return count + helper::scalar_count_less(data + i, len - i, key);
+  }
+
+  /**
+   * @brief Counts how many of the elements in [data, data + len) are less than or equal to 'key'.
+   *
+   * For sorted input this is the index std::upper_bound would return.
+   */
+  template<searchable T>
+  [[nodiscard]] __always_inline auto count_less_equal(const T *data, const usize len, const T key) -> usize {
+    if (key == std::numeric_limits<T>::max()) {
+      return len;
+    }
+    return count_less(data, len, static_cast<T>(key + 1));
+  }
+
+  /**
+   * @brief Total amount of set bits in 'words'
+   *
+   * With AVX2 this uses the nibble lookup table popcount (Mula et al.) which processes four words per
+   * instruction & accumulates in byte lanes, otherwise falls back to the hardware popcount per word.
+   */
+  [[nodiscard]] inline auto popcount(const u64 *words, const usize len) -> usize {
+    usize count = 0;
+    usize i = 0;
+
+    #if defined(__AVX2__)
+    const __m256i lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+    );
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+
+    __m256i total = _mm256_setzero_si256();
+    while (i + 4 <= len) {
+      // byte lanes can hold up to 255, 31 iterations of at most 8 bits per lane is safe
+      __m256i local = _mm256_setzero_si256();
+      for (usize n = 0; n < 31 and i + 4 <= len; n++, i += 4) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+        const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+        const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+        local = _mm256_add_epi8(local, _mm256_add_epi8(lo, hi));
+      }
+      total = _mm256_add_epi64(total, _mm256_sad_epu8(local, _mm256_setzero_si256()));
+    }
+
+    count += static_cast<usize>(_mm256_extract_epi64(total, 0)) + static_cast<usize>(_mm256_extract_epi64(total, 1)) +
+      static_cast<usize>(_mm256_extract_epi64(total, 2)) + static_cast<usize>(_mm256_extract_epi64(total, 3));
+    #endif
+
+    for (; i < len; i++) {
+      count += static_cast<usize>(std::popcount(words[i]));
+    }
+    return count;
+  }
+
+  /**
+   * @brief dst[i] = op(dst[i], src[i]) for every word, 'op' is called with either u64 or a vector of words
+   * (GCC / Clang vector extensions) so it must only use the bitwise operators.
+   */
+  template<typename Op>
+  __always_inline auto zip_words(u64 *dst, const u64 *src, const usize len, const Op op) -> void {
+    usize i = 0;
+
+    #if defined(__AVX2__)
+    for (const usize vector_end = len - len % 4; i < vector_end; i += 4) {
+      const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+      const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), op(a, b));
+    }
+    #elif defined(__SSE2__)
+    for (const usize vector_end = len - len % 2; i < vector_end; i += 2) {
+      const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+      const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), op(a, b));
+    }
+    #endif
+
+    for (; i < len; i++) {
+      dst[i] = op(dst[i], src[i]);
+    }
+  }
+
+  /**
+   * @brief Writes the values present in both sorted, duplicate free arrays to 'out' (which must have room for
+   * min(a_len, b_len) values) & returns how many were written.
+   *
+   * With SSE2 blocks of eight values are compared all against all by rotating one of the blocks through
+   * every lane, whichever block has the smaller maximum is then replaced (Schlegel et al.), the remainder
+   * is merged one value at a time.
+   */
+  [[nodiscard]] inline auto intersect_sorted(
+    const u16 *a,
+    const usize a_len,
+    const u16 *b,
+    const usize b_len,
+    u16 *out
+  ) -> usize {
+    usize count = 0;
+    usize i = 0;
+    usize j = 0;
+
+    #if defined(__SSE2__)
+    while (i + 8 <= a_len and j + 8 <= b_len) {
+      const __m128i block_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+      __m128i block_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+
+      __m128i equal = _mm_cmpeq_epi16(block_a, block_b);
+      for (usize rotation = 1; rotation < 8; rotation++) {
+        block_b = _mm_or_si128(_mm_srli_si128(block_b, 2), _mm_slli_si128(block_b, 14));
+        equal = _mm_or_si128(equal, _mm_cmpeq_epi16(block_a, block_b));
+      }
+
+      // movemask gives two bits per 16 bit lane, keep one of them
+      u32 mask = static_cast<u32>(_mm_movemask_epi8(equal)) & 0x5555;
+      while (mask != 0) {
+        out[count++] = a[i + static_cast<usize>(std::countr_zero(mask)) / 2];
+        mask &= mask - 1;
+      }
+
+      const u16 a_max = a[i + 7];
+      const u16 b_max = b[j + 7];
+      if (a_max <= b_max) i += 8;
+      if (b_max <= a_max) j += 8;
+    }
+    #endif
+
+    while (i < a_len and j < b_len) {
+      const u16 x = a[i];
+      const u16 y = b[j];
+      out[count] = x;
+      count += static_cast<usize>(x == y);
+      i += static_cast<usize>(x <= y);
+      j += static_cast<usize>(y <= x);
+    }
+    return count;
+  }
+
+  /**
+   * @brief Reads the 'bits' wide (at most 32) unsigned integer that starts 'bit' bits into 'words', the word after
+   * the one holding 'bit' must be readable.
+   */
+  [[nodiscard]] __always_inline auto read_bits(const u64 *words, const u64 bit, const u32 bits) -> u32 {
+    const u64 index = bit / 64;
+    const u32 shift = static_cast<u32>(bit % 64);
+    // split in two shifts so that shift == 0 does not shift by 64
+    const u64 joined = (words[index] >> shift) | ((words[index + 1] << 1) << (63 - shift));
+    return static_cast<u32>(joined & ((u64{1} << bits) - 1));
+  }
+
+  /**
+   * @brief Decodes 'count' consecutive 'bits' wide integers starting 'bit_offset' bits into 'words'.
+   *
+   * With AVX2 and widths up to 25 bits eight values are decoded at once, each lane gathers the four bytes that
+   * hold its value & shifts it into place. Needs one readable word of padding past the last value.
+   */
+  inline auto unpack_bits(const u64 *words, const u64 bit_offset, const u32 bits, const usize count, u32 *out) -> void {
+    usize i = 0;
+
+    #if defined(__AVX2__)
+    if (bits <= 25) {
+      const u8 *bytes = reinterpret_cast<const u8*>(words);
+      const __m256i lane_bits = _mm256_mullo_epi32(
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32(static_cast<i32>(bits))
+      );
+      const __m256i mask = _mm256_set1_epi32(static_cast<i32>((u32{1} << bits) - 1));
+      const __m256i seven = _mm256_set1_epi32(7);
+
+      for (; i + 8 <= count; i += 8) {
+        const u64 bit = bit_offset + i * bits;
+        const __m256i relative = _mm256_add_epi32(lane_bits, _mm256_set1_epi32(static_cast<i32>(bit % 8)));
+        const __m256i raw = _mm256_i32gather_epi32(
+          reinterpret_cast<const int*>(bytes + bit / 8),
+          _mm256_srli_epi32(relative, 3),
+          1
+        );
+        const __m256i values = _mm256_and_si256(_mm256_srlv_epi32(raw, _mm256_and_si256(relative, seven)), mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), values);
+      }
+    }
+    #endif
+
+    for (; i < count; i++) {
+      out[i] = read_bits(words, bit_offset + i * bits, bits);
+    }
+  }
+
+  /**
+   * @brief Replaces data[i] with initial + data[0] + ... + data[i] (inclusive prefix sum, wrapping)
+   */
+  inline auto prefix_sum(u32 *data, const usize len, const u32 initial) -> void {
+    usize i = 0;
+    u32 carry = initial;
+
+    #if defined(__SSE2__)
+    __m128i running = _mm_set1_epi32(static_cast<i32>(initial));
+    for (; i + 4 <= len; i += 4) {
+      __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+      x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+      x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+      x = _mm_add_epi32(x, running);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), x);
+      running = _mm_shuffle_epi32(x, 0xff);
+    }
+    carry = static_cast<u32>(_mm_cvtsi128_si32(running));
+    #endif
+
+    for (; i < len; i++) {
+      carry += data[i];
+      data[i] = carry;
+    }
+  }
+
+  /**
+   * @brief Integer types the saturating bulk operations accept
+   */
+  template<typename T>
+  concept saturable = std::is_integral_v<T> and not std::same_as<T, bool>;
+
+  namespace helper {
+    // T's maximum as its unsigned counterpart
+    template<typename T>
+    inline constexpr auto MAX = static_cast<std::make_unsigned_t<T>>(std::numeric_limits<T>::max());
+
+    /**
+     * @brief Branchless a + b clamped to T's range, written with plain bitwise ops so that loops over it
+     * auto vectorise for the lane widths without a native saturating instruction
+     */
+    template<saturable T>
+    __always_inline constexpr auto saturating_add_lane(const T a, const T b) -> T {
+      using U = std::make_unsigned_t<T>;
+      const U sum = static_cast<U>(static_cast<U>(a) + static_cast<U>(b));
+      if constexpr (std::is_unsigned_v<T>) {
+        return sum < a ? std::numeric_limits<T>::max() : sum;
+      } else {
+        // max for a positive 'a', min (max + 1) for a negative one
+        const U saturated = static_cast<U>((static_cast<U>(a) >> (sizeof(T) * 8 - 1)) + MAX<T>);
+        const bool overflow = static_cast<T>((static_cast<U>(a) ^ sum) & (static_cast<U>(b) ^ sum)) < 0;
+        return static_cast<T>(overflow ? saturated : sum);
+      }
+    }
+
+    /**
+     * @brief Branchless a - b clamped to T's range
+     */
+    template<saturable T>
+    __always_inline constexpr auto saturating_sub_lane(const T a, const T b) -> T {
+      using U = std::make_unsigned_t<T>;
+      const U difference = static_cast<U>(static_cast<U>(a) - static_cast<U>(b));
+      if constexpr (std::is_unsigned_v<T>) {
+        return a < b ? T{0} : difference;
+      } else {
+        const U saturated = static_cast<U>((static_cast<U>(a) >> (sizeof(T) * 8 - 1)) + MAX<T>);
+        const U operands_differ = static_cast<U>(a) ^ static_cast<U>(b);
+        const bool overflow = static_cast<T>(operands_differ & (static_cast<U>(a) ^ difference)) < 0;
+        return static_cast<T>(overflow ? saturated : difference);
+      }
+    }
+
+    #if defined(__AVX2__)
+    using Vector = __m256i;
+    #elif defined(__SSE2__)
+    using Vector = __m128i;
+    #endif
+
+    #if defined(__AVX2__) || defined(__SSE2__)
+    __always_inline auto load(const void *from) -> Vector {
+      #if defined(__AVX2__)
+      return _mm256_loadu_si256(static_cast<const __m256i*>(from));
+      #else
+      return _mm_loadu_si128(static_cast<const __m128i*>(from));
+      #endif
+    }
+
+    __always_inline auto store(void *to, const Vector value) -> void {
+      #if defined(__AVX2__)
+      _mm256_storeu_si256(static_cast<__m256i*>(to), value);
+      #else
+      _mm_storeu_si128(static_cast<__m128i*>(to), value);
+      #endif
+    }
+
+    /**
+     * @brief The native saturating instruction for 8 & 16 bit lanes
+     */
+    template<saturable T, bool ADD>
+    __always_inline auto saturate(const Vector a, const Vector b) -> Vector {
+      #if defined(__AVX2__)
+      if constexpr (sizeof(T) == 1 and std::is_signed_v<T>) {
+        return ADD ? _mm256_adds_epi8(a, b) : _mm256_subs_epi8(a, b);
+      } else if constexpr (sizeof(T) == 1) {
+        return ADD ? _mm256_adds_epu8(a, b) : _mm256_subs_epu8(a, b);
+      } else if constexpr (std::is_signed_v<T>) {
+        return ADD ? _mm256_adds_epi16(a, b) : _mm256_subs_epi16(a, b);
+      } else {
+        return ADD ? _mm256_adds_epu16(a, b) : _mm256_subs_epu16(a, b);
+      }
+      #else
+      if constexpr (sizeof(T) == 1 and std::is_signed_v<T>) {
+        return ADD ? _mm_adds_epi8(a, b) : _mm_subs_epi8(a, b);
+      } else if constexpr (sizeof(T) == 1) {
+        return ADD ? _mm_adds_epu8(a, b) : _mm_subs_epu8(a, b);
+      } else if constexpr (std::is_signed_v<T>) {
+        return ADD ? _mm_adds_epi16(a, b) : _mm_subs_epi16(a, b);
+      } else {
+        return ADD ? _mm_adds_epu16(a, b) : _mm_subs_epu16(a, b);
+      }
+      #endif
+    }
+    #endif
+
+    template<bool ADD, saturable T>
+    __always_inline auto saturate(T *dst, const T *src, const usize len) -> void {
+      usize i = 0;
+
+      #if defined(__AVX2__) || defined(__SSE2__)
+      if constexpr (sizeof(T) <= 2) {
+        constexpr usize LANES = sizeof(Vector) / sizeof(T);
+        for (const usize vector_end = len - len % LANES; i < vector_end; i += LANES) {
+          store(dst + i, saturate<T, ADD>(load(dst + i), load(src + i)));
+        }
+      }
+      #endif
+
+      // 32 & 64 bit lanes (& the tail) are left to the auto vectoriser
+      for (; i < len; i++) {
+        dst[i] = ADD ? saturating_add_lane(dst[i], src[i]) : saturating_sub_lane(dst[i], src[i]);
+      }
+    }
+  }
+
+  /**
+   * @brief dst[i] = dst[i] + src[i] clamped to T's range, 8 & 16 bit lanes use the native saturating instructions
+   */
+  template<saturable T>
+  inline auto saturating_add(T *dst, const T *src, const usize len) -> void {
+    helper::saturate<true>(dst, src, len);
+  }
+
+  /**
+   * @brief dst[i] = dst[i] - src[i] clamped to T's range
+   */
+  template<saturable T>
+  inline auto saturating_sub(T *dst, const T *src, const usize len) -> void {
+    helper::saturate<false>(dst, src, len);
+  }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <bit>
+#include <initializer_list>
+#include <memory>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/ring.hpp"
+#include "option.hpp"
+
+namespace crab {
+  /**
+   * @brief Growable double ended queue stored as one contiguous circular buffer.
+   *
+   * Unlike std::deque (a map of fixed size blocks) every element lives in a single allocation, so iteration
+   * walks at most two contiguous ranges (see as_spans). The capacity is kept a power of two & doubles when full,
+   * which moves every element (references are invalidated by growth).
+   */
+  template<typename T>
+    requires std::move_constructible<T>
+  class Deque : public ring::Ring<T, Deque<T>> {
+    using Base = ring::Ring<T, Deque>;
+    friend Base;
+
+    static constexpr usize MIN_CAPACITY = 8;
+
+    T *buffer = nullptr;
+    usize cap = 0;
+
+    [[nodiscard]] __always_inline auto slots() -> T* { return buffer; }
+
+    [[nodiscard]] __always_inline auto slots() const -> const T* { return buffer; }
+
+    __always_inline auto reserve_one() -> void {
+      if (this->len == cap) [[unlikely]] reallocate(cap == 0 ? MIN_CAPACITY : cap * 2);
+    }
+
+    /**
+     * @brief Moves the contents into a new buffer of 'capacity' slots, front first
+     */
+    auto reallocate(const usize capacity) -> void {
+      debug_assert(std::has_single_bit(capacity) and capacity >= this->len, "Invalid Deque capacity");
+
+      T *fresh = std::allocator<T>{}.allocate(capacity);
+      if (buffer != nullptr) {
+        this->relocate_into(fresh);
+        std::allocator<T>{}.deallocate(buffer, cap);
+      }
+      buffer = fresh;
+      cap = capacity;
+      this->head = 0;
+    }
+
+    auto release() -> void {
+      this->clear();
+      if (buffer != nullptr) std::allocator<T>{}.deallocate(buffer, cap);
+      buffer = nullptr;
+      cap = 0;
+    }
+
+  public:
+    Deque() = default;
+
+    Deque(const std::initializer_list<T> values) requires std::copy_constructible<T> {
+      reserve(values.size());
+      for (const T &value: values) this->push_back(value);
+    }
+
+    Deque(const Deque &other) requires std::copy_constructible<T> {
+      reserve(other.length());
+      for (const T &value: other) this->push_back(value);
+    }
+
+    Deque(Deque &&other) noexcept
+      : buffer{std::exchange(other.buffer, nullptr)}, cap{std::exchange(other.cap, 0)} {
+      this->head = std::exchange(other.head, 0);
+      this->len = std::exchange(other.len, 0);
+    }
+
+    auto operator=(const Deque &other) -> Deque& requires std::copy_constructible<T> {
+      if (this == &other) return *this;
+      this->clear();
+      reserve(other.length());
+      for (const T &value: other) this->push_back(value);
+      return *this;
+    }
+
+    auto operator=(Deque &&other) noexcept -> Deque& {
+      if (this == &other) return *this;
+      release();
+      buffer = std::exchange(other.buffer, nullptr);
+      cap = std::exchange(other.cap, 0);
+      this->head = std::exchange(other.head, 0);
+      this->len = std::exchange(other.len, 0);
+      return *this;
+    }
+
+    ~Deque() { release(); }
+
+    /**
+     * @brief Amount of elements the Deque can hold before it has to grow
+     */
+    [[nodiscard]] __always_inline auto capacity() const -> usize { return cap; }
+
+    /**
+     * @brief Makes sure at least 'capacity' elements fit without growing
+     */
+    auto reserve(const usize capacity) -> void {
+      if (capacity > cap) reallocate(std::bit_ceil(std::max(capacity, MIN_CAPACITY)));
+    }
+  };
+}
@@ -0,0 +1,817 @@
+#pragma once
+
+#include <array>
+#include <format>
+#include <type_traits>
+
+#include "preamble.hpp"
+#include "box.hpp"
+#include "result.hpp"
+#include "crab/debug.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace crab::encoding {
+  /**
+   * @brief Text that is not valid hex / base64, offset() is the index of the first character that cannot be there
+   * (or the length of the text if it ends early), everything before it is valid.
+   */
+  class DecodeError final : public Error {
+    usize position;
+
+  public:
+    explicit DecodeError(const usize position) : position{position} {}
+
+    [[nodiscard]] auto offset() const -> usize { return position; }
+
+    [[nodiscard]] auto what() const -> String override {
+      return std::format("invalid encoded text at byte {}", position);
+    }
+  };
+
+  /**
+   * @brief Letters hex digits are written with, decoding takes either
+   */
+  enum class Case : u8 { Lower, Upper };
+
+  /**
+   * @brief RFC 4648 base64 alphabets, Standard ends in '+' & '/' & is padded with '=' to a multiple of 4 characters,
+   * Url ends in '-' & '_' & is not padded (as in JWTs). Decoding takes text with or without padding in either.
+   */
+  enum class Base64 : u8 { Standard, Url };
+}
+
+namespace crab::encoding::helper {
+  // value of a character that is not in the alphabet
+  inline constexpr u8 INVALID = 0xff;
+
+  inline constexpr u8 PAD = '=';
+
+  inline constexpr StringView HEX_DIGITS[2] = {"0123456789abcdef", "0123456789ABCDEF"};
+
+  inline constexpr StringView BASE64_ALPHABETS[2] = {
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_",
+  };
+
+  [[nodiscard]] consteval auto make_values(const StringView alphabet) -> std::array<u8, 256> {
+    std::array<u8, 256> values{};
+    values.fill(INVALID);
+    for (usize value = 0; value < alphabet.size(); value++) {
+      values[static_cast<u8>(alphabet[value])] = static_cast<u8>(value);
+    }
+    return values;
+  }
+
+  [[nodiscard]] consteval auto make_hex_values() -> std::array<u8, 256> {
+    std::array<u8, 256> values = make_values(HEX_DIGITS[0]);
+    for (u8 digit = 10; digit < 16; digit++) values[static_cast<u8>(HEX_DIGITS[1][digit])] = digit;
+    return values;
+  }
+
+  inline constexpr std::array<u8, 256> HEX_VALUES = make_hex_values();
+
+  inline constexpr std::array<u8, 256> BASE64_VALUES[2] = {
+    make_values(BASE64_ALPHABETS[0]),
+    make_values(BASE64_ALPHABETS[1]),
+  };
+
+  [[nodiscard]] __always_inline auto base64_values(const Base64 variant) -> const std::array<u8, 256>& {
+    return BASE64_VALUES[static_cast<usize>(variant)];
+  }
+
+  inline auto scalar_hex_encode(const u8 *bytes, const usize len, u8 *out, const Case letters) -> void {
+    const char *digits = HEX_DIGITS[static_cast<usize>(letters)].data();
+    for (usize i = 0; i < len; i++) {
+      out[2 * i] = static_cast<u8>(digits[bytes[i] >> 4]);
+      out[2 * i + 1] = static_cast<u8>(digits[bytes[i] & 0x0f]);
+    }
+  }
+
+  /**
+   * @brief Decodes text[from, len) into out[from / 2, ...), 'from' being even
+   */
+  [[nodiscard]] inline auto scalar_hex_decode(const u8 *text, const usize len, u8 *out, const usize from = 0)
+    -> Result<usize, DecodeError> {
+    usize i = from;
+    for (; i + 2 <= len; i += 2) {
+      const u8 high = HEX_VALUES[text[i]];
+      const u8 low = HEX_VALUES[text[i + 1]];
+      if ((high | low) == INVALID) return DecodeError{high == INVALID ? i : i + 1};
+      out[i / 2] = static_cast<u8>(high << 4 | low);
+    }
+    if (i != len) return DecodeError{len};
+    return len / 2;
+  }
+
+  /**
+   * @brief Encodes 'bytes' into 'out', which has room for base64_encoded_length(len), & tells how many characters
+   * were written
+   */
+  inline auto scalar_base64_encode(const u8 *bytes, const usize len, u8 *out, const Base64 variant) -> usize {
+    const char *alphabet = BASE64_ALPHABETS[static_cast<usize>(variant)].data();
+    usize i = 0;
+    usize o = 0;
+    for (; i + 3 <= len; i += 3, o += 4) {
+      const u32 bits = u32{bytes[i]} << 16 | u32{bytes[i + 1]} << 8 | bytes[i + 2];
+      out[o] = static_cast<u8>(alphabet[bits >> 18]);
+      out[o + 1] = static_cast<u8>(alphabet[bits >> 12 & 0x3f]);
+      out[o + 2] = static_cast<u8>(alphabet[bits >> 6 & 0x3f]);
+      out[o + 3] = static_cast<u8>(alphabet[bits & 0x3f]);
+    }
+    if (i == len) return o;
+
+    // 1 or 2 bytes left over, 2 or 3 characters & the padding up to 4
+    const u32 bits = u32{bytes[i]} << 16 | (i + 1 < len ? u32{bytes[i + 1]} << 8 : 0);
+    out[o++] = static_cast<u8>(alphabet[bits >> 18]);
+    out[o++] = static_cast<u8>(alphabet[bits >> 12 & 0x3f]);
+    if (i + 1 < len) out[o++] = static_cast<u8>(alphabet[bits >> 6 & 0x3f]);
+    if (variant == Base64::Standard) {
+      while (o % 4 != 0) out[o++] = PAD;
+    }
+    return o;
+  }
+
+  /**
+   * @brief Decodes text[from, len) into out[from / 4 * 3, ...), 'from' being a multiple of 4, & tells how many
+   * bytes 'out' holds in total. The bits a last group of 2 or 3 characters has beyond its last byte must be zero,
+   * so that every byte string has exactly one encoding.
+   */
+  [[nodiscard]] inline auto scalar_base64_decode(
+    const u8 *text,
+    const usize len,
+    u8 *out,
+    const Base64 variant,
+    const usize from = 0
+  ) -> Result<usize, DecodeError> {
+    const std::array<u8, 256> &values = base64_values(variant);
+    usize i = from;
+    usize o = from / 4 * 3;
+    for (; i + 4 <= len; i += 4, o += 3) {
+      const u8 a = values[text[i]];
+      const u8 b = values[text[i + 1]];
+      const u8 c = values[text[i + 2]];
+      const u8 d = values[text[i + 3]];
+      if ((a | b | c | d) == INVALID) break;
+      const u32 bits = u32{a} << 18 | u32{b} << 12 | u32{c} << 6 | d;
+      out[o] = static_cast<u8>(bits >> 16);
+      out[o + 1] = static_cast<u8>(bits >> 8);
+      out[o + 2] = static_cast<u8>(bits);
+    }
+
+    // the last group, or the one with a character that is not in the alphabet
+    usize count = 0;
+    u32 bits = 0;
+    for (; i + count < len; count++) {
+      const u8 value = values[text[i + count]];
+      if (value == INVALID) break;
+      bits |= u32{value} << (18 - 6 * count);
+    }
+    if (i + count == len) {
+      if (count == 0) return o;
+      if (count == 1) return DecodeError{len};
+    } else {
+      if (text[i + count] != PAD or count < 2) return DecodeError{i + count};
+      for (usize p = i + count; p < i + 4; p++) {
+        if (p == len or text[p] != PAD) return DecodeError{p};
+      }
+      if (i + 4 != len) return DecodeError{i + 4};
+    }
+
+    if ((bits & ((u32{1} << (32 - 8 * count)) - 1)) != 0) return DecodeError{i + count - 1};
+    out[o++] = static_cast<u8>(bits >> 16);
+    if (count == 3) out[o++] = static_cast<u8>(bits >> 8);
+    return o;
+  }
+
+  #if defined(__SSSE3__)
+  /**
+   * @brief pshufb tables of a base64 alphabet. A character is in it if the bits 'low' & 'high' have for its low &
+   * high nibble share one, it then decodes to itself plus 'roll' of its high nibble, save the 2 last characters of
+   * the alphabet which share their nibble with others & are corrected by 'fix' after. 'shift' is the reverse, what
+   * to add to a value to encode it, indexed by the range it is in (see simd_base64_encode).
+   */
+  struct Base64Lookup {
+    std::array<u8, 16> low{};
+    std::array<u8, 16> high{};
+    std::array<u8, 16> roll{};
+    std::array<u8, 16> shift{};
+    u8 char_62 = 0;
+    u8 char_63 = 0;
+    u8 fix_62 = 0;
+    u8 fix_63 = 0;
+  };
+
+  [[nodiscard]] consteval auto make_base64_lookup(const StringView alphabet) -> Base64Lookup {
+    Base64Lookup lookup;
+    for (usize value = 0; value < 64; value++) {
+      const u8 c = static_cast<u8>(alphabet[value]);
+      lookup.low[c & 0x0f] |= static_cast<u8>(1 << (c >> 4));
+      if (value < 62) lookup.roll[c >> 4] = static_cast<u8>(value - c);
+    }
+    for (usize nibble = 0; nibble < 8; nibble++) lookup.high[nibble] = static_cast<u8>(1 << nibble);
+
+    lookup.char_62 = static_cast<u8>(alphabet[62]);
+    lookup.char_63 = static_cast<u8>(alphabet[63]);
+    lookup.fix_62 = static_cast<u8>(62 - lookup.char_62 - lookup.roll[lookup.char_62 >> 4]);
+    lookup.fix_63 = static_cast<u8>(63 - lookup.char_63 - lookup.roll[lookup.char_63 >> 4]);
+
+    // values 0..25 are uppercase, 26..51 lowercase, 52..61 digits, then 62 & 63
+    lookup.shift[0] = static_cast<u8>(alphabet[0]);
+    lookup.shift[1] = static_cast<u8>(alphabet[26] - 26);
+    for (usize range = 2; range < 12; range++) lookup.shift[range] = static_cast<u8>(alphabet[52] - 52);
+    lookup.shift[12] = static_cast<u8>(alphabet[62] - 62);
+    lookup.shift[13] = static_cast<u8>(alphabet[63] - 63);
+    return lookup;
+  }
+
+  inline constexpr Base64Lookup BASE64_LOOKUPS[2] = {
+    make_base64_lookup(BASE64_ALPHABETS[0]),
+    make_base64_lookup(BASE64_ALPHABETS[1]),
+  };
+
+  // the 3 bytes b0 b1 b2 of every group into a 32 bit lane as b1 b0 b2 b1, two 16 bit words holding 2 values each
+  inline constexpr std::array<u8, 16> SPREAD_GROUPS{1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10};
+
+  // the 3 bytes in every 32 bit lane the decoded group ends up in, to the front
+  inline constexpr std::array<u8, 16> GATHER_GROUPS{
+    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 0x80, 0x80, 0x80, 0x80
+  };
+  #endif
+
+  #if defined(__AVX2__)
+  struct Avx2 {
+    using Vector = __m256i;
+    static constexpr usize WIDTH = 32;
+    // bytes a base64 block reads, its 2 lanes load 16 bytes each 12 bytes apart
+    static constexpr usize GROUPS_READ = 28;
+
+    [[nodiscard]] __always_inline static auto load(const u8 *from) -> Vector {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from));
+    }
+
+    __always_inline static auto store(u8 *to, const Vector v) -> void {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(to), v);
+    }
+
+    [[nodiscard]] __always_inline static auto splat(const u8 value) -> Vector {
+      return _mm256_set1_epi8(static_cast<char>(value));
+    }
+
+    [[nodiscard]] __always_inline static auto splat32(const u32 value) -> Vector {
+      return _mm256_set1_epi32(static_cast<i32>(value));
+    }
+
+    [[nodiscard]] __always_inline static auto table(const u8 *entries) -> Vector {
+      return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(entries)));
+    }
+
+    [[nodiscard]] __always_inline static auto lookup(const Vector table, const Vector indices) -> Vector {
+      return _mm256_shuffle_epi8(table, indices);
+    }
+
+    [[nodiscard]] __always_inline static auto high_nibbles(const Vector v) -> Vector {
+      return _mm256_and_si256(_mm256_srli_epi16(v, 4), splat(0x0f));
+    }
+
+    [[nodiscard]] __always_inline static auto low_nibbles(const Vector v) -> Vector {
+      return _mm256_and_si256(v, splat(0x0f));
+    }
+
+    [[nodiscard]] __always_inline static auto bit_and(const Vector a, const Vector b) -> Vector {
+      return _mm256_and_si256(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_or(const Vector a, const Vector b) -> Vector {
+      return _mm256_or_si256(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto add(const Vector a, const Vector b) -> Vector {
+      return _mm256_add_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto sub(const Vector a, const Vector b) -> Vector {
+      return _mm256_sub_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto saturating_sub(const Vector a, const Vector b) -> Vector {
+      return _mm256_subs_epu8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto equal(const Vector a, const Vector b) -> Vector {
+      return _mm256_cmpeq_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto greater(const Vector a, const Vector b) -> Vector {
+      return _mm256_cmpgt_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto at_most(const Vector v, const u8 limit) -> Vector {
+      return _mm256_cmpeq_epi8(_mm256_min_epu8(v, splat(limit)), v);
+    }
+
+    [[nodiscard]] __always_inline static auto mul_high_u16(const Vector a, const Vector b) -> Vector {
+      return _mm256_mulhi_epu16(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto mul_low_u16(const Vector a, const Vector b) -> Vector {
+      return _mm256_mullo_epi16(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto madd_u8(const Vector a, const Vector b) -> Vector {
+      return _mm256_maddubs_epi16(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto madd_u16(const Vector a, const Vector b) -> Vector {
+      return _mm256_madd_epi16(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto any(const Vector mask) -> bool { return _mm256_movemask_epi8(mask) != 0; }
+
+    /**
+     * @brief The bytes of 'a' & 'b' alternating, a0 b0 a1 b1 ..., in 2 vectors
+     */
+    __always_inline static auto interleave(const Vector a, const Vector b, Vector &first, Vector &second) -> void {
+      // the unpacks work within 128 bit lanes, giving a0..7 a16..23 & a8..15 a24..31
+      const Vector low = _mm256_unpacklo_epi8(a, b);
+      const Vector high = _mm256_unpackhi_epi8(a, b);
+      first = _mm256_permute2x128_si256(low, high, 0x20);
+      second = _mm256_permute2x128_si256(low, high, 0x31);
+    }
+
+    /**
+     * @brief The 16 bit lanes of 'a' & then 'b' narrowed to bytes, all below 256
+     */
+    [[nodiscard]] __always_inline static auto narrow(const Vector a, const Vector b) -> Vector {
+      return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0b11'01'10'00);
+    }
+
+    /**
+     * @brief 2 lanes of 12 bytes (& 4 ignored after each)
+     */
+    [[nodiscard]] __always_inline static auto load_groups(const u8 *from) -> Vector {
+      return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(from))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + 12)),
+        1
+      );
+    }
+
+    /**
+     * @brief Stores the first 12 bytes of each lane as 24 bytes, writing 8 more after them
+     */
+    __always_inline static auto store_groups(u8 *to, const Vector v) -> void {
+      store(to, _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)));
+    }
+  };
+  #endif
+
+  #if defined(__SSSE3__)
+  struct Sse {
+    using Vector = __m128i;
+    static constexpr usize WIDTH = 16;
+    static constexpr usize GROUPS_READ = 16;
+
+    [[nodiscard]] __always_inline static auto load(const u8 *from) -> Vector {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(from));
+    }
+
+    __always_inline static auto store(u8 *to, const Vector v) -> void {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(to), v);
+    }
+
+    [[nodiscard]] __always_inline static auto splat(const u8 value) -> Vector {
+      return _mm_set1_epi8(static_cast<char>(value));
+    }
+
+    [[nodiscard]] __always_inline static auto splat32(const u32 value) -> Vector {
+      return _mm_set1_epi32(static_cast<i32>(value));
+    }
+
+    [[nodiscard]] __always_inline static auto table(const u8 *entries) -> Vector { return load(entries); }
+
+    [[nodiscard]] __always_inline static auto lookup(const Vector table, const Vector indices) -> Vector {
+      return _mm_shuffle_epi8(table, indices);
+    }
+
+    [[nodiscard]] __always_inline static auto high_nibbles(const Vector v) -> Vector {
+      return _mm_and_si128(_mm_srli_epi16(v, 4), splat(0x0f));
+    }
+
+    [[nodiscard]] __always_inline static auto low_nibbles(const Vector v) -> Vector {
+      return _mm_and_si128(v, splat(0x0f));
+    }
+
+    [[nodiscard]] __always_inline static auto bit_and(const Vector a, const Vector b) -> Vector {
+      return _mm_and_si128(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_or(const Vector a, const Vector b) -> Vector {
+      return _mm_or_si128(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto add(const Vector a, const Vector b) -> Vector {
+      return _mm_add_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto sub(const Vector a, const Vector b) -> Vector {
+      return _mm_sub_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto saturating_sub(const Vector a, const Vector b) -> Vector {
+      return _mm_subs_epu8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto equal(const Vector a, const Vector b) -> Vector {
+      return _mm_cmpeq_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto greater(const Vector a, const Vector b) -> Vector {
+      return _mm_cmpgt_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto at_most(const Vector v, const u8 limit) -> Vector {
+      return _mm_cmpeq_epi8(_mm_min_epu8(v, splat(limit)), v);
+    }
+
+    [[nodiscard]] __always_inline static auto mul_high_u16(const Vector a, const Vector b) -> Vector {
+      return _mm_mulhi_epu16(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto mul_low_u16(const Vector a, const Vector b) -> Vector {
+      return _mm_mullo_epi16(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto madd_u8(const Vector a, const Vector b) -> Vector {
+      return _mm_maddubs_epi16(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto madd_u16(const Vector a, const Vector b) -> Vector {
+      return _mm_madd_epi16(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto any(const Vector mask) -> bool { return _mm_movemask_epi8(mask) != 0; }
+
+    __always_inline static auto interleave(const Vector a, const Vector b, Vector &first, Vector &second) -> void {
+      first = _mm_unpacklo_epi8(a, b);
+      second = _mm_unpackhi_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto narrow(const Vector a, const Vector b) -> Vector {
+      return _mm_packus_epi16(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto load_groups(const u8 *from) -> Vector { return load(from); }
+
+    __always_inline static auto store_groups(u8 *to, const Vector v) -> void { store(to, v); }
+  };
+  #endif
+
+  #if defined(__SSSE3__)
+  /**
+   * @brief Writes 2 digits per byte, WIDTH bytes at a time: the nibbles of every byte are looked up in a table of
+   * the 16 digits & interleaved
+   */
+  template<typename Simd>
+  auto simd_hex_encode(const u8 *bytes, const usize len, u8 *out, const Case letters) -> void {
+    using Vector = typename Simd::Vector;
+    constexpr usize WIDTH = Simd::WIDTH;
+
+    const Vector digits = Simd::table(reinterpret_cast<const u8*>(HEX_DIGITS[static_cast<usize>(letters)].data()));
+    usize i = 0;
+    for (; i + WIDTH <= len; i += WIDTH) {
+      const Vector input = Simd::load(bytes + i);
+      Vector first, second;
+      Simd::interleave(
+        Simd::lookup(digits, Simd::high_nibbles(input)),
+        Simd::lookup(digits, Simd::low_nibbles(input)),
+        first,
+        second
+      );
+      Simd::store(out + 2 * i, first);
+      Simd::store(out + 2 * i + WIDTH, second);
+    }
+    scalar_hex_encode(bytes + i, len - i, out + 2 * i, letters);
+  }
+
+  /**
+   * @brief Value of every hex digit in 'text', & a lane of 'invalid' set for every other character
+   */
+  template<typename Simd>
+  [[nodiscard]] __always_inline auto hex_values(const typename Simd::Vector text, typename Simd::Vector &invalid)
+    -> typename Simd::Vector {
+    using Vector = typename Simd::Vector;
+    const Vector digit = Simd::sub(text, Simd::splat('0'));
+    // lowercased, anything not a letter either stays out of 'a'..'f'
+    const Vector letter = Simd::sub(Simd::bit_or(text, Simd::splat(0x20)), Simd::splat('a'));
+    const Vector is_digit = Simd::at_most(digit, 9);
+    const Vector is_letter = Simd::at_most(letter, 5);
+    invalid = Simd::bit_or(invalid, Simd::equal(Simd::bit_or(is_digit, is_letter), Simd::splat(0)));
+    return Simd::bit_or(
+      Simd::bit_and(is_digit, digit),
+      Simd::bit_and(is_letter, Simd::add(letter, Simd::splat(10)))
+    );
+  }
+
+  /**
+   * @brief Decodes 2 * WIDTH digits at a time, the pairs of values joined by a multiply add. A block with anything
+   * but digits in it is left to the scalar decoder, which finds where.
+   */
+  template<typename Simd>
+  [[nodiscard]] auto simd_hex_decode(const u8 *text, const usize len, u8 *out) -> Result<usize, DecodeError> {
+    using Vector = typename Simd::Vector;
+    constexpr usize WIDTH = Simd::WIDTH;
+
+    // high digit * 16 + low digit
+    const Vector weights = Simd::splat32(0x0110'0110);
+    usize i = 0;
+    for (; i + 2 * WIDTH <= len; i += 2 * WIDTH) {
+      Vector invalid = Simd::splat(0);
+      const Vector first = hex_values<Simd>(Simd::load(text + i), invalid);
+      const Vector second = hex_values<Simd>(Simd::load(text + i + WIDTH), invalid);
+      if (Simd::any(invalid)) break;
+      Simd::store(out + i / 2, Simd::narrow(Simd::madd_u8(first, weights), Simd::madd_u8(second, weights)));
+    }
+    return scalar_hex_decode(text, len, out, i);
+  }
+
+  /**
+   * @brief Encodes 3 / 4 WIDTH bytes into WIDTH characters at a time (Muła & Lemire): the 4 values of every group
+   * are moved into their own bytes by multiplies, then turned into characters by adding the 'shift' of the range
+   * each is in.
+   */
+  template<typename Simd>
+  [[nodiscard]] auto simd_base64_encode(const u8 *bytes, const usize len, u8 *out, const Base64 variant) -> usize {
+    using Vector = typename Simd::Vector;
+    constexpr usize WIDTH = Simd::WIDTH;
+
+    const Vector spread = Simd::table(SPREAD_GROUPS.data());
+    const Vector shift = Simd::table(BASE64_LOOKUPS[static_cast<usize>(variant)].shift.data());
+    usize i = 0;
+    usize o = 0;
+    for (; i + Simd::GROUPS_READ <= len; i += WIDTH / 4 * 3, o += WIDTH) {
+      const Vector groups = Simd::lookup(Simd::load_groups(bytes + i), spread);
+      // values 0 & 2 of the group to the low byte of each word, 1 & 3 to the high byte
+      const Vector outer = Simd::mul_high_u16(
+        Simd::bit_and(groups, Simd::splat32(0x0fc0'fc00)),
+        Simd::splat32(0x0400'0040)
+      );
+      const Vector inner = Simd::mul_low_u16(
+        Simd::bit_and(groups, Simd::splat32(0x003f'03f0)),
+        Simd::splat32(0x0100'0010)
+      );
+      const Vector values = Simd::bit_or(outer, inner);
+
+      // 0..25 to range 0, 26..51 to 1, 52..61 to 2..11, 62 to 12 & 63 to 13
+      const Vector range = Simd::sub(
+        Simd::saturating_sub(values, Simd::splat(51)),
+        Simd::greater(values, Simd::splat(25))
+      );
+      Simd::store(out + o, Simd::add(values, Simd::lookup(shift, range)));
+    }
+    return o + scalar_base64_encode(bytes + i, len - i, out + o, variant);
+  }
+
+  /**
+   * @brief Decodes WIDTH characters into 3 / 4 WIDTH bytes at a time (Muła & Lemire), checking every character is
+   * in the alphabet through its nibbles. A block with anything else (like the padding) is left to the scalar
+   * decoder.
+   */
+  template<typename Simd>
+  [[nodiscard]] auto simd_base64_decode(const u8 *text, const usize len, u8 *out, const Base64 variant)
+    -> Result<usize, DecodeError> {
+    using Vector = typename Simd::Vector;
+    constexpr usize WIDTH = Simd::WIDTH;
+
+    const Base64Lookup &tables = BASE64_LOOKUPS[static_cast<usize>(variant)];
+    const Vector low = Simd::table(tables.low.data());
+    const Vector high = Simd::table(tables.high.data());
+    const Vector roll = Simd::table(tables.roll.data());
+    const Vector gather = Simd::table(GATHER_GROUPS.data());
+    usize i = 0;
+    // a block stores WIDTH bytes of which 3 / 4 are decoded, stopping WIDTH characters short of the end keeps the
+    // rest within base64_decoded_length()
+    for (; i + 2 * WIDTH <= len; i += WIDTH) {
+      const Vector input = Simd::load(text + i);
+      const Vector nibbles = Simd::high_nibbles(input);
+      const Vector classes = Simd::bit_and(Simd::lookup(low, Simd::low_nibbles(input)), Simd::lookup(high, nibbles));
+      if (Simd::any(Simd::equal(classes, Simd::splat(0)))) break;
+
+      const Vector is_62 = Simd::equal(input, Simd::splat(tables.char_62));
+      const Vector is_63 = Simd::equal(input, Simd::splat(tables.char_63));
+      Vector values = Simd::add(input, Simd::lookup(roll, nibbles));
+      values = Simd::add(values, Simd::bit_or(
+        Simd::bit_and(is_62, Simd::splat(tables.fix_62)),
+        Simd::bit_and(is_63, Simd::splat(tables.fix_63))
+      ));
+
+      // 4 values of 6 bits to 2 words of 12 bits, to 3 bytes in a 32 bit lane
+      const Vector words = Simd::madd_u8(values, Simd::splat32(0x0140'0140));
+      const Vector groups = Simd::madd_u16(words, Simd::splat32(0x0001'1000));
+      Simd::store_groups(out + i / 4 * 3, Simd::lookup(groups, gather));
+    }
+    return scalar_base64_decode(text, len, out, variant, i);
+  }
+  #endif
+
+  inline auto hex_encode(const u8 *bytes, const usize len, u8 *out, const Case letters) -> void {
+    #if defined(__AVX2__)
+    simd_hex_encode<Avx2>(bytes, len, out, letters);
+    #elif defined(__SSSE3__)
+    simd_hex_encode<Sse>(bytes, len, out, letters);
+    #else
+    scalar_hex_encode(bytes, len, out, letters);
+    #endif
+  }
+
+  [[nodiscard]] inline auto hex_decode(const u8 *text, const usize len, u8 *out) -> Result<usize, DecodeError> {
+    #if defined(__AVX2__)
+    return simd_hex_decode<Avx2>(text, len, out);
+    #elif defined(__SSSE3__)
+    return simd_hex_decode<Sse>(text, len, out);
+    #else
+    return scalar_hex_decode(text, len, out);
+    #endif
+  }
+
+  [[nodiscard]] inline auto base64_encode(const u8 *bytes, const usize len, u8 *out, const Base64 variant) -> usize {
+    #if defined(__AVX2__)
+    return simd_base64_encode<Avx2>(bytes, len, out, variant);
+    #elif defined(__SSSE3__)
+    return simd_base64_encode<Sse>(bytes, len, out, variant);
+    #else
+    return scalar_base64_encode(bytes, len, out, variant);
+    #endif
+  }
+
+  [[nodiscard]] inline auto base64_decode(const u8 *text, const usize len, u8 *out, const Base64 variant)
+    -> Result<usize, DecodeError> {
+    #if defined(__AVX2__)
+    return simd_base64_decode<Avx2>(text, len, out, variant);
+    #elif defined(__SSSE3__)
+    return simd_base64_decode<Sse>(text, len, out, variant);
+    #else
+    return scalar_base64_decode(text, len, out, variant);
+    #endif
+  }
+
+  [[nodiscard]] __always_inline auto bytes(const StringView text) -> Span<const u8> {
+    return Span<const u8>{reinterpret_cast<const u8*>(text.data()), text.size()};
+  }
+
+  /**
+   * @brief An array of 'len' bytes left uninitialised, all of it is about to be written
+   */
+  [[nodiscard]] __always_inline auto uninit_bytes(const usize len) -> Box<u8[]> {
+    return Box<u8[]>::wrap_unchecked(new u8[len], len);
+  }
+}
+
+namespace crab::encoding {
+  /**
+   * @brief Characters hex encoding 'bytes' bytes takes
+   */
+  [[nodiscard]] constexpr auto hex_encoded_length(const usize bytes) -> usize { return bytes * 2; }
+
+  /**
+   * @brief Bytes hex text of 'chars' characters decodes to
+   */
+  [[nodiscard]] constexpr auto hex_decoded_length(const usize chars) -> usize { return chars / 2; }
+
+  /**
+   * @brief Characters base64 encoding 'bytes' bytes takes, with the padding of 'variant'
+   */
+  [[nodiscard]] constexpr auto base64_encoded_length(const usize bytes, const Base64 variant = Base64::Standard)
+    -> usize {
+    if (variant == Base64::Standard) return (bytes + 2) / 3 * 4;
+    return bytes / 3 * 4 + (bytes % 3 == 0 ? 0 : bytes % 3 + 1);
+  }
+
+  /**
+   * @brief Bytes base64 'text' decodes to, padded or not (an upper bound if it is invalid)
+   */
+  [[nodiscard]] inline auto base64_decoded_length(const Span<const u8> text) -> usize {
+    usize len = text.size();
+    for (usize pad = 0; pad < 2 and len > 0 and text[len - 1] == helper::PAD; pad++) len--;
+    return len / 4 * 3 + (len % 4 == 0 ? 0 : len % 4 - 1);
+  }
+
+  [[nodiscard]] inline auto base64_decoded_length(const StringView text) -> usize {
+    return base64_decoded_length(helper::bytes(text));
+  }
+
+  /**
+   * @brief Writes 2 hex digits per byte of 'bytes' to 'out', which needs room for hex_encoded_length(bytes.size()),
+   * & tells how many were written
+   *
+   * Uses AVX2 (or SSSE3) to encode 32 (16) bytes at a time.
+   */
+  inline auto hex_encode(const Span<const u8> bytes, const Span<u8> out, const Case letters = Case::Lower) -> usize {
+    debug_assert(out.size() >= hex_encoded_length(bytes.size()), "Output too small for the hex encoding");
+    helper::hex_encode(bytes.data(), bytes.size(), out.data(), letters);
+    return hex_encoded_length(bytes.size());
+  }
+
+  /**
+   * @brief 'bytes' in hex, 2 digits per byte
+   */
+  [[nodiscard]] inline auto hex_encode(const Span<const u8> bytes, const Case letters = Case::Lower) -> Box<u8[]> {
+    Box<u8[]> text = helper::uninit_bytes(hex_encoded_length(bytes.size()));
+    helper::hex_encode(bytes.data(), bytes.size(), text.as_ptr(), letters);
+    return text;
+  }
+
+  /**
+   * @brief Decodes hex 'text' (digits of either case, nothing between them) into 'out', which needs room for
+   * hex_decoded_length(text.size()), & tells how many bytes were written. What is written before an error is
+   * unspecified.
+   *
+   * Uses AVX2 (or SSSE3) to decode 64 (32) digits at a time.
+   */
+  [[nodiscard]] inline auto hex_decode(const Span<const u8> text, const Span<u8> out) -> Result<usize, DecodeError> {
+    debug_assert(out.size() >= hex_decoded_length(text.size()), "Output too small for the decoded hex");
+    return helper::hex_decode(text.data(), text.size(), out.data());
+  }
+
+  [[nodiscard]] inline auto hex_decode(const StringView text, const Span<u8> out) -> Result<usize, DecodeError> {
+    return hex_decode(helper::bytes(text), out);
+  }
+
+  /**
+   * @brief The bytes of hex 'text'
+   */
+  [[nodiscard]] inline auto hex_decode(const Span<const u8> text) -> Result<Box<u8[]>, DecodeError> {
+    Box<u8[]> bytes = helper::uninit_bytes(hex_decoded_length(text.size()));
+    auto decoded = helper::hex_decode(text.data(), text.size(), bytes.as_ptr());
+    if (decoded.is_err()) return decoded.take_err_unchecked();
+    return bytes;
+  }
+
+  [[nodiscard]] inline auto hex_decode(const StringView text) -> Result<Box<u8[]>, DecodeError> {
+    return hex_decode(helper::bytes(text));
+  }
+
+  /**
+   * @brief Writes 'bytes' in base64 to 'out', which needs room for base64_encoded_length(bytes.size(), variant), &
+   * tells how many characters were written
+   *
+   * Uses AVX2 (or SSSE3) to encode 24 (12) bytes at a time.
+   */
+  inline auto base64_encode(const Span<const u8> bytes, const Span<u8> out, const Base64 variant = Base64::Standard)
+    -> usize {
+    debug_assert(out.size() >= base64_encoded_length(bytes.size(), variant), "Output too small for the base64");
+    return helper::base64_encode(bytes.data(), bytes.size(), out.data(), variant);
+  }
+
+  /**
+   * @brief 'bytes' in base64
+   */
+  [[nodiscard]] inline auto base64_encode(const Span<const u8> bytes, const Base64 variant = Base64::Standard)
+    -> Box<u8[]> {
+    Box<u8[]> text = helper::uninit_bytes(base64_encoded_length(bytes.size(), variant));
+    (void) helper::base64_encode(bytes.data(), bytes.size(), text.as_ptr(), variant);
+    return text;
+  }
+
+  /**
+   * @brief Decodes base64 'text' in the alphabet of 'variant', with its padding or none, into 'out', which needs
+   * room for base64_decoded_length(text), & tells how many bytes were written. Whitespace is not skipped & the
+   * unused bits of the last character must be zero. What is written before an error is unspecified.
+   *
+   * Uses AVX2 (or SSSE3) to decode 32 (16) characters at a time.
+   */
+  [[nodiscard]] inline auto base64_decode(
+    const Span<const u8> text,
+    const Span<u8> out,
+    const Base64 variant = Base64::Standard
+  ) -> Result<usize, DecodeError> {
+    debug_assert(out.size() >= base64_decoded_length(text), "Output too small for the decoded base64");
+    return helper::base64_decode(text.data(), text.size(), out.data(), variant);
+  }
+
+  [[nodiscard]] inline auto base64_decode(
+    const StringView text,
+    const Span<u8> out,
+    const Base64 variant = Base64::Standard
+  ) -> Result<usize, DecodeError> {
+    return base64_decode(helper::bytes(text), out, variant);
+  }
+
+  /**
+   * @brief The bytes of base64 'text'
+   */
+  [[nodiscard]] inline auto base64_decode(const Span<const u8> text, const Base64 variant = Base64::Standard)
+    -> Result<Box<u8[]>, DecodeError> {
+    Box<u8[]> bytes = helper::uninit_bytes(base64_decoded_length(text));
+    auto decoded = helper::base64_decode(text.data(), text.size(), bytes.as_ptr(), variant);
+    if (decoded.is_err()) return decoded.take_err_unchecked();
+    return bytes;
+  }
+
+  [[nodiscard]] inline auto base64_decode(const StringView text, const Base64 variant = Base64::Standard)
+    -> Result<Box<u8[]>, DecodeError> {
+    return base64_decode(helper::bytes(text), variant);
+  }
+}
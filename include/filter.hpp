@@ -0,0 +1,507 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "preamble.hpp"
+#include "bytes.hpp"
+#include "option.hpp"
+#include "result.hpp"
+#include "crab/debug.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace crab::filter::helper {
+  /**
+   * @brief Spreads a std::hash over all 64 bits (murmur3's finalizer), libstdc++ & libc++ hash integers to
+   * themselves
+   */
+  [[nodiscard]] __always_inline constexpr auto mix(u64 hash) -> u64 {
+    hash ^= hash >> 33;
+    hash *= 0xff51'afd7'ed55'8ccd;
+    hash ^= hash >> 33;
+    hash *= 0xc4ce'b9fe'1a85'ec53;
+    return hash ^ (hash >> 33);
+  }
+
+  /**
+   * @brief Keys the bulk lookups hash & prefetch before probing any, enough to keep that many cache misses in
+   * flight at once
+   */
+  inline constexpr usize BATCH = 16;
+
+  /**
+   * @brief False positive rate of a split block Bloom filter holding 'per_block' keys per block on average: a miss
+   * is found if the eight bits it tests are set in its block, whose number of keys is Poisson distributed
+   */
+  [[nodiscard]] inline auto split_block_rate(const f64 per_block) -> f64 {
+    f64 rate = 0;
+    f64 probability = std::exp(-per_block);
+    const auto last = static_cast<usize>(per_block + 20 * std::sqrt(per_block) + 20);
+    for (usize keys = 0; keys <= last; keys++) {
+      rate += probability * std::pow(1 - std::pow(f64{31} / 32, static_cast<f64>(keys)), 8);
+      probability *= per_block / static_cast<f64>(keys + 1);
+    }
+    return rate;
+  }
+
+  /**
+   * @brief Checks & skips the magic number & version every serialized filter starts with
+   */
+  [[nodiscard]] inline auto read_header(
+    ByteCursor &cursor,
+    const Span<const u8, 4> magic,
+    const u8 version
+  ) -> Result<unit, DecodeError> {
+    auto header = cursor.read_slice(5);
+    if (header.is_err()) return header.take_err_unchecked();
+    const Span<const u8> bytes = header.take_unchecked();
+    if (not std::ranges::equal(bytes.first(4), magic) or bytes[4] != version) {
+      return DecodeError{DecodeError::Kind::Invalid, 0};
+    }
+    return unit{};
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Set membership with false positives but no false negatives, in a fraction of the memory of a Set, for
+   * skipping lookups of keys that are most likely missing.
+   *
+   * Split block layout (Putze et al., the one Parquet & Impala use): a key picks one 32 byte block & sets one bit
+   * in each of its eight 32 bit words, so a lookup reads a single cache line & with AVX2 is tested with a handful
+   * of vector instructions. Sized from the expected amount of keys & the false positive rate wanted, keys cannot
+   * be removed (see CuckooFilter).
+   *
+   * Serialized filters hash with 'Hash', they can only be read by programs whose 'Hash' agrees.
+   *
+   * @code
+   * crab::BloomFilter<u64> stored{1'000'000, 0.01};
+   * for (const u64 id: ids) stored.insert(id);
+   * if (stored.contains(id)) lookup(id); // else 'id' is certainly absent
+   * @endcode
+   */
+  template<typename T, typename Hash = std::hash<T>>
+  class BloomFilter {
+    struct alignas(32) Block {
+      std::array<u32, 8> words{};
+    };
+
+    static constexpr std::array<u32, 8> SALT{
+      0x47b6'137b, 0x4497'4d91, 0x8824'ad5b, 0xa2b7'289d, 0x7054'95c7, 0x2df1'424b, 0x9efc'4947, 0x5c6b'fb31,
+    };
+
+    static constexpr std::array<u8, 4> MAGIC{'C', 'R', 'B', 'F'};
+    static constexpr u8 VERSION = 1;
+
+    Vec<Block> blocks;
+    [[no_unique_address]] Hash hasher;
+
+    explicit BloomFilter(Vec<Block> blocks) : blocks{std::move(blocks)} {}
+
+    [[nodiscard]] __always_inline auto hash_of(const T &key) const -> u64 {
+      return filter::helper::mix(static_cast<u64>(hasher(key)));
+    }
+
+    /**
+     * @brief The high half of the hash picks the block (scaled by a multiply rather than a modulo), the low half
+     * the bits in it
+     */
+    [[nodiscard]] __always_inline auto block_of(const u64 hash) const -> usize {
+      return static_cast<usize>(((hash >> 32) * blocks.size()) >> 32);
+    }
+
+    [[nodiscard]] __always_inline static auto test(const Block &block, const u32 bits) -> bool {
+      #if defined(__AVX2__)
+      const __m256i salt = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(SALT.data()));
+      const __m256i shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<i32>(bits)), salt), 27);
+      const __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+      // set if every bit of 'mask' is set in the block
+      return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(block.words.data())), mask) != 0;
+      #else
+      u32 missing = 0;
+      for (usize i = 0; i < 8; i++) missing |= ~block.words[i] & (u32{1} << ((bits * SALT[i]) >> 27));
+      return missing == 0;
+      #endif
+    }
+
+  public:
+    /**
+     * @brief An empty filter that holds 'expected_keys' keys at about 'false_positive_rate'
+     */
+    explicit BloomFilter(const usize expected_keys, const f64 false_positive_rate = 0.01) {
+      debug_assert(false_positive_rate > 0 and false_positive_rate < 1, "False positive rate must be in (0, 1)");
+      // the most keys per block that stay under the rate, the rate grows with the keys per block
+      f64 fewest = 0;
+      f64 most = 256;
+      for (usize i = 0; i < 64; i++) {
+        const f64 middle = (fewest + most) / 2;
+        (filter::helper::split_block_rate(middle) <= false_positive_rate ? fewest : most) = middle;
+      }
+      const f64 needed = std::ceil(static_cast<f64>(std::max<usize>(expected_keys, 1)) / fewest);
+      blocks.resize(std::max<usize>(static_cast<usize>(needed), 1));
+      debug_assert(blocks.size() <= (u64{1} << 32), "Bloom filter too large for 32 bit block indices");
+    }
+
+    auto insert(const T &key) -> void {
+      const u64 hash = hash_of(key);
+      std::array<u32, 8> &words = blocks[block_of(hash)].words;
+      for (usize i = 0; i < 8; i++) words[i] |= u32{1} << ((static_cast<u32>(hash) * SALT[i]) >> 27);
+    }
+
+    /**
+     * @brief False if 'key' was never inserted, true if it was or (at the false positive rate) was not
+     */
+    [[nodiscard]] __always_inline auto contains(const T &key) const -> bool {
+      const u64 hash = hash_of(key);
+      return test(blocks[block_of(hash)], static_cast<u32>(hash));
+    }
+
+    /**
+     * @brief found[i] = contains(keys[i]) for every key & how many were found, keys are hashed & their blocks
+     * prefetched a batch at a time so the cache misses of a batch overlap
+     */
+    auto contains_many(const Span<const T> keys, const Span<bool> found) const -> usize {
+      debug_assert(found.size() >= keys.size(), "Output has less room than there are keys");
+      usize count = 0;
+      std::array<u64, filter::helper::BATCH> hashes;
+      for (usize start = 0; start < keys.size(); start += filter::helper::BATCH) {
+        const usize batch = std::min(filter::helper::BATCH, keys.size() - start);
+        for (usize i = 0; i < batch; i++) {
+          hashes[i] = hash_of(keys[start + i]);
+          __builtin_prefetch(&blocks[block_of(hashes[i])]);
+        }
+        for (usize i = 0; i < batch; i++) {
+          found[start + i] = test(blocks[block_of(hashes[i])], static_cast<u32>(hashes[i]));
+          count += found[start + i];
+        }
+      }
+      return count;
+    }
+
+    auto clear() -> void { std::ranges::fill(blocks, Block{}); }
+
+    /**
+     * @brief Size of the filter in bytes
+     */
+    [[nodiscard]] auto memory() const -> usize { return blocks.size() * sizeof(Block); }
+
+    /**
+     * @brief "CRBF", a version byte, the block count (u64) & the blocks as little endian u32 words
+     */
+    [[nodiscard]] auto serialize() const -> Vec<u8> {
+      ByteWriter writer{5 + sizeof(u64) + memory()};
+      writer.write_bytes(MAGIC);
+      writer.write(VERSION);
+      writer.write_le<u64>(blocks.size());
+      for (const Block &block: blocks) {
+        for (const u32 word: block.words) writer.write_le(word);
+      }
+      return writer.take();
+    }
+
+    [[nodiscard]] static auto deserialize(const Span<const u8> bytes) -> Result<BloomFilter, DecodeError> {
+      ByteCursor cursor{bytes};
+      if (auto header = filter::helper::read_header(cursor, MAGIC, VERSION); header.is_err()) {
+        return header.take_err_unchecked();
+      }
+
+      auto count = cursor.read_le<u64>();
+      if (count.is_err()) return count.take_err_unchecked();
+      const u64 block_count = count.take_unchecked();
+      if (block_count == 0 or block_count > (u64{1} << 32)) return DecodeError{DecodeError::Kind::Invalid, 5};
+      if (cursor.remaining() / sizeof(Block) < block_count) {
+        return DecodeError{DecodeError::Kind::UnexpectedEnd, cursor.offset()};
+      }
+
+      auto reader = cursor.unchecked(block_count * sizeof(Block)).take_unchecked();
+      Vec<Block> blocks(block_count);
+      for (Block &block: blocks) {
+        for (u32 &word: block.words) word = reader.read_le<u32>();
+      }
+      return BloomFilter{std::move(blocks)};
+    }
+  };
+
+  /**
+   * @brief Set membership with false positives but no false negatives that, unlike BloomFilter, supports removal.
+   *
+   * Cuckoo filter (Fan et al.): a fingerprint of every key is stored in one of two buckets of four, the second
+   * bucket is derived from the first & the fingerprint alone, so fingerprints can be moved between their buckets
+   * to make room without the keys. A lookup reads both buckets & compares their four fingerprints at once.
+   *
+   * The false positive rate is set by the fingerprint size, at most 8 / 2^bits (3% for u8, 0.012% for u16), &
+   * the capacity by the constructor. An insert only fails once the filter is nearly full (about 95% of its slots).
+   * Only keys that were inserted may be removed, removing any other key may remove the fingerprint of a key that
+   * collides with it.
+   *
+   * @code
+   * crab::CuckooFilter<String> sessions{100'000};
+   * sessions.insert(token);
+   * sessions.remove(token);
+   * @endcode
+   */
+  template<typename T, typename Hash = std::hash<T>, typename Fingerprint = u16>
+    requires std::same_as<Fingerprint, u8> or std::same_as<Fingerprint, u16>
+  class CuckooFilter {
+    static constexpr usize SLOTS = 4;
+    // moves of fingerprints an insert tries before the filter counts as full
+    static constexpr usize MAX_KICKS = 500;
+
+    static constexpr std::array<u8, 4> MAGIC{'C', 'R', 'C', 'F'};
+    static constexpr u8 VERSION = 1;
+
+    // the four fingerprints of a bucket as one integer, with the lowest & highest bit of every fingerprint
+    using Bucket = bytes::helper::unsigned_of<SLOTS * sizeof(Fingerprint)>;
+    static constexpr Bucket LOW = static_cast<Bucket>(~Bucket{0} / std::numeric_limits<Fingerprint>::max());
+    static constexpr Bucket HIGH = static_cast<Bucket>(LOW << (8 * sizeof(Fingerprint) - 1));
+
+    struct Victim {
+      usize bucket;
+      Fingerprint fingerprint;
+    };
+
+    // SLOTS fingerprints per bucket, 0 is an empty slot
+    Vec<Fingerprint> slots;
+    usize mask;
+    usize count = 0;
+    // the fingerprint left without a slot by the insert that filled the filter
+    Option<Victim> victim;
+    u64 random = 0x853c'49e6'748f'ea9b;
+    [[no_unique_address]] Hash hasher;
+
+    CuckooFilter(Vec<Fingerprint> slots, const usize count, Option<Victim> victim)
+      : slots{std::move(slots)}, mask{this->slots.size() / SLOTS - 1}, count{count}, victim{std::move(victim)} {}
+
+    struct Position {
+      usize bucket;
+      Fingerprint fingerprint;
+    };
+
+    [[nodiscard]] __always_inline auto position(const T &key) const -> Position {
+      const u64 hash = filter::helper::mix(static_cast<u64>(hasher(key)));
+      const auto fingerprint = static_cast<Fingerprint>(hash);
+      return {static_cast<usize>(hash >> 32) & mask, fingerprint == 0 ? Fingerprint{1} : fingerprint};
+    }
+
+    /**
+     * @brief The other bucket of 'fingerprint', an involution: the alternative of the alternative is 'bucket'
+     */
+    [[nodiscard]] __always_inline auto alternative(const usize bucket, const Fingerprint fingerprint) const -> usize {
+      return (bucket ^ static_cast<usize>(u64{fingerprint} * 0x5bd1'e995)) & mask;
+    }
+
+    [[nodiscard]] __always_inline auto has(const usize bucket, const Fingerprint fingerprint) const -> bool {
+      Bucket fingerprints;
+      std::memcpy(&fingerprints, slots.data() + bucket * SLOTS, sizeof(Bucket));
+      // a slot equal to 'fingerprint' is a zero lane after the xor (Mycroft's has-zero-byte test)
+      const auto lanes = static_cast<Bucket>(fingerprints ^ static_cast<Bucket>(LOW * fingerprint));
+      return (static_cast<Bucket>(lanes - LOW) & static_cast<Bucket>(~lanes) & HIGH) != 0;
+    }
+
+    [[nodiscard]] __always_inline auto contains_at(const Position at) const -> bool {
+      if (has(at.bucket, at.fingerprint) or has(alternative(at.bucket, at.fingerprint), at.fingerprint)) return true;
+      if (victim.is_none()) return false;
+      const Victim &left = victim.get_unchecked();
+      return left.fingerprint == at.fingerprint
+             and (left.bucket == at.bucket or left.bucket == alternative(at.bucket, at.fingerprint));
+    }
+
+    auto next_random() -> u64 {
+      random ^= random << 13;
+      random ^= random >> 7;
+      random ^= random << 17;
+      return random;
+    }
+
+    auto place(const usize bucket, const Fingerprint fingerprint) -> bool {
+      for (usize i = 0; i < SLOTS; i++) {
+        if (Fingerprint &slot = slots[bucket * SLOTS + i]; slot == 0) {
+          slot = fingerprint;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    auto erase(const usize bucket, const Fingerprint fingerprint) -> bool {
+      for (usize i = 0; i < SLOTS; i++) {
+        if (Fingerprint &slot = slots[bucket * SLOTS + i]; slot == fingerprint) {
+          slot = 0;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * @brief Places 'fingerprint' in 'bucket' or its alternative, evicting fingerprints to their alternatives if
+     * both are full, the fingerprint left over is kept in 'victim' if no room was found in MAX_KICKS moves
+     */
+    auto insert_at(usize bucket, Fingerprint fingerprint) -> void {
+      if (place(bucket, fingerprint) or place(alternative(bucket, fingerprint), fingerprint)) return;
+      if (next_random() & 1) bucket = alternative(bucket, fingerprint);
+      for (usize kick = 0; kick < MAX_KICKS; kick++) {
+        // the evicted fingerprint was in 'bucket', its other bucket is where it may have room
+        std::swap(fingerprint, slots[bucket * SLOTS + next_random() % SLOTS]);
+        bucket = alternative(bucket, fingerprint);
+        if (place(bucket, fingerprint)) return;
+      }
+      victim = Victim{bucket, fingerprint};
+    }
+
+  public:
+    /**
+     * @brief An empty filter with room for about 'capacity' keys
+     */
+    explicit CuckooFilter(const usize capacity)
+      : slots(SLOTS * std::bit_ceil(std::max<usize>((capacity * 20 / 19 + SLOTS - 1) / SLOTS, 1))),
+        mask{slots.size() / SLOTS - 1} {}
+
+    /**
+     * @brief Upper bound of the false positive rate, reached when the filter is full
+     */
+    [[nodiscard]] static constexpr auto false_positive_rate() -> f64 {
+      return f64{2 * SLOTS} / static_cast<f64>(std::numeric_limits<Fingerprint>::max());
+    }
+
+    /**
+     * @brief Adds 'key', false (without adding it) if the filter is full
+     */
+    auto insert(const T &key) -> bool {
+      if (victim.is_some()) return false;
+      const auto [bucket, fingerprint] = position(key);
+      insert_at(bucket, fingerprint);
+      count++;
+      return true;
+    }
+
+    /**
+     * @brief False if 'key' was never inserted (or was removed), true if it was or (at the false positive rate)
+     * was not
+     */
+    [[nodiscard]] __always_inline auto contains(const T &key) const -> bool { return contains_at(position(key)); }
+
+    /**
+     * @brief found[i] = contains(keys[i]) for every key & how many were found, see BloomFilter::contains_many
+     */
+    auto contains_many(const Span<const T> keys, const Span<bool> found) const -> usize {
+      debug_assert(found.size() >= keys.size(), "Output has less room than there are keys");
+      usize total = 0;
+      std::array<Position, filter::helper::BATCH> positions;
+      for (usize start = 0; start < keys.size(); start += filter::helper::BATCH) {
+        const usize batch = std::min(filter::helper::BATCH, keys.size() - start);
+        for (usize i = 0; i < batch; i++) {
+          const Position at = positions[i] = position(keys[start + i]);
+          __builtin_prefetch(slots.data() + at.bucket * SLOTS);
+          __builtin_prefetch(slots.data() + alternative(at.bucket, at.fingerprint) * SLOTS);
+        }
+        for (usize i = 0; i < batch; i++) {
+          found[start + i] = contains_at(positions[i]);
+          total += found[start + i];
+        }
+      }
+      return total;
+    }
+
+    /**
+     * @brief Removes one insert of 'key', false if it was not found. 'key' must have been inserted.
+     */
+    auto remove(const T &key) -> bool {
+      const auto [bucket, fingerprint] = position(key);
+      const usize other = alternative(bucket, fingerprint);
+      if (victim.is_some()) {
+        if (const Victim left = victim.get_unchecked(); left.fingerprint == fingerprint
+                                                        and (left.bucket == bucket or left.bucket == other)) {
+          victim = crab::none;
+          count--;
+          return true;
+        }
+      }
+      if (not erase(bucket, fingerprint) and not erase(other, fingerprint)) return false;
+      count--;
+      // a slot was freed, room for the fingerprint that did not fit
+      if (victim.is_some()) {
+        const Victim left = victim.take_unchecked();
+        insert_at(left.bucket, left.fingerprint);
+      }
+      return true;
+    }
+
+    /**
+     * @brief Inserts not yet removed, counting the ones of equal keys separately
+     */
+    [[nodiscard]] auto size() const -> usize { return count; }
+
+    [[nodiscard]] auto capacity() const -> usize { return slots.size(); }
+
+    /**
+     * @brief Whether inserts fail, after an insert found no room by moving fingerprints
+     */
+    [[nodiscard]] auto is_full() const -> bool { return victim.is_some(); }
+
+    /**
+     * @brief Size of the filter in bytes
+     */
+    [[nodiscard]] auto memory() const -> usize { return slots.size() * sizeof(Fingerprint); }
+
+    /**
+     * @brief "CRCF", a version byte, the fingerprint size, the bucket & key counts (u64), the victim (a presence
+     * byte, its bucket as u64 & fingerprint) & the fingerprints, integers in little endian
+     */
+    [[nodiscard]] auto serialize() const -> Vec<u8> {
+      ByteWriter writer{32 + memory()};
+      writer.write_bytes(MAGIC);
+      writer.write(VERSION);
+      writer.write(static_cast<u8>(sizeof(Fingerprint)));
+      writer.write_le<u64>(slots.size() / SLOTS);
+      writer.write_le<u64>(count);
+      writer.write(static_cast<u8>(victim.is_some()));
+      writer.write_le<u64>(victim.is_some() ? victim.get_unchecked().bucket : 0);
+      writer.write_le<Fingerprint>(victim.is_some() ? victim.get_unchecked().fingerprint : 0);
+      for (const Fingerprint fingerprint: slots) writer.write_le(fingerprint);
+      return writer.take();
+    }
+
+    [[nodiscard]] static auto deserialize(const Span<const u8> bytes) -> Result<CuckooFilter, DecodeError> {
+      ByteCursor cursor{bytes};
+      if (auto header = filter::helper::read_header(cursor, MAGIC, VERSION); header.is_err()) {
+        return header.take_err_unchecked();
+      }
+
+      constexpr usize FIELDS = 1 + 2 * sizeof(u64) + 1 + sizeof(u64) + sizeof(Fingerprint);
+      auto fields = cursor.unchecked(FIELDS);
+      if (fields.is_err()) return fields.take_err_unchecked();
+      auto reader = fields.take_unchecked();
+      const auto size = reader.read<u8>();
+      const auto buckets = reader.read_le<u64>();
+      const auto count = reader.read_le<u64>();
+      const auto has_victim = reader.read<u8>();
+      const auto victim_bucket = reader.read_le<u64>();
+      const auto victim_fingerprint = reader.read_le<Fingerprint>();
+
+      const bool valid = size == sizeof(Fingerprint) and std::has_single_bit(buckets) and has_victim <= 1
+                         and buckets <= std::numeric_limits<usize>::max() / SLOTS and victim_bucket < buckets;
+      if (not valid) return DecodeError{DecodeError::Kind::Invalid, 5};
+      if (cursor.remaining() / SLOTS / sizeof(Fingerprint) < buckets) {
+        return DecodeError{DecodeError::Kind::UnexpectedEnd, cursor.offset()};
+      }
+
+      auto fingerprints = cursor.unchecked(buckets * SLOTS * sizeof(Fingerprint)).take_unchecked();
+      Vec<Fingerprint> slots(buckets * SLOTS);
+      for (Fingerprint &slot: slots) slot = fingerprints.read_le<Fingerprint>();
+      Option<Victim> victim;
+      if (has_victim) victim = Victim{victim_bucket, victim_fingerprint};
+      return CuckooFilter{std::move(slots), count, std::move(victim)};
+    }
+  };
+}
@@ -0,0 +1,385 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/simd.hpp"
+#include "option.hpp"
+#include "ref.hpp"
+
+namespace crab::flat {
+  /**
+   * @brief Up to this many keys are searched with a linear SIMD scan, past it a branchless binary search is used
+   */
+  inline constexpr usize LINEAR_SEARCH_MAX = 64;
+
+  namespace helper {
+    /**
+     * @brief std::lower_bound without a data dependent branch in the loop, the halving sequence only
+     * depends on the length so the loop is predicted perfectly and the loads can be issued early.
+     */
+    template<typename K, typename Compare>
+    [[nodiscard]] __always_inline auto branchless_lower_bound(
+      const K *data,
+      const usize len,
+      const K &key,
+      const Compare &comp
+    ) -> usize {
+      if (len == 0) return 0;
+
+      const K *base = data;
+      usize n = len;
+      while (n > 1) {
+        const usize half = n / 2;
+        base = comp(base[half], key) ? base + half : base;
+        n -= half;
+      }
+      return static_cast<usize>(base - data) + static_cast<usize>(comp(*base, key));
+    }
+
+    template<typename K, typename Compare>
+    [[nodiscard]] __always_inline auto lower_bound(
+      const K *data,
+      const usize len,
+      const K &key,
+      const Compare &comp
+    ) -> usize {
+      if constexpr (simd::searchable<K> and (std::same_as<Compare, std::less<K>> or
+                                             std::same_as<Compare, std::less<>>)) {
+        if (len <= LINEAR_SEARCH_MAX) {
+          return simd::count_less(data, len, key);
+        }
+      }
+      return branchless_lower_bound(data, len, key, comp);
+    }
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Ordered key-value collection stored as two sorted contiguous arrays (keys & values kept apart
+   * so a lookup only touches key memory).
+   *
+   * Meant for small, read-mostly maps where a hash table's per-entry overhead dominates, single
+   * insertions & removals are O(n), prefer insert_batch when adding many entries.
+   */
+  template<typename K, typename V, typename Compare = std::less<K>>
+    requires std::movable<K> and std::movable<V>
+  class FlatMap {
+    Vec<K> key_data;
+    Vec<V> value_data;
+    [[no_unique_address]] Compare comp{};
+
+  public:
+    /**
+     * @brief Cursor over the entries of a FlatMap in ascending key order
+     */
+    template<bool IS_CONST>
+    class Iterator {
+      friend class FlatMap;
+
+      using MapPtr = std::conditional_t<IS_CONST, const FlatMap*, FlatMap*>;
+      using ValueRef = std::conditional_t<IS_CONST, const V&, V&>;
+
+      MapPtr map = nullptr;
+      usize index = 0;
+
+      __always_inline Iterator(MapPtr map, const usize index) : map{map}, index{index} {}
+
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = std::pair<const K&, ValueRef>;
+      using reference = value_type;
+
+      Iterator() = default;
+
+      [[nodiscard]] __always_inline auto operator*() const -> reference {
+        return {map->key_data[index], map->value_data[index]};
+      }
+
+      __always_inline auto operator++() -> Iterator& {
+        ++index;
+        return *this;
+      }
+
+      __always_inline auto operator++(int) -> Iterator {
+        Iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator==(const Iterator &a, const Iterator &b) -> bool {
+        return a.index == b.index;
+      }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(Compare comp) : comp{std::move(comp)} {}
+
+    FlatMap(std::initializer_list<std::pair<K, V>> entries) requires std::copy_constructible<K> and
+                                                                   std::copy_constructible<V> {
+      insert_batch(Vec<std::pair<K, V>>{entries});
+    }
+
+    /**
+     * @brief Amount of entries in the map
+     */
+    [[nodiscard]] __always_inline auto length() const -> usize { return key_data.size(); }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return key_data.empty(); }
+
+    auto reserve(const usize capacity) -> void {
+      key_data.reserve(capacity);
+      value_data.reserve(capacity);
+    }
+
+    auto clear() -> void {
+      key_data.clear();
+      value_data.clear();
+    }
+
+    /**
+     * @brief Inserts a key-value pair, if the key was already present its value is replaced and the previous
+     * value is returned.
+     */
+    auto insert(K key, V value) -> Option<V> {
+      const usize index = position(key);
+      if (index < length() and not comp(key, key_data[index])) {
+        return crab::some(std::exchange(value_data[index], std::move(value)));
+      }
+
+      key_data.insert(key_data.begin() + static_cast<std::ptrdiff_t>(index), std::move(key));
+      value_data.insert(value_data.begin() + static_cast<std::ptrdiff_t>(index), std::move(value));
+      return crab::none;
+    }
+
+    /**
+     * @brief Inserts many entries at once with a single sort & merge instead of one shift per entry,
+     * when a key appears more than once the last occurrence wins.
+     */
+    auto insert_batch(Vec<std::pair<K, V>> entries) -> void {
+      if (entries.empty()) return;
+
+      std::stable_sort(
+        entries.begin(),
+        entries.end(),
+        [this](const auto &a, const auto &b) { return comp(a.first, b.first); }
+      );
+
+      Vec<K> keys;
+      Vec<V> values;
+      keys.reserve(length() + entries.size());
+      values.reserve(length() + entries.size());
+
+      usize old = 0;
+      for (usize i = 0; i < entries.size(); i++) {
+        // only the last of a run of equal keys is kept
+        if (i + 1 < entries.size() and not comp(entries[i].first, entries[i + 1].first)) continue;
+
+        K &key = entries[i].first;
+        while (old < length() and comp(key_data[old], key)) {
+          keys.push_back(std::move(key_data[old]));
+          values.push_back(std::move(value_data[old]));
+          old++;
+        }
+        if (old < length() and not comp(key, key_data[old])) {
+          old++;
+        }
+        keys.push_back(std::move(key));
+        values.push_back(std::move(entries[i].second));
+      }
+
+      for (; old < length(); old++) {
+        keys.push_back(std::move(key_data[old]));
+        values.push_back(std::move(value_data[old]));
+      }
+
+      key_data = std::move(keys);
+      value_data = std::move(values);
+    }
+
+    /**
+     * @brief Removes a key from the map, returning the value it held if it was present
+     */
+    auto remove(const K &key) -> Option<V> {
+      const usize index = position(key);
+      if (index >= length() or comp(key, key_data[index])) {
+        return crab::none;
+      }
+
+      V value{std::move(value_data[index])};
+      key_data.erase(key_data.begin() + static_cast<std::ptrdiff_t>(index));
+      value_data.erase(value_data.begin() + static_cast<std::ptrdiff_t>(index));
+      return crab::some(std::move(value));
+    }
+
+    /**
+     * @brief Gets a reference to the value with the given key, if it exists
+     */
+    [[nodiscard]] auto get(const K &key) const -> Option<Ref<V>> {
+      const usize index = position(key);
+      if (index < length() and not comp(key, key_data[index])) {
+        return crab::some(Ref<V>{value_data[index]});
+      }
+      return crab::none;
+    }
+
+    /**
+     * @brief Gets a mutable reference to the value with the given key, if it exists
+     */
+    [[nodiscard]] auto get_mut(const K &key) -> Option<RefMut<V>> {
+      const usize index = position(key);
+      if (index < length() and not comp(key, key_data[index])) {
+        return crab::some(RefMut<V>{value_data[index]});
+      }
+      return crab::none;
+    }
+
+    [[nodiscard]] auto contains(const K &key) const -> bool {
+      const usize index = position(key);
+      return index < length() and not comp(key, key_data[index]);
+    }
+
+    /**
+     * @brief Index of the first key that is not less than 'key', this is also an index into keys() & values()
+     */
+    [[nodiscard]] auto position(const K &key) const -> usize {
+      return flat::helper::lower_bound(key_data.data(), key_data.size(), key, comp);
+    }
+
+    /**
+     * @brief All keys in ascending order
+     */
+    [[nodiscard]] auto keys() const -> Span<const K> { return key_data; }
+
+    /**
+     * @brief All values, values()[i] belongs to keys()[i]
+     */
+    [[nodiscard]] auto values() const -> Span<const V> { return value_data; }
+
+    /**
+     * @brief All values, values_mut()[i] belongs to keys()[i]
+     */
+    [[nodiscard]] auto values_mut() -> Span<V> { return value_data; }
+
+    [[nodiscard]] auto begin() -> iterator { return iterator{this, 0}; }
+
+    [[nodiscard]] auto begin() const -> const_iterator { return const_iterator{this, 0}; }
+
+    [[nodiscard]] auto end() -> iterator { return iterator{this, length()}; }
+
+    [[nodiscard]] auto end() const -> const_iterator { return const_iterator{this, length()}; }
+  };
+
+  /**
+   * @brief Ordered set stored as a single sorted contiguous array, see FlatMap
+   */
+  template<typename K, typename Compare = std::less<K>>
+    requires std::movable<K>
+  class FlatSet {
+    Vec<K> key_data;
+    [[no_unique_address]] Compare comp{};
+
+  public:
+    FlatSet() = default;
+
+    explicit FlatSet(Compare comp) : comp{std::move(comp)} {}
+
+    FlatSet(std::initializer_list<K> keys) requires std::copy_constructible<K> {
+      insert_batch(Vec<K>{keys});
+    }
+
+    [[nodiscard]] __always_inline auto length() const -> usize { return key_data.size(); }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return key_data.empty(); }
+
+    auto reserve(const usize capacity) -> void { key_data.reserve(capacity); }
+
+    auto clear() -> void { key_data.clear(); }
+
+    /**
+     * @brief Inserts a key, returns false if the key was already in the set
+     */
+    auto insert(K key) -> bool {
+      const usize index = position(key);
+      if (index < length() and not comp(key, key_data[index])) {
+        return false;
+      }
+      key_data.insert(key_data.begin() + static_cast<std::ptrdiff_t>(index), std::move(key));
+      return true;
+    }
+
+    /**
+     * @brief Inserts many keys at once with a single sort & merge
+     */
+    auto insert_batch(Vec<K> keys) -> void {
+      if (keys.empty()) return;
+
+      std::sort(keys.begin(), keys.end(), comp);
+
+      Vec<K> merged;
+      merged.reserve(length() + keys.size());
+      std::merge(
+        std::make_move_iterator(key_data.begin()),
+        std::make_move_iterator(key_data.end()),
+        std::make_move_iterator(keys.begin()),
+        std::make_move_iterator(keys.end()),
+        std::back_inserter(merged),
+        comp
+      );
+      merged.erase(
+        std::unique(
+          merged.begin(),
+          merged.end(),
+          [this](const K &a, const K &b) { return not comp(a, b) and not comp(b, a); }
+        ),
+        merged.end()
+      );
+
+      key_data = std::move(merged);
+    }
+
+    /**
+     * @brief Removes a key, returns whether the key was in the set
+     */
+    auto remove(const K &key) -> bool {
+      const usize index = position(key);
+      if (index >= length() or comp(key, key_data[index])) {
+        return false;
+      }
+      key_data.erase(key_data.begin() + static_cast<std::ptrdiff_t>(index));
+      return true;
+    }
+
+    [[nodiscard]] auto contains(const K &key) const -> bool {
+      const usize index = position(key);
+      return index < length() and not comp(key, key_data[index]);
+    }
+
+    /**
+     * @brief Index of the first key that is not less than 'key'
+     */
+    [[nodiscard]] auto position(const K &key) const -> usize {
+      return flat::helper::lower_bound(key_data.data(), key_data.size(), key, comp);
+    }
+
+    /**
+     * @brief All keys in ascending order
+     */
+    [[nodiscard]] auto as_span() const -> Span<const K> { return key_data; }
+
+    [[nodiscard]] auto begin() const -> typename Vec<K>::const_iterator { return key_data.begin(); }
+
+    [[nodiscard]] auto end() const -> typename Vec<K>::const_iterator { return key_data.end(); }
+  };
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/pool.hpp"
+#include "option.hpp"
+#include "ref.hpp"
+
+namespace crab::generator::helper {
+  /**
+   * @brief Awaiter for 'co_yield' of an lvalue in a Generator of values, keeps a copy alive in the coroutine frame
+   * until the consumer resumes it
+   */
+  template<typename T>
+  struct CopyAwaiter {
+    T copy;
+    T **slot;
+
+    [[nodiscard]] static constexpr auto await_ready() noexcept -> bool { return false; }
+
+    auto await_suspend(std::coroutine_handle<>) noexcept -> void { *slot = std::addressof(copy); }
+
+    static constexpr auto await_resume() noexcept -> void {}
+  };
+}
+
+namespace crab {
+  /**
+   * @brief Lazily produced sequence written as a coroutine, usable in range-for & as a std::ranges::input_range /
+   * view.
+   *
+   * Generator<T> yields rvalues that can be moved out of (like std::generator), Generator<const T&> /
+   * Generator<T&> hand out references to whatever was yielded, nothing is copied. Coroutine frames come from the
+   * per-thread crab::pool, so short lived generators recycle the same few blocks instead of hitting the heap.
+   *
+   * @code
+   * auto evens(const u32 max) -> crab::Generator<u32> {
+   *   for (u32 i = 0; i < max; i += 2) co_yield i;
+   * }
+   *
+   * for (const u32 even: evens(10)) ...
+   * @endcode
+   */
+  template<typename T>
+  class Generator : public std::ranges::view_interface<Generator<T>> {
+  public:
+    using value_type = std::remove_cvref_t<T>;
+    using reference = std::conditional_t<std::is_reference_v<T>, T, T&&>;
+
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct promise_type {
+      std::add_pointer_t<reference> value = nullptr;
+      std::exception_ptr exception;
+
+      [[nodiscard]] auto get_return_object() noexcept -> Generator { return Generator{Handle::from_promise(*this)}; }
+
+      [[nodiscard]] static constexpr auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+
+      [[nodiscard]] static constexpr auto final_suspend() noexcept -> std::suspend_always { return {}; }
+
+      auto yield_value(reference yielded) noexcept -> std::suspend_always {
+        value = std::addressof(yielded);
+        return {};
+      }
+
+      auto yield_value(const value_type &yielded) -> generator::helper::CopyAwaiter<value_type>
+        requires (not std::is_reference_v<T> and std::copy_constructible<value_type>) {
+        return {yielded, &value};
+      }
+
+      static constexpr auto return_void() noexcept -> void {}
+
+      auto unhandled_exception() noexcept -> void { exception = std::current_exception(); }
+
+      // generators only produce values, awaiting inside of one is an error
+      template<typename U>
+      auto await_transform(U &&) -> std::suspend_never = delete;
+
+      /**
+       * @brief Runs the coroutine until its next co_yield (or its end), rethrowing anything it threw
+       */
+      auto resume() -> void {
+        Handle::from_promise(*this).resume();
+        if (exception) std::rethrow_exception(std::exchange(exception, nullptr));
+      }
+
+      [[nodiscard]] static auto operator new(const usize bytes) -> void* { return pool::allocate(bytes); }
+
+      static auto operator delete(void *frame, const usize bytes) -> void { pool::deallocate(frame, bytes); }
+    };
+
+    class Iterator {
+      Handle handle = nullptr;
+
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = Generator::value_type;
+
+      Iterator() = default;
+
+      explicit Iterator(const Handle handle) : handle{handle} {}
+
+      [[nodiscard]] auto operator*() const -> reference {
+        debug_assert(not handle.done(), "Cannot dereference a finished Generator");
+        return static_cast<reference>(*handle.promise().value);
+      }
+
+      auto operator++() -> Iterator& {
+        handle.promise().resume();
+        return *this;
+      }
+
+      auto operator++(int) -> void { ++*this; }
+
+      [[nodiscard]] friend auto operator==(const Iterator &iterator, std::default_sentinel_t) -> bool {
+        return iterator.handle.done();
+      }
+    };
+
+    Generator() = default;
+
+    Generator(const Generator &) = delete;
+
+    Generator(Generator &&from) noexcept : handle{std::exchange(from.handle, nullptr)} {}
+
+    auto operator=(const Generator &) -> Generator& = delete;
+
+    auto operator=(Generator &&from) noexcept -> Generator& {
+      if (this != &from) {
+        if (handle) handle.destroy();
+        handle = std::exchange(from.handle, nullptr);
+      }
+      return *this;
+    }
+
+    ~Generator() {
+      if (handle) handle.destroy();
+    }
+
+    /**
+     * @brief Starts the coroutine & runs it to its first value, a Generator is single pass so this is only called
+     * once (and not mixed with next())
+     */
+    [[nodiscard]] auto begin() -> Iterator {
+      debug_assert(handle, "Cannot iterate a moved from Generator");
+      handle.promise().resume();
+      return Iterator{handle};
+    }
+
+    [[nodiscard]] static constexpr auto end() noexcept -> std::default_sentinel_t { return std::default_sentinel; }
+
+    /**
+     * @brief Produces the next value, None once the coroutine returned. Generators of values move the yielded value
+     * out, generators of references give a Ref / RefMut to it.
+     */
+    [[nodiscard]] auto next() -> Option<typename ref::decay_type<T>::type> {
+      debug_assert(handle, "Cannot iterate a moved from Generator");
+      if (handle.done()) return crab::none;
+
+      handle.promise().resume();
+      if (handle.done()) return crab::none;
+
+      if constexpr (std::is_reference_v<T>) {
+        return crab::some(typename ref::decay_type<T>::type{*handle.promise().value});
+      } else {
+        return crab::some(value_type{std::move(*handle.promise().value)});
+      }
+    }
+
+    /**
+     * @brief Whether the coroutine has returned
+     */
+    [[nodiscard]] auto is_done() const -> bool { return not handle or handle.done(); }
+
+  private:
+    Handle handle = nullptr;
+
+    explicit Generator(const Handle handle) : handle{handle} {}
+  };
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <functional>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "preamble.hpp"
+#include "option.hpp"
+#include "ref.hpp"
+#include "crab/debug.hpp"
+
+namespace crab::heap {
+  inline constexpr usize CACHE_LINE = 64;
+
+  namespace helper {
+    /**
+     * @brief Allocator that places the first element just before a cache line boundary, so that in a d-ary heap
+     * (children of node i at D * i + 1 onwards) the children of every node start on one (LaMarca & Ladner). With
+     * D * sizeof(T) a multiple or a divisor of the cache line, siblings never straddle two lines.
+     */
+    template<typename T>
+    struct ChildAlignedAllocator {
+      using value_type = T;
+
+      static constexpr usize OFFSET = sizeof(T) < CACHE_LINE ? CACHE_LINE - sizeof(T) : 0;
+
+      ChildAlignedAllocator() = default;
+
+      template<typename U>
+      constexpr ChildAlignedAllocator(const ChildAlignedAllocator<U> &) noexcept {}
+
+      [[nodiscard]] auto allocate(const usize count) -> T* {
+        auto *bytes = static_cast<u8*>(::operator new(count * sizeof(T) + OFFSET, std::align_val_t{CACHE_LINE}));
+        return reinterpret_cast<T*>(bytes + OFFSET);
+      }
+
+      auto deallocate(T *pointer, const usize) noexcept -> void {
+        ::operator delete(reinterpret_cast<u8*>(pointer) - OFFSET, std::align_val_t{CACHE_LINE});
+      }
+
+      [[nodiscard]] friend constexpr auto operator==(const ChildAlignedAllocator &, const ChildAlignedAllocator &)
+        -> bool {
+        return true;
+      }
+    };
+
+    template<typename T>
+    using Storage = std::vector<T, ChildAlignedAllocator<T>>;
+
+    /**
+     * @brief Index of the least of the children [first, last)
+     *
+     * Which child wins is a coin flip, so small values are carried in a register, which the compiler turns into
+     * conditional moves (a min) instead of a branch mispredicted half the time. Not __always_inline, which inlines it
+     * before that rewrite & leaves the branch in.
+     */
+    template<typename T, typename Less>
+    [[nodiscard]] auto least_child(const T *data, const usize first, const usize last, const Less &less) -> usize {
+      usize least = first;
+      if constexpr (std::is_trivially_copy_constructible_v<T> and sizeof(T) <= 2 * sizeof(u64)) {
+        T best = data[first];
+        for (usize child = first + 1; child < last; child++) {
+          const bool smaller = less(data[child], best);
+          least = smaller ? child : least;
+          best = smaller ? data[child] : best;
+        }
+      } else {
+        for (usize child = first + 1; child < last; child++) {
+          if (less(data[child], data[least])) least = child;
+        }
+      }
+      return least;
+    }
+
+    /**
+     * @brief Moves data[index] towards the root past every parent it is 'less' than, moving those parents down into
+     * the hole it leaves, 'placed(element, index)' is told every element's new index
+     */
+    template<usize D, typename T, typename Less, typename Placed>
+    __always_inline auto sift_up(T *data, usize index, const Less &less, const Placed &placed) -> void {
+      T value = std::move(data[index]);
+      while (index > 0) {
+        const usize parent = (index - 1) / D;
+        if (not less(value, data[parent])) break;
+        data[index] = std::move(data[parent]);
+        placed(data[index], index);
+        index = parent;
+      }
+      data[index] = std::move(value);
+      placed(data[index], index);
+    }
+
+    /**
+     * @brief Removes the root & puts 'value' (the former last element) in its place, see sift_up
+     *
+     * Floyd's bottom-up variant, as in std::pop_heap: the hole at the root follows the least children all the way
+     * to a leaf & 'value' is sifted up from there. The last element almost always belongs near the leaves, so this
+     * saves comparing it against the least child on every level on the way down.
+     */
+    template<usize D, typename T, typename Less, typename Placed>
+    __always_inline auto replace_root(
+      T *data,
+      const usize len,
+      T value,
+      const Less &less,
+      const Placed &placed
+    ) -> void {
+      usize index = 0;
+      while (D * index + 1 < len) {
+        const usize first = D * index + 1;
+        const usize least = least_child(data, first, std::min(first + D, len), less);
+        data[index] = std::move(data[least]);
+        placed(data[index], index);
+        index = least;
+      }
+      data[index] = std::move(value);
+      sift_up<D>(data, index, less, placed);
+    }
+
+    inline constexpr auto UNTRACKED = [](const auto &, usize) {};
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Priority queue popping the least element first (by 'Compare'), the opposite order of
+   * std::priority_queue.
+   *
+   * A D-ary heap: a node has D children instead of 2, so the heap is log2(D) times shallower & a pop walks that
+   * many fewer levels, each one comparing D siblings that lie in the same cache line (see
+   * heap::helper::ChildAlignedAllocator). D = 4 is a good default, wider only pays off for small elements.
+   *
+   * @code
+   * crab::DaryHeap<std::pair<u64, u32>> events;
+   * events.push({deadline, connection});
+   * for (auto next = events.pop(); next.is_some(); next = events.pop()) fire(next.take_unchecked());
+   * @endcode
+   */
+  template<typename T, usize D = 4, typename Compare = std::less<T>>
+    requires (D >= 2) and std::is_move_constructible_v<T> and std::is_move_assignable_v<T>
+  class DaryHeap {
+    heap::helper::Storage<T> elements;
+    [[no_unique_address]] Compare comp;
+
+  public:
+    explicit DaryHeap(Compare comp = {}) : comp{std::move(comp)} {}
+
+    [[nodiscard]] auto size() const -> usize { return elements.size(); }
+
+    [[nodiscard]] auto is_empty() const -> bool { return elements.empty(); }
+
+    auto reserve(const usize capacity) -> void { elements.reserve(capacity); }
+
+    auto clear() -> void { elements.clear(); }
+
+    auto push(T value) -> void {
+      elements.push_back(std::move(value));
+      heap::helper::sift_up<D>(elements.data(), elements.size() - 1, comp, heap::helper::UNTRACKED);
+    }
+
+    /**
+     * @brief The least element, without removing it
+     */
+    [[nodiscard]] auto peek() const -> Option<Ref<T>> {
+      if (is_empty()) return crab::none;
+      return crab::some(Ref<T>{elements.front()});
+    }
+
+    /**
+     * @brief Removes & returns the least element
+     */
+    [[nodiscard]] auto pop() -> Option<T> {
+      if (is_empty()) return crab::none;
+      T least = std::move(elements.front());
+      T last = std::move(elements.back());
+      elements.pop_back();
+      if (not is_empty()) {
+        heap::helper::replace_root<D>(elements.data(), elements.size(), std::move(last), comp, heap::helper::UNTRACKED);
+      }
+      return crab::some(std::move(least));
+    }
+  };
+
+  /**
+   * @brief DaryHeap of the ids 0 to n - 1 each with a priority, which can be lowered in place (decrease key).
+   *
+   * Every id's position in the heap is tracked, so Dijkstra's algorithm & the like update an entry instead of
+   * pushing duplicates & skipping the stale ones when they are popped. Pops the least priority (by 'Compare')
+   * first.
+   *
+   * @code
+   * crab::IndexedDaryHeap<u64> frontier{vertex_count};
+   * frontier.push(source, 0);
+   * for (auto next = frontier.pop(); next.is_some(); next = frontier.pop()) {
+   *   const auto [vertex, distance] = next.take_unchecked();
+   *   for (const auto &[to, weight]: edges(vertex)) frontier.push_or_decrease(to, distance + weight);
+   * }
+   * @endcode
+   */
+  template<typename Priority, usize D = 4, typename Compare = std::less<Priority>>
+    requires (D >= 2) and std::movable<Priority>
+  class IndexedDaryHeap {
+    struct Entry {
+      Priority priority;
+      u32 id;
+    };
+
+    static constexpr u32 ABSENT = std::numeric_limits<u32>::max();
+
+    heap::helper::Storage<Entry> entries;
+    // heap index of every id, ABSENT if it is not in the heap
+    Vec<u32> positions;
+    [[no_unique_address]] Compare comp;
+
+    [[nodiscard]] __always_inline auto less() const {
+      return [this](const Entry &a, const Entry &b) { return comp(a.priority, b.priority); };
+    }
+
+    [[nodiscard]] __always_inline auto track() {
+      return [this](const Entry &entry, const usize index) { positions[entry.id] = static_cast<u32>(index); };
+    }
+
+  public:
+    /**
+     * @brief An empty heap for the ids 0 to 'ids' - 1
+     */
+    explicit IndexedDaryHeap(const usize ids, Compare comp = {}) : positions(ids, ABSENT), comp{std::move(comp)} {
+      debug_assert(ids < ABSENT, "IndexedDaryHeap holds up to 2^32 - 1 ids");
+    }
+
+    [[nodiscard]] auto size() const -> usize { return entries.size(); }
+
+    [[nodiscard]] auto is_empty() const -> bool { return entries.empty(); }
+
+    [[nodiscard]] auto contains(const usize id) const -> bool { return positions[id] != ABSENT; }
+
+    /**
+     * @brief The priority of 'id', if it is in the heap
+     */
+    [[nodiscard]] auto priority(const usize id) const -> Option<Ref<Priority>> {
+      if (not contains(id)) return crab::none;
+      return crab::some(Ref<Priority>{entries[positions[id]].priority});
+    }
+
+    auto clear() -> void {
+      for (const Entry &entry: entries) positions[entry.id] = ABSENT;
+      entries.clear();
+    }
+
+    /**
+     * @brief Adds 'id', which must not be in the heap
+     */
+    auto push(const usize id, Priority priority) -> void {
+      debug_assert(id < positions.size(), "Id out of the heap's range");
+      debug_assert(not contains(id), "Id is already in the heap, use decrease_key");
+      entries.push_back(Entry{std::move(priority), static_cast<u32>(id)});
+      heap::helper::sift_up<D>(entries.data(), entries.size() - 1, less(), track());
+    }
+
+    /**
+     * @brief Lowers the priority of 'id', which must be in the heap & not have a lower priority already
+     */
+    auto decrease_key(const usize id, Priority priority) -> void {
+      debug_assert(contains(id), "Id is not in the heap");
+      Entry &entry = entries[positions[id]];
+      debug_assert(not comp(entry.priority, priority), "decrease_key cannot raise a priority");
+      entry.priority = std::move(priority);
+      heap::helper::sift_up<D>(entries.data(), positions[id], less(), track());
+    }
+
+    /**
+     * @brief Pushes 'id' or lowers its priority if 'priority' is lower than its current one, whether the heap
+     * changed (the relaxation step of Dijkstra's algorithm)
+     */
+    auto push_or_decrease(const usize id, Priority priority) -> bool {
+      if (not contains(id)) {
+        push(id, std::move(priority));
+        return true;
+      }
+      if (not comp(priority, entries[positions[id]].priority)) return false;
+      decrease_key(id, std::move(priority));
+      return true;
+    }
+
+    /**
+     * @brief Removes & returns the id with the least priority, with its priority
+     */
+    [[nodiscard]] auto pop() -> Option<std::pair<usize, Priority>> {
+      if (is_empty()) return crab::none;
+      Entry least = std::move(entries.front());
+      positions[least.id] = ABSENT;
+      Entry last = std::move(entries.back());
+      entries.pop_back();
+      if (not is_empty()) {
+        heap::helper::replace_root<D>(entries.data(), entries.size(), std::move(last), less(), track());
+      }
+      return crab::some(std::pair<usize, Priority>{least.id, std::move(least.priority)});
+    }
+  };
+
+  /**
+   * @brief Monotone priority queue of unsigned integer keys, each with a value, popping the least key first. Keys
+   * pushed may not be less than the last key popped, which holds for Dijkstra's algorithm & event simulations
+   * (nothing is scheduled in the past).
+   *
+   * Radix heap (Ahuja et al.): entries sit in the bucket of the highest bit in which their key differs from the
+   * last key popped. When bucket 0 (keys equal to the last) is empty, the first non empty bucket is emptied into
+   * lower ones around its least key, every entry moves down at most once per bit of the key, so push is O(1) &
+   * pop amortized O(log C) for keys spanning a range of C, with no comparisons between entries.
+   */
+  template<std::unsigned_integral Key, typename Value = unit>
+    requires std::movable<Value>
+  class RadixHeap {
+    using Entry = std::pair<Key, Value>;
+
+    std::array<Vec<Entry>, std::numeric_limits<Key>::digits + 1> buckets;
+    Key last = 0;
+    usize count = 0;
+
+    [[nodiscard]] __always_inline auto bucket_of(const Key key) const -> usize {
+      return static_cast<usize>(std::bit_width(static_cast<Key>(key ^ last)));
+    }
+
+  public:
+    RadixHeap() = default;
+
+    [[nodiscard]] auto size() const -> usize { return count; }
+
+    [[nodiscard]] auto is_empty() const -> bool { return count == 0; }
+
+    /**
+     * @brief The key pushed keys may not be less than, the last one popped
+     */
+    [[nodiscard]] auto minimum() const -> Key { return last; }
+
+    auto clear() -> void {
+      for (Vec<Entry> &bucket: buckets) bucket.clear();
+      last = 0;
+      count = 0;
+    }
+
+    auto push(const Key key, Value value = {}) -> void {
+      debug_assert(key >= last, "RadixHeap keys may not be less than the last key popped");
+      buckets[bucket_of(key)].emplace_back(key, std::move(value));
+      count++;
+    }
+
+    /**
+     * @brief Removes & returns an entry with the least key, entries with equal keys come out in any order
+     */
+    [[nodiscard]] auto pop() -> Option<Entry> {
+      if (is_empty()) return crab::none;
+      if (buckets[0].empty()) {
+        usize index = 1;
+        while (buckets[index].empty()) index++;
+        Vec<Entry> &from = buckets[index];
+        last = std::ranges::min_element(from, {}, &Entry::first)->first;
+        // every entry shares more high bits with the new least key than with the old one, it lands lower
+        for (Entry &entry: from) buckets[bucket_of(entry.first)].push_back(std::move(entry));
+        from.clear();
+      }
+      count--;
+      Entry least = std::move(buckets[0].back());
+      buckets[0].pop_back();
+      return crab::some(std::move(least));
+    }
+  };
+}
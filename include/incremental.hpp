@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "preamble.hpp"
+#include "box.hpp"
+#include "option.hpp"
+#include "rc.hpp"
+#include "crab/debug.hpp"
+
+namespace crab::incremental {
+  /**
+   * @brief Logical clock of a Database, every input change starts a new revision
+   */
+  using Revision = u64;
+
+  class Database;
+
+  template<typename T>
+  class Input;
+
+  template<typename Key, typename Value>
+  class Query;
+
+  namespace helper {
+    /**
+     * @brief An input or a memoized query result, what queries depend on
+     */
+    class Node {
+    public:
+      Node() = default;
+
+      Node(const Node &) = delete;
+
+      auto operator=(const Node &) -> Node& = delete;
+
+      virtual ~Node() = default;
+
+      /**
+       * @brief Brings the node up to date with its database & tells whether its value changed after 'revision'
+       */
+      virtual auto changed_after(Revision revision) -> bool = 0;
+    };
+
+    /**
+     * @brief Owner of the memoized results of one query
+     */
+    class Table {
+    public:
+      virtual ~Table() = default;
+    };
+
+    /**
+     * @brief Whether a new value can be cut off as unchanged, values without == always count as changed
+     */
+    template<typename T>
+    [[nodiscard]] auto same(const T &a, const T &b) -> bool {
+      if constexpr (std::equality_comparable<T>) {
+        return a == b;
+      } else {
+        return false;
+      }
+    }
+
+    template<typename T>
+    [[nodiscard]] auto share(T value) -> Rc<T> { return Rc<T>::from_owned_unchecked(new T(std::move(value))); }
+
+    template<typename T>
+    class InputNode;
+
+    template<typename Key, typename Value>
+    class QueryTable;
+  }
+
+  /**
+   * @brief Inputs & memoized queries over them, recomputing only what an input change can affect (salsa's red
+   * green algorithm).
+   *
+   * Inputs are set from outside, queries are pure functions of their key & whatever inputs & queries they read.
+   * Reads made while a query runs are recorded as its dependencies. After inputs change, a query result is reused
+   * if none of its dependencies changed since it was last verified, checking them (& recomputing the queries
+   * among them) in the order they were read. A recomputed value that compares equal to the previous one keeps its
+   * old change revision, so the queries depending on it are not recomputed either (early cutoff).
+   *
+   * @code
+   * crab::incremental::Database db;
+   * const auto text = db.input<String>("crab");
+   * const auto length = db.query<u8>([=](u8) { return text.get()->size(); });
+   * length.get(0);     // computed
+   * text.set("crab");  // equal, still the same revision
+   * length.get(0);     // memoized
+   * text.set("crabs");
+   * length.get(0);     // recomputed
+   * @endcode
+   */
+  class Database {
+    template<typename T>
+    friend class Input;
+
+    template<typename Key, typename Value>
+    friend class Query;
+
+    template<typename Key, typename Value>
+    friend class helper::QueryTable;
+
+    Revision current = 1;
+    Vec<Box<helper::Node>> inputs;
+    Vec<Box<helper::Table>> tables;
+    // dependencies read by the queries being computed, innermost last
+    Vec<Vec<helper::Node*>> frames;
+
+    auto record(helper::Node *node) -> void {
+      if (frames.empty()) return;
+      // repeated reads of the same node are common (a loop over an input), they only need checking once
+      if (Vec<helper::Node*> &dependencies = frames.back(); dependencies.empty() or dependencies.back() != node) {
+        dependencies.push_back(node);
+      }
+    }
+
+  public:
+    Database() = default;
+
+    Database(const Database &) = delete;
+
+    auto operator=(const Database &) -> Database& = delete;
+
+    [[nodiscard]] auto revision() const -> Revision { return current; }
+
+    /**
+     * @brief A new input holding 'value'
+     */
+    template<typename T>
+    [[nodiscard]] auto input(T value) -> Input<T>;
+
+    /**
+     * @brief A new memoized query computing 'function(key)', the handles it uses (Input & Query) are captured by
+     * value. Keys need std::hash & ==.
+     */
+    template<typename Key, typename Function>
+      requires std::invocable<Function&, const Key&>
+    [[nodiscard]] auto query(
+      Function function
+    ) -> Query<Key, std::remove_cvref_t<std::invoke_result_t<Function&, const Key&>>>;
+  };
+
+  namespace helper {
+    template<typename T>
+    class InputNode final : public Node {
+    public:
+      Rc<T> value;
+      Revision changed_at;
+
+      InputNode(Rc<T> value, const Revision changed_at) : value{std::move(value)}, changed_at{changed_at} {}
+
+      auto changed_after(const Revision revision) -> bool override { return changed_at > revision; }
+    };
+
+    template<typename Key, typename Value>
+    class Memo final : public Node {
+    public:
+      QueryTable<Key, Value> *table = nullptr;
+      const Key *key = nullptr;
+      Option<Rc<Value>> value;
+      // the last revision the value was known to be up to date in & the one it last changed in
+      Revision verified_at = 0;
+      Revision changed_at = 0;
+      Vec<Node*> dependencies;
+      bool computing = false;
+
+      auto changed_after(const Revision revision) -> bool override {
+        table->refresh(*this);
+        return changed_at > revision;
+      }
+    };
+
+    template<typename Key, typename Value>
+    class QueryTable final : public Table {
+    public:
+      Database *database;
+      std::function<Value(const Key&)> function;
+      Dictionary<Key, Memo<Key, Value>> memos;
+      usize executions = 0;
+
+      QueryTable(Database &database, std::function<Value(const Key&)> function)
+        : database{&database}, function{std::move(function)} {}
+
+      [[nodiscard]] auto memo(const Key &key) -> Memo<Key, Value>& {
+        auto [entry, inserted] = memos.try_emplace(key);
+        if (inserted) {
+          entry->second.table = this;
+          entry->second.key = &entry->first;
+        }
+        return entry->second;
+      }
+
+      auto refresh(Memo<Key, Value> &memo) -> void {
+        debug_assert(not memo.computing, "Cycle between incremental queries");
+        const Revision current = database->current;
+        if (memo.verified_at == current) return;
+
+        if (memo.value.is_some()) {
+          const Revision verified = memo.verified_at;
+          const bool stale = std::ranges::any_of(
+            memo.dependencies,
+            [verified](Node *dependency) { return dependency->changed_after(verified); }
+          );
+          if (not stale) {
+            memo.verified_at = current;
+            return;
+          }
+        }
+
+        // pops the dependency frame & clears the cycle mark even if 'function' throws, leaving the memo as it was
+        struct Computing {
+          Memo<Key, Value> &memo;
+          Vec<Vec<Node*>> &frames;
+
+          Computing(Memo<Key, Value> &memo, Vec<Vec<Node*>> &frames) : memo{memo}, frames{frames} {
+            frames.emplace_back();
+            memo.computing = true;
+          }
+
+          Computing(const Computing &) = delete;
+
+          ~Computing() {
+            frames.pop_back();
+            memo.computing = false;
+          }
+        };
+
+        Value result = [&] {
+          const Computing computing{memo, database->frames};
+          Value value = function(*memo.key);
+          memo.dependencies = std::move(database->frames.back());
+          return value;
+        }();
+        executions++;
+
+        if (memo.value.is_none() or not same(*memo.value.get_unchecked(), result)) {
+          memo.value = share(std::move(result));
+          memo.changed_at = current;
+        }
+        memo.verified_at = current;
+      }
+    };
+  }
+
+  /**
+   * @brief Handle to an input of a Database, cheap to copy into query functions
+   */
+  template<typename T>
+  class Input {
+    Database *database;
+    helper::InputNode<T> *node;
+
+  public:
+    Input(Database &database, helper::InputNode<T> &node) : database{&database}, node{&node} {}
+
+    /**
+     * @brief The current value, a dependency of the query being computed (if any)
+     */
+    [[nodiscard]] auto get() const -> Rc<T> {
+      database->record(node);
+      return node->value;
+    }
+
+    /**
+     * @brief Replaces the value & starts a new revision, unless 'value' equals the current one
+     */
+    auto set(T value) const -> void {
+      debug_assert(database->frames.empty(), "Inputs cannot be set while a query is being computed");
+      if (helper::same(*node->value, value)) return;
+      node->value = helper::share(std::move(value));
+      node->changed_at = ++database->current;
+    }
+
+    /**
+     * @brief The revision the value last changed in
+     */
+    [[nodiscard]] auto changed_at() const -> Revision { return node->changed_at; }
+  };
+
+  /**
+   * @brief Handle to a memoized query of a Database, cheap to copy into other query functions
+   */
+  template<typename Key, typename Value>
+  class Query {
+    helper::QueryTable<Key, Value> *table;
+
+  public:
+    explicit Query(helper::QueryTable<Key, Value> &table) : table{&table} {}
+
+    /**
+     * @brief The value for 'key', reused if nothing it depends on changed, a dependency of the query being
+     * computed (if any)
+     */
+    [[nodiscard]] auto get(const Key &key) const -> Rc<Value> {
+      helper::Memo<Key, Value> &memo = table->memo(key);
+      table->refresh(memo);
+      table->database->record(&memo);
+      return memo.value.get_unchecked();
+    }
+
+    [[nodiscard]] auto operator()(const Key &key) const -> Rc<Value> { return get(key); }
+
+    /**
+     * @brief Times the function ran, over every key
+     */
+    [[nodiscard]] auto executions() const -> usize { return table->executions; }
+  };
+
+  template<typename T>
+  auto Database::input(T value) -> Input<T> {
+    auto node = crab::make_box<helper::InputNode<T>>(helper::share(std::move(value)), current);
+    helper::InputNode<T> &created = *node;
+    inputs.emplace_back(std::move(node));
+    return Input<T>{*this, created};
+  }
+
+  template<typename Key, typename Function>
+    requires std::invocable<Function&, const Key&>
+  auto Database::query(
+    Function function
+  ) -> Query<Key, std::remove_cvref_t<std::invoke_result_t<Function&, const Key&>>> {
+    using Value = std::remove_cvref_t<std::invoke_result_t<Function&, const Key&>>;
+    auto table = crab::make_box<helper::QueryTable<Key, Value>>(*this, std::move(function));
+    helper::QueryTable<Key, Value> &created = *table;
+    tables.emplace_back(std::move(table));
+    return Query<Key, Value>{created};
+  }
+}
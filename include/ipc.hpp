@@ -0,0 +1,271 @@
+#pragma once
+
+#include "preamble.hpp"
+#include "option.hpp"
+#include "result.hpp"
+
+namespace crab::ipc {
+  /**
+   * @brief Smallest ring a Channel can be created with
+   */
+  inline constexpr usize MIN_CAPACITY = 4096;
+
+  /**
+   * @brief Bytes in front of every message in the ring, messages start 8 byte aligned
+   */
+  inline constexpr usize RECORD_HEADER_BYTES = 8;
+
+  class IpcError final : public Error {
+  public:
+    enum class Kind : u8 {
+      // nothing to receive right now (try_receive)
+      Empty,
+      // not enough free space right now (try_reserve)
+      Full,
+      // message is bigger than max_message_size()
+      TooLarge,
+      // the channel was closed & (for receivers) drained
+      Closed,
+      // shared memory does not hold a channel
+      Format,
+      // a system call failed, code() is its errno
+      System,
+    };
+
+  private:
+    Kind error_kind;
+    i32 error_code;
+
+  public:
+    explicit IpcError(Kind kind, i32 code = 0);
+
+    [[nodiscard]] auto kind() const -> Kind { return error_kind; }
+
+    [[nodiscard]] auto code() const -> i32 { return error_code; }
+
+    [[nodiscard]] auto what() const -> String override;
+  };
+
+  // shared state at the start of the mapping
+  struct Control;
+
+  /**
+   * @brief Space for a single message that was reserved in the ring, the message becomes visible to the consumer
+   * on commit(). A reservation that is dropped without commit is skipped by the consumer.
+   */
+  class Reservation {
+    Control *control = nullptr;
+    u8 *header = nullptr;
+    Span<u8> payload;
+
+    friend class Producer;
+
+    Reservation(Control *control, u8 *header, Span<u8> payload);
+
+    auto publish(u32 state) -> void;
+
+  public:
+    Reservation(const Reservation &) = delete;
+
+    Reservation(Reservation &&from) noexcept;
+
+    auto operator=(const Reservation &) -> Reservation& = delete;
+
+    auto operator=(Reservation &&from) noexcept -> Reservation&;
+
+    ~Reservation();
+
+    /**
+     * @brief Memory to write the message into, directly inside the shared ring
+     */
+    [[nodiscard]] auto bytes() const -> Span<u8> { return payload; }
+
+    /**
+     * @brief Publishes the message & wakes the consumer if it sleeps
+     */
+    auto commit() -> void;
+  };
+
+  /**
+   * @brief Sending end, cheap to copy. Any amount of producers (threads or processes) can send into the same
+   * channel concurrently.
+   */
+  class Producer {
+    Control *control;
+    u8 *data;
+
+    friend class Channel;
+
+    Producer(Control *control, u8 *data);
+
+  public:
+    /**
+     * @brief Reserves 'bytes' for a message, IpcError::Kind::Full if the consumer has not freed enough space yet
+     */
+    [[nodiscard]] auto try_reserve(usize bytes) const -> Result<Reservation, IpcError>;
+
+    /**
+     * @brief Reserves 'bytes' for a message, sleeping until the consumer frees enough space
+     */
+    [[nodiscard]] auto reserve(usize bytes) const -> Result<Reservation, IpcError>;
+
+    /**
+     * @brief Copies 'message' into the ring & commits it
+     */
+    auto send(Span<const u8> message) const -> Result<unit, IpcError>;
+  };
+
+  /**
+   * @brief Received message, a view directly into the ring. Its space is handed back to producers when the
+   * Message is dropped, messages have to be dropped in the order they were received.
+   */
+  class Message {
+    Control *control = nullptr;
+    u8 *data = nullptr;
+    // ring positions of the message (including padding that was skipped to get to it)
+    u64 start = 0;
+    u64 end = 0;
+    Span<const u8> payload;
+
+    friend class Consumer;
+
+    Message(Control *control, u8 *data, u64 start, u64 end, Span<const u8> payload);
+
+  public:
+    Message(const Message &) = delete;
+
+    Message(Message &&from) noexcept;
+
+    auto operator=(const Message &) -> Message& = delete;
+
+    auto operator=(Message &&from) noexcept -> Message&;
+
+    ~Message();
+
+    [[nodiscard]] auto bytes() const -> Span<const u8> { return payload; }
+  };
+
+  /**
+   * @brief Receiving end, there must only be a single Consumer of a channel at a time
+   */
+  class Consumer {
+    Control *control;
+    u8 *data;
+    // position of the next record to read, ahead of the shared 'consumed' while messages are held
+    u64 cursor;
+
+    friend class Channel;
+
+    Consumer(Control *control, u8 *data);
+
+  public:
+    Consumer(const Consumer &) = delete;
+
+    Consumer(Consumer &&) = default;
+
+    auto operator=(const Consumer &) -> Consumer& = delete;
+
+    auto operator=(Consumer &&) -> Consumer& = default;
+
+    /**
+     * @brief Next message, IpcError::Kind::Empty if there is none yet (or Closed once the channel was closed &
+     * every message was received)
+     */
+    [[nodiscard]] auto try_receive() -> Result<Message, IpcError>;
+
+    /**
+     * @brief Next message, sleeping until one is committed
+     */
+    [[nodiscard]] auto receive() -> Result<Message, IpcError>;
+  };
+
+  /**
+   * @brief Shared memory ring of variable sized messages between processes (or threads).
+   *
+   * Producers reserve space in the ring, write their message in place & commit it, the consumer reads it as a
+   * Span<const u8> straight out of the ring, so each message is written once & never copied by the channel.
+   * Waiting sides sleep on futexes in the shared memory, a process that sends or receives without anyone
+   * waiting makes no system calls.
+   *
+   * The memory is either a named POSIX shared memory object (create / open by name from any process) or an
+   * anonymous memfd that is shared through fork() or fd passing.
+   */
+  class Channel {
+    i32 fd = -1;
+    u8 *mapping = nullptr;
+    usize mapping_bytes = 0;
+
+    Channel(i32 fd, u8 *mapping, usize mapping_bytes);
+
+    [[nodiscard]] static auto map(i32 fd, Option<usize> capacity) -> Result<Channel, IpcError>;
+
+    [[nodiscard]] auto control() const -> Control*;
+
+    [[nodiscard]] auto data() const -> u8*;
+
+  public:
+    /**
+     * @brief Creates the named shared memory object 'name' (like "/my-channel") with a ring of 'capacity' bytes
+     * (rounded up to a power of two), fails if it already exists
+     */
+    [[nodiscard]] static auto create(StringView name, usize capacity) -> Result<Channel, IpcError>;
+
+    /**
+     * @brief Opens a channel another process created with create()
+     */
+    [[nodiscard]] static auto open(StringView name) -> Result<Channel, IpcError>;
+
+    /**
+     * @brief Removes the name of a channel, processes that have it open keep using it
+     */
+    static auto unlink(StringView name) -> Result<unit, IpcError>;
+
+    /**
+     * @brief Channel without a name (memfd), shared with child processes through fork() or by passing
+     * file_descriptor()
+     */
+    [[nodiscard]] static auto anonymous(usize capacity) -> Result<Channel, IpcError>;
+
+    /**
+     * @brief Maps a channel from a file descriptor (of anonymous() in another process), takes ownership of 'fd'
+     */
+    [[nodiscard]] static auto from_fd(i32 fd) -> Result<Channel, IpcError>;
+
+    Channel(const Channel &) = delete;
+
+    Channel(Channel &&from) noexcept;
+
+    auto operator=(const Channel &) -> Channel& = delete;
+
+    auto operator=(Channel &&from) noexcept -> Channel&;
+
+    ~Channel();
+
+    [[nodiscard]] auto file_descriptor() const -> i32 { return fd; }
+
+    /**
+     * @brief Bytes of the ring
+     */
+    [[nodiscard]] auto capacity() const -> usize;
+
+    /**
+     * @brief Largest message that can be sent, half of the ring minus its header
+     */
+    [[nodiscard]] auto max_message_size() const -> usize;
+
+    [[nodiscard]] auto producer() const -> Producer;
+
+    /**
+     * @brief Receiving end, continues after the last message a previous consumer released
+     */
+    [[nodiscard]] auto consumer() const -> Consumer;
+
+    /**
+     * @brief Marks the channel as closed for every process & wakes everyone, reservations fail from now on & the
+     * consumer gets Closed once it drained the remaining messages
+     */
+    auto close() const -> void;
+
+    [[nodiscard]] auto is_closed() const -> bool;
+  };
+}
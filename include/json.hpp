@@ -0,0 +1,762 @@
+#pragma once
+
+#include <bit>
+#include <cstring>
+#include <format>
+#include <limits>
+
+#include "preamble.hpp"
+#include "box.hpp"
+#include "option.hpp"
+#include "parse.hpp"
+#include "result.hpp"
+#include "strings.hpp"
+#include "utf.hpp"
+#include "crab/debug.hpp"
+
+#if defined(__PCLMUL__)
+#include <immintrin.h>
+#endif
+
+namespace crab::json {
+  class JsonError final : public Error {
+  public:
+    enum class Kind : u8 {
+      // the document is not valid UTF-8
+      InvalidUtf8,
+      // unbalanced brackets, a missing ':' or ',', an unclosed string, a raw control character in a string...
+      Syntax,
+      // the value is not of the requested type
+      WrongType,
+      // a token that starts like a number but is not a JSON number
+      InvalidNumber,
+      // the number does not fit the requested type, or the document is over 4 GiB
+      OutOfRange,
+      // an unknown escape or an unpaired surrogate
+      InvalidEscape,
+      // as_string_view() of a string that has escapes, as_string() unescapes it
+      Escaped,
+    };
+
+  private:
+    Kind error_kind;
+    usize byte;
+
+  public:
+    JsonError(const Kind kind, const usize position) : error_kind{kind}, byte{position} {}
+
+    [[nodiscard]] auto kind() const -> Kind { return error_kind; }
+
+    /**
+     * @brief Offset in the document of the value or character at fault
+     */
+    [[nodiscard]] auto offset() const -> usize { return byte; }
+
+    [[nodiscard]] auto what() const -> String override {
+      constexpr const char *descriptions[]{
+        "invalid UTF-8",
+        "syntax error",
+        "value of the wrong type",
+        "invalid number",
+        "number out of range",
+        "invalid escape",
+        "string needs unescaping",
+      };
+      return std::format("{} at byte {}", descriptions[static_cast<usize>(error_kind)], byte);
+    }
+  };
+}
+
+namespace crab::json::helper {
+  // bytes classified at once by the structural indexer, one bit each in a u64
+  inline constexpr usize BLOCK = 64;
+
+  struct Masks {
+    u64 quote = 0;
+    u64 backslash = 0;
+    // { } [ ] : ,
+    u64 operators = 0;
+    u64 whitespace = 0;
+    // below 0x20, only allowed outside of strings
+    u64 control = 0;
+  };
+
+  [[nodiscard]] __always_inline auto classify(const char *block) -> Masks {
+    Masks masks;
+    #if defined(__AVX2__) || defined(__SSE2__)
+    using strings::helper::Simd;
+    for (usize i = 0; i < BLOCK; i += Simd::WIDTH) {
+      const auto bytes = Simd::load(block + i);
+      const auto bits = [i](const Simd::Vector lanes) { return u64{Simd::mask(lanes)} << i; };
+      const auto is = [bytes](const char c) { return Simd::equal(bytes, Simd::splat(c)); };
+
+      // '[' & ']' are '{' & '}' without 0x20
+      const auto lower = Simd::bit_or(bytes, Simd::splat(0x20));
+      const auto brackets = Simd::bit_or(
+        Simd::equal(lower, Simd::splat('{')),
+        Simd::equal(lower, Simd::splat('}'))
+      );
+      masks.quote |= bits(is('"'));
+      masks.backslash |= bits(is('\\'));
+      masks.operators |= bits(Simd::bit_or(brackets, Simd::bit_or(is(':'), is(','))));
+      masks.whitespace |= bits(Simd::bit_or(
+        Simd::bit_or(is(' '), is('\r')),
+        Simd::in_range(bytes, '\t', '\n' - '\t')
+      ));
+      masks.control |= bits(Simd::in_range(bytes, 0, 0x1f));
+    }
+    #else
+    for (usize i = 0; i < BLOCK; i++) {
+      const char c = block[i];
+      const u64 bit = u64{1} << i;
+      if (c == '"') masks.quote |= bit;
+      if (c == '\\') masks.backslash |= bit;
+      if (c == '{' or c == '}' or c == '[' or c == ']' or c == ':' or c == ',') masks.operators |= bit;
+      if (c == ' ' or c == '\t' or c == '\n' or c == '\r') masks.whitespace |= bit;
+      if (static_cast<u8>(c) < 0x20) masks.control |= bit;
+    }
+    #endif
+    return masks;
+  }
+
+  /**
+   * @brief Bit i is the xor of bits 0..i, which turns quote bits into "inside a string" bits
+   */
+  [[nodiscard]] __always_inline auto prefix_xor(u64 bits) -> u64 {
+    #if defined(__PCLMUL__)
+    const __m128i all_ones = _mm_set1_epi8(-1);
+    return static_cast<u64>(_mm_cvtsi128_si64(
+      _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<i64>(bits)), all_ones, 0)
+    ));
+    #else
+    for (u32 shift = 1; shift < 64; shift *= 2) bits ^= bits << shift;
+    return bits;
+    #endif
+  }
+
+  /**
+   * @brief State carried from one block to the next by the structural indexer
+   */
+  struct Scanner {
+    // the first byte of the next block is escaped by an odd run of backslashes
+    u64 escape_carry = 0;
+    // all ones when the previous block ended inside a string
+    u64 in_string = 0;
+    // the previous block ended inside a number or literal
+    u64 scalar_carry = 0;
+
+    /**
+     * @brief Bytes escaped by a backslash: those after an odd length run of backslashes
+     */
+    [[nodiscard]] __always_inline auto escaped(u64 backslash) -> u64 {
+      constexpr u64 EVEN = 0x5555'5555'5555'5555;
+
+      // an escaped backslash does not escape what follows it
+      backslash &= ~escape_carry;
+      const u64 follows_escape = backslash << 1 | escape_carry;
+      // runs starting on an odd bit, added to the backslashes their carry ends up one past the run
+      const u64 odd_starts = backslash & ~EVEN & ~follows_escape;
+      u64 even_started;
+      escape_carry = __builtin_add_overflow(odd_starts, backslash, &even_started);
+      return (EVEN ^ even_started << 1) & follows_escape;
+    }
+
+    /**
+     * @brief Structural bits of a block: operators outside strings, opening quotes & the first byte of every number
+     * or literal. 'control' gets the raw control characters found inside strings.
+     */
+    [[nodiscard]] __always_inline auto structurals(const Masks &masks, u64 &control) -> u64 {
+      const u64 quote = masks.quote & ~escaped(masks.backslash);
+      // opening quotes & string contents, not closing quotes
+      const u64 inside = prefix_xor(quote) ^ in_string;
+      in_string = static_cast<u64>(static_cast<i64>(inside) >> 63);
+      control = masks.control & inside & ~quote;
+
+      const u64 scalars = ~(masks.operators | masks.whitespace | quote | inside);
+      const u64 scalar_starts = scalars & ~(scalars << 1 | scalar_carry);
+      scalar_carry = scalars >> 63;
+      return (masks.operators & ~inside) | scalar_starts | (quote & inside);
+    }
+  };
+
+  /**
+   * @brief Appends the offsets of the structurals of the block at 'base' to 'cursor' & returns the bits of raw
+   * control characters found inside strings
+   */
+  [[nodiscard]] __always_inline auto scan_block(Scanner &scanner, const char *block, const usize base, u32 *&cursor)
+    -> u64 {
+    u64 control;
+    u64 bits = scanner.structurals(classify(block), control);
+    // 8 at a time without looking at the count, which keeps the branches predictable, the slack in the output takes
+    // the overshoot
+    const auto count = static_cast<usize>(std::popcount(bits));
+    for (usize written = 0; written < count; written += 8) {
+      for (usize i = 0; i < 8; i++) {
+        cursor[written + i] = static_cast<u32>(base + static_cast<usize>(std::countr_zero(bits)));
+        bits &= bits - 1;
+      }
+    }
+    cursor += count;
+    return control;
+  }
+
+  /**
+   * @brief Stage one: writes the offset of every structural character of 'text' to 'out' (which has room for
+   * text.size() + BLOCK of them) & returns how many there are. Also rejects unclosed strings & raw control characters
+   * in strings.
+   */
+  [[nodiscard]] inline auto index_structurals(const StringView text, u32 *out) -> Result<usize, JsonError> {
+    const auto control_error = [](const usize base, const u64 control) {
+      return JsonError{JsonError::Kind::Syntax, base + static_cast<usize>(std::countr_zero(control))};
+    };
+
+    Scanner scanner;
+    u32 *cursor = out;
+    usize base = 0;
+    for (; base + BLOCK <= text.size(); base += BLOCK) {
+      const u64 control = scan_block(scanner, text.data() + base, base, cursor);
+      if (control != 0) [[unlikely]] return control_error(base, control);
+    }
+    if (base < text.size()) {
+      // padded with whitespace, which is neither structural nor part of a scalar
+      char tail[BLOCK];
+      std::memset(tail, ' ', BLOCK);
+      std::memcpy(tail, text.data() + base, text.size() - base);
+      const u64 control = scan_block(scanner, tail, base, cursor);
+      if (control != 0) return control_error(base, control);
+    }
+
+    if (scanner.in_string != 0) return JsonError{JsonError::Kind::Syntax, text.size()};
+    return static_cast<usize>(cursor - out);
+  }
+
+  [[nodiscard]] __always_inline constexpr auto is_whitespace(const char c) -> bool {
+    return c == ' ' or c == '\t' or c == '\n' or c == '\r';
+  }
+
+  /**
+   * @brief Whether 'token' is a number in JSON's grammar, which is stricter than crab::parse (no '+', no leading
+   * zeros, digits on both sides of the '.')
+   */
+  [[nodiscard]] inline auto is_number(const StringView token) -> bool {
+    usize i = 0;
+    const auto digits = [&] {
+      const usize start = i;
+      while (i < token.size() and static_cast<u8>(token[i] - '0') <= 9) i++;
+      return i - start;
+    };
+
+    if (i < token.size() and token[i] == '-') i++;
+    if (i < token.size() and token[i] == '0') {
+      i++;
+    } else if (digits() == 0) {
+      return false;
+    }
+    if (i < token.size() and token[i] == '.') {
+      i++;
+      if (digits() == 0) return false;
+    }
+    if (i < token.size() and (token[i] == 'e' or token[i] == 'E')) {
+      i++;
+      if (i < token.size() and (token[i] == '+' or token[i] == '-')) i++;
+      if (digits() == 0) return false;
+    }
+    return i == token.size();
+  }
+
+  [[nodiscard]] inline auto hex_value(const StringView digits) -> Option<u32> {
+    u32 value = 0;
+    for (const char c: digits) {
+      u32 digit;
+      if (c >= '0' and c <= '9') digit = static_cast<u32>(c - '0');
+      else if ((c | 0x20) >= 'a' and (c | 0x20) <= 'f') digit = static_cast<u32>((c | 0x20) - 'a' + 10);
+      else return crab::none;
+      value = value << 4 | digit;
+    }
+    return crab::some(value);
+  }
+
+  /**
+   * @brief Appends 'raw' (the inside of a string that starts at 'offset' in the document) to 'out' with its
+   * escapes resolved
+   */
+  [[nodiscard]] inline auto unescape(const StringView raw, const usize offset, String &out) -> Result<unit, JsonError> {
+    usize i = 0;
+    while (true) {
+      const usize backslash = i + strings::helper::find_byte(raw.data() + i, raw.size() - i, '\\');
+      out.append(raw.data() + i, backslash - i);
+      if (backslash == raw.size()) return unit{};
+
+      // the indexer guarantees something follows a backslash inside a string
+      const JsonError error{JsonError::Kind::InvalidEscape, offset + backslash};
+      i = backslash + 2;
+      switch (raw[backslash + 1]) {
+        case '"': out.push_back('"');
+          break;
+        case '\\': out.push_back('\\');
+          break;
+        case '/': out.push_back('/');
+          break;
+        case 'b': out.push_back('\b');
+          break;
+        case 'f': out.push_back('\f');
+          break;
+        case 'n': out.push_back('\n');
+          break;
+        case 'r': out.push_back('\r');
+          break;
+        case 't': out.push_back('\t');
+          break;
+        case 'u': {
+          if (raw.size() - i < 4) return error;
+          auto unit = hex_value(raw.substr(i, 4));
+          if (unit.is_none()) return error;
+          u32 point = unit.take_unchecked();
+          i += 4;
+
+          if (point >= 0xdc00 and point <= 0xdfff) return error;
+          if (point >= 0xd800 and point <= 0xdbff) {
+            // must be followed by an escaped low surrogate
+            if (raw.size() - i < 6 or raw[i] != '\\' or raw[i + 1] != 'u') return error;
+            auto low = hex_value(raw.substr(i + 2, 4));
+            if (low.is_none()) return error;
+            const u32 low_unit = low.take_unchecked();
+            if (low_unit < 0xdc00 or low_unit > 0xdfff) return error;
+            point = 0x10000 + ((point - 0xd800) << 10) + (low_unit - 0xdc00);
+            i += 6;
+          }
+
+          char encoded[4];
+          char *end = encoded;
+          utf::helper::encode(point, end);
+          out.append(encoded, end);
+          break;
+        }
+        default: return error;
+      }
+    }
+  }
+}
+
+namespace crab::json {
+  class Value;
+  class Document;
+
+  /**
+   * @brief Entry of an object, the key is as written in the document (escapes are not resolved)
+   */
+  struct Member;
+
+  /**
+   * @brief Entries of an object, see Value::members()
+   */
+  class Members;
+
+  /**
+   * @brief Values of an array, see Value::elements()
+   */
+  class Elements;
+
+  /**
+   * @brief A value in a Document, a cheap handle that is only valid as long as the Document (and the text it was
+   * parsed from) is. Nothing is decoded until it is asked for.
+   */
+  class Value {
+    friend class Document;
+    friend class Members;
+    friend class Elements;
+
+    const Document *document;
+    u32 index;
+
+    Value(const Document *document, const u32 index) : document{document}, index{index} {}
+
+  public:
+    enum class Type : u8 {
+      Null,
+      Bool,
+      Number,
+      String,
+      Array,
+      Object,
+    };
+
+    [[nodiscard]] auto type() const -> Type;
+
+    [[nodiscard]] auto is_null() const -> bool { return type() == Type::Null; }
+
+    /**
+     * @brief Offset of the value in the document
+     */
+    [[nodiscard]] auto offset() const -> usize;
+
+    /**
+     * @brief Text of the value, including the quotes of a string & everything inside an array / object
+     */
+    [[nodiscard]] auto raw() const -> StringView;
+
+    [[nodiscard]] auto as_bool() const -> Result<bool, JsonError>;
+
+    /**
+     * @brief The number as a T with crab::parse, WrongType for non numbers & for fractions / exponents when T is an
+     * integer, OutOfRange if it does not fit
+     */
+    template<parsing::number T>
+    [[nodiscard]] auto as() const -> Result<T, JsonError>;
+
+    /**
+     * @brief The string as a view into the document, without copying. Fails with Escaped when the string has
+     * escapes, as_string() resolves them.
+     */
+    [[nodiscard]] auto as_string_view() const -> Result<StringView, JsonError>;
+
+    /**
+     * @brief The string with its escapes resolved
+     */
+    [[nodiscard]] auto as_string() const -> Result<String, JsonError>;
+
+    /**
+     * @brief Value of the first member named 'key' (compared to the key as written, escapes & all), None if this is
+     * not an object or there is no such member
+     */
+    [[nodiscard]] auto operator[](StringView key) const -> Option<Value>;
+
+    /**
+     * @brief Element 'i' of an array, None if this is not an array or it is too short
+     */
+    [[nodiscard]] auto at(usize i) const -> Option<Value>;
+
+    /**
+     * @brief Entries of an object (none for anything else)
+     */
+    [[nodiscard]] auto members() const -> Members;
+
+    /**
+     * @brief Elements of an array (none for anything else)
+     */
+    [[nodiscard]] auto elements() const -> Elements;
+
+    /**
+     * @brief Number of elements / members of an array / object, 0 for anything else
+     */
+    [[nodiscard]] auto length() const -> usize;
+  };
+
+  struct Member {
+    StringView key;
+    Value value;
+  };
+
+  /**
+   * @brief A parsed JSON text.
+   *
+   * Parsing is a single SIMD pass that finds every structural character ({ } [ ] : , the quote opening a string &
+   * the start of each number / literal), 64 bytes at a time, followed by a pass over those that checks the grammar &
+   * links every '{' / '[' to its closing bracket. Nothing is allocated per value & nothing is decoded: navigating
+   * jumps over whole arrays & objects, numbers & strings are converted when they are read. The text is not copied,
+   * it must outlive the Document.
+   *
+   * @code
+   * const auto document = crab::json::parse(R"({"name": "crab", "legs": [1, 2]})").take_unchecked();
+   * const StringView name = document["name"].take_unchecked().as_string_view().take_unchecked();
+   * for (const crab::json::Value leg: document["legs"].take_unchecked().elements()) ...
+   * @endcode
+   */
+  class Document {
+    friend class Value;
+    friend class Members;
+    friend class Elements;
+
+    StringView text;
+    // offset of every structural character
+    Box<u32[]> positions;
+    // for every '{' / '[' the index (into positions) of its closing bracket, unused elsewhere
+    Box<u32[]> closers;
+    usize count;
+
+    Document(const StringView text, Box<u32[]> positions, Box<u32[]> closers, const usize count)
+      : text{text}, positions{std::move(positions)}, closers{std::move(closers)}, count{count} {}
+
+    [[nodiscard]] auto character(const u32 i) const -> char { return text[positions[i]]; }
+
+    /**
+     * @brief Index of the structural after the value at 'i'
+     */
+    [[nodiscard]] auto after(const u32 i) const -> u32 {
+      const char c = character(i);
+      return c == '{' or c == '[' ? closers[i] + 1 : i + 1;
+    }
+
+    /**
+     * @brief Text of the string / number / literal at 'i', up to the next structural & without trailing whitespace
+     */
+    [[nodiscard]] auto token(const u32 i) const -> StringView {
+      usize end = i + 1 < count ? positions[i + 1] : text.size();
+      while (helper::is_whitespace(text[end - 1])) end--;
+      return text.substr(positions[i], end - positions[i]);
+    }
+
+    /**
+     * @brief Inside of the string at 'i', escapes not resolved
+     */
+    [[nodiscard]] auto string(const u32 i) const -> StringView {
+      const StringView quoted = token(i);
+      return quoted.substr(1, quoted.size() - 2);
+    }
+
+    /**
+     * @brief Stage two: checks the grammar over the structurals & fills in closers
+     */
+    [[nodiscard]] auto link() -> Result<unit, JsonError> {
+      using Kind = JsonError::Kind;
+      enum class Expect : u8 { Value, ValueOrClose, Key, KeyOrClose, Colon, Next };
+
+      Vec<u32> open;
+      // whether the innermost open container is an object
+      bool in_object = false;
+      Expect expect = Expect::Value;
+      for (u32 i = 0; i < count; i++) {
+        const char c = character(i);
+        const auto error = [&] { return JsonError{Kind::Syntax, positions[i]}; };
+
+        const auto close = [&] {
+          closers[open.back()] = i;
+          open.pop_back();
+          in_object = not open.empty() and character(open.back()) == '{';
+          expect = Expect::Next;
+        };
+
+        switch (expect) {
+          case Expect::Value:
+          case Expect::ValueOrClose:
+            if (c == '"') {
+              expect = Expect::Next;
+            } else if (c == '-' or static_cast<u8>(c - '0') <= 9) {
+              // numbers are checked when they are read
+              expect = Expect::Next;
+            } else if (c == '{' or c == '[') {
+              open.push_back(i);
+              in_object = c == '{';
+              expect = in_object ? Expect::KeyOrClose : Expect::ValueOrClose;
+            } else if (c == ']' and expect == Expect::ValueOrClose) {
+              close();
+            } else if (const StringView word = token(i); word == "true" or word == "false" or word == "null") {
+              expect = Expect::Next;
+            } else {
+              return error();
+            }
+            break;
+          case Expect::Key:
+          case Expect::KeyOrClose:
+            if (c == '"') {
+              expect = Expect::Colon;
+            } else if (c == '}' and expect == Expect::KeyOrClose) {
+              close();
+            } else {
+              return error();
+            }
+            break;
+          case Expect::Colon:
+            if (c != ':') return error();
+            expect = Expect::Value;
+            break;
+          case Expect::Next:
+            if (c == ',' and not open.empty()) {
+              expect = in_object ? Expect::Key : Expect::Value;
+            } else if (not open.empty() and c == (in_object ? '}' : ']')) {
+              close();
+            } else {
+              return error();
+            }
+            break;
+        }
+      }
+
+      if (expect != Expect::Next or not open.empty()) return JsonError{Kind::Syntax, text.size()};
+      return unit{};
+    }
+
+  public:
+    Document(Document &&) noexcept = default;
+
+    auto operator=(Document &&) noexcept -> Document& = default;
+
+    /**
+     * @brief Indexes 'text', failing on invalid UTF-8 & on anything that is not well-formed JSON except for the
+     * digits of numbers (checked when they are read)
+     */
+    [[nodiscard]] static auto parse(const StringView text) -> Result<Document, JsonError> {
+      using Kind = JsonError::Kind;
+      if (text.size() >= std::numeric_limits<u32>::max()) return JsonError{Kind::OutOfRange, 0};
+      if (auto valid = utf::validate(text); valid.is_err()) {
+        return JsonError{Kind::InvalidUtf8, valid.take_err_unchecked().offset()};
+      }
+
+      // there can be no more structurals than bytes (plus what the indexer overshoots by), left uninitialised as
+      // only the ones found are read
+      auto positions = Box<u32[]>::wrap_unchecked(new u32[text.size() + helper::BLOCK], text.size() + helper::BLOCK);
+      auto indexed = helper::index_structurals(text, positions.as_ptr());
+      if (indexed.is_err()) return indexed.take_err_unchecked();
+      const usize count = indexed.take_unchecked();
+
+      auto closers = Box<u32[]>::wrap_unchecked(new u32[count], count);
+      Document document{text, std::move(positions), std::move(closers), count};
+      if (auto linked = document.link(); linked.is_err()) return linked.take_err_unchecked();
+      return document;
+    }
+
+    [[nodiscard]] auto root() const -> Value { return Value{this, 0}; }
+
+    [[nodiscard]] auto operator[](const StringView key) const -> Option<Value> { return root()[key]; }
+  };
+
+  class Members {
+    friend class Value;
+
+    const Document *document;
+    u32 cursor;
+    u32 close;
+
+    Members(const Document *document, const u32 cursor, const u32 close)
+      : document{document}, cursor{cursor}, close{close} {}
+
+  public:
+    [[nodiscard]] auto next() -> Option<Member> {
+      if (cursor >= close) return crab::none;
+      const Member member{document->string(cursor), Value{document, cursor + 2}};
+      // lands on the ',' before the next key, or on the '}'
+      cursor = document->after(cursor + 2) + 1;
+      return crab::some(member);
+    }
+
+    [[nodiscard]] auto begin() -> strings::helper::TokenIterator<Members> {
+      return strings::helper::TokenIterator<Members>{*this};
+    }
+
+    [[nodiscard]] static constexpr auto end() -> std::default_sentinel_t { return std::default_sentinel; }
+  };
+
+  class Elements {
+    friend class Value;
+
+    const Document *document;
+    u32 cursor;
+    u32 close;
+
+    Elements(const Document *document, const u32 cursor, const u32 close)
+      : document{document}, cursor{cursor}, close{close} {}
+
+  public:
+    [[nodiscard]] auto next() -> Option<Value> {
+      if (cursor >= close) return crab::none;
+      const Value element{document, cursor};
+      cursor = document->after(cursor) + 1;
+      return crab::some(element);
+    }
+
+    [[nodiscard]] auto begin() -> strings::helper::TokenIterator<Elements> {
+      return strings::helper::TokenIterator<Elements>{*this};
+    }
+
+    [[nodiscard]] static constexpr auto end() -> std::default_sentinel_t { return std::default_sentinel; }
+  };
+
+  inline auto Value::type() const -> Type {
+    switch (document->character(index)) {
+      case '{': return Type::Object;
+      case '[': return Type::Array;
+      case '"': return Type::String;
+      case 't':
+      case 'f': return Type::Bool;
+      case 'n': return Type::Null;
+      default: return Type::Number;
+    }
+  }
+
+  inline auto Value::offset() const -> usize { return document->positions[index]; }
+
+  inline auto Value::raw() const -> StringView {
+    if (const Type kind = type(); kind == Type::Object or kind == Type::Array) {
+      const usize close = document->positions[document->closers[index]];
+      return document->text.substr(offset(), close + 1 - offset());
+    }
+    return document->token(index);
+  }
+
+  inline auto Value::as_bool() const -> Result<bool, JsonError> {
+    if (type() != Type::Bool) return JsonError{JsonError::Kind::WrongType, offset()};
+    return document->character(index) == 't';
+  }
+
+  template<parsing::number T>
+  auto Value::as() const -> Result<T, JsonError> {
+    using Kind = JsonError::Kind;
+    if (type() != Type::Number) return JsonError{Kind::WrongType, offset()};
+
+    const StringView token = document->token(index);
+    if (not helper::is_number(token)) return JsonError{Kind::InvalidNumber, offset()};
+    auto parsed = crab::parse<T>(token);
+    if (parsed.is_ok()) return parsed.take_unchecked();
+    const bool too_big = parsed.take_err_unchecked().kind() == ParseError::Kind::OutOfRange;
+    return JsonError{too_big ? Kind::OutOfRange : Kind::WrongType, offset()};
+  }
+
+  inline auto Value::as_string_view() const -> Result<StringView, JsonError> {
+    if (type() != Type::String) return JsonError{JsonError::Kind::WrongType, offset()};
+    const StringView inside = document->string(index);
+    if (crab::contains(inside, '\\')) return JsonError{JsonError::Kind::Escaped, offset()};
+    return inside;
+  }
+
+  inline auto Value::as_string() const -> Result<String, JsonError> {
+    if (type() != Type::String) return JsonError{JsonError::Kind::WrongType, offset()};
+    String out;
+    if (auto unescaped = helper::unescape(document->string(index), offset() + 1, out); unescaped.is_err()) {
+      return unescaped.take_err_unchecked();
+    }
+    return out;
+  }
+
+  inline auto Value::members() const -> Members {
+    if (type() != Type::Object) return Members{document, 0, 0};
+    return Members{document, index + 1, document->closers[index]};
+  }
+
+  inline auto Value::elements() const -> Elements {
+    if (type() != Type::Array) return Elements{document, 0, 0};
+    return Elements{document, index + 1, document->closers[index]};
+  }
+
+  inline auto Value::operator[](const StringView key) const -> Option<Value> {
+    Members entries = members();
+    while (auto member = entries.next()) {
+      if (member.get_unchecked().key == key) return crab::some(member.get_unchecked().value);
+    }
+    return crab::none;
+  }
+
+  inline auto Value::at(usize i) const -> Option<Value> {
+    Elements values = elements();
+    while (auto element = values.next()) {
+      if (i-- == 0) return element;
+    }
+    return crab::none;
+  }
+
+  inline auto Value::length() const -> usize {
+    usize length = 0;
+    if (type() == Type::Array) {
+      for (Elements values = elements(); values.next().is_some();) length++;
+    } else if (type() == Type::Object) {
+      for (Members entries = members(); entries.next().is_some();) length++;
+    }
+    return length;
+  }
+
+  /**
+   * @brief Indexes 'text' as a Document, see Document::parse
+   */
+  [[nodiscard]] inline auto parse(const StringView text) -> Result<Document, JsonError> {
+    return Document::parse(text);
+  }
+}
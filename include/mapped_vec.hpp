@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <type_traits>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/mapped.hpp"
+#include "option.hpp"
+#include "result.hpp"
+
+namespace crab::mapped {
+  inline constexpr u64 MAGIC = 0x3156'4450'414d'4243; // "CBMAPDV1"
+
+  /**
+   * @brief Bytes before the first element, also the largest element alignment a MappedVec supports
+   */
+  inline constexpr usize HEADER_BYTES = 64;
+
+  /**
+   * @brief Capacity of a freshly created MappedVec
+   */
+  inline constexpr usize MIN_CAPACITY = 64;
+
+  namespace helper {
+    /**
+     * @brief Start of every MappedVec file, the length lives here so that it persists with the elements
+     */
+    struct Header {
+      u64 magic;
+      u64 element_size;
+      u64 element_align;
+      u64 length;
+    };
+
+    static_assert(sizeof(Header) <= HEADER_BYTES);
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Vec of trivially copyable elements that lives in a memory mapped file.
+   *
+   * Everything written to it is the file contents, so reopening the same path gives the previous elements back
+   * without reading or parsing anything, pages are faulted in when they are first touched. Growing is geometric
+   * (ftruncate & remap), so pointers & spans are invalidated by anything that can grow the vec, like Vec.
+   *
+   * The kernel writes modified pages back at its own pace, flush() forces them out (for crash consistency after
+   * an OS crash, a process crash loses nothing once the write happened).
+   */
+  template<typename T>
+    requires std::is_trivially_copyable_v<T> and (alignof(T) <= mapped::HEADER_BYTES)
+  class MappedVec {
+    mapped::File file;
+
+    explicit MappedVec(mapped::File file) : file{std::move(file)} {}
+
+    [[nodiscard]] auto header() const -> mapped::helper::Header* {
+      return reinterpret_cast<mapped::helper::Header*>(file.data());
+    }
+
+    [[nodiscard]] static constexpr auto bytes_for(const usize capacity) -> usize {
+      return mapped::HEADER_BYTES + capacity * sizeof(T);
+    }
+
+  public:
+    /**
+     * @brief Opens the MappedVec stored at 'path', creating an empty one if the file does not exist (or is empty).
+     * Fails if the file holds something else, or elements of a different size / alignment.
+     */
+    [[nodiscard]] static auto open(const std::filesystem::path &path) -> Result<MappedVec, mapped::IoError> {
+      Result<mapped::File, mapped::IoError> opened = mapped::File::open(path);
+      if (opened.is_err()) return opened.take_err_unchecked();
+
+      MappedVec vec{opened.take_unchecked()};
+
+      if (vec.file.size() == 0) {
+        if (auto resized = vec.file.resize(bytes_for(mapped::MIN_CAPACITY)); resized.is_err()) {
+          return resized.take_err_unchecked();
+        }
+
+        const mapped::helper::Header header{mapped::MAGIC, sizeof(T), alignof(T), 0};
+        std::memcpy(vec.file.data(), &header, sizeof(header));
+        return vec;
+      }
+
+      if (vec.file.size() < mapped::HEADER_BYTES) return mapped::IoError{"MappedVec header validation", EINVAL};
+
+      const mapped::helper::Header *header = vec.header();
+      if (
+        header->magic != mapped::MAGIC
+        or header->element_size != sizeof(T)
+        or header->element_align != alignof(T)
+        or header->length > vec.capacity()
+      ) {
+        return mapped::IoError{"MappedVec header validation", EINVAL};
+      }
+
+      return vec;
+    }
+
+    [[nodiscard]] auto length() const -> usize { return header()->length; }
+
+    [[nodiscard]] auto is_empty() const -> bool { return length() == 0; }
+
+    /**
+     * @brief Elements that fit before the file has to grow
+     */
+    [[nodiscard]] auto capacity() const -> usize { return (file.size() - mapped::HEADER_BYTES) / sizeof(T); }
+
+    [[nodiscard]] auto data() -> T* { return reinterpret_cast<T*>(file.data() + mapped::HEADER_BYTES); }
+
+    [[nodiscard]] auto data() const -> const T* {
+      return reinterpret_cast<const T*>(file.data() + mapped::HEADER_BYTES);
+    }
+
+    [[nodiscard]] auto operator[](const usize index) -> T& {
+      debug_assert(index < length(), "Index out of Bounds");
+      return data()[index];
+    }
+
+    [[nodiscard]] auto operator[](const usize index) const -> const T& {
+      debug_assert(index < length(), "Index out of Bounds");
+      return data()[index];
+    }
+
+    [[nodiscard]] auto as_span() const -> Span<const T> { return {data(), length()}; }
+
+    [[nodiscard]] auto as_span_mut() -> Span<T> { return {data(), length()}; }
+
+    [[nodiscard]] auto begin() -> T* { return data(); }
+
+    [[nodiscard]] auto end() -> T* { return data() + length(); }
+
+    [[nodiscard]] auto begin() const -> const T* { return data(); }
+
+    [[nodiscard]] auto end() const -> const T* { return data() + length(); }
+
+    /**
+     * @brief Makes room for at least 'count' elements, at least doubling the file when it has to grow
+     */
+    auto reserve(const usize count) -> Result<unit, mapped::IoError> {
+      if (count <= capacity()) return unit{};
+      return file.resize(bytes_for(std::max(count, capacity() * 2)));
+    }
+
+    auto push(const T &value) -> Result<unit, mapped::IoError> {
+      if (auto reserved = reserve(length() + 1); reserved.is_err()) return reserved;
+
+      data()[length()] = value;
+      header()->length++;
+      return unit{};
+    }
+
+    /**
+     * @brief Appends every element of 'values' with a single growth
+     */
+    auto extend(const Span<const T> values) -> Result<unit, mapped::IoError> {
+      if (auto reserved = reserve(length() + values.size()); reserved.is_err()) return reserved;
+
+      std::copy(values.begin(), values.end(), data() + length());
+      header()->length += values.size();
+      return unit{};
+    }
+
+    /**
+     * @brief Grows (filling with 'value') or truncates to 'count' elements
+     */
+    auto resize(const usize count, const T &value = T{}) -> Result<unit, mapped::IoError> {
+      if (auto reserved = reserve(count); reserved.is_err()) return reserved;
+
+      if (count > length()) std::fill(data() + length(), data() + count, value);
+      header()->length = count;
+      return unit{};
+    }
+
+    [[nodiscard]] auto pop() -> Option<T> {
+      if (is_empty()) return crab::none;
+      header()->length--;
+      return crab::some(T{data()[length()]});
+    }
+
+    /**
+     * @brief Drops every element past 'count', the file keeps its size
+     */
+    auto truncate(const usize count) -> void {
+      header()->length = std::min(count, length());
+    }
+
+    auto clear() -> void { header()->length = 0; }
+
+    /**
+     * @brief Shrinks the file to exactly fit the current elements
+     */
+    auto shrink_to_fit() -> Result<unit, mapped::IoError> {
+      return file.resize(bytes_for(std::max(length(), usize{1})));
+    }
+
+    /**
+     * @brief Blocks until the elements & length are written back to the file
+     */
+    auto flush() const -> Result<unit, mapped::IoError> { return file.flush(); }
+  };
+}
@@ -0,0 +1,748 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_mdspan)
+#include <mdspan>
+#endif
+
+#include "preamble.hpp"
+#include "option.hpp"
+#include "crab/debug.hpp"
+
+namespace crab::nd {
+  template<usize Rank>
+  using Shape = std::array<usize, Rank>;
+
+  /**
+   * @brief Element types, arithmetic ones so that expressions can run on them a vector of lanes at a time
+   */
+  template<typename T>
+  concept element = std::is_arithmetic_v<T> and not std::same_as<T, bool>;
+
+  template<typename T, usize Rank>
+    requires element<std::remove_const_t<T>> and (Rank >= 1)
+  class View;
+
+  namespace helper {
+    // storage starts on a cache line, so contiguous rows of a vector multiple start on a vector boundary
+    inline constexpr usize ALIGNMENT = 64;
+
+    #if defined(__AVX__)
+    inline constexpr usize VECTOR_BYTES = 32;
+    #else
+    inline constexpr usize VECTOR_BYTES = 16;
+    #endif
+
+    template<typename T>
+    struct VectorOf {
+      using type [[gnu::vector_size(VECTOR_BYTES)]] = T;
+    };
+
+    /**
+     * @brief Elements that have a GCC / Clang vector extension type (long double has none)
+     */
+    template<typename T>
+    concept lane = element<T> and sizeof(T) <= 8;
+
+    template<lane T>
+    using Vector = typename VectorOf<T>::type;
+
+    template<lane T>
+    inline constexpr usize LANES = VECTOR_BYTES / sizeof(T);
+
+    template<lane T>
+    [[nodiscard]] __always_inline auto load(const T *from) -> Vector<T> {
+      Vector<T> vector;
+      std::memcpy(&vector, from, sizeof(vector));
+      return vector;
+    }
+
+    template<lane T>
+    __always_inline auto store(T *to, const Vector<T> vector) -> void { std::memcpy(to, &vector, sizeof(vector)); }
+
+    template<lane T>
+    [[nodiscard]] __always_inline auto splat(const T value) -> Vector<T> { return Vector<T>{} + value; }
+
+    /**
+     * @brief 'Op' applied lane wise to vectors gives a vector of T, the row can then be evaluated vectors at a time
+     */
+    template<typename Op, typename T, typename... Operands>
+    concept vector_op = lane<T> and (lane<Operands> and ...)
+      and std::invocable<const Op&, Vector<Operands>...>
+      and std::same_as<std::invoke_result_t<const Op&, Vector<Operands>...>, Vector<T>>;
+
+    /**
+     * @brief Element type of 'op' applied to 'Input's. Integer promotion is undone, u8 + u8 stays u8 (as it does lane
+     * wise in vectors).
+     */
+    template<typename Op, typename Input, typename... Rest>
+    using Output = std::conditional_t<
+      std::same_as<std::invoke_result_t<const Op&, Input, Rest...>, decltype(+std::declval<Input>())>,
+      Input,
+      std::remove_cvref_t<std::invoke_result_t<const Op&, Input, Rest...>>
+    >;
+
+    template<usize Rank>
+    [[nodiscard]] constexpr auto product(const Shape<Rank> &shape) -> usize {
+      usize count = 1;
+      for (const usize extent: shape) count *= extent;
+      return count;
+    }
+
+    /**
+     * @brief Row major strides (in elements) of a contiguous array of 'shape'
+     */
+    template<usize Rank>
+    [[nodiscard]] constexpr auto contiguous_strides(const Shape<Rank> &shape) -> Shape<Rank> {
+      Shape<Rank> strides;
+      usize step = 1;
+      for (usize d = Rank; d-- > 0;) {
+        strides[d] = step;
+        step *= shape[d];
+      }
+      return strides;
+    }
+
+    /**
+     * @brief Owned, cache line aligned & zero initialised elements, a Box<T[]> with an alignment
+     */
+    template<element T>
+    class Storage {
+      T *elements = nullptr;
+      usize len = 0;
+
+    public:
+      Storage() = default;
+
+      explicit Storage(const usize count)
+        : elements{static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ALIGNMENT}))}, len{count} {
+        std::memset(elements, 0, count * sizeof(T));
+      }
+
+      Storage(const Storage &from) : Storage{from.len} { std::memcpy(elements, from.elements, len * sizeof(T)); }
+
+      Storage(Storage &&from) noexcept
+        : elements{std::exchange(from.elements, nullptr)}, len{std::exchange(from.len, 0)} {}
+
+      auto operator=(Storage from) noexcept -> Storage& {
+        std::swap(elements, from.elements);
+        std::swap(len, from.len);
+        return *this;
+      }
+
+      ~Storage() {
+        if (elements != nullptr) ::operator delete(elements, std::align_val_t{ALIGNMENT});
+      }
+
+      [[nodiscard]] auto data() const -> T* { return elements; }
+
+      [[nodiscard]] auto length() const -> usize { return len; }
+    };
+
+    /**
+     * @brief One row of a view being evaluated, its elements are 'stride' apart (0 when broadcast along the row)
+     */
+    template<element T>
+    struct StridedRow {
+      static constexpr bool VECTOR = lane<T>;
+
+      const T *data;
+      usize stride;
+
+      [[nodiscard]] __always_inline auto vectorizable() const -> bool { return stride <= 1; }
+
+      [[nodiscard]] __always_inline auto get(const usize j) const -> T { return data[j * stride]; }
+
+      [[nodiscard]] __always_inline auto load(const usize j) const requires VECTOR {
+        return stride == 0 ? splat(data[0]) : helper::load(data + j);
+      }
+    };
+
+    template<element T>
+    struct ScalarRow {
+      static constexpr bool VECTOR = lane<T>;
+
+      T value;
+
+      [[nodiscard]] __always_inline auto vectorizable() const -> bool { return true; }
+
+      [[nodiscard]] __always_inline auto get(usize) const -> T { return value; }
+
+      [[nodiscard]] __always_inline auto load(usize) const requires VECTOR { return splat(value); }
+    };
+
+    template<typename Op, typename Inner>
+    struct MapRow {
+      using Input = decltype(std::declval<const Inner&>().get(0));
+      using T = Output<Op, Input>;
+      static constexpr bool VECTOR = Inner::VECTOR and vector_op<Op, T, Input>;
+
+      [[no_unique_address]] Op op;
+      Inner inner;
+
+      [[nodiscard]] __always_inline auto vectorizable() const -> bool { return inner.vectorizable(); }
+
+      [[nodiscard]] __always_inline auto get(const usize j) const -> T { return static_cast<T>(op(inner.get(j))); }
+
+      [[nodiscard]] __always_inline auto load(const usize j) const requires VECTOR {
+        return op(inner.load(j));
+      }
+    };
+
+    template<typename Op, typename Left, typename Right>
+    struct ZipRow {
+      using Input = decltype(std::declval<const Left&>().get(0));
+      using T = Output<Op, Input, Input>;
+      static constexpr bool VECTOR = Left::VECTOR and Right::VECTOR and vector_op<Op, T, Input, Input>;
+
+      [[no_unique_address]] Op op;
+      Left left;
+      Right right;
+
+      [[nodiscard]] __always_inline auto vectorizable() const -> bool {
+        return left.vectorizable() and right.vectorizable();
+      }
+
+      [[nodiscard]] __always_inline auto get(const usize j) const -> T {
+        return static_cast<T>(op(left.get(j), right.get(j)));
+      }
+
+      [[nodiscard]] __always_inline auto load(const usize j) const requires VECTOR {
+        return op(left.load(j), right.load(j));
+      }
+    };
+
+    // a tile of rows x columns is evaluated at a time when an operand is read across rows (a transpose), every
+    // cache line of it that is loaded then serves TILE_ROWS rows
+    inline constexpr usize TILE_ROWS = 16;
+    inline constexpr usize TILE_COLUMNS = 64;
+
+    /**
+     * @brief out[j * stride] = row[j] for j in [from, to), vectors at a time when both sides are contiguous (or
+     * broadcast)
+     */
+    template<element T, typename Row>
+    __always_inline auto evaluate_row(T *out, const usize stride, const Row &row, usize from, const usize to) -> void {
+      if constexpr (Row::VECTOR) {
+        if (stride == 1 and row.vectorizable()) {
+          for (; from + LANES<T> <= to; from += LANES<T>) store(out + from, row.load(from));
+        }
+      }
+      for (; from < to; from++) out[from * stride] = row.get(from);
+    }
+
+    /**
+     * @brief Odometer step over the first 'axes' axes of 'index'
+     */
+    template<usize Rank>
+    __always_inline auto advance(Shape<Rank> &index, const Shape<Rank> &shape, const usize axes) -> void {
+      for (usize d = axes; d-- > 0;) {
+        if (++index[d] < shape[d]) break;
+        index[d] = 0;
+      }
+    }
+
+    /**
+     * @brief Writes 'source' into 'into': as a single row when both are laid out contiguously, row by row when rows
+     * are contiguous, otherwise in tiles over the last two axes
+     */
+    template<element T, usize Rank, typename Source>
+    auto evaluate(const View<T, Rank> &into, const Source &source, const bool contiguous) -> void {
+      const Shape<Rank> &shape = into.shape();
+      const Shape<Rank> &strides = into.strides();
+      const usize length = shape[Rank - 1];
+      if (into.size() == 0) return;
+
+      if (contiguous and into.is_contiguous()) {
+        evaluate_row(into.data(), 1, source.row(Shape<Rank>{}), 0, into.size());
+        return;
+      }
+
+      const auto start = [&](const Shape<Rank> &index) {
+        T *out = into.data();
+        for (usize d = 0; d + 1 < Rank; d++) out += index[d] * strides[d];
+        return out;
+      };
+
+      Shape<Rank> index{};
+      if constexpr (Rank >= 2) {
+        if (strides[Rank - 1] != 1 or not source.row(index).vectorizable()) {
+          const usize rows = shape[Rank - 2];
+          for (usize plane = 0, planes = into.size() / (rows * length); plane < planes; plane++) {
+            for (usize first = 0; first < rows; first += TILE_ROWS) {
+              for (usize column = 0; column < length; column += TILE_COLUMNS) {
+                for (usize row = first; row < std::min(first + TILE_ROWS, rows); row++) {
+                  index[Rank - 2] = row;
+                  const usize end = std::min(column + TILE_COLUMNS, length);
+                  evaluate_row(start(index), strides[Rank - 1], source.row(index), column, end);
+                }
+              }
+            }
+            index[Rank - 2] = 0;
+            advance(index, shape, Rank - 2);
+          }
+          return;
+        }
+      }
+
+      for (usize row = 0, rows = into.size() / length; row < rows; row++) {
+        evaluate_row(start(index), strides[Rank - 1], source.row(index), 0, length);
+        advance(index, shape, Rank - 1);
+      }
+    }
+  }
+
+  /**
+   * @brief Anything an element wise expression can be built from & evaluated: views, arrays & the expression nodes
+   * combining them. row(index) gives the elements of the row at 'index' (whose last axis is ignored), contiguous()
+   * whether the whole expression could be read as one row major run.
+   */
+  template<typename E>
+  concept expression = requires(const E &e, const Shape<E::RANK> &index) {
+    typename E::value_type;
+    { e.shape() } -> std::same_as<Shape<E::RANK>>;
+    { e.contiguous() } -> std::same_as<bool>;
+    e.row(index);
+  };
+
+  /**
+   * @brief A constant that stands in for every element of the other side of an operator
+   */
+  template<element T>
+  class Scalar {
+    T value;
+
+  public:
+    using value_type = T;
+
+    explicit Scalar(const T value) : value{value} {}
+
+    template<usize Rank>
+    [[nodiscard]] __always_inline auto row(const Shape<Rank>&) const -> helper::ScalarRow<T> { return {value}; }
+  };
+
+  /**
+   * @brief 'op' applied to every element of 'inner', evaluated lazily
+   */
+  template<typename Op, expression Inner>
+  class Map {
+    Inner inner;
+    [[no_unique_address]] Op op;
+
+  public:
+    static constexpr usize RANK = Inner::RANK;
+    using value_type = helper::Output<Op, typename Inner::value_type>;
+    static_assert(element<value_type>, "nd expressions must produce arithmetic elements");
+
+    Map(Inner inner, Op op) : inner{std::move(inner)}, op{std::move(op)} {}
+
+    [[nodiscard]] auto shape() const -> Shape<RANK> { return inner.shape(); }
+
+    [[nodiscard]] auto contiguous() const -> bool { return inner.contiguous(); }
+
+    [[nodiscard]] __always_inline auto row(const Shape<RANK> &index) const {
+      return helper::MapRow<Op, decltype(inner.row(index))>{op, inner.row(index)};
+    }
+  };
+
+  /**
+   * @brief 'op' applied to the elements of 'left' & 'right' pairwise, evaluated lazily. Either side can be a Scalar,
+   * two expressions must have the same shape (broadcast_to makes them so without copying).
+   */
+  template<typename Op, typename Left, typename Right>
+    requires expression<Left> or expression<Right>
+  class Zip {
+    using Shaped = std::conditional_t<expression<Left>, Left, Right>;
+
+    Left left;
+    Right right;
+    [[no_unique_address]] Op op;
+
+  public:
+    static constexpr usize RANK = Shaped::RANK;
+    using value_type = helper::Output<Op, typename Left::value_type, typename Right::value_type>;
+    static_assert(element<value_type>, "nd expressions must produce arithmetic elements");
+    static_assert(
+      std::same_as<typename Left::value_type, typename Right::value_type>,
+      "Operands of an nd expression must have the same element type, convert one with nd::map"
+    );
+
+    Zip(Left left, Right right, Op op) : left{std::move(left)}, right{std::move(right)}, op{std::move(op)} {
+      if constexpr (expression<Left> and expression<Right>) {
+        debug_assert(
+          this->left.shape() == this->right.shape(),
+          "Operands of an nd expression must have the same shape, broadcast_to one of them"
+        );
+      }
+    }
+
+    [[nodiscard]] auto shape() const -> Shape<RANK> {
+      if constexpr (expression<Left>) {
+        return left.shape();
+      } else {
+        return right.shape();
+      }
+    }
+
+    [[nodiscard]] auto contiguous() const -> bool {
+      if constexpr (not expression<Left>) {
+        return right.contiguous();
+      } else if constexpr (not expression<Right>) {
+        return left.contiguous();
+      } else {
+        return left.contiguous() and right.contiguous();
+      }
+    }
+
+    [[nodiscard]] __always_inline auto row(const Shape<RANK> &index) const {
+      return helper::ZipRow<Op, decltype(left.row(index)), decltype(right.row(index))>{
+        op,
+        left.row(index),
+        right.row(index)
+      };
+    }
+  };
+
+  /**
+   * @brief Non owning, strided window of 'Rank' axes over elements, the NDArray counterpart of Span.
+   *
+   * Strides are in elements, row major views have a last stride of 1. Slicing, selecting, transposing &
+   * broadcasting only change the shape & strides, never the elements, a broadcast axis has stride 0.
+   */
+  template<typename T, usize Rank>
+    requires element<std::remove_const_t<T>> and (Rank >= 1)
+  class View {
+    T *pointer = nullptr;
+    Shape<Rank> extents{};
+    Shape<Rank> steps{};
+
+  public:
+    static constexpr usize RANK = Rank;
+    using value_type = std::remove_const_t<T>;
+
+    View() = default;
+
+    View(T *data, const Shape<Rank> &shape, const Shape<Rank> &strides)
+      : pointer{data}, extents{shape}, steps{strides} {}
+
+    /**
+     * @brief Row major view of contiguous elements
+     */
+    View(T *data, const Shape<Rank> &shape) : View{data, shape, helper::contiguous_strides(shape)} {}
+
+    operator View<const T, Rank>() const requires(not std::is_const_v<T>) { return {pointer, extents, steps}; }
+
+    #if defined(__cpp_lib_mdspan)
+    template<typename Extents, typename Layout>
+      requires(Extents::rank() == Rank)
+    explicit View(const std::mdspan<T, Extents, Layout> &from) : pointer{from.data_handle()} {
+      for (usize d = 0; d < Rank; d++) {
+        extents[d] = static_cast<usize>(from.extent(d));
+        steps[d] = static_cast<usize>(from.stride(d));
+      }
+    }
+
+    [[nodiscard]] auto to_mdspan() const -> std::mdspan<T, std::dextents<usize, Rank>, std::layout_stride> {
+      using Extents = std::dextents<usize, Rank>;
+      return {pointer, std::layout_stride::mapping<Extents>{Extents{extents}, steps}};
+    }
+    #endif
+
+    [[nodiscard]] auto data() const -> T* { return pointer; }
+
+    [[nodiscard]] auto shape() const -> Shape<Rank> { return extents; }
+
+    [[nodiscard]] auto strides() const -> const Shape<Rank>& { return steps; }
+
+    [[nodiscard]] auto size() const -> usize { return helper::product(extents); }
+
+    /**
+     * @brief Whether the elements are one row major run
+     */
+    [[nodiscard]] auto is_contiguous() const -> bool { return steps == helper::contiguous_strides(extents); }
+
+    template<std::convertible_to<usize>... Indices>
+      requires(sizeof...(Indices) == Rank)
+    [[nodiscard]] __always_inline auto operator()(const Indices... indices) const -> T& {
+      const Shape<Rank> index{static_cast<usize>(indices)...};
+      usize offset = 0;
+      for (usize d = 0; d < Rank; d++) {
+        debug_assert(index[d] < extents[d], "NDArray index out of bounds");
+        offset += index[d] * steps[d];
+      }
+      return pointer[offset];
+    }
+
+    /**
+     * @brief Every 'step'th element of 'axis' in [start, stop)
+     */
+    [[nodiscard]] auto slice(
+      const usize axis,
+      const usize start,
+      const usize stop,
+      const usize step = 1
+    ) const -> View {
+      debug_assert(axis < Rank, "Slice axis out of range");
+      debug_assert(start <= stop and stop <= extents[axis] and step > 0, "Slice out of bounds");
+      View sliced = *this;
+      sliced.pointer += start * steps[axis];
+      sliced.extents[axis] = (stop - start + step - 1) / step;
+      sliced.steps[axis] *= step;
+      return sliced;
+    }
+
+    /**
+     * @brief The view at 'index' along 'axis', one rank lower (a row or column of a matrix)
+     */
+    [[nodiscard]] auto select(const usize axis, const usize index) const requires(Rank > 1) {
+      debug_assert(axis < Rank and index < extents[axis], "Select out of bounds");
+      Shape<Rank - 1> shape, strides;
+      for (usize d = 0, to = 0; d < Rank; d++) {
+        if (d == axis) continue;
+        shape[to] = extents[d];
+        strides[to++] = steps[d];
+      }
+      return View<T, Rank - 1>{pointer + index * steps[axis], shape, strides};
+    }
+
+    /**
+     * @brief Axis d of the result is axis order[d] of this view
+     */
+    [[nodiscard]] auto permute(const Shape<Rank> &order) const -> View {
+      View permuted = *this;
+      for (usize d = 0; d < Rank; d++) {
+        debug_assert(order[d] < Rank, "Permutation axis out of range");
+        permuted.extents[d] = extents[order[d]];
+        permuted.steps[d] = steps[order[d]];
+      }
+      return permuted;
+    }
+
+    /**
+     * @brief The axes in reverse order
+     */
+    [[nodiscard]] auto transpose() const -> View {
+      Shape<Rank> order;
+      for (usize d = 0; d < Rank; d++) order[d] = Rank - 1 - d;
+      return permute(order);
+    }
+
+    /**
+     * @brief Read only view of 'shape' with NumPy's rules: axes are matched from the last one, missing axes & axes of
+     * extent 1 repeat (stride 0). None if an axis of this view is neither 1 nor the target extent.
+     */
+    template<usize To>
+      requires(To >= Rank)
+    [[nodiscard]] auto broadcast_to(const Shape<To> &shape) const -> Option<View<const T, To>> {
+      Shape<To> strides{};
+      for (usize d = To - Rank; d < To; d++) {
+        const usize from = d - (To - Rank);
+        if (extents[from] == shape[d]) {
+          strides[d] = steps[from];
+        } else if (extents[from] != 1) {
+          return crab::none;
+        }
+      }
+      return crab::some(View<const T, To>{pointer, shape, strides});
+    }
+
+    /**
+     * @brief Writes every element of 'source' (of the same shape) into this view. The source is read while the
+     * view is written, so it must not read elements of this view at other positions (a transpose of itself).
+     */
+    template<expression Source>
+    auto assign(const Source &source) const -> void requires(not std::is_const_v<T>) {
+      static_assert(Source::RANK == Rank, "Assigned expression has a different rank");
+      debug_assert(source.shape() == extents, "Assigned expression has a different shape");
+      helper::evaluate(*this, source, source.contiguous());
+    }
+
+    auto fill(const value_type value) const -> void requires(not std::is_const_v<T>) {
+      helper::evaluate(*this, Scalar{value}, true);
+    }
+
+    [[nodiscard]] auto contiguous() const -> bool { return is_contiguous(); }
+
+    [[nodiscard]] __always_inline auto row(const Shape<Rank> &index) const -> helper::StridedRow<value_type> {
+      const T *start = pointer;
+      for (usize d = 0; d + 1 < Rank; d++) start += index[d] * steps[d];
+      return {start, steps[Rank - 1]};
+    }
+  };
+
+  /**
+   * @brief Owned, row major N dimensional array of arithmetic elements in cache line aligned storage.
+   *
+   * Views (view(), then slice / select / transpose / broadcast_to) never copy. Arithmetic operators on arrays,
+   * views & scalars build expression templates that are evaluated in a single pass once assigned or converted to
+   * an NDArray, without temporaries, a vector of lanes at a time where the innermost axis is contiguous:
+   *
+   * @code
+   * crab::NDArray<f32, 2> normalised = (image - mean.view().broadcast_to(image.shape()).take_unchecked()) * scale;
+   * @endcode
+   *
+   * Expressions refer to their operands, they must be evaluated before any operand is destroyed.
+   */
+  template<element T, usize Rank>
+    requires(Rank >= 1)
+  class NDArray {
+    helper::Storage<T> storage;
+    Shape<Rank> extents{};
+
+  public:
+    static constexpr usize RANK = Rank;
+    using value_type = T;
+
+    NDArray() = default;
+
+    /**
+     * @brief Zero initialised
+     */
+    explicit NDArray(const Shape<Rank> &shape) : storage{helper::product(shape)}, extents{shape} {}
+
+    NDArray(const Shape<Rank> &shape, const T value) : NDArray{shape} { fill(value); }
+
+    /**
+     * @brief Evaluates 'source'
+     */
+    template<expression Source>
+      requires(Source::RANK == Rank and std::same_as<typename Source::value_type, T>)
+    NDArray(const Source &source) : NDArray{source.shape()} { view().assign(source); }
+
+    [[nodiscard]] auto view() -> View<T, Rank> { return {storage.data(), extents}; }
+
+    [[nodiscard]] auto view() const -> View<const T, Rank> { return {storage.data(), extents}; }
+
+    #if defined(__cpp_lib_mdspan)
+    [[nodiscard]] auto to_mdspan() -> std::mdspan<T, std::dextents<usize, Rank>> {
+      return {storage.data(), std::dextents<usize, Rank>{extents}};
+    }
+
+    [[nodiscard]] auto to_mdspan() const -> std::mdspan<const T, std::dextents<usize, Rank>> {
+      return {storage.data(), std::dextents<usize, Rank>{extents}};
+    }
+    #endif
+
+    [[nodiscard]] auto data() -> T* { return storage.data(); }
+
+    [[nodiscard]] auto data() const -> const T* { return storage.data(); }
+
+    [[nodiscard]] auto shape() const -> Shape<Rank> { return extents; }
+
+    [[nodiscard]] auto size() const -> usize { return storage.length(); }
+
+    [[nodiscard]] auto as_span() -> Span<T> { return {storage.data(), storage.length()}; }
+
+    [[nodiscard]] auto as_span() const -> Span<const T> { return {storage.data(), storage.length()}; }
+
+    template<std::convertible_to<usize>... Indices>
+      requires(sizeof...(Indices) == Rank)
+    [[nodiscard]] __always_inline auto operator()(const Indices... indices) -> T& { return view()(indices...); }
+
+    template<std::convertible_to<usize>... Indices>
+      requires(sizeof...(Indices) == Rank)
+    [[nodiscard]] __always_inline auto operator()(const Indices... indices) const -> const T& {
+      return view()(indices...);
+    }
+
+    /**
+     * @brief Evaluates 'source' (of the same shape) into this array, see View::assign for aliasing
+     */
+    template<expression Source>
+    auto assign(const Source &source) -> void { view().assign(source); }
+
+    auto fill(const T value) -> void { view().fill(value); }
+
+    [[nodiscard]] auto contiguous() const -> bool { return true; }
+
+    [[nodiscard]] __always_inline auto row(const Shape<Rank> &index) const -> helper::StridedRow<T> {
+      return view().row(index);
+    }
+  };
+
+  namespace helper {
+    template<typename T>
+    inline constexpr bool is_scalar = false;
+
+    template<typename T>
+    inline constexpr bool is_scalar<Scalar<T>> = true;
+
+    template<typename T>
+    concept operand = expression<T> or is_scalar<T>;
+
+    /**
+     * @brief How an operand is held inside an expression: arrays & views as read only views, the rest by value
+     */
+    template<typename T, usize Rank>
+    [[nodiscard]] auto hold(const NDArray<T, Rank> &array) -> View<const T, Rank> { return array.view(); }
+
+    template<typename T, usize Rank>
+    [[nodiscard]] auto hold(const View<T, Rank> &view) -> View<const std::remove_const_t<T>, Rank> { return view; }
+
+    template<operand T>
+    [[nodiscard]] auto hold(const T &node) -> const T& { return node; }
+
+    template<typename T>
+    using Held = std::remove_cvref_t<decltype(hold(std::declval<const T&>()))>;
+  }
+
+  /**
+   * @brief Lazily applies 'op' to every element of 'source', 'op' is also called with vectors of elements (GCC /
+   * Clang vector extensions) when it accepts them
+   */
+  template<helper::operand Source, typename Op>
+  [[nodiscard]] auto map(const Source &source, Op op) -> Map<Op, helper::Held<Source>> {
+    return {helper::hold(source), std::move(op)};
+  }
+
+  /**
+   * @brief Lazily applies 'op' to the elements of 'left' & 'right' pairwise, see map for vectors
+   */
+  template<helper::operand Left, helper::operand Right, typename Op>
+  [[nodiscard]] auto zip(
+    const Left &left,
+    const Right &right,
+    Op op
+  ) -> Zip<Op, helper::Held<Left>, helper::Held<Right>> {
+    return {helper::hold(left), helper::hold(right), std::move(op)};
+  }
+
+  template<helper::operand Source>
+  [[nodiscard]] auto operator-(const Source &source) { return map(source, std::negate<>{}); }
+
+  #define crab_nd_operator(symbol, functor)                                                                   \
+    template<helper::operand Left, helper::operand Right>                                                     \
+    [[nodiscard]] auto operator symbol(const Left &left, const Right &right) {                                \
+      return zip(left, right, functor{});                                                                     \
+    }                                                                                                         \
+                                                                                                              \
+    template<helper::operand Left, element S>                                                                 \
+    [[nodiscard]] auto operator symbol(const Left &left, const S right) {                                     \
+      return zip(left, Scalar{static_cast<typename helper::Held<Left>::value_type>(right)}, functor{});       \
+    }                                                                                                         \
+                                                                                                              \
+    template<element S, helper::operand Right>                                                                \
+    [[nodiscard]] auto operator symbol(const S left, const Right &right) {                                    \
+      return zip(Scalar{static_cast<typename helper::Held<Right>::value_type>(left)}, right, functor{});      \
+    }
+
+  crab_nd_operator(+, std::plus<>)
+  crab_nd_operator(-, std::minus<>)
+  crab_nd_operator(*, std::multiplies<>)
+  crab_nd_operator(/, std::divides<>)
+
+  #undef crab_nd_operator
+}
+
+namespace crab {
+  using nd::NDArray;
+}
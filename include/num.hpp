@@ -0,0 +1,283 @@
+#pragma once
+
+#include <compare>
+#include <concepts>
+#include <limits>
+#include <type_traits>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/simd.hpp"
+#include "option.hpp"
+
+namespace crab::num {
+  /**
+   * @brief Integer types the overflow aware arithmetic works with
+   */
+  template<typename T>
+  concept integer = std::is_integral_v<T> and not std::same_as<T, bool>;
+
+  namespace helper {
+    /**
+     * @brief Value an overflowing signed operation clamps to, given the sign the exact result would have had
+     */
+    template<integer T>
+    [[nodiscard]] __always_inline constexpr auto saturation(const bool negative) -> T {
+      return negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    }
+  }
+}
+
+namespace crab {
+  /**
+   * @brief a + b, None if the result does not fit in T
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline auto checked_add(const T a, const T b) -> Option<T> {
+    T result;
+    if (__builtin_add_overflow(a, b, &result)) return crab::none;
+    return crab::some(result);
+  }
+
+  /**
+   * @brief a - b, None if the result does not fit in T
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline auto checked_sub(const T a, const T b) -> Option<T> {
+    T result;
+    if (__builtin_sub_overflow(a, b, &result)) return crab::none;
+    return crab::some(result);
+  }
+
+  /**
+   * @brief a * b, None if the result does not fit in T
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline auto checked_mul(const T a, const T b) -> Option<T> {
+    T result;
+    if (__builtin_mul_overflow(a, b, &result)) return crab::none;
+    return crab::some(result);
+  }
+
+  /**
+   * @brief a / b, None when dividing by zero or for the one overflowing division (min / -1)
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline auto checked_div(const T a, const T b) -> Option<T> {
+    if (b == 0) return crab::none;
+    if constexpr (std::is_signed_v<T>) {
+      if (a == std::numeric_limits<T>::min() and b == -1) return crab::none;
+    }
+    return crab::some(static_cast<T>(a / b));
+  }
+
+  /**
+   * @brief a + b modulo 2^bits, also for signed T (where plain overflow is undefined)
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline constexpr auto wrapping_add(const T a, const T b) -> T {
+    T result;
+    (void) __builtin_add_overflow(a, b, &result);
+    return result;
+  }
+
+  template<num::integer T>
+  [[nodiscard]] __always_inline constexpr auto wrapping_sub(const T a, const T b) -> T {
+    T result;
+    (void) __builtin_sub_overflow(a, b, &result);
+    return result;
+  }
+
+  template<num::integer T>
+  [[nodiscard]] __always_inline constexpr auto wrapping_mul(const T a, const T b) -> T {
+    T result;
+    (void) __builtin_mul_overflow(a, b, &result);
+    return result;
+  }
+
+  /**
+   * @brief a / b, where min / -1 wraps around to min
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline constexpr auto wrapping_div(const T a, const T b) -> T {
+    debug_assert(b != 0, "Division by zero");
+    if constexpr (std::is_signed_v<T>) {
+      if (b == -1) return wrapping_sub(T{0}, a);
+    }
+    return static_cast<T>(a / b);
+  }
+
+  /**
+   * @brief a + b clamped to [min, max] of T
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline constexpr auto saturating_add(const T a, const T b) -> T {
+    T result;
+    if (__builtin_add_overflow(a, b, &result)) {
+      if constexpr (std::is_signed_v<T>) return num::helper::saturation<T>(a < 0);
+      else return std::numeric_limits<T>::max();
+    }
+    return result;
+  }
+
+  /**
+   * @brief a - b clamped to [min, max] of T
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline constexpr auto saturating_sub(const T a, const T b) -> T {
+    T result;
+    if (__builtin_sub_overflow(a, b, &result)) {
+      if constexpr (std::is_signed_v<T>) return num::helper::saturation<T>(a < 0);
+      else return T{0};
+    }
+    return result;
+  }
+
+  /**
+   * @brief a * b clamped to [min, max] of T
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline constexpr auto saturating_mul(const T a, const T b) -> T {
+    T result;
+    if (__builtin_mul_overflow(a, b, &result)) {
+      if constexpr (std::is_signed_v<T>) return num::helper::saturation<T>((a < 0) != (b < 0));
+      else return std::numeric_limits<T>::max();
+    }
+    return result;
+  }
+
+  /**
+   * @brief a / b, where min / -1 clamps to max
+   */
+  template<num::integer T>
+  [[nodiscard]] __always_inline constexpr auto saturating_div(const T a, const T b) -> T {
+    debug_assert(b != 0, "Division by zero");
+    if constexpr (std::is_signed_v<T>) {
+      if (a == std::numeric_limits<T>::min() and b == -1) return std::numeric_limits<T>::max();
+    }
+    return static_cast<T>(a / b);
+  }
+
+  /**
+   * @brief dst[i] = saturating_add(dst[i], src[i]) over whole spans, vectorised (native saturating instructions
+   * for 8 & 16 bit lanes)
+   */
+  template<num::integer T>
+  auto saturating_add(const Span<T> dst, const Span<const T> src) -> void {
+    debug_assert(dst.size() == src.size(), "Spans must have the same length");
+    simd::saturating_add(dst.data(), src.data(), dst.size());
+  }
+
+  /**
+   * @brief dst[i] = saturating_sub(dst[i], src[i]) over whole spans, vectorised
+   */
+  template<num::integer T>
+  auto saturating_sub(const Span<T> dst, const Span<const T> src) -> void {
+    debug_assert(dst.size() == src.size(), "Spans must have the same length");
+    simd::saturating_sub(dst.data(), src.data(), dst.size());
+  }
+
+  /**
+   * @brief Integer whose arithmetic wraps around on overflow (modulo 2^bits) instead of being undefined for signed
+   * types, for hashes, checksums & sequence numbers where that is the intent.
+   */
+  template<num::integer T>
+  class Wrapping {
+    T value{};
+
+  public:
+    constexpr Wrapping() = default;
+
+    constexpr explicit Wrapping(const T value) : value{value} {}
+
+    [[nodiscard]] __always_inline constexpr auto get() const -> T { return value; }
+
+    [[nodiscard]] __always_inline constexpr friend auto operator+(const Wrapping a, const Wrapping b) -> Wrapping {
+      return Wrapping{wrapping_add(a.value, b.value)};
+    }
+
+    [[nodiscard]] __always_inline constexpr friend auto operator-(const Wrapping a, const Wrapping b) -> Wrapping {
+      return Wrapping{wrapping_sub(a.value, b.value)};
+    }
+
+    [[nodiscard]] __always_inline constexpr friend auto operator*(const Wrapping a, const Wrapping b) -> Wrapping {
+      return Wrapping{wrapping_mul(a.value, b.value)};
+    }
+
+    [[nodiscard]] __always_inline constexpr friend auto operator/(const Wrapping a, const Wrapping b) -> Wrapping {
+      return Wrapping{wrapping_div(a.value, b.value)};
+    }
+
+    [[nodiscard]] __always_inline constexpr auto operator-() const -> Wrapping {
+      return Wrapping{wrapping_sub(T{0}, value)};
+    }
+
+    __always_inline constexpr auto operator+=(const Wrapping other) -> Wrapping& { return *this = *this + other; }
+
+    __always_inline constexpr auto operator-=(const Wrapping other) -> Wrapping& { return *this = *this - other; }
+
+    __always_inline constexpr auto operator*=(const Wrapping other) -> Wrapping& { return *this = *this * other; }
+
+    __always_inline constexpr auto operator/=(const Wrapping other) -> Wrapping& { return *this = *this / other; }
+
+    [[nodiscard]] constexpr friend auto operator<=>(const Wrapping &, const Wrapping &) = default;
+  };
+
+  /**
+   * @brief Integer whose arithmetic clamps to T's range on overflow, for counters, gains & pixel math that
+   * should stick at the limits instead of wrapping around.
+   */
+  template<num::integer T>
+  class Saturating {
+    T value{};
+
+  public:
+    constexpr Saturating() = default;
+
+    constexpr explicit Saturating(const T value) : value{value} {}
+
+    [[nodiscard]] __always_inline constexpr auto get() const -> T { return value; }
+
+    [[nodiscard]] __always_inline constexpr friend auto operator+(
+      const Saturating a,
+      const Saturating b
+    ) -> Saturating {
+      return Saturating{saturating_add(a.value, b.value)};
+    }
+
+    [[nodiscard]] __always_inline constexpr friend auto operator-(
+      const Saturating a,
+      const Saturating b
+    ) -> Saturating {
+      return Saturating{saturating_sub(a.value, b.value)};
+    }
+
+    [[nodiscard]] __always_inline constexpr friend auto operator*(
+      const Saturating a,
+      const Saturating b
+    ) -> Saturating {
+      return Saturating{saturating_mul(a.value, b.value)};
+    }
+
+    [[nodiscard]] __always_inline constexpr friend auto operator/(
+      const Saturating a,
+      const Saturating b
+    ) -> Saturating {
+      return Saturating{saturating_div(a.value, b.value)};
+    }
+
+    [[nodiscard]] __always_inline constexpr auto operator-() const -> Saturating requires std::is_signed_v<T> {
+      return Saturating{saturating_sub(T{0}, value)};
+    }
+
+    __always_inline constexpr auto operator+=(const Saturating other) -> Saturating& { return *this = *this + other; }
+
+    __always_inline constexpr auto operator-=(const Saturating other) -> Saturating& { return *this = *this - other; }
+
+    __always_inline constexpr auto operator*=(const Saturating other) -> Saturating& { return *this = *this * other; }
+
+    __always_inline constexpr auto operator/=(const Saturating other) -> Saturating& { return *this = *this / other; }
+
+    [[nodiscard]] constexpr friend auto operator<=>(const Saturating &, const Saturating &) = default;
+  };
+}
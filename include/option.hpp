@@ -126,12 +126,11 @@ public:
   }
 
   /**
-   * @brief Takes value out of the option and returns it, will error if option is none
+   * @brief Takes value out of the option and returns it, will error if option is none (undefined behaviour in
+   * release builds)
    */
   [[nodiscard]] auto take_unchecked() -> Contained {
-    #if DEBUG
-    debug_assert(is_some(), "Cannot take value from a empty option.");
-    #endif
+    debug_assume(is_some(), "Cannot take value from a empty option.");
     return std::get<Contained>(std::exchange(value, crab::None{}));
   }
 
@@ -201,9 +200,21 @@ public:
     return is_some() ? Contained{get_unchecked()} : Contained{default_generator()};
   }
 
-  [[nodiscard]] auto get_unchecked() -> Contained& { return std::get<Contained>(value); }
+  /**
+   * @brief The contained value, will error if option is none (undefined behaviour in release builds)
+   */
+  [[nodiscard]] auto get_unchecked() -> Contained& {
+    debug_assume(is_some(), "Cannot get value from a empty option.");
+    return std::get<Contained>(value);
+  }
 
-  [[nodiscard]] auto get_unchecked() const -> const Contained& { return std::get<Contained>(value); }
+  /**
+   * @brief The contained value, will error if option is none (undefined behaviour in release builds)
+   */
+  [[nodiscard]] auto get_unchecked() const -> const Contained& {
+    debug_assume(is_some(), "Cannot get value from a empty option.");
+    return std::get<Contained>(value);
+  }
 
   /**
    * @brief Creates a Result<T, E> from this given option, where "None" is expanded to some error given.
@@ -0,0 +1,528 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/simd.hpp"
+
+namespace crab::packed {
+  /**
+   * @brief Bit width of a PackedVec that is chosen at runtime
+   */
+  inline constexpr usize DYNAMIC = std::numeric_limits<usize>::max();
+
+  /**
+   * @brief Amount of values per block of PackedFrameVec / PackedDeltaVec, 128 values of any width always fill a
+   * whole number of words so every block starts word aligned.
+   */
+  inline constexpr usize BLOCK_SIZE = 128;
+
+  /**
+   * @brief Smallest bit width that can hold 'max'
+   */
+  [[nodiscard]] constexpr auto bits_for(const u32 max) -> u32 { return static_cast<u32>(std::bit_width(max)); }
+
+  namespace helper {
+    /**
+     * @brief Words needed for 'count' values of 'bits' bits including padding, a value starting at bit b reads
+     * the words b / 64 and b / 64 + 1 (gathers in simd::unpack_bits stay within the same two words).
+     */
+    [[nodiscard]] __always_inline constexpr auto words_for(const usize count, const u32 bits) -> usize {
+      return count * bits / 64 + 2;
+    }
+
+    __always_inline auto write(u64 *words, const u64 bit, const u32 bits, const u32 value) -> void {
+      const u64 index = bit / 64;
+      const u32 shift = static_cast<u32>(bit % 64);
+      const u64 mask = (u64{1} << bits) - 1;
+
+      words[index] = (words[index] & ~(mask << shift)) | (u64{value} << shift);
+      // part that spills into the next word, empty when it fits (split shifts so shift == 0 is well defined)
+      words[index + 1] = (words[index + 1] & ~((mask >> 1) >> (63 - shift))) | ((u64{value} >> 1) >> (63 - shift));
+    }
+
+    /**
+     * @brief Packs 'count' values into 'words' which must start zeroed, through a 64 bit accumulator so every
+     * word is stored once.
+     */
+    inline auto pack(u64 *words, const u32 bits, const u32 *values, const usize count) -> void {
+      u64 accumulator = 0;
+      u32 filled = 0;
+      for (usize i = 0; i < count; i++) {
+        debug_assert(bits == 32 or values[i] >> bits == 0, "Value does not fit in the bit width");
+        accumulator |= u64{values[i]} << filled;
+        filled += bits;
+        if (filled >= 64) {
+          *words++ = accumulator;
+          filled -= 64;
+          accumulator = filled == 0 ? 0 : u64{values[i]} >> (bits - filled);
+        }
+      }
+      if (filled != 0) *words = accumulator;
+    }
+
+    struct Empty {};
+  }
+
+  /**
+   * @brief Ascending cursor over a block encoded vector, decodes a whole block at a time through 'unpack'
+   */
+  template<typename V>
+  class BlockIterator {
+    const V *vec = nullptr;
+    usize index = 0;
+    std::array<u32, BLOCK_SIZE> buffer{};
+
+    auto fill() -> void {
+      if (index >= vec->length()) return;
+      const usize count = std::min(BLOCK_SIZE, vec->length() - index);
+      vec->unpack(index, Span<u32>{buffer.data(), count});
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = u32;
+    using reference = u32;
+
+    BlockIterator() = default;
+
+    BlockIterator(const V &vec, const usize index) : vec{&vec}, index{index} { fill(); }
+
+    [[nodiscard]] __always_inline auto operator*() const -> reference { return buffer[index % BLOCK_SIZE]; }
+
+    __always_inline auto operator++() -> BlockIterator& {
+      if (++index % BLOCK_SIZE == 0) fill();
+      return *this;
+    }
+
+    __always_inline auto operator++(int) -> BlockIterator {
+      BlockIterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    [[nodiscard]] __always_inline friend auto operator==(const BlockIterator &a, const BlockIterator &b) -> bool {
+      return a.index == b.index;
+    }
+  };
+}
+
+namespace crab {
+  /**
+   * @brief Vector of unsigned integers that are each stored in exactly BITS bits (at most 32), values are laid
+   * out back to back across word boundaries.
+   *
+   * For arrays whose values only need a handful of bits this cuts memory (& memory bandwidth) by 32 / BITS,
+   * get / set stay O(1) & bulk decoding (unpack) is vectorised. With BITS = packed::DYNAMIC the width is passed
+   * to the constructor instead.
+   */
+  template<usize BITS = packed::DYNAMIC>
+    requires (BITS == packed::DYNAMIC or BITS <= 32)
+  class PackedVec {
+    Vec<u64> data;
+    usize len = 0;
+    [[no_unique_address]] std::conditional_t<BITS == packed::DYNAMIC, u32, packed::helper::Empty> width{};
+
+  public:
+    class Iterator {
+      const PackedVec *vec = nullptr;
+      usize index = 0;
+
+    public:
+      using iterator_category = std::random_access_iterator_tag;
+      using difference_type = std::ptrdiff_t;
+      using value_type = u32;
+      using reference = u32;
+
+      Iterator() = default;
+
+      __always_inline Iterator(const PackedVec &vec, const usize index) : vec{&vec}, index{index} {}
+
+      [[nodiscard]] __always_inline auto operator*() const -> reference { return vec->get(index); }
+
+      [[nodiscard]] __always_inline auto operator[](const difference_type offset) const -> reference {
+        return vec->get(static_cast<usize>(static_cast<difference_type>(index) + offset));
+      }
+
+      __always_inline auto operator++() -> Iterator& {
+        ++index;
+        return *this;
+      }
+
+      __always_inline auto operator++(int) -> Iterator {
+        Iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      __always_inline auto operator--() -> Iterator& {
+        --index;
+        return *this;
+      }
+
+      __always_inline auto operator--(int) -> Iterator {
+        Iterator tmp = *this;
+        --*this;
+        return tmp;
+      }
+
+      __always_inline auto operator+=(const difference_type offset) -> Iterator& {
+        index = static_cast<usize>(static_cast<difference_type>(index) + offset);
+        return *this;
+      }
+
+      __always_inline auto operator-=(const difference_type offset) -> Iterator& { return *this += -offset; }
+
+      [[nodiscard]] __always_inline friend auto operator+(Iterator it, const difference_type offset) -> Iterator {
+        return it += offset;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator+(const difference_type offset, Iterator it) -> Iterator {
+        return it += offset;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator-(Iterator it, const difference_type offset) -> Iterator {
+        return it -= offset;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator-(const Iterator &a, const Iterator &b) -> difference_type {
+        return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+      }
+
+      [[nodiscard]] __always_inline friend auto operator==(const Iterator &a, const Iterator &b) -> bool {
+        return a.index == b.index;
+      }
+
+      [[nodiscard]] __always_inline friend auto operator<=>(const Iterator &a, const Iterator &b) {
+        return a.index <=> b.index;
+      }
+    };
+
+    /**
+     * @brief 'length' zeroes
+     */
+    explicit PackedVec(const usize length = 0) requires (BITS != packed::DYNAMIC)
+      : data(packed::helper::words_for(length, BITS), 0), len{length} {}
+
+    /**
+     * @brief 'length' zeroes of 'bits' bits each
+     */
+    PackedVec(const usize length, const u32 bits) requires (BITS == packed::DYNAMIC)
+      : data(packed::helper::words_for(length, bits), 0), len{length}, width{bits} {
+      debug_assert(bits <= 32, "PackedVec holds at most 32 bit values");
+    }
+
+    /**
+     * @brief Packs 'values' which must all fit in BITS bits
+     */
+    [[nodiscard]] static auto from_values(const Span<const u32> values) -> PackedVec requires (BITS != packed::DYNAMIC) {
+      PackedVec vec{values.size()};
+      packed::helper::pack(vec.data.data(), BITS, values.data(), values.size());
+      return vec;
+    }
+
+    /**
+     * @brief Packs 'values' with the smallest width that fits the largest one
+     */
+    [[nodiscard]] static auto from_values(const Span<const u32> values) -> PackedVec requires (BITS == packed::DYNAMIC) {
+      const u32 max = values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+      return from_values(values, packed::bits_for(max));
+    }
+
+    /**
+     * @brief Packs 'values' which must all fit in 'bits' bits
+     */
+    [[nodiscard]] static auto from_values(const Span<const u32> values, const u32 bits) -> PackedVec
+      requires (BITS == packed::DYNAMIC) {
+      PackedVec vec{values.size(), bits};
+      packed::helper::pack(vec.data.data(), bits, values.data(), values.size());
+      return vec;
+    }
+
+    /**
+     * @brief Bits per value
+     */
+    [[nodiscard]] __always_inline auto bits() const -> u32 {
+      if constexpr (BITS == packed::DYNAMIC) {
+        return width;
+      } else {
+        return static_cast<u32>(BITS);
+      }
+    }
+
+    /**
+     * @brief Amount of values
+     */
+    [[nodiscard]] __always_inline auto length() const -> usize { return len; }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return len == 0; }
+
+    [[nodiscard]] __always_inline auto get(const usize index) const -> u32 {
+      debug_assert(index < len, "Index out of Bounds");
+      return simd::read_bits(data.data(), u64{index} * bits(), bits());
+    }
+
+    [[nodiscard]] __always_inline auto operator[](const usize index) const -> u32 { return get(index); }
+
+    __always_inline auto set(const usize index, const u32 value) -> void {
+      debug_assert(index < len, "Index out of Bounds");
+      debug_assert(bits() == 32 or value >> bits() == 0, "Value does not fit in the bit width");
+      packed::helper::write(data.data(), u64{index} * bits(), bits(), value);
+    }
+
+    auto push(const u32 value) -> void {
+      data.resize(packed::helper::words_for(len + 1, bits()), 0);
+      len++;
+      set(len - 1, value);
+    }
+
+    /**
+     * @brief Decodes values [first, first + out.size()) into 'out'
+     */
+    auto unpack(const usize first, const Span<u32> out) const -> void {
+      debug_assert(first + out.size() <= len, "Index out of Bounds");
+      simd::unpack_bits(data.data(), u64{first} * bits(), bits(), out.size(), out.data());
+    }
+
+    [[nodiscard]] auto to_vec() const -> Vec<u32> {
+      Vec<u32> values(len);
+      unpack(0, values);
+      return values;
+    }
+
+    /**
+     * @brief Heap memory used by the packed values
+     */
+    [[nodiscard]] auto memory_bytes() const -> usize { return data.capacity() * sizeof(u64); }
+
+    [[nodiscard]] auto begin() const -> Iterator { return Iterator{*this, 0}; }
+
+    [[nodiscard]] auto end() const -> Iterator { return Iterator{*this, len}; }
+  };
+
+  /**
+   * @brief Immutable packed vector with frame of reference encoding: every block of 128 values stores its minimum
+   * & the offsets from it with the width its largest offset needs.
+   *
+   * Good for clustered values (ids, timestamps) whose absolute values are large but vary little locally, random
+   * access stays O(1).
+   */
+  class PackedFrameVec {
+    struct Block {
+      u32 base;
+      u32 bits;
+      // first word of the block in 'data'
+      usize word;
+    };
+
+    Vec<Block> blocks;
+    Vec<u64> data;
+    usize len = 0;
+
+  public:
+    using Iterator = packed::BlockIterator<PackedFrameVec>;
+
+    PackedFrameVec() = default;
+
+    [[nodiscard]] static auto from_values(const Span<const u32> values) -> PackedFrameVec {
+      PackedFrameVec vec;
+      vec.len = values.size();
+
+      usize words = 0;
+      for (usize first = 0; first < values.size(); first += packed::BLOCK_SIZE) {
+        const Span<const u32> block = values.subspan(first, std::min(packed::BLOCK_SIZE, values.size() - first));
+        const auto [min, max] = std::minmax_element(block.begin(), block.end());
+        const u32 bits = packed::bits_for(*max - *min);
+        vec.blocks.push_back(Block{*min, bits, words});
+        words += (block.size() * bits + 63) / 64;
+      }
+      vec.data.resize(words + 2, 0);
+
+      std::array<u32, packed::BLOCK_SIZE> offsets;
+      for (usize b = 0; b < vec.blocks.size(); b++) {
+        const Block &block = vec.blocks[b];
+        const usize first = b * packed::BLOCK_SIZE;
+        const usize count = std::min(packed::BLOCK_SIZE, values.size() - first);
+        for (usize i = 0; i < count; i++) offsets[i] = values[first + i] - block.base;
+        packed::helper::pack(vec.data.data() + block.word, block.bits, offsets.data(), count);
+      }
+      return vec;
+    }
+
+    [[nodiscard]] __always_inline auto length() const -> usize { return len; }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return len == 0; }
+
+    [[nodiscard]] __always_inline auto get(const usize index) const -> u32 {
+      debug_assert(index < len, "Index out of Bounds");
+      const Block &block = blocks[index / packed::BLOCK_SIZE];
+      return block.base + simd::read_bits(
+               data.data() + block.word,
+               u64{index % packed::BLOCK_SIZE} * block.bits,
+               block.bits
+             );
+    }
+
+    [[nodiscard]] __always_inline auto operator[](const usize index) const -> u32 { return get(index); }
+
+    /**
+     * @brief Decodes values [first, first + out.size()) into 'out'
+     */
+    auto unpack(usize first, Span<u32> out) const -> void {
+      debug_assert(first + out.size() <= len, "Index out of Bounds");
+      while (not out.empty()) {
+        const Block &block = blocks[first / packed::BLOCK_SIZE];
+        const usize offset = first % packed::BLOCK_SIZE;
+        const usize count = std::min(packed::BLOCK_SIZE - offset, out.size());
+
+        simd::unpack_bits(data.data() + block.word, u64{offset} * block.bits, block.bits, count, out.data());
+        for (usize i = 0; i < count; i++) out[i] += block.base;
+
+        first += count;
+        out = out.subspan(count);
+      }
+    }
+
+    [[nodiscard]] auto to_vec() const -> Vec<u32> {
+      Vec<u32> values(len);
+      unpack(0, values);
+      return values;
+    }
+
+    /**
+     * @brief Heap memory used by the packed values & block headers
+     */
+    [[nodiscard]] auto memory_bytes() const -> usize {
+      return data.capacity() * sizeof(u64) + blocks.capacity() * sizeof(Block);
+    }
+
+    [[nodiscard]] auto begin() const -> Iterator { return Iterator{*this, 0}; }
+
+    [[nodiscard]] auto end() const -> Iterator { return Iterator{*this, len}; }
+  };
+
+  /**
+   * @brief Immutable packed vector for ascending (non decreasing) values, each block of 128 stores its first value
+   * & the gaps between neighbours packed with the width its largest gap needs.
+   *
+   * Dense sorted data (posting lists, offsets) compresses to a few bits per value. Decoding is a vectorised unpack
+   * followed by a vectorised prefix sum, so get() costs a partial block decode (up to 128 values), prefer unpack or
+   * iteration for bulk access.
+   */
+  class PackedDeltaVec {
+    struct Block {
+      u32 first;
+      u32 bits;
+      usize word;
+    };
+
+    Vec<Block> blocks;
+    Vec<u64> data;
+    usize len = 0;
+
+  public:
+    using Iterator = packed::BlockIterator<PackedDeltaVec>;
+
+    PackedDeltaVec() = default;
+
+    [[nodiscard]] static auto from_values(const Span<const u32> values) -> PackedDeltaVec {
+      debug_assert(std::is_sorted(values.begin(), values.end()), "PackedDeltaVec needs ascending values");
+
+      PackedDeltaVec vec;
+      vec.len = values.size();
+
+      usize words = 0;
+      for (usize first = 0; first < values.size(); first += packed::BLOCK_SIZE) {
+        const usize count = std::min(packed::BLOCK_SIZE, values.size() - first);
+        u32 max_gap = 0;
+        for (usize i = first + 1; i < first + count; i++) max_gap = std::max(max_gap, values[i] - values[i - 1]);
+
+        const u32 bits = packed::bits_for(max_gap);
+        vec.blocks.push_back(Block{values[first], bits, words});
+        words += (count * bits + 63) / 64;
+      }
+      vec.data.resize(words + 2, 0);
+
+      std::array<u32, packed::BLOCK_SIZE> gaps;
+      for (usize b = 0; b < vec.blocks.size(); b++) {
+        const Block &block = vec.blocks[b];
+        const usize first = b * packed::BLOCK_SIZE;
+        const usize count = std::min(packed::BLOCK_SIZE, values.size() - first);
+
+        gaps[0] = 0;
+        for (usize i = 1; i < count; i++) gaps[i] = values[first + i] - values[first + i - 1];
+        packed::helper::pack(vec.data.data() + block.word, block.bits, gaps.data(), count);
+      }
+      return vec;
+    }
+
+    [[nodiscard]] __always_inline auto length() const -> usize { return len; }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return len == 0; }
+
+    [[nodiscard]] auto get(const usize index) const -> u32 {
+      debug_assert(index < len, "Index out of Bounds");
+      const Block &block = blocks[index / packed::BLOCK_SIZE];
+
+      u32 value = block.first;
+      for (usize i = 1; i <= index % packed::BLOCK_SIZE; i++) {
+        value += simd::read_bits(data.data() + block.word, u64{i} * block.bits, block.bits);
+      }
+      return value;
+    }
+
+    [[nodiscard]] auto operator[](const usize index) const -> u32 { return get(index); }
+
+    /**
+     * @brief Decodes values [first, first + out.size()) into 'out'
+     */
+    auto unpack(usize first, Span<u32> out) const -> void {
+      debug_assert(first + out.size() <= len, "Index out of Bounds");
+
+      std::array<u32, packed::BLOCK_SIZE> buffer;
+      while (not out.empty()) {
+        const Block &block = blocks[first / packed::BLOCK_SIZE];
+        const usize offset = first % packed::BLOCK_SIZE;
+        const usize count = std::min(packed::BLOCK_SIZE - offset, out.size());
+
+        if (offset == 0) {
+          // decode in place, the gap of the first value is 0
+          simd::unpack_bits(data.data() + block.word, 0, block.bits, count, out.data());
+          simd::prefix_sum(out.data(), count, block.first);
+        } else {
+          // the gaps before 'first' are still needed for the running sum
+          simd::unpack_bits(data.data() + block.word, 0, block.bits, offset + count, buffer.data());
+          simd::prefix_sum(buffer.data(), offset + count, block.first);
+          std::copy_n(buffer.begin() + static_cast<std::ptrdiff_t>(offset), count, out.begin());
+        }
+
+        first += count;
+        out = out.subspan(count);
+      }
+    }
+
+    [[nodiscard]] auto to_vec() const -> Vec<u32> {
+      Vec<u32> values(len);
+      unpack(0, values);
+      return values;
+    }
+
+    /**
+     * @brief Heap memory used by the packed gaps & block headers
+     */
+    [[nodiscard]] auto memory_bytes() const -> usize {
+      return data.capacity() * sizeof(u64) + blocks.capacity() * sizeof(Block);
+    }
+
+    [[nodiscard]] auto begin() const -> Iterator { return Iterator{*this, 0}; }
+
+    [[nodiscard]] auto end() const -> Iterator { return Iterator{*this, len}; }
+  };
+}
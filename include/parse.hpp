@@ -0,0 +1,229 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "preamble.hpp"
+#include "box.hpp"
+#include "option.hpp"
+#include "result.hpp"
+
+#if defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace crab {
+  class ParseError final : public Error {
+  public:
+    enum class Kind : u8 {
+      // the text was empty
+      Empty,
+      // a character that does not belong in a number of the requested type
+      InvalidDigit,
+      // the number does not fit the requested type
+      OutOfRange,
+    };
+
+  private:
+    Kind error_kind;
+    usize byte;
+    Option<usize> field_index;
+
+  public:
+    ParseError(Kind kind, usize position);
+
+    [[nodiscard]] auto kind() const -> Kind { return error_kind; }
+
+    /**
+     * @brief Offset of the offending character in the text (0 for Empty & OutOfRange)
+     */
+    [[nodiscard]] auto position() const -> usize { return byte; }
+
+    /**
+     * @brief Index of the field that failed when parsing a column
+     */
+    [[nodiscard]] auto field() const -> Option<usize> { return field_index; }
+
+    /**
+     * @brief Same error, attributed to field 'index' of a column
+     */
+    [[nodiscard]] auto in_field(usize index) const -> ParseError;
+
+    [[nodiscard]] auto what() const -> String override;
+  };
+}
+
+namespace crab::parsing {
+  /**
+   * @brief Types crab::parse can produce, every preamble integer & float alias
+   */
+  template<typename T>
+  concept number = (std::is_integral_v<T> and not std::same_as<T, bool> and sizeof(T) <= sizeof(u64))
+    or std::is_floating_point_v<T>;
+
+  namespace helper {
+    /**
+     * @brief 8 characters as a word, first character in the lowest byte
+     */
+    [[nodiscard]] __always_inline auto load_eight(const char *from) -> u64 {
+      u64 word;
+      std::memcpy(&word, from, sizeof(word));
+      if constexpr (std::endian::native == std::endian::big) word = std::byteswap(word);
+      return word;
+    }
+
+    /**
+     * @brief Whether all 8 bytes of 'word' are '0'..'9'
+     */
+    [[nodiscard]] __always_inline constexpr auto is_eight_digits(const u64 word) -> bool {
+      return ((word & 0xf0f0'f0f0'f0f0'f0f0) | ((word + 0x0606'0606'0606'0606) & 0xf0f0'f0f0'f0f0'f0f0) >> 4)
+        == 0x3333'3333'3333'3333;
+    }
+
+    /**
+     * @brief Value of 8 digit characters, with three multiplies instead of eight (SWAR)
+     */
+    [[nodiscard]] __always_inline constexpr auto eight_digits(u64 word) -> u32 {
+      constexpr u64 MASK = 0x0000'00ff'0000'00ff;
+      // 100 + (1'000'000 << 32) & 1 + (10'000 << 32)
+      constexpr u64 HUNDREDS = 0x000f'4240'0000'0064;
+      constexpr u64 UNITS = 0x0000'2710'0000'0001;
+
+      word -= 0x3030'3030'3030'3030;
+      // pairs of digits
+      word = word * 10 + (word >> 8);
+      return static_cast<u32>(((word & MASK) * HUNDREDS + (word >> 16 & MASK) * UNITS) >> 32);
+    }
+
+    #if defined(__SSE4_1__)
+    /**
+     * @brief Value of 16 digit characters with SSE multiply-adds, None if any of them is not a digit
+     */
+    [[nodiscard]] __always_inline auto sixteen_digits(const char *from) -> Option<u64> {
+      const __m128i digits = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(from)), _mm_set1_epi8('0'));
+      const __m128i invalid = _mm_or_si128(
+        _mm_cmplt_epi8(digits, _mm_setzero_si128()),
+        _mm_cmpgt_epi8(digits, _mm_set1_epi8(9))
+      );
+      if (_mm_movemask_epi8(invalid) != 0) return crab::none;
+
+      const __m128i tens = _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1);
+      const __m128i pairs = _mm_maddubs_epi16(digits, tens);
+      const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+      const __m128i packed = _mm_packus_epi32(quads, quads);
+      const __m128i octets = _mm_madd_epi16(packed, _mm_setr_epi16(10'000, 1, 10'000, 1, 10'000, 1, 10'000, 1));
+
+      const auto high = static_cast<u32>(_mm_cvtsi128_si32(octets));
+      const auto low = static_cast<u32>(_mm_extract_epi32(octets, 1));
+      return crab::some(u64{high} * 100'000'000 + low);
+    }
+    #endif
+
+    template<number T> requires std::is_integral_v<T>
+    [[nodiscard]] auto parse_integer(const StringView text) -> Result<T, ParseError> {
+      using U = std::make_unsigned_t<T>;
+      using Kind = ParseError::Kind;
+
+      const char *const begin = text.data();
+      const char *const end = begin + text.size();
+      const char *cursor = begin;
+
+      if (cursor == end) return ParseError{Kind::Empty, 0};
+
+      bool negative = false;
+      if (*cursor == '+' or *cursor == '-') {
+        negative = *cursor == '-';
+        if (std::is_unsigned_v<T> and negative) return ParseError{Kind::InvalidDigit, 0};
+        if (++cursor == end) return ParseError{Kind::InvalidDigit, 1};
+      }
+
+      while (cursor != end and *cursor == '0') cursor++;
+      const char *const digits = cursor;
+
+      u64 value = 0;
+
+      #if defined(__SSE4_1__)
+      if (end - cursor >= 16) {
+        if (const Option<u64> chunk = sixteen_digits(cursor); chunk.is_some()) {
+          value = chunk.get_unchecked();
+          cursor += 16;
+        }
+      }
+      #endif
+
+      while (end - cursor >= 8) {
+        const u64 chunk = load_eight(cursor);
+        if (not is_eight_digits(chunk)) break;
+        value = value * 100'000'000 + eight_digits(chunk);
+        cursor += 8;
+      }
+
+      for (; cursor != end; cursor++) {
+        const auto digit = static_cast<u8>(*cursor - '0');
+        if (digit > 9) return ParseError{Kind::InvalidDigit, static_cast<usize>(cursor - begin)};
+        value = value * 10 + digit;
+      }
+
+      // wrapped if there were too many digits
+      const auto count = static_cast<usize>(end - digits);
+      if (count > std::numeric_limits<U>::digits10 + 1) return ParseError{Kind::OutOfRange, 0};
+      if constexpr (sizeof(U) == sizeof(u64)) {
+        // 20 digits only fit if they start with a 1 & did not wrap below 10^19
+        if (count == 20 and (*digits != '1' or value < 10'000'000'000'000'000'000u)) {
+          return ParseError{Kind::OutOfRange, 0};
+        }
+      }
+
+      const u64 limit = u64{std::numeric_limits<T>::max()} + (std::is_signed_v<T> and negative);
+      if (value > limit) return ParseError{Kind::OutOfRange, 0};
+
+      return static_cast<T>(negative ? U{0} - static_cast<U>(value) : static_cast<U>(value));
+    }
+
+    [[nodiscard]] auto parse_float(StringView text) -> Result<float, ParseError>;
+
+    [[nodiscard]] auto parse_double(StringView text) -> Result<double, ParseError>;
+
+    [[nodiscard]] auto parse_long_double(StringView text) -> Result<long double, ParseError>;
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Parses the whole of 'text' as a T, without locales, exceptions or allocations.
+   *
+   * Integers are an optional sign followed by decimal digits, floats additionally take a fraction, an exponent
+   * ('e' / 'E') and 'inf' / 'infinity' / 'nan' in any case. Whitespace is not skipped. Digits are consumed 8 (or 16
+   * with SSE4.1) at a time, floats are rounded correctly with the Eisel-Lemire algorithm.
+   */
+  template<parsing::number T>
+  [[nodiscard]] auto parse(const StringView text) -> Result<T, ParseError> {
+    if constexpr (std::is_integral_v<T>) {
+      return parsing::helper::parse_integer<T>(text);
+    } else if constexpr (std::same_as<T, float>) {
+      return parsing::helper::parse_float(text);
+    } else if constexpr (std::same_as<T, double>) {
+      return parsing::helper::parse_double(text);
+    } else {
+      return parsing::helper::parse_long_double(text);
+    }
+  }
+
+  /**
+   * @brief Parses every field of a column, the error (if any) is that of the first field that failed & carries
+   * its index in ParseError::field()
+   */
+  template<parsing::number T>
+  [[nodiscard]] auto parse_column(const Span<const StringView> fields) -> Result<Box<T[]>, ParseError> {
+    Box<T[]> values = crab::make_boxxed_array<T>(fields.size());
+    for (usize i = 0; i < fields.size(); i++) {
+      auto parsed = parse<T>(fields[i]);
+      if (parsed.is_err()) return parsed.get_err_unchecked().in_field(i);
+      values[i] = parsed.take_unchecked();
+    }
+    return values;
+  }
+}
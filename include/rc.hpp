@@ -3,10 +3,17 @@
 #pragma once
 
 #include <atomic>
+#include <bit>
+#include <concepts>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include <preamble.hpp>
 
 #include "box.hpp"
+#include "option.hpp"
 #include "ref.hpp"
 
 namespace crab::rc {
@@ -71,7 +78,9 @@ namespace crab::rc {
         delete data;
       }
 
-      template<typename Derived=Contained> requires std::is_base_of_v<Contained, Derived>
+      // is_base_of is false for non class types, Rc<int> reads its own type
+      template<typename Derived=Contained>
+        requires std::same_as<Derived, Contained> or std::is_base_of_v<Contained, Derived>
       auto raw_ptr() const -> Derived * {
         debug_assert(data != nullptr, "Invalid access of Rc<T> or RcMut<T>, data is nullptr");
         return static_cast<Derived*>(data);
@@ -232,6 +241,8 @@ public:
   auto operator=(const Rc &from) -> Rc& {
     if (&from == this) return *this;
 
+    from.get_interior()->increment_ref_count();
+
     destruct();
 
     interior = from.interior;
@@ -269,6 +280,14 @@ public:
     return is_valid() and get_interior()->is_unique();
   }
 
+  /**
+   * @brief Whether both share the same value, which for interned values (crab::make_rc_interned) is the same as
+   * comparing them
+   */
+  [[nodiscard]] auto ptr_eq(const Rc &other) const -> bool {
+    return interior == other.interior;
+  }
+
   /**
    * @brief Queries if this instance has been
    */
@@ -442,6 +461,8 @@ public:
   auto operator=(const RcMut &from) -> RcMut& {
     if (&from == this) return *this;
 
+    from.get_interior()->increment_ref_count();
+
     destruct();
 
     interior = from.interior;
@@ -537,6 +558,122 @@ public:
   }
 };
 
+namespace crab::rc {
+  /**
+   * @brief Hash consing table of T, handing out one shared Rc<T> for every distinct value, so equal values are
+   * stored once & comparing interned values is comparing pointers (Rc::ptr_eq).
+   *
+   * Rc has no weak references, so the table holds one reference to every value & a value only it still refers to
+   * is dead. Dead entries are dropped when the table fills up, before it would grow, & by purge(), so they cost
+   * memory only until then & the table stays within about twice the live values. Linear probing over cached
+   * hashes, a lookup compares values only on a full hash match.
+   *
+   * Rc counts references without atomics, so a table & the Rcs it hands out belong to one thread, local() being
+   * the calling thread's own.
+   */
+  template<typename T, typename Hash = std::hash<T>>
+    requires std::equality_comparable<T> and std::is_invocable_r_v<usize, const Hash&, const T&>
+  class InternTable {
+    static constexpr usize MIN_CAPACITY = 16;
+
+    // 0 marks an empty slot, a hash is never 0
+    Vec<u64> hashes;
+    Vec<Option<::Rc<T>>> values;
+    usize count = 0;
+    // slots are picked by the top bits of the hash, 64 - log2(capacity) is the shift bringing them down
+    usize shift = 0;
+    [[no_unique_address]] Hash hash;
+
+    [[nodiscard]] auto hash_of(const T &value) const -> u64 {
+      // Fibonacci hashing spreads std::hash's identity for integers over the top bits
+      return static_cast<u64>(hash(value)) * 0x9E3779B97F4A7C15ull | 1;
+    }
+
+    /**
+     * @brief The slot holding 'value', or the empty one it would go in
+     */
+    [[nodiscard]] auto find(const u64 hashed, const T &value) const -> usize {
+      const usize mask = hashes.size() - 1;
+      for (usize slot = hashed >> shift;; slot = (slot + 1) & mask) {
+        if (hashes[slot] == 0) return slot;
+        if (hashes[slot] == hashed and *values[slot].get_unchecked() == value) return slot;
+      }
+    }
+
+    /**
+     * @brief Rehashes the live entries into 'capacity' slots, dropping the dead ones
+     */
+    auto rebuild(const usize capacity) -> void {
+      Vec<u64> old_hashes = std::exchange(hashes, Vec<u64>(capacity));
+      Vec<Option<::Rc<T>>> old_values = std::exchange(values, Vec<Option<::Rc<T>>>(capacity));
+      shift = static_cast<usize>(std::numeric_limits<u64>::digits - std::countr_zero(capacity));
+      count = 0;
+      for (usize slot = 0; slot < old_hashes.size(); slot++) {
+        if (old_hashes[slot] == 0 or old_values[slot].get_unchecked().is_unique()) continue;
+        const usize to = find(old_hashes[slot], *old_values[slot].get_unchecked());
+        hashes[to] = old_hashes[slot];
+        values[to] = std::move(old_values[slot]);
+        count++;
+      }
+    }
+
+  public:
+    explicit InternTable(Hash hash = {}) : hash{std::move(hash)} { rebuild(MIN_CAPACITY); }
+
+    InternTable(const InternTable &) = delete;
+
+    auto operator=(const InternTable &) -> InternTable& = delete;
+
+    /**
+     * @brief The calling thread's table, the one crab::make_rc_interned uses
+     */
+    [[nodiscard]] static auto local() -> InternTable& {
+      thread_local InternTable table;
+      return table;
+    }
+
+    /**
+     * @brief The Rc holding a value equal to 'value', made from 'value' if there is none yet
+     */
+    [[nodiscard]] auto intern(T value) -> ::Rc<T> {
+      const u64 hashed = hash_of(value);
+      usize slot = find(hashed, value);
+      if (hashes[slot] != 0) return values[slot].get_unchecked();
+
+      // past 7/8 full, drop the dead entries & grow if over half of the slots are still taken
+      if (8 * (count + 1) > 7 * hashes.size()) {
+        usize live = 1;
+        for (const Option<::Rc<T>> &entry: values) live += entry.is_some() and not entry.get_unchecked().is_unique();
+        rebuild(std::max(MIN_CAPACITY, std::bit_ceil(2 * live)));
+        slot = find(hashed, value);
+      }
+      hashes[slot] = hashed;
+      values[slot] = ::Rc<T>::from_owned_unchecked(new T{std::move(value)});
+      count++;
+      return values[slot].get_unchecked();
+    }
+
+    /**
+     * @brief Entries in the table, including dead ones not dropped yet
+     */
+    [[nodiscard]] auto size() const -> usize { return count; }
+
+    /**
+     * @brief Bytes of the table itself, not counting the values
+     */
+    [[nodiscard]] auto memory() const -> usize { return hashes.size() * (sizeof(u64) + sizeof(Option<::Rc<T>>)); }
+
+    /**
+     * @brief Drops every entry nothing outside the table refers to, & tells how many
+     */
+    auto purge() -> usize {
+      const usize before = count;
+      rebuild(hashes.size());
+      return before - count;
+    }
+  };
+}
+
 namespace crab {
   /**
    * Creates a new reference counted instance of T
@@ -559,4 +696,16 @@ namespace crab {
   auto make_rc_mut(Args... args) -> RcMut<T> {
     return RcMut<T>::from_owned_unchecked(new T{std::forward<Args>(args)...});
   }
+
+  /**
+   * Creates a reference counted instance of T, or shares the existing one equal to it (hash consing through the
+   * calling thread's crab::rc::InternTable). Equal interned values are the same Rc, compared with Rc::ptr_eq.
+   * @tparam T The type to be interned, which needs == & std::hash
+   * @tparam Args Argument types to be passed to T's constructor
+   * @param args Arguments to be passed to T's constructor
+   */
+  template<typename T, typename... Args> requires std::is_constructible_v<T, Args...>
+  auto make_rc_interned(Args... args) -> Rc<T> {
+    return rc::InternTable<T>::local().intern(T{std::forward<Args>(args)...});
+  }
 }
@@ -128,11 +128,12 @@ private:
 public:
   Result(T from) : Result{Ok{std::move(from)}} {}
 
-  Result(E from) : Result{Err{std::move(from)}} {}
+  // errors are the unlikely path, cold keeps them out of line & lets branches that lead to them be predicted not taken
+  [[gnu::cold]] Result(E from) : Result{Err{std::move(from)}} {}
 
   Result(Ok &&from) : inner{std::forward<Ok>(from)} {}
 
-  Result(Err &&from) : inner{std::forward<Err>(from)} {}
+  [[gnu::cold]] Result(Err &&from) : inner{std::forward<Err>(from)} {}
 
   Result(Result &&from) noexcept: inner{std::exchange(from.inner, invalidated{})} {}
 
@@ -149,7 +150,7 @@ public:
     return *this;
   }
 
-  auto operator=(Err &&from) -> Result& {
+  [[gnu::cold]] auto operator=(Err &&from) -> Result& {
     inner = std::forward<Err>(from);
     return *this;
   }
@@ -158,7 +159,7 @@ public:
     return *this = Ok{std::forward<T>(from)};
   }
 
-  auto operator=(E &&from) -> Result& {
+  [[gnu::cold]] auto operator=(E &&from) -> Result& {
     return *this = Err{std::forward<E>(from)};
   }
 
@@ -180,24 +181,35 @@ public:
     return std::holds_alternative<Err>(inner);
   }
 
+  /**
+   * @brief Takes the Ok value out, leaving the result moved from. Will error if it is not Ok (undefined behaviour in
+   * release builds)
+   */
   [[nodiscard]] auto take_unchecked() -> T {
     T val{std::move(get_unchecked())};
     inner = invalidated{};
     return val;
   }
 
+  /**
+   * @brief Takes the error out, leaving the result moved from. Will error if it is not an Err (undefined behaviour in
+   * release builds)
+   */
   [[nodiscard]] auto take_err_unchecked() -> E {
     E val{std::move(get_err_unchecked())};
     inner = invalidated{};
     return val;
   }
 
+  /**
+   * @brief The Ok value, will error if it is not Ok (undefined behaviour in release builds)
+   */
   [[nodiscard]] auto get_unchecked() -> T& {
     // #if DEBUG
     // ensure_valid();
     // #endif
 
-    debug_assert(
+    debug_assume(
       is_ok(),
       std::format(
         "Called unwrap on result with Error:\n{}",
@@ -208,8 +220,11 @@ public:
     return std::get<Ok>(inner).value;
   }
 
+  /**
+   * @brief The error, will error if it is not an Err (undefined behaviour in release builds)
+   */
   [[nodiscard]] auto get_err_unchecked() -> E& {
-    debug_assert(
+    debug_assume(
       is_err(),
       std::format("Called unwrap on ok value")
     );
@@ -217,8 +232,11 @@ public:
     return std::get<Err>(inner).value;
   }
 
+  /**
+   * @brief The Ok value, will error if it is not Ok (undefined behaviour in release builds)
+   */
   [[nodiscard]] auto get_unchecked() const -> const T& {
-    debug_assert(
+    debug_assume(
       is_ok(),
       std::format(
         "Called unwrap on result with Error:\n{}",
@@ -228,8 +246,11 @@ public:
     return std::get<Ok>(inner).value;
   }
 
+  /**
+   * @brief The error, will error if it is not an Err (undefined behaviour in release builds)
+   */
   [[nodiscard]] auto get_err_unchecked() const -> const E& {
-    debug_assert(
+    debug_assume(
       is_err(),
       std::format("Called unwrap on ok value{}",
         [&]{ ensure_valid(); return ""; }()
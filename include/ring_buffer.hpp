@@ -0,0 +1,95 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/ring.hpp"
+#include "option.hpp"
+
+namespace crab {
+  /**
+   * @brief Fixed capacity circular queue stored inline (no heap allocation), double ended.
+   *
+   * N must be a power of two so that wrapping around is a mask instead of a division. Pushing into a full
+   * buffer is a bug, use push_overwrite for a sliding window that evicts the oldest element instead.
+   */
+  template<typename T, usize N>
+    requires std::move_constructible<T> and (N != 0) and (std::has_single_bit(N))
+  class RingBuffer : public ring::Ring<T, RingBuffer<T, N>> {
+    using Base = ring::Ring<T, RingBuffer>;
+    friend Base;
+
+    alignas(T) std::byte storage[sizeof(T) * N];
+
+    [[nodiscard]] __always_inline auto slots() -> T* { return std::launder(reinterpret_cast<T*>(storage)); }
+
+    [[nodiscard]] __always_inline auto slots() const -> const T* {
+      return std::launder(reinterpret_cast<const T*>(storage));
+    }
+
+    __always_inline auto reserve_one() const -> void {
+      debug_assert(not this->is_full(), "Cannot push into a full RingBuffer, use push_overwrite to evict");
+    }
+
+  public:
+    RingBuffer() = default;
+
+    RingBuffer(const std::initializer_list<T> values) requires std::copy_constructible<T> {
+      debug_assert(values.size() <= N, "More values than the RingBuffer can hold");
+      for (const T &value: values) this->push_back(value);
+    }
+
+    RingBuffer(const RingBuffer &other) requires std::copy_constructible<T> {
+      for (const T &value: other) this->push_back(value);
+    }
+
+    RingBuffer(RingBuffer &&other) noexcept {
+      other.relocate_into(slots());
+      this->len = std::exchange(other.len, 0);
+      other.head = 0;
+    }
+
+    auto operator=(const RingBuffer &other) -> RingBuffer& requires std::copy_constructible<T> {
+      if (this == &other) return *this;
+      this->clear();
+      for (const T &value: other) this->push_back(value);
+      return *this;
+    }
+
+    auto operator=(RingBuffer &&other) noexcept -> RingBuffer& {
+      if (this == &other) return *this;
+      this->clear();
+      other.relocate_into(slots());
+      this->len = std::exchange(other.len, 0);
+      other.head = 0;
+      return *this;
+    }
+
+    ~RingBuffer() { this->clear(); }
+
+    [[nodiscard]] static constexpr auto capacity() -> usize { return N; }
+
+    /**
+     * @brief Appends 'value', if the buffer is full the front element is evicted to make room & returned
+     */
+    auto push_overwrite(T value) -> Option<T> {
+      if (not this->is_full()) {
+        this->push_back(std::move(value));
+        return crab::none;
+      }
+
+      // the slot past the back is the front, replace it & rotate by one
+      T *front = this->slot(0);
+      Option<T> evicted = crab::some(std::move(*front));
+      std::destroy_at(front);
+      std::construct_at(front, std::move(value));
+      this->head = (this->head + 1) & (N - 1);
+      return evicted;
+    }
+  };
+}
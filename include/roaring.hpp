@@ -0,0 +1,1313 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <variant>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/simd.hpp"
+#include "option.hpp"
+#include "range.hpp"
+#include "result.hpp"
+
+namespace crab::roaring {
+  /**
+   * @brief Amount of values covered by one container, the upper 16 bits of a value select the container
+   */
+  inline constexpr usize CHUNK_SIZE = usize{1} << 16;
+
+  /**
+   * @brief Array containers hold at most this many values, past it a bitmap takes less memory
+   */
+  inline constexpr usize ARRAY_MAX = 4096;
+
+  /**
+   * @brief Amount of words in a bitmap container
+   */
+  inline constexpr usize BITMAP_WORDS = CHUNK_SIZE / 64;
+
+  /**
+   * @brief Header tag of the serialized format, see RoaringBitmap::serialize
+   */
+  inline constexpr u32 MAGIC = 0x31425243; // "CRB1"
+
+  enum class Kind : u8 {
+    Array = 1,
+    Bitmap = 2,
+    Run = 3,
+  };
+
+  /**
+   * @brief Consecutive values [start, start + length]
+   */
+  struct Run {
+    u16 start;
+    u16 length;
+
+    [[nodiscard]] __always_inline constexpr auto last() const -> u32 { return u32{start} + length; }
+
+    [[nodiscard]] constexpr auto operator==(const Run &) const -> bool = default;
+  };
+
+  /**
+   * @brief Read only view of one container, either owned by a RoaringBitmap or living inside of a
+   * serialized buffer (RoaringView).
+   */
+  struct ContainerRef {
+    Kind kind = Kind::Array;
+    u32 cardinality = 0;
+    // values for arrays, runs for run containers & BITMAP_WORDS for bitmaps
+    u32 size = 0;
+    const void *data = nullptr;
+
+    [[nodiscard]] __always_inline auto values() const -> Span<const u16> {
+      return {static_cast<const u16*>(data), size};
+    }
+
+    [[nodiscard]] __always_inline auto words() const -> const u64* { return static_cast<const u64*>(data); }
+
+    [[nodiscard]] __always_inline auto runs() const -> Span<const Run> {
+      return {static_cast<const Run*>(data), size};
+    }
+  };
+
+  /**
+   * @brief Anything that exposes sorted 16 bit keys each with a non empty container
+   */
+  template<typename S>
+  concept source = requires(const S &s, const usize index) {
+    { s.container_count() } -> std::same_as<usize>;
+    { s.key(index) } -> std::same_as<u16>;
+    { s.container(index) } -> std::same_as<ContainerRef>;
+  };
+
+  /**
+   * @brief Reason a buffer could not be read as a serialized RoaringBitmap
+   */
+  class FormatError final : public Error {
+    StringView reason;
+
+  public:
+    explicit FormatError(const StringView reason) : reason{reason} {}
+
+    [[nodiscard]] auto what() const -> String override { return String{reason}; }
+  };
+
+  namespace helper {
+    /**
+     * @brief Per container entry of the serialized format
+     */
+    struct Descriptor {
+      u16 key;
+      Kind kind;
+      u8 reserved;
+      u32 cardinality;
+      u32 size;
+      // from the start of the buffer, always a multiple of 8
+      u32 offset;
+    };
+
+    static_assert(sizeof(Descriptor) == 16);
+
+    inline constexpr usize HEADER_BYTES = 8;
+
+    [[nodiscard]] __always_inline constexpr auto payload_bytes(const Kind kind, const usize size) -> usize {
+      switch (kind) {
+        case Kind::Array: return size * sizeof(u16);
+        case Kind::Bitmap: return size * sizeof(u64);
+        case Kind::Run: return size * sizeof(Run);
+      }
+      return 0;
+    }
+
+    [[nodiscard]] __always_inline constexpr auto align8(const usize bytes) -> usize { return (bytes + 7) & ~usize{7}; }
+
+    [[nodiscard]] __always_inline auto test(const u64 *words, const u16 value) -> bool {
+      return (words[value / 64] >> (value % 64)) & 1;
+    }
+
+    /**
+     * @brief Applies 'op' to every word of 'words' with a mask of the bits in [first, last] (inclusive)
+     */
+    template<typename Op>
+    __always_inline auto apply_range(u64 *words, const u32 first, const u32 last, const Op op) -> void {
+      const u32 first_word = first / 64;
+      const u32 last_word = last / 64;
+      const u64 head = ~u64{0} << (first % 64);
+      const u64 tail = ~u64{0} >> (63 - last % 64);
+
+      if (first_word == last_word) {
+        words[first_word] = op(words[first_word], head & tail);
+        return;
+      }
+
+      words[first_word] = op(words[first_word], head);
+      for (u32 i = first_word + 1; i < last_word; i++) {
+        words[i] = op(words[i], ~u64{0});
+      }
+      words[last_word] = op(words[last_word], tail);
+    }
+
+    /**
+     * @brief words = op(words, bits of 'container') for 'op' in {|, ^, & ~}, ie. operations where a value
+     * missing from 'container' leaves the word unchanged.
+     */
+    template<typename Op>
+    auto apply(const ContainerRef container, u64 *words, const Op op) -> void {
+      switch (container.kind) {
+        case Kind::Array:
+          for (const u16 value: container.values()) {
+            words[value / 64] = op(words[value / 64], u64{1} << (value % 64));
+          }
+          return;
+        case Kind::Bitmap:
+          simd::zip_words(words, container.words(), BITMAP_WORDS, op);
+          return;
+        case Kind::Run:
+          for (const Run run: container.runs()) {
+            apply_range(words, run.start, run.last(), op);
+          }
+          return;
+      }
+    }
+
+    [[nodiscard]] inline auto to_words(const ContainerRef container) -> Vec<u64> {
+      Vec<u64> words(BITMAP_WORDS, 0);
+      apply(container, words.data(), [](auto a, auto b) { return a | b; });
+      return words;
+    }
+
+    [[nodiscard]] inline auto values_of(const u64 *words, const usize cardinality) -> Vec<u16> {
+      Vec<u16> values;
+      values.reserve(cardinality);
+      for (usize i = 0; i < BITMAP_WORDS; i++) {
+        for (u64 word = words[i]; word != 0; word &= word - 1) {
+          values.push_back(static_cast<u16>(i * 64 + static_cast<usize>(std::countr_zero(word))));
+        }
+      }
+      return values;
+    }
+
+    [[nodiscard]] inline auto runs_of(const u64 *words) -> Vec<Run> {
+      Vec<Run> runs;
+      usize i = 0;
+      u64 word = words[0];
+      while (true) {
+        while (word == 0) {
+          if (++i == BITMAP_WORDS) return runs;
+          word = words[i];
+        }
+        const usize start = i * 64 + static_cast<usize>(std::countr_zero(word));
+
+        // fill the zeros below the run so the run's end is the first zero
+        word |= word - 1;
+        while (word == ~u64{0}) {
+          if (++i == BITMAP_WORDS) {
+            runs.push_back(Run{static_cast<u16>(start), static_cast<u16>(CHUNK_SIZE - 1 - start)});
+            return runs;
+          }
+          word = words[i];
+        }
+        const usize end = i * 64 + static_cast<usize>(std::countr_zero(~word));
+        runs.push_back(Run{static_cast<u16>(start), static_cast<u16>(end - 1 - start)});
+
+        // clear the run
+        word &= word + 1;
+      }
+    }
+
+    [[nodiscard]] inline auto runs_of(const Span<const u16> values) -> Vec<Run> {
+      Vec<Run> runs;
+      for (usize i = 0; i < values.size();) {
+        usize j = i + 1;
+        while (j < values.size() and values[j] == values[j - 1] + 1) j++;
+        runs.push_back(Run{values[i], static_cast<u16>(j - 1 - i)});
+        i = j;
+      }
+      return runs;
+    }
+
+    /**
+     * @brief Amount of runs the set bits of 'words' form, a run starts at every set bit whose lower neighbour
+     * is unset.
+     */
+    [[nodiscard]] inline auto count_runs(const u64 *words) -> usize {
+      usize runs = 0;
+      u64 carry = 0;
+      for (usize i = 0; i < BITMAP_WORDS; i++) {
+        const u64 word = words[i];
+        runs += static_cast<usize>(std::popcount(word & ~((word << 1) | carry)));
+        carry = word >> 63;
+      }
+      return runs;
+    }
+
+    /**
+     * @brief Index of the run that contains 'value' or the last one that starts before it, size() if none
+     * starts before it
+     */
+    [[nodiscard]] __always_inline auto run_before(const Span<const Run> runs, const u16 value) -> usize {
+      const auto after = std::upper_bound(
+        runs.begin(),
+        runs.end(),
+        value,
+        [](const u16 v, const Run &run) { return v < run.start; }
+      );
+      return after == runs.begin() ? runs.size() : static_cast<usize>(after - runs.begin()) - 1;
+    }
+
+    [[nodiscard]] inline auto contains(const ContainerRef container, const u16 value) -> bool {
+      switch (container.kind) {
+        case Kind::Array: {
+          const Span<const u16> values = container.values();
+          return std::binary_search(values.begin(), values.end(), value);
+        }
+        case Kind::Bitmap:
+          return test(container.words(), value);
+        case Kind::Run: {
+          const Span<const Run> runs = container.runs();
+          const usize index = run_before(runs, value);
+          return index != runs.size() and value <= runs[index].last();
+        }
+      }
+      return false;
+    }
+  }
+
+  /**
+   * @brief Owned container of the values that share the same upper 16 bits.
+   *
+   * Sparse chunks are sorted arrays of the lower 16 bits, dense chunks are 65536 bit bitmaps & chunks made of
+   * long stretches of consecutive values can be run length encoded (see RoaringBitmap::optimize).
+   */
+  class Container {
+    std::variant<Vec<u16>, Vec<u64>, Vec<Run>> storage;
+    u32 cardinality = 0;
+
+    Container(decltype(storage) storage, const u32 cardinality)
+      : storage{std::move(storage)}, cardinality{cardinality} {}
+
+    auto convert_to_bitmap() -> void {
+      storage = helper::to_words(as_ref());
+    }
+
+    auto convert_to_array() -> void {
+      if (kind() == Kind::Bitmap) {
+        storage = helper::values_of(std::get<Vec<u64>>(storage).data(), cardinality);
+      } else {
+        storage = helper::values_of(helper::to_words(as_ref()).data(), cardinality);
+      }
+    }
+
+  public:
+    /**
+     * @brief Container of sorted, duplicate free values
+     */
+    [[nodiscard]] static auto from_values(Vec<u16> values) -> Container {
+      const u32 cardinality = static_cast<u32>(values.size());
+      if (values.size() > ARRAY_MAX) {
+        Container container{std::move(values), cardinality};
+        container.convert_to_bitmap();
+        return container;
+      }
+      return Container{std::move(values), cardinality};
+    }
+
+    /**
+     * @brief Container of the set bits in BITMAP_WORDS words, stored as an array if sparse enough
+     */
+    [[nodiscard]] static auto from_words(Vec<u64> words) -> Container {
+      debug_assert(words.size() == BITMAP_WORDS, "Bitmap containers are exactly BITMAP_WORDS words");
+      const u32 cardinality = static_cast<u32>(simd::popcount(words.data(), words.size()));
+      if (cardinality <= ARRAY_MAX) {
+        return Container{helper::values_of(words.data(), cardinality), cardinality};
+      }
+      return Container{std::move(words), cardinality};
+    }
+
+    /**
+     * @brief Container of sorted, non overlapping & non adjacent runs, converted to an array or a bitmap if
+     * either is smaller
+     */
+    [[nodiscard]] static auto from_runs(Vec<Run> runs) -> Container {
+      u32 cardinality = 0;
+      for (const Run run: runs) cardinality += u32{run.length} + 1;
+
+      Container container{std::move(runs), cardinality};
+      container.shrink();
+      return container;
+    }
+
+    /**
+     * @brief Deep copy of 'container'
+     */
+    [[nodiscard]] static auto from_ref(const ContainerRef container) -> Container {
+      switch (container.kind) {
+        case Kind::Array: {
+          const Span<const u16> values = container.values();
+          return Container{Vec<u16>(values.begin(), values.end()), container.cardinality};
+        }
+        case Kind::Bitmap:
+          return Container{Vec<u64>(container.words(), container.words() + BITMAP_WORDS), container.cardinality};
+        case Kind::Run: {
+          const Span<const Run> runs = container.runs();
+          return Container{Vec<Run>(runs.begin(), runs.end()), container.cardinality};
+        }
+      }
+      return Container{Vec<u16>{}, 0};
+    }
+
+    [[nodiscard]] __always_inline auto kind() const -> Kind { return static_cast<Kind>(storage.index() + 1); }
+
+    [[nodiscard]] __always_inline auto length() const -> u32 { return cardinality; }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return cardinality == 0; }
+
+    [[nodiscard]] auto as_ref() const -> ContainerRef {
+      return std::visit(
+        [this]<typename T>(const Vec<T> &items) {
+          return ContainerRef{kind(), cardinality, static_cast<u32>(items.size()), items.data()};
+        },
+        storage
+      );
+    }
+
+    /**
+     * @brief Heap memory owned by the container
+     */
+    [[nodiscard]] auto heap_bytes() const -> usize {
+      return std::visit([]<typename T>(const Vec<T> &items) { return items.capacity() * sizeof(T); }, storage);
+    }
+
+    [[nodiscard]] auto contains(const u16 value) const -> bool { return helper::contains(as_ref(), value); }
+
+    /**
+     * @brief Adds 'value', false if it was already present
+     */
+    auto insert(const u16 value) -> bool {
+      if (Vec<u16> *values = std::get_if<Vec<u16>>(&storage)) {
+        const auto it = std::lower_bound(values->begin(), values->end(), value);
+        if (it != values->end() and *it == value) return false;
+
+        if (values->size() < ARRAY_MAX) {
+          values->insert(it, value);
+          cardinality++;
+          return true;
+        }
+        convert_to_bitmap();
+      }
+
+      if (Vec<u64> *words = std::get_if<Vec<u64>>(&storage)) {
+        u64 &word = (*words)[value / 64];
+        const u64 mask = u64{1} << (value % 64);
+        if (word & mask) return false;
+        word |= mask;
+        cardinality++;
+        return true;
+      }
+
+      Vec<Run> &runs = std::get<Vec<Run>>(storage);
+      const usize index = helper::run_before(runs, value);
+      const bool has_before = index != runs.size();
+      if (has_before and value <= runs[index].last()) return false;
+
+      const usize next = has_before ? index + 1 : 0;
+      const bool joins_before = has_before and runs[index].last() + 1 == value;
+      const bool joins_next = next < runs.size() and u32{value} + 1 == runs[next].start;
+
+      if (joins_before and joins_next) {
+        runs[index].length = static_cast<u16>(runs[next].last() - runs[index].start);
+        runs.erase(runs.begin() + static_cast<std::ptrdiff_t>(next));
+      } else if (joins_before) {
+        runs[index].length++;
+      } else if (joins_next) {
+        runs[next].start--;
+        runs[next].length++;
+      } else {
+        runs.insert(runs.begin() + static_cast<std::ptrdiff_t>(next), Run{value, 0});
+      }
+      cardinality++;
+      return true;
+    }
+
+    /**
+     * @brief Removes 'value', false if it was not present
+     */
+    auto remove(const u16 value) -> bool {
+      if (Vec<u16> *values = std::get_if<Vec<u16>>(&storage)) {
+        const auto it = std::lower_bound(values->begin(), values->end(), value);
+        if (it == values->end() or *it != value) return false;
+        values->erase(it);
+        cardinality--;
+        return true;
+      }
+
+      if (Vec<u64> *words = std::get_if<Vec<u64>>(&storage)) {
+        u64 &word = (*words)[value / 64];
+        const u64 mask = u64{1} << (value % 64);
+        if (not (word & mask)) return false;
+        word &= ~mask;
+        if (--cardinality <= ARRAY_MAX) convert_to_array();
+        return true;
+      }
+
+      Vec<Run> &runs = std::get<Vec<Run>>(storage);
+      const usize index = helper::run_before(runs, value);
+      if (index == runs.size() or value > runs[index].last()) return false;
+
+      Run &run = runs[index];
+      if (run.length == 0) {
+        runs.erase(runs.begin() + static_cast<std::ptrdiff_t>(index));
+      } else if (value == run.start) {
+        run.start++;
+        run.length--;
+      } else if (value == run.last()) {
+        run.length--;
+      } else {
+        const Run upper{static_cast<u16>(value + 1), static_cast<u16>(run.last() - value - 1)};
+        run.length = static_cast<u16>(value - run.start - 1);
+        runs.insert(runs.begin() + static_cast<std::ptrdiff_t>(index + 1), upper);
+      }
+      cardinality--;
+      return true;
+    }
+
+    /**
+     * @brief Switches to whichever representation takes the least memory, including run length encoding
+     */
+    auto shrink() -> void {
+      const usize array_bytes = usize{cardinality} * sizeof(u16);
+      const usize bitmap_bytes = BITMAP_WORDS * sizeof(u64);
+
+      const usize run_count = [&] -> usize {
+        switch (kind()) {
+          case Kind::Array: return helper::runs_of(std::get<Vec<u16>>(storage)).size();
+          case Kind::Bitmap: return helper::count_runs(std::get<Vec<u64>>(storage).data());
+          default: return std::get<Vec<Run>>(storage).size();
+        }
+      }();
+      const usize run_bytes = run_count * sizeof(Run);
+
+      if (run_bytes < std::min(array_bytes, bitmap_bytes)) {
+        if (kind() == Kind::Array) {
+          storage = helper::runs_of(Span<const u16>{std::get<Vec<u16>>(storage)});
+        } else if (kind() == Kind::Bitmap) {
+          storage = helper::runs_of(std::get<Vec<u64>>(storage).data());
+        }
+      } else if (cardinality <= ARRAY_MAX) {
+        if (kind() != Kind::Array) convert_to_array();
+      } else if (kind() != Kind::Bitmap) {
+        convert_to_bitmap();
+      }
+
+      std::visit([](auto &items) { items.shrink_to_fit(); }, storage);
+    }
+  };
+
+  namespace helper {
+    [[nodiscard]] inline auto filter(const ContainerRef array, const ContainerRef other, const bool keep) -> Container {
+      Vec<u16> values(array.size);
+      usize count = 0;
+      for (const u16 value: array.values()) {
+        values[count] = value;
+        count += static_cast<usize>(contains(other, value) == keep);
+      }
+      values.resize(count);
+      return Container::from_values(std::move(values));
+    }
+
+    [[nodiscard]] inline auto intersect(const ContainerRef a, const ContainerRef b) -> Container {
+      if (a.kind == Kind::Array and b.kind == Kind::Array) {
+        const usize small = std::min(a.size, b.size);
+        const usize large = std::max(a.size, b.size);
+
+        // binary searching the few values of a tiny array beats scanning all of the large one
+        if (small * 64 < large) {
+          return a.size < b.size ? filter(a, b, true) : filter(b, a, true);
+        }
+
+        Vec<u16> values(small);
+        values.resize(simd::intersect_sorted(a.values().data(), a.size, b.values().data(), b.size, values.data()));
+        return Container::from_values(std::move(values));
+      }
+
+      if (a.kind == Kind::Array) return filter(a, b, true);
+      if (b.kind == Kind::Array) return filter(b, a, true);
+
+      if (a.kind == Kind::Run and b.kind == Kind::Run) {
+        const Span<const Run> x = a.runs();
+        const Span<const Run> y = b.runs();
+        Vec<Run> runs;
+        usize i = 0;
+        usize j = 0;
+        while (i < x.size() and j < y.size()) {
+          const u32 start = std::max<u32>(x[i].start, y[j].start);
+          const u32 last = std::min(x[i].last(), y[j].last());
+          if (start <= last) runs.push_back(Run{static_cast<u16>(start), static_cast<u16>(last - start)});
+          if (x[i].last() < y[j].last()) {
+            i++;
+          } else {
+            j++;
+          }
+        }
+        return Container::from_runs(std::move(runs));
+      }
+
+      Vec<u64> words = to_words(a);
+      if (b.kind == Kind::Bitmap) {
+        simd::zip_words(words.data(), b.words(), BITMAP_WORDS, [](auto x, auto y) { return x & y; });
+      } else {
+        simd::zip_words(words.data(), to_words(b).data(), BITMAP_WORDS, [](auto x, auto y) { return x & y; });
+      }
+      return Container::from_words(std::move(words));
+    }
+
+    [[nodiscard]] inline auto unite(const ContainerRef a, const ContainerRef b) -> Container {
+      if (a.kind == Kind::Array and b.kind == Kind::Array) {
+        Vec<u16> values(a.size + b.size);
+        const auto end = std::set_union(
+          a.values().begin(),
+          a.values().end(),
+          b.values().begin(),
+          b.values().end(),
+          values.begin()
+        );
+        values.erase(end, values.end());
+        return Container::from_values(std::move(values));
+      }
+
+      if (a.kind == Kind::Run and b.kind == Kind::Run) {
+        Vec<Run> merged;
+        std::merge(
+          a.runs().begin(),
+          a.runs().end(),
+          b.runs().begin(),
+          b.runs().end(),
+          std::back_inserter(merged),
+          [](const Run &x, const Run &y) { return x.start < y.start; }
+        );
+
+        Vec<Run> runs;
+        for (const Run run: merged) {
+          if (not runs.empty() and run.start <= runs.back().last() + 1) {
+            runs.back().length = static_cast<u16>(std::max(runs.back().last(), run.last()) - runs.back().start);
+          } else {
+            runs.push_back(run);
+          }
+        }
+        return Container::from_runs(std::move(runs));
+      }
+
+      Vec<u64> words = to_words(a);
+      apply(b, words.data(), [](auto x, auto y) { return x | y; });
+      return Container::from_words(std::move(words));
+    }
+
+    [[nodiscard]] inline auto difference(const ContainerRef a, const ContainerRef b) -> Container {
+      if (a.kind == Kind::Array) return filter(a, b, false);
+
+      Vec<u64> words = to_words(a);
+      apply(b, words.data(), [](auto x, auto y) { return x & ~y; });
+      return Container::from_words(std::move(words));
+    }
+
+    [[nodiscard]] inline auto symmetric_difference(const ContainerRef a, const ContainerRef b) -> Container {
+      if (a.kind == Kind::Array and b.kind == Kind::Array) {
+        Vec<u16> values(a.size + b.size);
+        const auto end = std::set_symmetric_difference(
+          a.values().begin(),
+          a.values().end(),
+          b.values().begin(),
+          b.values().end(),
+          values.begin()
+        );
+        values.erase(end, values.end());
+        return Container::from_values(std::move(values));
+      }
+
+      Vec<u64> words = to_words(a);
+      apply(b, words.data(), [](auto x, auto y) { return x ^ y; });
+      return Container::from_words(std::move(words));
+    }
+
+    /**
+     * @brief Index of the first container whose key is not less than 'key'
+     */
+    template<source S>
+    [[nodiscard]] auto lower_bound(const S &set, const u16 key) -> usize {
+      usize low = 0;
+      usize high = set.container_count();
+      while (low < high) {
+        const usize mid = low + (high - low) / 2;
+        if (set.key(mid) < key) {
+          low = mid + 1;
+        } else {
+          high = mid;
+        }
+      }
+      return low;
+    }
+
+    template<source S>
+    [[nodiscard]] auto contains(const S &set, const u32 value) -> bool {
+      const u16 key = static_cast<u16>(value >> 16);
+      const usize index = lower_bound(set, key);
+      return index < set.container_count() and set.key(index) == key and
+             contains(set.container(index), static_cast<u16>(value));
+    }
+
+    template<source S>
+    [[nodiscard]] auto cardinality(const S &set) -> usize {
+      usize total = 0;
+      for (usize i = 0; i < set.container_count(); i++) total += set.container(i).cardinality;
+      return total;
+    }
+
+    /**
+     * @brief Calls 'function' with every value in ascending order, tighter than going through an Iterator
+     * since the container kind is only dispatched on once per container
+     */
+    template<source S, typename F>
+    auto for_each(const S &set, F &&function) -> void {
+      for (usize i = 0; i < set.container_count(); i++) {
+        const u32 high = u32{set.key(i)} << 16;
+        const ContainerRef container = set.container(i);
+
+        switch (container.kind) {
+          case Kind::Array:
+            for (const u16 value: container.values()) function(high | value);
+            break;
+          case Kind::Bitmap:
+            for (usize w = 0; w < BITMAP_WORDS; w++) {
+              for (u64 word = container.words()[w]; word != 0; word &= word - 1) {
+                function(high | static_cast<u32>(w * 64 + static_cast<usize>(std::countr_zero(word))));
+              }
+            }
+            break;
+          case Kind::Run:
+            for (const Run run: container.runs()) {
+              for (u32 value = run.start; value <= run.last(); value++) function(high | value);
+            }
+            break;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Ascending cursor over the values of a RoaringBitmap or RoaringView
+   */
+  template<typename S>
+  class Iterator {
+    const S *set = nullptr;
+    usize index = 0;
+    ContainerRef current{};
+    u32 high = 0;
+    // array index, bitmap word or run
+    usize position = 0;
+    // bits of the current bitmap word that were not visited yet
+    u64 word = 0;
+    u32 value = 0;
+
+    auto load() -> void {
+      if (index == set->container_count()) return;
+
+      current = set->container(index);
+      high = u32{set->key(index)} << 16;
+      position = 0;
+
+      switch (current.kind) {
+        case Kind::Array:
+          value = high | current.values()[0];
+          break;
+        case Kind::Bitmap:
+          word = current.words()[0];
+          while (word == 0) word = current.words()[++position];
+          value = high | static_cast<u32>(position * 64 + static_cast<usize>(std::countr_zero(word)));
+          break;
+        case Kind::Run:
+          value = high | current.runs()[0].start;
+          break;
+      }
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = u32;
+    using reference = u32;
+
+    Iterator() = default;
+
+    Iterator(const S &set, const usize index) : set{&set}, index{index} { load(); }
+
+    [[nodiscard]] __always_inline auto operator*() const -> reference { return value; }
+
+    auto operator++() -> Iterator& {
+      switch (current.kind) {
+        case Kind::Array:
+          if (++position < current.size) {
+            value = high | current.values()[position];
+            return *this;
+          }
+          break;
+        case Kind::Bitmap:
+          word &= word - 1;
+          while (word == 0 and ++position < BITMAP_WORDS) word = current.words()[position];
+          if (word != 0) {
+            value = high | static_cast<u32>(position * 64 + static_cast<usize>(std::countr_zero(word)));
+            return *this;
+          }
+          break;
+        case Kind::Run:
+          if ((value & 0xffff) < current.runs()[position].last()) {
+            value++;
+            return *this;
+          }
+          if (++position < current.size) {
+            value = high | current.runs()[position].start;
+            return *this;
+          }
+          break;
+      }
+
+      index++;
+      load();
+      return *this;
+    }
+
+    auto operator++(int) -> Iterator {
+      Iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    [[nodiscard]] friend auto operator==(const Iterator &a, const Iterator &b) -> bool {
+      return a.index == b.index and (a.index == a.set->container_count() or a.value == b.value);
+    }
+  };
+}
+
+namespace crab {
+  class RoaringBitmap;
+  class RoaringView;
+}
+
+namespace crab::roaring {
+  /**
+   * @brief Values present in both sets
+   */
+  template<source A, source B>
+  [[nodiscard]] auto intersect(const A &a, const B &b) -> RoaringBitmap;
+
+  /**
+   * @brief Values present in either set
+   */
+  template<source A, source B>
+  [[nodiscard]] auto unite(const A &a, const B &b) -> RoaringBitmap;
+
+  /**
+   * @brief Values of 'a' that are not in 'b'
+   */
+  template<source A, source B>
+  [[nodiscard]] auto difference(const A &a, const B &b) -> RoaringBitmap;
+
+  /**
+   * @brief Values present in exactly one of the sets
+   */
+  template<source A, source B>
+  [[nodiscard]] auto symmetric_difference(const A &a, const B &b) -> RoaringBitmap;
+}
+
+namespace crab {
+
+  /**
+   * @brief Compressed set of u32 values (Roaring bitmap).
+   *
+   * Values are split into 65536 wide chunks by their upper 16 bits, each chunk is stored in whichever container
+   * suits its density: a sorted array of up to 4096 values, a 8KiB bitmap or (after optimize()) a list of runs.
+   * Sparse & dense sets both cost a few bits to bytes per value instead of the ~32 bytes of a hash set node, and
+   * set operations work container against container (SIMD array intersections & word wise bitmap operations).
+   *
+   * serialize() produces a buffer that RoaringView reads in place.
+   */
+  class RoaringBitmap {
+    Vec<u16> keys;
+    Vec<roaring::Container> containers;
+
+    /**
+     * @brief Container for 'key', created empty (as an array) if missing
+     */
+    auto container_for(const u16 key) -> roaring::Container& {
+      const auto it = std::lower_bound(keys.begin(), keys.end(), key);
+      const auto index = it - keys.begin();
+      if (it == keys.end() or *it != key) {
+        keys.insert(it, key);
+        containers.insert(containers.begin() + index, roaring::Container::from_values({}));
+      }
+      return containers[static_cast<usize>(index)];
+    }
+
+  public:
+    using Iterator = roaring::Iterator<RoaringBitmap>;
+
+    RoaringBitmap() = default;
+
+    RoaringBitmap(const std::initializer_list<u32> values) {
+      for (const u32 value: values) insert(value);
+    }
+
+    /**
+     * @brief Takes ascending keys with one non empty container per key
+     */
+    [[nodiscard]] static auto from_containers(Vec<u16> keys, Vec<roaring::Container> containers) -> RoaringBitmap {
+      debug_assert(keys.size() == containers.size(), "Every key needs exactly one container");
+      RoaringBitmap set;
+      set.keys = std::move(keys);
+      set.containers = std::move(containers);
+      return set;
+    }
+
+    /**
+     * @brief Builds the set from ascending, duplicate free values in one pass
+     */
+    [[nodiscard]] static auto from_sorted(const Span<const u32> values) -> RoaringBitmap {
+      RoaringBitmap set;
+      for (usize i = 0; i < values.size();) {
+        const u16 key = static_cast<u16>(values[i] >> 16);
+        Vec<u16> low;
+        for (; i < values.size() and static_cast<u16>(values[i] >> 16) == key; i++) {
+          debug_assert(low.empty() or static_cast<u16>(values[i]) > low.back(), "Values must be sorted & unique");
+          low.push_back(static_cast<u16>(values[i]));
+        }
+        set.keys.push_back(key);
+        set.containers.push_back(roaring::Container::from_values(std::move(low)));
+      }
+      return set;
+    }
+
+    /**
+     * @brief Adds 'value', false if it was already present
+     */
+    auto insert(const u32 value) -> bool { return container_for(static_cast<u16>(value >> 16)).insert(value); }
+
+    /**
+     * @brief Adds every value in 'range', stored as runs
+     */
+    auto insert_range(const Range<u32> range) -> void {
+      if (range.lower_bound() == range.upper_bound()) return;
+
+      RoaringBitmap runs;
+      u32 first = range.lower_bound();
+      const u32 last = range.upper_bound() - 1;
+      while (true) {
+        const u32 chunk_last = first | 0xffff;
+        const u32 run_last = std::min(chunk_last, last);
+        runs.keys.push_back(static_cast<u16>(first >> 16));
+        runs.containers.push_back(
+          roaring::Container::from_runs({roaring::Run{static_cast<u16>(first), static_cast<u16>(run_last - first)}})
+        );
+        if (run_last == last) break;
+        first = run_last + 1;
+      }
+      *this |= runs;
+    }
+
+    /**
+     * @brief Removes 'value', false if it was not present
+     */
+    auto remove(const u32 value) -> bool {
+      const u16 key = static_cast<u16>(value >> 16);
+      const auto it = std::lower_bound(keys.begin(), keys.end(), key);
+      if (it == keys.end() or *it != key) return false;
+
+      const auto index = it - keys.begin();
+      roaring::Container &container = containers[static_cast<usize>(index)];
+      if (not container.remove(static_cast<u16>(value))) return false;
+
+      if (container.is_empty()) {
+        keys.erase(it);
+        containers.erase(containers.begin() + index);
+      }
+      return true;
+    }
+
+    [[nodiscard]] auto contains(const u32 value) const -> bool { return roaring::helper::contains(*this, value); }
+
+    /**
+     * @brief Amount of values in the set
+     */
+    [[nodiscard]] auto cardinality() const -> usize { return roaring::helper::cardinality(*this); }
+
+    [[nodiscard]] auto is_empty() const -> bool { return keys.empty(); }
+
+    auto clear() -> void {
+      keys.clear();
+      containers.clear();
+    }
+
+    [[nodiscard]] auto min() const -> Option<u32> {
+      if (is_empty()) return crab::none;
+      return crab::some(*begin());
+    }
+
+    [[nodiscard]] auto max() const -> Option<u32> {
+      if (is_empty()) return crab::none;
+
+      const roaring::ContainerRef last = containers.back().as_ref();
+      const u32 high = u32{keys.back()} << 16;
+      switch (last.kind) {
+        case roaring::Kind::Array:
+          return crab::some(high | last.values().back());
+        case roaring::Kind::Bitmap: {
+          usize w = roaring::BITMAP_WORDS - 1;
+          while (last.words()[w] == 0) w--;
+          return crab::some(high | static_cast<u32>(w * 64 + 63 - static_cast<usize>(std::countl_zero(last.words()[w]))));
+        }
+        case roaring::Kind::Run:
+          return crab::some(high | last.runs().back().last());
+      }
+      return crab::none;
+    }
+
+    /**
+     * @brief Converts every container to its smallest representation, notably run length encoding chunks made of
+     * consecutive values. Worth calling once a set is done being built.
+     */
+    auto optimize() -> void {
+      for (roaring::Container &container: containers) container.shrink();
+      keys.shrink_to_fit();
+      containers.shrink_to_fit();
+    }
+
+    /**
+     * @brief Approximate amount of bytes used by the set, including heap memory
+     */
+    [[nodiscard]] auto memory_usage() const -> usize {
+      usize bytes = sizeof(RoaringBitmap) + keys.capacity() * sizeof(u16) +
+                    containers.capacity() * sizeof(roaring::Container);
+      for (const roaring::Container &container: containers) bytes += container.heap_bytes();
+      return bytes;
+    }
+
+    [[nodiscard]] auto container_count() const -> usize { return keys.size(); }
+
+    [[nodiscard]] auto key(const usize index) const -> u16 { return keys[index]; }
+
+    [[nodiscard]] auto container(const usize index) const -> roaring::ContainerRef {
+      return containers[index].as_ref();
+    }
+
+    [[nodiscard]] auto begin() const -> Iterator { return Iterator{*this, 0}; }
+
+    [[nodiscard]] auto end() const -> Iterator { return Iterator{*this, container_count()}; }
+
+    /**
+     * @brief Calls 'function' with every value in ascending order, faster than iterating
+     */
+    template<typename F>
+    auto for_each(F &&function) const -> void { roaring::helper::for_each(*this, std::forward<F>(function)); }
+
+    [[nodiscard]] auto to_vec() const -> Vec<u32> {
+      Vec<u32> values;
+      values.reserve(cardinality());
+      for_each([&values](const u32 value) { values.push_back(value); });
+      return values;
+    }
+
+    /**
+     * @brief Size of the buffer serialize() produces
+     */
+    [[nodiscard]] auto serialized_size() const -> usize {
+      usize bytes = roaring::helper::HEADER_BYTES + containers.size() * sizeof(roaring::helper::Descriptor);
+      for (usize i = 0; i < containers.size(); i++) {
+        const roaring::ContainerRef container = containers[i].as_ref();
+        bytes += roaring::helper::align8(roaring::helper::payload_bytes(container.kind, container.size));
+      }
+      return bytes;
+    }
+
+    /**
+     * @brief Writes the set into a flat buffer that RoaringView can read without copying or parsing the contents.
+     *
+     * Layout (host byte order): u32 MAGIC, u32 container count, one 16 byte descriptor per container (key, kind,
+     * cardinality, element count & offset) then every container's values / words / runs, each at an 8 byte
+     * aligned offset.
+     */
+    [[nodiscard]] auto serialize() const -> Vec<u8> {
+      using roaring::helper::Descriptor;
+
+      Vec<u8> bytes(serialized_size(), 0);
+      const u32 header[2]{roaring::MAGIC, static_cast<u32>(containers.size())};
+      std::memcpy(bytes.data(), header, sizeof(header));
+
+      usize offset = roaring::helper::HEADER_BYTES + containers.size() * sizeof(Descriptor);
+      for (usize i = 0; i < containers.size(); i++) {
+        const roaring::ContainerRef container = containers[i].as_ref();
+        const usize payload = roaring::helper::payload_bytes(container.kind, container.size);
+
+        const Descriptor descriptor{
+          keys[i],
+          container.kind,
+          0,
+          container.cardinality,
+          container.size,
+          static_cast<u32>(offset)
+        };
+        std::memcpy(bytes.data() + roaring::helper::HEADER_BYTES + i * sizeof(Descriptor), &descriptor, sizeof(Descriptor));
+        std::memcpy(bytes.data() + offset, container.data, payload);
+        offset += roaring::helper::align8(payload);
+      }
+      return bytes;
+    }
+
+    auto operator&=(const RoaringBitmap &other) -> RoaringBitmap& { return *this = *this & other; }
+
+    auto operator|=(const RoaringBitmap &other) -> RoaringBitmap& { return *this = *this | other; }
+
+    auto operator^=(const RoaringBitmap &other) -> RoaringBitmap& { return *this = *this ^ other; }
+
+    auto operator-=(const RoaringBitmap &other) -> RoaringBitmap& { return *this = *this - other; }
+
+    [[nodiscard]] friend auto operator&(const RoaringBitmap &a, const RoaringBitmap &b) -> RoaringBitmap {
+      return roaring::intersect(a, b);
+    }
+
+    [[nodiscard]] friend auto operator|(const RoaringBitmap &a, const RoaringBitmap &b) -> RoaringBitmap {
+      return roaring::unite(a, b);
+    }
+
+    [[nodiscard]] friend auto operator^(const RoaringBitmap &a, const RoaringBitmap &b) -> RoaringBitmap {
+      return roaring::symmetric_difference(a, b);
+    }
+
+    [[nodiscard]] friend auto operator-(const RoaringBitmap &a, const RoaringBitmap &b) -> RoaringBitmap {
+      return roaring::difference(a, b);
+    }
+
+    /**
+     * @brief Same values, regardless of how the containers are represented
+     */
+    [[nodiscard]] friend auto operator==(const RoaringBitmap &a, const RoaringBitmap &b) -> bool {
+      return a.keys == b.keys and a.cardinality() == b.cardinality() and (a ^ b).is_empty();
+    }
+  };
+
+  /**
+   * @brief Read only RoaringBitmap backed by a buffer from RoaringBitmap::serialize, containers are used in place
+   * so opening a view is O(containers) validation without copying any values.
+   *
+   * The buffer must be 8 byte aligned & outlive the view.
+   */
+  class RoaringView {
+    Span<const u8> bytes;
+    usize count = 0;
+
+    RoaringView(const Span<const u8> bytes, const usize count) : bytes{bytes}, count{count} {}
+
+    [[nodiscard]] __always_inline auto descriptor(const usize index) const -> roaring::helper::Descriptor {
+      roaring::helper::Descriptor descriptor;
+      std::memcpy(
+        &descriptor,
+        bytes.data() + roaring::helper::HEADER_BYTES + index * sizeof(roaring::helper::Descriptor),
+        sizeof(descriptor)
+      );
+      return descriptor;
+    }
+
+  public:
+    using Iterator = roaring::Iterator<RoaringView>;
+
+    /**
+     * @brief Checks a serialized buffer is well formed (header, bounds, alignment, key order & that every container
+     * holds sorted values matching its cardinality), so untrusted bytes are safe to open
+     */
+    [[nodiscard]] static auto from_bytes(const Span<const u8> bytes) -> Result<RoaringView, roaring::FormatError> {
+      using roaring::helper::Descriptor;
+      using roaring::FormatError;
+
+      if (reinterpret_cast<uptr>(bytes.data()) % 8 != 0) return FormatError{"Buffer is not 8 byte aligned"};
+      if (bytes.size() < roaring::helper::HEADER_BYTES) return FormatError{"Buffer is smaller than the header"};
+
+      u32 header[2];
+      std::memcpy(header, bytes.data(), sizeof(header));
+      if (header[0] != roaring::MAGIC) return FormatError{"Buffer does not start with the RoaringBitmap magic"};
+
+      const usize count = header[1];
+      if (count > roaring::CHUNK_SIZE or
+          bytes.size() < roaring::helper::HEADER_BYTES + count * sizeof(Descriptor)) {
+        return FormatError{"Buffer is too small for its container descriptors"};
+      }
+
+      const RoaringView view{bytes, count};
+      for (usize i = 0; i < count; i++) {
+        const Descriptor descriptor = view.descriptor(i);
+
+        if (i != 0 and view.descriptor(i - 1).key >= descriptor.key) return FormatError{"Keys are not ascending"};
+        if (descriptor.offset % 8 != 0) return FormatError{"Container is not 8 byte aligned"};
+
+        switch (descriptor.kind) {
+          case roaring::Kind::Array:
+            if (descriptor.size == 0 or descriptor.size > roaring::ARRAY_MAX or descriptor.size != descriptor.cardinality) {
+              return FormatError{"Invalid array container size"};
+            }
+            break;
+          case roaring::Kind::Bitmap:
+            if (descriptor.size != roaring::BITMAP_WORDS or descriptor.cardinality == 0 or
+                descriptor.cardinality > roaring::CHUNK_SIZE) {
+              return FormatError{"Invalid bitmap container size"};
+            }
+            break;
+          case roaring::Kind::Run:
+            if (descriptor.size == 0 or descriptor.size > roaring::CHUNK_SIZE / 2 or descriptor.cardinality == 0 or
+                descriptor.cardinality > roaring::CHUNK_SIZE) {
+              return FormatError{"Invalid run container size"};
+            }
+            break;
+          default:
+            return FormatError{"Unknown container kind"};
+        }
+
+        const usize end = usize{descriptor.offset} + roaring::helper::payload_bytes(descriptor.kind, descriptor.size);
+        if (end > bytes.size()) return FormatError{"Container extends past the end of the buffer"};
+
+        // the iterators & conversions rely on the payload agreeing with its descriptor
+        const roaring::ContainerRef container = view.container(i);
+        switch (descriptor.kind) {
+          case roaring::Kind::Array: {
+            const Span<const u16> values = container.values();
+            for (usize v = 1; v < values.size(); v++) {
+              if (values[v - 1] >= values[v]) return FormatError{"Array container is not strictly ascending"};
+            }
+            break;
+          }
+          case roaring::Kind::Bitmap:
+            if (simd::popcount(container.words(), roaring::BITMAP_WORDS) != descriptor.cardinality) {
+              return FormatError{"Bitmap container does not hold its cardinality"};
+            }
+            break;
+          default: {
+            usize total = 0;
+            const Span<const roaring::Run> runs = container.runs();
+            for (usize r = 0; r < runs.size(); r++) {
+              if (runs[r].last() > std::numeric_limits<u16>::max()) return FormatError{"Run goes past 0xFFFF"};
+              if (r != 0 and runs[r].start <= runs[r - 1].last()) {
+                return FormatError{"Runs are not ascending & disjoint"};
+              }
+              total += usize{runs[r].length} + 1;
+            }
+            if (total != descriptor.cardinality) return FormatError{"Run container does not hold its cardinality"};
+          }
+        }
+      }
+
+      return view;
+    }
+
+    [[nodiscard]] auto container_count() const -> usize { return count; }
+
+    [[nodiscard]] auto key(const usize index) const -> u16 {
+      u16 key;
+      std::memcpy(
+        &key,
+        bytes.data() + roaring::helper::HEADER_BYTES + index * sizeof(roaring::helper::Descriptor),
+        sizeof(key)
+      );
+      return key;
+    }
+
+    [[nodiscard]] auto container(const usize index) const -> roaring::ContainerRef {
+      const roaring::helper::Descriptor descriptor = this->descriptor(index);
+      return roaring::ContainerRef{
+        descriptor.kind,
+        descriptor.cardinality,
+        descriptor.size,
+        bytes.data() + descriptor.offset
+      };
+    }
+
+    [[nodiscard]] auto contains(const u32 value) const -> bool { return roaring::helper::contains(*this, value); }
+
+    [[nodiscard]] auto cardinality() const -> usize { return roaring::helper::cardinality(*this); }
+
+    [[nodiscard]] auto is_empty() const -> bool { return count == 0; }
+
+    [[nodiscard]] auto begin() const -> Iterator { return Iterator{*this, 0}; }
+
+    [[nodiscard]] auto end() const -> Iterator { return Iterator{*this, count}; }
+
+    template<typename F>
+    auto for_each(F &&function) const -> void { roaring::helper::for_each(*this, std::forward<F>(function)); }
+
+    /**
+     * @brief Owned copy of the set
+     */
+    [[nodiscard]] auto to_bitmap() const -> RoaringBitmap { return roaring::unite(*this, RoaringBitmap{}); }
+  };
+}
+
+namespace crab::roaring {
+  namespace helper {
+    /**
+     * @brief Walks the keys of both sets in order, 'op' combines containers present in both & containers present
+     * in only one side are copied if that side is kept.
+     */
+    template<source A, source B, typename Op>
+    [[nodiscard]] auto merge(const A &a, const B &b, const bool keep_a, const bool keep_b, const Op op) -> RoaringBitmap {
+      Vec<u16> keys;
+      Vec<Container> containers;
+
+      const auto push = [&](const u16 key, Container container) {
+        if (container.is_empty()) return;
+        keys.push_back(key);
+        containers.push_back(std::move(container));
+      };
+
+      usize i = 0;
+      usize j = 0;
+      while (i < a.container_count() and j < b.container_count()) {
+        const u16 key_a = a.key(i);
+        const u16 key_b = b.key(j);
+        if (key_a == key_b) {
+          push(key_a, op(a.container(i++), b.container(j++)));
+        } else if (key_a < key_b) {
+          if (keep_a) push(key_a, Container::from_ref(a.container(i)));
+          i++;
+        } else {
+          if (keep_b) push(key_b, Container::from_ref(b.container(j)));
+          j++;
+        }
+      }
+
+      for (; keep_a and i < a.container_count(); i++) push(a.key(i), Container::from_ref(a.container(i)));
+      for (; keep_b and j < b.container_count(); j++) push(b.key(j), Container::from_ref(b.container(j)));
+      return RoaringBitmap::from_containers(std::move(keys), std::move(containers));
+    }
+  }
+
+  template<source A, source B>
+  auto intersect(const A &a, const B &b) -> RoaringBitmap {
+    return helper::merge(a, b, false, false, helper::intersect);
+  }
+
+  template<source A, source B>
+  auto unite(const A &a, const B &b) -> RoaringBitmap {
+    return helper::merge(a, b, true, true, helper::unite);
+  }
+
+  template<source A, source B>
+  auto difference(const A &a, const B &b) -> RoaringBitmap {
+    return helper::merge(a, b, true, false, helper::difference);
+  }
+
+  template<source A, source B>
+  auto symmetric_difference(const A &a, const B &b) -> RoaringBitmap {
+    return helper::merge(a, b, true, true, helper::symmetric_difference);
+  }
+}
@@ -0,0 +1,434 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "crab/epoch.hpp"
+#include "crab/pool.hpp"
+#include "option.hpp"
+#include "ref.hpp"
+
+namespace crab::skip_list {
+  /**
+   * @brief Tallest tower a node can have, with a branching factor of 4 this covers ~4^16 entries
+   */
+  inline constexpr usize MAX_HEIGHT = 16;
+
+  namespace helper {
+    // low bit of a 'next' pointer marks the node that owns it as deleted at that level
+    inline constexpr uptr MARK = 1;
+
+    [[nodiscard]] __always_inline constexpr auto is_marked(const uptr link) -> bool { return (link & MARK) != 0; }
+
+    /**
+     * @brief Geometric (p = 1/4) tower height from a per thread xorshift generator
+     */
+    [[nodiscard]] inline auto random_height() -> usize {
+      thread_local u64 state = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<uptr>(&state);
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      const usize height = 1 + static_cast<usize>(std::countr_zero(state | (1ull << (2 * (MAX_HEIGHT - 1))))) / 2;
+      return height;
+    }
+
+    // node lifecycle flags, whoever sets the second one retires the node
+    inline constexpr u8 LINKED = 1;
+    inline constexpr u8 UNLINKED = 2;
+
+    template<typename K, typename V>
+    struct alignas(alignof(std::atomic<uptr>)) Node {
+      K key;
+      V value;
+      u32 height;
+      std::atomic<u8> lifecycle{0};
+
+      Node(K key, V value, const usize height)
+        : key{std::move(key)}, value{std::move(value)}, height{static_cast<u32>(height)} {}
+
+      [[nodiscard]] static auto bytes(const usize height) -> usize {
+        return sizeof(Node) + height * sizeof(std::atomic<uptr>);
+      }
+
+      /**
+       * @brief The 'next' links of every level, stored directly after the node
+       */
+      [[nodiscard]] __always_inline auto tower() -> std::atomic<uptr>* {
+        return reinterpret_cast<std::atomic<uptr>*>(this + 1);
+      }
+
+      [[nodiscard]] static auto create(K key, V value, const usize height) -> Node* {
+        void *memory = pool::allocate(bytes(height));
+        Node *node = ::new(memory) Node{std::move(key), std::move(value), height};
+        for (usize i = 0; i < height; i++) {
+          std::construct_at(node->tower() + i, 0);
+        }
+        return node;
+      }
+
+      static auto destroy(void *erased) -> void {
+        Node *node = static_cast<Node*>(erased);
+        const usize height = node->height;
+        std::destroy_at(node);
+        pool::deallocate(node, bytes(height));
+      }
+    };
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Ordered key-value index that many threads can insert into, remove from & scan concurrently without locks.
+   *
+   * Nodes are unlinked with marked pointers (Harris / Fraser style) & freed through epoch based reclamation,
+   * so any Ref handed out stays valid for as long as the Guard / Scan it was obtained through is alive.
+   * Values are immutable once inserted.
+   *
+   * Node memory is taken from a per-thread pool (see crab::pool).
+   */
+  template<typename K, typename V, typename Compare = std::less<K>>
+    requires std::is_move_constructible_v<K> and std::is_move_constructible_v<V>
+  class ConcurrentSkipList {
+    using Node = skip_list::helper::Node<K, V>;
+    using Link = std::atomic<uptr>;
+
+    static constexpr usize MAX_HEIGHT = skip_list::MAX_HEIGHT;
+
+    Link head[MAX_HEIGHT]{};
+    std::atomic<usize> count{0};
+    [[no_unique_address]] Compare comp{};
+
+    [[nodiscard]] __always_inline static auto as_node(const uptr link) -> Node* {
+      return reinterpret_cast<Node*>(link & ~skip_list::helper::MARK);
+    }
+
+  public:
+    /**
+     * @brief Range of entries that keeps the current thread pinned, so the yielded references cannot be freed
+     * underneath it. Entries inserted or removed during the scan may or may not be observed.
+     */
+    class Scan {
+      friend class ConcurrentSkipList;
+
+      // declared first so that the thread is pinned before 'first' is searched for
+      epoch::Guard guard{};
+      const ConcurrentSkipList *list;
+      Node *first;
+      Option<K> max;
+
+      Scan(const ConcurrentSkipList *list, const K *min, Option<K> max)
+        : list{list},
+          first{min ? list->lower_bound(*min) : as_node(list->head[0].load(std::memory_order_acquire))},
+          max{std::move(max)} {}
+
+    public:
+      class Iterator {
+        friend class Scan;
+
+        const Scan *scan = nullptr;
+        Node *node = nullptr;
+
+        Iterator(const Scan *scan, Node *node) : scan{scan}, node{node} { skip(); }
+
+        auto skip() -> void {
+          while (node != nullptr) {
+            if (scan->max.is_some() and not scan->list->comp(node->key, scan->max.get_unchecked())) {
+              node = nullptr;
+              return;
+            }
+            const uptr next = node->tower()[0].load(std::memory_order_acquire);
+            if (not skip_list::helper::is_marked(next)) return;
+            node = as_node(next);
+          }
+        }
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = std::pair<Ref<K>, Ref<V>>;
+        using reference = value_type;
+
+        Iterator() = default;
+
+        [[nodiscard]] auto operator*() const -> reference { return {Ref<K>{node->key}, Ref<V>{node->value}}; }
+
+        auto operator++() -> Iterator& {
+          node = as_node(node->tower()[0].load(std::memory_order_acquire));
+          skip();
+          return *this;
+        }
+
+        auto operator++(int) -> Iterator {
+          Iterator tmp = *this;
+          ++*this;
+          return tmp;
+        }
+
+        [[nodiscard]] friend auto operator==(const Iterator &a, const Iterator &b) -> bool {
+          return a.node == b.node;
+        }
+      };
+
+      Scan(const Scan &) = delete;
+
+      auto operator=(const Scan &) -> Scan& = delete;
+
+      [[nodiscard]] auto begin() const -> Iterator { return Iterator{this, first}; }
+
+      [[nodiscard]] auto end() const -> Iterator { return Iterator{this, nullptr}; }
+    };
+
+    ConcurrentSkipList() = default;
+
+    explicit ConcurrentSkipList(Compare comp) : comp{std::move(comp)} {}
+
+    ConcurrentSkipList(const ConcurrentSkipList &) = delete;
+
+    auto operator=(const ConcurrentSkipList &) -> ConcurrentSkipList& = delete;
+
+    /**
+     * @brief Must not run concurrently with any other operation on the list
+     */
+    ~ConcurrentSkipList() {
+      uptr link = head[0].load(std::memory_order_acquire);
+      while (Node *node = as_node(link)) {
+        link = node->tower()[0].load(std::memory_order_relaxed);
+        Node::destroy(node);
+      }
+    }
+
+    /**
+     * @brief Approximate amount of entries, exact when no operation is in flight
+     */
+    [[nodiscard]] auto length() const -> usize { return count.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] auto is_empty() const -> bool { return length() == 0; }
+
+    /**
+     * @brief Inserts a key-value pair if the key is not already present, returns whether it was inserted
+     */
+    auto insert(K key, V value) -> bool {
+      const epoch::Guard guard{};
+
+      Link *preds[MAX_HEIGHT];
+      Node *succs[MAX_HEIGHT];
+
+      if (find(key, preds, succs)) {
+        return false;
+      }
+
+      const usize height = skip_list::helper::random_height();
+      Node *node = Node::create(std::move(key), std::move(value), height);
+      for (usize level = 0; level < height; level++) {
+        node->tower()[level].store(reinterpret_cast<uptr>(succs[level]), std::memory_order_relaxed);
+      }
+
+      while (true) {
+        uptr expected = reinterpret_cast<uptr>(succs[0]);
+        if (preds[0]->compare_exchange_strong(expected, reinterpret_cast<uptr>(node))) {
+          break;
+        }
+
+        if (find(node->key, preds, succs)) {
+          Node::destroy(node);
+          return false;
+        }
+        node->tower()[0].store(reinterpret_cast<uptr>(succs[0]), std::memory_order_relaxed);
+      }
+      count.fetch_add(1, std::memory_order_relaxed);
+
+      for (usize level = 1; level < height; level++) {
+        while (true) {
+          // point our own link at the successor first, if it was marked we have been removed already
+          uptr own = node->tower()[level].load(std::memory_order_acquire);
+          if (skip_list::helper::is_marked(own)) break;
+          if (as_node(own) != succs[level] and
+              not node->tower()[level].compare_exchange_strong(own, reinterpret_cast<uptr>(succs[level]))) {
+            break;
+          }
+
+          uptr expected = reinterpret_cast<uptr>(succs[level]);
+          if (preds[level]->compare_exchange_strong(expected, reinterpret_cast<uptr>(node))) break;
+
+          find(node->key, preds, succs);
+          if (succs[0] != node) break;
+        }
+      }
+
+      if (skip_list::helper::is_marked(node->tower()[0].load(std::memory_order_seq_cst))) {
+        // removed while we were still linking the upper levels, make sure no level still points at it
+        find(node->key, preds, succs);
+      }
+      if (node->lifecycle.fetch_or(skip_list::helper::LINKED) & skip_list::helper::UNLINKED) {
+        guard.retire(node, &Node::destroy);
+      }
+      return true;
+    }
+
+    /**
+     * @brief Removes a key, returns whether this call removed it
+     */
+    auto remove(const K &key) -> bool {
+      const epoch::Guard guard{};
+
+      Link *preds[MAX_HEIGHT];
+      Node *succs[MAX_HEIGHT];
+
+      if (not find(key, preds, succs)) {
+        return false;
+      }
+
+      Node *node = succs[0];
+      for (usize level = node->height; level-- > 1;) {
+        uptr link = node->tower()[level].load(std::memory_order_acquire);
+        while (not skip_list::helper::is_marked(link)) {
+          node->tower()[level].compare_exchange_weak(link, link | skip_list::helper::MARK);
+        }
+      }
+
+      uptr link = node->tower()[0].load(std::memory_order_acquire);
+      while (true) {
+        if (skip_list::helper::is_marked(link)) {
+          // someone else won the removal
+          return false;
+        }
+        if (node->tower()[0].compare_exchange_strong(link, link | skip_list::helper::MARK)) {
+          break;
+        }
+      }
+      count.fetch_sub(1, std::memory_order_relaxed);
+
+      find(key, preds, succs);
+      if (node->lifecycle.fetch_or(skip_list::helper::UNLINKED) & skip_list::helper::LINKED) {
+        guard.retire(node, &Node::destroy);
+      }
+      return true;
+    }
+
+    [[nodiscard]] auto contains(const K &key) const -> bool {
+      const epoch::Guard guard{};
+      return lookup(key) != nullptr;
+    }
+
+    /**
+     * @brief Copy of the value with the given key, if it exists
+     */
+    [[nodiscard]] auto get(const K &key) const -> Option<V> requires std::copy_constructible<V> {
+      const epoch::Guard guard{};
+      if (const Node *node = lookup(key)) {
+        return crab::some(V{node->value});
+      }
+      return crab::none;
+    }
+
+    /**
+     * @brief Reference to the value with the given key, which stays valid while 'guard' is alive
+     */
+    [[nodiscard]] auto get(const K &key, [[maybe_unused]] const epoch::Guard &guard) const -> Option<Ref<V>> {
+      if (const Node *node = lookup(key)) {
+        return crab::some(Ref<V>{node->value});
+      }
+      return crab::none;
+    }
+
+    /**
+     * @brief All entries with keys in [min, max), in ascending order
+     */
+    [[nodiscard]] auto range(const K &min, const K &max) const -> Scan requires std::copy_constructible<K> {
+      return Scan{this, &min, crab::some(K{max})};
+    }
+
+    /**
+     * @brief All entries with keys not less than 'min', in ascending order
+     */
+    [[nodiscard]] auto range_from(const K &min) const -> Scan {
+      return Scan{this, &min, crab::none};
+    }
+
+    /**
+     * @brief All entries, in ascending order
+     */
+    [[nodiscard]] auto scan() const -> Scan {
+      return Scan{this, nullptr, crab::none};
+    }
+
+  private:
+    /**
+     * @brief Finds the predecessor & successor of 'key' on every level, unlinking marked nodes along the way.
+     * Returns whether succs[0] holds 'key'.
+     */
+    auto find(const K &key, Link **preds, Node **succs) -> bool {
+    retry:
+      Link *pred = head;
+      Node *curr = nullptr;
+
+      for (usize level = MAX_HEIGHT; level-- > 0;) {
+        uptr link = pred[level].load(std::memory_order_acquire);
+        if (skip_list::helper::is_marked(link)) goto retry;
+        curr = as_node(link);
+
+        while (curr != nullptr) {
+          uptr next = curr->tower()[level].load(std::memory_order_acquire);
+
+          while (skip_list::helper::is_marked(next)) {
+            uptr expected = reinterpret_cast<uptr>(curr);
+            const uptr unmarked = next & ~skip_list::helper::MARK;
+            if (not pred[level].compare_exchange_strong(expected, unmarked)) goto retry;
+
+            curr = as_node(unmarked);
+            if (curr == nullptr) break;
+            next = curr->tower()[level].load(std::memory_order_acquire);
+          }
+
+          if (curr == nullptr or not comp(curr->key, key)) break;
+
+          pred = curr->tower();
+          curr = as_node(next);
+        }
+
+        preds[level] = &pred[level];
+        succs[level] = curr;
+      }
+
+      return curr != nullptr and not comp(key, curr->key);
+    }
+
+    /**
+     * @brief Read-only search for the first live node not less than 'key', never writes to the list
+     */
+    [[nodiscard]] auto lower_bound(const K &key) const -> Node* {
+      const Link *pred = head;
+      Node *curr = nullptr;
+
+      for (usize level = MAX_HEIGHT; level-- > 0;) {
+        curr = as_node(pred[level].load(std::memory_order_acquire));
+        while (curr != nullptr) {
+          const uptr next = curr->tower()[level].load(std::memory_order_acquire);
+          if (skip_list::helper::is_marked(next)) {
+            curr = as_node(next);
+            continue;
+          }
+          if (not comp(curr->key, key)) break;
+          pred = curr->tower();
+          curr = as_node(next);
+        }
+      }
+
+      return curr;
+    }
+
+    [[nodiscard]] auto lookup(const K &key) const -> const Node* {
+      const Node *node = lower_bound(key);
+      if (node != nullptr and not comp(key, node->key)) {
+        return node;
+      }
+      return nullptr;
+    }
+  };
+}
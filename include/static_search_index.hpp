@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "preamble.hpp"
+#include "crab/debug.hpp"
+#include "option.hpp"
+
+namespace crab::search {
+  inline constexpr usize CACHE_LINE = 64;
+
+  /**
+   * @brief Amount of queries a batched lookup advances in lock step, enough independent loads in flight to
+   * cover a DRAM miss
+   */
+  inline constexpr usize BATCH_WIDTH = 16;
+
+  namespace helper {
+    /**
+     * @brief Allocator that places the first element on a cache line boundary
+     */
+    template<typename T>
+    struct CacheLineAllocator {
+      using value_type = T;
+
+      CacheLineAllocator() = default;
+
+      template<typename U>
+      constexpr CacheLineAllocator(const CacheLineAllocator<U> &) noexcept {}
+
+      [[nodiscard]] auto allocate(const usize count) -> T* {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{CACHE_LINE}));
+      }
+
+      auto deallocate(T *pointer, const usize) noexcept -> void {
+        ::operator delete(pointer, std::align_val_t{CACHE_LINE});
+      }
+
+      [[nodiscard]] friend constexpr auto operator==(const CacheLineAllocator &, const CacheLineAllocator &) -> bool {
+        return true;
+      }
+    };
+
+    /**
+     * @brief Hints the cache line 'bytes' past 'base', computed on integers as the address is usually past the
+     * end of the array (prefetches never fault)
+     */
+    __always_inline auto prefetch(const void *base, const usize bytes) -> void {
+      __builtin_prefetch(reinterpret_cast<const void*>(reinterpret_cast<uptr>(base) + bytes));
+    }
+
+    /**
+     * @brief Undoes the trailing right turns of an Eytzinger descent, leaving the last node where the search went
+     * left (the answer) or 0 if it never did.
+     */
+    [[nodiscard]] __always_inline constexpr auto resolve(const usize k) -> usize {
+      return k >> (std::countr_one(k) + 1);
+    }
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Read only lower_bound index over a sorted array, stored in Eytzinger (breadth first) order.
+   *
+   * Node k has its children at 2k & 2k + 1, so the first levels of the tree share a few hot cache lines and the
+   * 16 (for 4 byte keys) descendants four levels down are always one cache line that gets prefetched while the
+   * current level is compared. The descent is branchless, each step is a compare & a shift.
+   *
+   * Results are positions in the original sorted array, so the index can sit next to the data it was built from
+   * (or replace it, value() gives the elements back).
+   */
+  template<typename T, typename Compare = std::less<T>>
+    requires std::copyable<T>
+  class StaticSearchIndex {
+    // 1 indexed, slot 0 holds a copy of the smallest element so that finished batch lanes read something valid
+    std::vector<T, search::helper::CacheLineAllocator<T>> tree;
+    // sorted position of every node
+    Vec<u32> ranks;
+    usize len = 0;
+    [[no_unique_address]] Compare comp{};
+
+    /**
+     * @brief Elements a cache line holds, the descendants 'log2(LINE_ELEMENTS)' levels down from k start at
+     * k * LINE_ELEMENTS
+     */
+    static constexpr usize LINE_ELEMENTS = std::max<usize>(1, search::CACHE_LINE / sizeof(T));
+
+    auto build(const Span<const T> sorted, usize &next, const usize k) -> void {
+      if (k > len) return;
+      build(sorted, next, 2 * k);
+      tree[k] = sorted[next];
+      ranks[k] = static_cast<u32>(next);
+      next++;
+      build(sorted, next, 2 * k + 1);
+    }
+
+    [[nodiscard]] __always_inline auto position(const usize node) const -> usize {
+      return node == 0 ? len : ranks[node];
+    }
+
+  public:
+    StaticSearchIndex() = default;
+
+    /**
+     * @brief Copies 'sorted' (ascending according to 'comp') into the index
+     */
+    explicit StaticSearchIndex(const Span<const T> sorted, Compare comp = {})
+      : len{sorted.size()}, comp{std::move(comp)} {
+      debug_assert(
+        std::is_sorted(sorted.begin(), sorted.end(), this->comp),
+        "StaticSearchIndex needs sorted input"
+      );
+      debug_assert(sorted.size() < std::numeric_limits<u32>::max(), "StaticSearchIndex holds up to 2^32 - 1 elements");
+
+      if (sorted.empty()) return;
+
+      tree.resize(len + 1, sorted.front());
+      ranks.resize(len + 1, 0);
+      usize next = 0;
+      build(sorted, next, 1);
+    }
+
+    /**
+     * @brief Amount of elements
+     */
+    [[nodiscard]] __always_inline auto length() const -> usize { return len; }
+
+    [[nodiscard]] __always_inline auto is_empty() const -> bool { return len == 0; }
+
+    /**
+     * @brief Position of the first element that is not less than 'key' in the sorted input, length() if there is
+     * none (same result as std::lower_bound)
+     */
+    [[nodiscard]] auto lower_bound(const T &key) const -> usize {
+      const T *nodes = tree.data();
+      usize k = 1;
+      while (k <= len) {
+        search::helper::prefetch(nodes, k * LINE_ELEMENTS * sizeof(T));
+        k = 2 * k + static_cast<usize>(comp(nodes[k], key));
+      }
+      return position(search::helper::resolve(k));
+    }
+
+    /**
+     * @brief Position of an element equal to 'key' in the sorted input
+     */
+    [[nodiscard]] auto find(const T &key) const -> Option<usize> {
+      const usize index = lower_bound(key);
+      if (index == len or comp(key, value(index))) return crab::none;
+      return crab::some(index);
+    }
+
+    [[nodiscard]] auto contains(const T &key) const -> bool { return find(key).is_some(); }
+
+    /**
+     * @brief out[i] = lower_bound(keys[i]), descends for BATCH_WIDTH keys at a time in lock step so their cache
+     * misses overlap instead of being paid one after another
+     */
+    auto lower_bound_batch(const Span<const T> keys, const Span<usize> out) const -> void {
+      debug_assert(keys.size() == out.size(), "Every key needs an output slot");
+
+      if (len == 0) {
+        std::fill(out.begin(), out.end(), 0);
+        return;
+      }
+
+      const T *nodes = tree.data();
+      const usize height = static_cast<usize>(std::bit_width(len));
+
+      for (usize first = 0; first < keys.size(); first += search::BATCH_WIDTH) {
+        const usize count = std::min(search::BATCH_WIDTH, keys.size() - first);
+
+        std::array<usize, search::BATCH_WIDTH> ks;
+        ks.fill(1);
+
+        for (usize level = 0; level < height; level++) {
+          for (usize lane = 0; lane < count; lane++) {
+            const usize k = ks[lane];
+            const bool inside = k <= len;
+            // lanes that already fell off the bottom keep reading slot 0 & stay where they are
+            const usize next = 2 * k + static_cast<usize>(comp(nodes[inside ? k : 0], keys[first + lane]));
+            ks[lane] = inside ? next : k;
+            search::helper::prefetch(nodes, ks[lane] * LINE_ELEMENTS * sizeof(T));
+          }
+        }
+
+        for (usize lane = 0; lane < count; lane++) {
+          out[first + lane] = position(search::helper::resolve(ks[lane]));
+        }
+      }
+    }
+
+    /**
+     * @brief Element at 'index' of the sorted input, O(log n)
+     */
+    [[nodiscard]] auto value(const usize index) const -> const T& {
+      debug_assert(index < len, "Index out of Bounds");
+
+      // in order walk: the node for rank 'index' is found by descending on ranks
+      usize k = 1;
+      while (ranks[k] != index) k = 2 * k + static_cast<usize>(ranks[k] < index);
+      return tree[k];
+    }
+
+    /**
+     * @brief Heap memory used by the index
+     */
+    [[nodiscard]] auto memory_bytes() const -> usize {
+      return tree.capacity() * sizeof(T) + ranks.capacity() * sizeof(u32);
+    }
+  };
+}
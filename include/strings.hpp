@@ -0,0 +1,477 @@
+#pragma once
+
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include "preamble.hpp"
+#include "option.hpp"
+#include "crab/debug.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace crab::strings::helper {
+  /**
+   * @brief Byte vector operations the searches are written against, one bit per byte in the masks
+   */
+  #if defined(__AVX2__)
+  struct Simd {
+    using Vector = __m256i;
+    static constexpr usize WIDTH = 32;
+
+    [[nodiscard]] __always_inline static auto load(const char *from) -> Vector {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from));
+    }
+
+    [[nodiscard]] __always_inline static auto splat(const char value) -> Vector { return _mm256_set1_epi8(value); }
+
+    [[nodiscard]] __always_inline static auto equal(const Vector a, const Vector b) -> Vector {
+      return _mm256_cmpeq_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_or(const Vector a, const Vector b) -> Vector {
+      return _mm256_or_si256(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_and(const Vector a, const Vector b) -> Vector {
+      return _mm256_and_si256(a, b);
+    }
+
+    /**
+     * @brief Lanes where 'low' <= byte <= 'low' + 'span' (unsigned)
+     */
+    [[nodiscard]] __always_inline static auto in_range(const Vector bytes, const char low, const char span) -> Vector {
+      const Vector offset = _mm256_sub_epi8(bytes, splat(low));
+      return equal(_mm256_min_epu8(offset, splat(span)), offset);
+    }
+
+    [[nodiscard]] __always_inline static auto mask(const Vector lanes) -> u32 {
+      return static_cast<u32>(_mm256_movemask_epi8(lanes));
+    }
+  };
+  #elif defined(__SSE2__)
+  struct Simd {
+    using Vector = __m128i;
+    static constexpr usize WIDTH = 16;
+
+    [[nodiscard]] __always_inline static auto load(const char *from) -> Vector {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(from));
+    }
+
+    [[nodiscard]] __always_inline static auto splat(const char value) -> Vector { return _mm_set1_epi8(value); }
+
+    [[nodiscard]] __always_inline static auto equal(const Vector a, const Vector b) -> Vector {
+      return _mm_cmpeq_epi8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_or(const Vector a, const Vector b) -> Vector {
+      return _mm_or_si128(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_and(const Vector a, const Vector b) -> Vector {
+      return _mm_and_si128(a, b);
+    }
+
+    /**
+     * @brief Lanes where 'low' <= byte <= 'low' + 'span' (unsigned)
+     */
+    [[nodiscard]] __always_inline static auto in_range(const Vector bytes, const char low, const char span) -> Vector {
+      const Vector offset = _mm_sub_epi8(bytes, splat(low));
+      return equal(_mm_min_epu8(offset, splat(span)), offset);
+    }
+
+    [[nodiscard]] __always_inline static auto mask(const Vector lanes) -> u32 {
+      return static_cast<u32>(_mm_movemask_epi8(lanes));
+    }
+  };
+  #endif
+
+  [[nodiscard]] __always_inline constexpr auto is_whitespace(const char c) -> bool {
+    // '\t' '\n' '\v' '\f' '\r' are contiguous
+    return c == ' ' or static_cast<u8>(c - '\t') <= '\r' - '\t';
+  }
+
+  /**
+   * @brief Index of the first byte in [data, data + len) 'matches' accepts, 'len' if there is none. 'lanes' is the
+   * same test on a whole vector, giving a lane mask.
+   */
+  template<typename Lanes, typename Matches>
+  [[nodiscard]] __always_inline auto find_if(
+    const char *data,
+    const usize len,
+    [[maybe_unused]] const Lanes lanes,
+    const Matches matches
+  ) -> usize {
+    usize i = 0;
+    #if defined(__AVX2__) || defined(__SSE2__)
+    for (; i + Simd::WIDTH <= len; i += Simd::WIDTH) {
+      if (const u32 found = Simd::mask(lanes(Simd::load(data + i))); found != 0) {
+        return i + static_cast<usize>(std::countr_zero(found));
+      }
+    }
+    #endif
+    for (; i < len; i++) {
+      if (matches(data[i])) return i;
+    }
+    return len;
+  }
+
+  [[nodiscard]] __always_inline auto find_byte(const char *data, const usize len, const char byte) -> usize {
+    #if defined(__AVX2__) || defined(__SSE2__)
+    const auto needle = Simd::splat(byte);
+    return find_if(
+      data,
+      len,
+      [needle](const Simd::Vector bytes) { return Simd::equal(bytes, needle); },
+      [byte](const char c) { return c == byte; }
+    );
+    #else
+    const void *found = std::memchr(data, byte, len);
+    return found == nullptr ? len : static_cast<usize>(static_cast<const char*>(found) - data);
+    #endif
+  }
+
+  /**
+   * @brief Index of the first ASCII whitespace byte, or of the first other byte if 'whitespace' is false
+   */
+  [[nodiscard]] __always_inline auto find_whitespace(
+    const char *data,
+    const usize len,
+    const bool whitespace
+  ) -> usize {
+    #if defined(__AVX2__) || defined(__SSE2__)
+    const auto lanes = [whitespace](const Simd::Vector bytes) {
+      const auto found = Simd::bit_or(Simd::equal(bytes, Simd::splat(' ')), Simd::in_range(bytes, '\t', '\r' - '\t'));
+      // lanes are all ones or all zeros, comparing with zero flips the test
+      return whitespace ? found : Simd::equal(found, Simd::splat(0));
+    };
+    #else
+    const auto lanes = [](auto) { return 0; };
+    #endif
+    return find_if(data, len, lanes, [whitespace](const char c) { return is_whitespace(c) == whitespace; });
+  }
+
+  /**
+   * @brief Index of the first occurrence of 'needle' (of length 'count' >= 2) in 'data', 'len' if there is none.
+   *
+   * Vectors of positions where both the first & last byte of the needle match are compared first, only those
+   * candidates get a memcmp, which skips most of the text without looking at it byte by byte.
+   */
+  [[nodiscard]] inline auto find_substring(
+    const char *data,
+    const usize len,
+    const char *needle,
+    const usize count
+  ) -> usize {
+    if (count > len) return len;
+    usize i = 0;
+
+    #if defined(__AVX2__) || defined(__SSE2__)
+    const auto first = Simd::splat(needle[0]);
+    const auto last = Simd::splat(needle[count - 1]);
+    for (; i + count - 1 + Simd::WIDTH <= len; i += Simd::WIDTH) {
+      u32 candidates = Simd::mask(Simd::bit_and(
+        Simd::equal(Simd::load(data + i), first),
+        Simd::equal(Simd::load(data + i + count - 1), last)
+      ));
+      while (candidates != 0) {
+        const usize at = i + static_cast<usize>(std::countr_zero(candidates));
+        if (std::memcmp(data + at + 1, needle + 1, count - 2) == 0) return at;
+        candidates &= candidates - 1;
+      }
+    }
+    #endif
+
+    for (; i + count <= len; i++) {
+      if (data[i] == needle[0] and std::memcmp(data + i + 1, needle + 1, count - 1) == 0) return i;
+    }
+    return len;
+  }
+
+  /**
+   * @brief Delimiter of crab::split on a single byte
+   */
+  struct ByteDelimiter {
+    char byte;
+
+    [[nodiscard]] __always_inline auto find(const char *data, const usize len) const -> usize {
+      return find_byte(data, len, byte);
+    }
+
+    [[nodiscard]] static constexpr auto length() -> usize { return 1; }
+  };
+
+  /**
+   * @brief Delimiter of crab::split on a whole string
+   */
+  struct StringDelimiter {
+    StringView text;
+
+    [[nodiscard]] __always_inline auto find(const char *data, const usize len) const -> usize {
+      return text.size() == 1 ? find_byte(data, len, text[0]) : find_substring(data, len, text.data(), text.size());
+    }
+
+    [[nodiscard]] auto length() const -> usize { return text.size(); }
+  };
+
+  /**
+   * @brief Delimiter of crab::split_any, up to MAX_VECTOR bytes are compared a vector at a time, larger sets go
+   * through a 256 bit table one byte at a time
+   */
+  class AnyDelimiter {
+    static constexpr usize MAX_VECTOR = 8;
+
+    char bytes[MAX_VECTOR]{};
+    usize count;
+    u64 table[4]{};
+
+  public:
+    explicit AnyDelimiter(const StringView set) : count{set.size()} {
+      for (usize i = 0; i < set.size(); i++) {
+        const auto byte = static_cast<u8>(set[i]);
+        table[byte / 64] |= u64{1} << (byte % 64);
+        if (i < MAX_VECTOR) bytes[i] = set[i];
+      }
+    }
+
+    [[nodiscard]] __always_inline auto contains(const char c) const -> bool {
+      const auto byte = static_cast<u8>(c);
+      return (table[byte / 64] >> (byte % 64) & 1) != 0;
+    }
+
+    [[nodiscard]] __always_inline auto find(const char *data, const usize len) const -> usize {
+      const auto matches = [this](const char c) { return contains(c); };
+      #if defined(__AVX2__) || defined(__SSE2__)
+      if (count <= MAX_VECTOR) {
+        return find_if(
+          data,
+          len,
+          [this](const Simd::Vector lanes) {
+            auto found = Simd::splat(0);
+            for (usize i = 0; i < count; i++) found = Simd::bit_or(found, Simd::equal(lanes, Simd::splat(bytes[i])));
+            return found;
+          },
+          matches
+        );
+      }
+      #endif
+      usize i = 0;
+      while (i < len and not matches(data[i])) i++;
+      return i;
+    }
+
+    [[nodiscard]] static constexpr auto length() -> usize { return 1; }
+  };
+
+  /**
+   * @brief Single pass input iterator over anything with next() -> Option<T> (cheap to copy T), for range-for
+   */
+  template<typename Tokens>
+  class TokenIterator {
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = typename decltype(std::declval<Tokens&>().next())::Contained;
+
+  private:
+    Tokens *tokens;
+    Option<value_type> current;
+
+  public:
+    explicit TokenIterator(Tokens &tokens) : tokens{&tokens}, current{tokens.next()} {}
+
+    [[nodiscard]] auto operator*() const -> value_type { return current.get_unchecked(); }
+
+    auto operator++() -> TokenIterator& {
+      current = tokens->next();
+      return *this;
+    }
+
+    auto operator++(int) -> void { ++*this; }
+
+    [[nodiscard]] friend auto operator==(const TokenIterator &iterator, std::default_sentinel_t) -> bool {
+      return iterator.current.is_none();
+    }
+  };
+}
+
+namespace crab::strings {
+  /**
+   * @brief Pieces of a string between delimiters, see crab::split & crab::split_any
+   */
+  template<typename Delimiter>
+  class Split {
+    const char *cursor;
+    const char *last;
+    Delimiter delimiter;
+    bool finished = false;
+
+  public:
+    Split(const StringView text, Delimiter delimiter)
+      : cursor{text.data()}, last{text.data() + text.size()}, delimiter{delimiter} {}
+
+    /**
+     * @brief The next piece, None once the piece after the last delimiter was produced
+     */
+    [[nodiscard]] auto next() -> Option<StringView> {
+      if (finished) return crab::none;
+
+      const auto remaining = static_cast<usize>(last - cursor);
+      const usize at = delimiter.find(cursor, remaining);
+      const StringView piece{cursor, at};
+      if (at == remaining) {
+        finished = true;
+      } else {
+        cursor += at + delimiter.length();
+      }
+      return crab::some(piece);
+    }
+
+    /**
+     * @brief What next() has not consumed yet, None once finished
+     */
+    [[nodiscard]] auto remainder() const -> Option<StringView> {
+      if (finished) return crab::none;
+      return crab::some(StringView{cursor, static_cast<usize>(last - cursor)});
+    }
+
+    [[nodiscard]] auto begin() -> helper::TokenIterator<Split> { return helper::TokenIterator<Split>{*this}; }
+
+    [[nodiscard]] static constexpr auto end() -> std::default_sentinel_t { return std::default_sentinel; }
+  };
+
+  /**
+   * @brief Runs of non whitespace, see crab::split_whitespace
+   */
+  class SplitWhitespace {
+    const char *cursor;
+    const char *last;
+
+  public:
+    explicit SplitWhitespace(const StringView text) : cursor{text.data()}, last{text.data() + text.size()} {}
+
+    [[nodiscard]] auto next() -> Option<StringView> {
+      cursor += helper::find_whitespace(cursor, static_cast<usize>(last - cursor), false);
+      if (cursor == last) return crab::none;
+
+      const usize length = helper::find_whitespace(cursor, static_cast<usize>(last - cursor), true);
+      const StringView word{cursor, length};
+      cursor += length;
+      return crab::some(word);
+    }
+
+    [[nodiscard]] auto begin() -> helper::TokenIterator<SplitWhitespace> {
+      return helper::TokenIterator<SplitWhitespace>{*this};
+    }
+
+    [[nodiscard]] static constexpr auto end() -> std::default_sentinel_t { return std::default_sentinel; }
+  };
+
+  /**
+   * @brief Lines without their "\n" / "\r\n", see crab::lines
+   */
+  class Lines {
+    const char *cursor;
+    const char *last;
+
+  public:
+    explicit Lines(const StringView text) : cursor{text.data()}, last{text.data() + text.size()} {}
+
+    [[nodiscard]] auto next() -> Option<StringView> {
+      if (cursor == last) return crab::none;
+
+      const auto remaining = static_cast<usize>(last - cursor);
+      const usize length = helper::find_byte(cursor, remaining, '\n');
+      StringView line{cursor, length};
+      cursor += length == remaining ? length : length + 1;
+      if (length != remaining and line.ends_with('\r')) line.remove_suffix(1);
+      return crab::some(line);
+    }
+
+    [[nodiscard]] auto begin() -> helper::TokenIterator<Lines> { return helper::TokenIterator<Lines>{*this}; }
+
+    [[nodiscard]] static constexpr auto end() -> std::default_sentinel_t { return std::default_sentinel; }
+  };
+}
+
+namespace crab {
+  /**
+   * @brief Lazily splits 'text' on every 'delimiter', yielding views into 'text' (which must outlive the
+   * iterator). Like Rust's str::split, adjacent delimiters give empty pieces & "" gives a single empty piece.
+   *
+   * @code
+   * auto fields = crab::split("a,b,,c", ',');
+   * while (auto field = fields.next()) ...
+   *
+   * for (const StringView field: crab::split(row, ", ")) ...
+   * @endcode
+   */
+  [[nodiscard]] inline auto split(
+    const StringView text,
+    const char delimiter
+  ) -> strings::Split<strings::helper::ByteDelimiter> {
+    return {text, strings::helper::ByteDelimiter{delimiter}};
+  }
+
+  [[nodiscard]] inline auto split(
+    const StringView text,
+    const StringView delimiter
+  ) -> strings::Split<strings::helper::StringDelimiter> {
+    debug_assert(not delimiter.empty(), "Cannot split on an empty delimiter");
+    return {text, strings::helper::StringDelimiter{delimiter}};
+  }
+
+  /**
+   * @brief Lazily splits 'text' on any of the bytes in 'delimiters'
+   */
+  [[nodiscard]] inline auto split_any(
+    const StringView text,
+    const StringView delimiters
+  ) -> strings::Split<strings::helper::AnyDelimiter> {
+    return {text, strings::helper::AnyDelimiter{delimiters}};
+  }
+
+  /**
+   * @brief Lazily yields the runs of non ASCII whitespace in 'text', never empty ones
+   */
+  [[nodiscard]] inline auto split_whitespace(const StringView text) -> strings::SplitWhitespace {
+    return strings::SplitWhitespace{text};
+  }
+
+  /**
+   * @brief Lazily yields the lines of 'text' without their "\n" or "\r\n", a final line ending does not start an
+   * empty line
+   */
+  [[nodiscard]] inline auto lines(const StringView text) -> strings::Lines { return strings::Lines{text}; }
+
+  /**
+   * @brief Offset of the first occurrence of 'needle' in 'haystack', an empty needle is found at 0
+   */
+  [[nodiscard]] inline auto find(const StringView haystack, const StringView needle) -> Option<usize> {
+    if (needle.empty()) return crab::some(usize{0});
+    const usize at = strings::helper::StringDelimiter{needle}.find(haystack.data(), haystack.size());
+    if (at == haystack.size()) return crab::none;
+    return crab::some(at);
+  }
+
+  /**
+   * @brief Offset of the first 'needle' byte, this goes to the C library's memchr which is unrolled further than the
+   * inlined search the splitters use & wins on long scans
+   */
+  [[nodiscard]] inline auto find(const StringView haystack, const char needle) -> Option<usize> {
+    const void *found = std::memchr(haystack.data(), needle, haystack.size());
+    if (found == nullptr) return crab::none;
+    return crab::some(static_cast<usize>(static_cast<const char*>(found) - haystack.data()));
+  }
+
+  [[nodiscard]] inline auto contains(const StringView haystack, const StringView needle) -> bool {
+    return find(haystack, needle).is_some();
+  }
+
+  [[nodiscard]] inline auto contains(const StringView haystack, const char needle) -> bool {
+    return find(haystack, needle).is_some();
+  }
+}
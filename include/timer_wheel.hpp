@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "preamble.hpp"
+#include "option.hpp"
+#include "crab/debug.hpp"
+
+namespace crab::timer_wheel {
+  /**
+   * @brief Time in ticks, the caller picks the unit (a millisecond, a scheduler quantum, ...)
+   */
+  using Tick = u64;
+
+  /**
+   * @brief Every level has 2^SLOT_BITS slots, each spanning 2^SLOT_BITS times as many ticks as one of the level
+   * below
+   */
+  inline constexpr usize SLOT_BITS = 6;
+
+  inline constexpr usize SLOTS = usize{1} << SLOT_BITS;
+
+  /**
+   * @brief Enough levels to hold any deadline a Tick can express
+   */
+  inline constexpr usize LEVELS = (std::numeric_limits<Tick>::digits + SLOT_BITS - 1) / SLOT_BITS;
+
+  namespace helper {
+    inline constexpr u32 NONE = std::numeric_limits<u32>::max();
+
+    /**
+     * @brief Node of a circular doubly linked list, the first LEVELS * SLOTS + 1 links are the heads of the
+     * slot lists & of the list being fired, the ones after them belong to timers
+     */
+    struct Link {
+      u32 prev;
+      u32 next;
+    };
+
+    inline constexpr u32 FIRING = LEVELS * SLOTS;
+
+    inline constexpr u32 HEADS = FIRING + 1;
+  }
+}
+
+namespace crab {
+  /**
+   * @brief Timers due at a tick, each holding a T (the callback or whatever identifies what timed out), with O(1)
+   * schedule & cancel through stable handles.
+   *
+   * A hierarchical timing wheel (Varghese & Lauck): level k has 64 slots of 64^k ticks each, a timer sits in the
+   * slot of the level of the highest 6 bit group in which its deadline differs from the current time. Firing a slot
+   * of a higher level moves its timers down into finer slots, which happens at most once per level in a timer's
+   * life, & timers cancelled before that (most timeouts) never move at all. A bitmap of the occupied slots per
+   * level finds the next due slot without walking empty ones, so advancing by a long stretch of time is cheap.
+   *
+   * Timers live in a slot map, values stored inline & the slots of fired & cancelled timers reused, so no timer is
+   * allocated on its own.
+   *
+   * @code
+   * crab::TimerWheel<u32> timeouts;
+   * const auto handle = timeouts.schedule_after(30'000, connection);
+   * timeouts.cancel(handle);  // the request completed in time
+   * timeouts.advance(now_ms, [&](const u32 expired) { close(expired); });
+   * @endcode
+   */
+  template<typename T>
+    requires std::is_move_constructible_v<T> and std::is_move_assignable_v<T>
+  class TimerWheel {
+    using Tick = timer_wheel::Tick;
+    using Link = timer_wheel::helper::Link;
+
+    struct Timer {
+      Tick deadline = 0;
+      u32 generation = 0;
+      // list head of the slot the timer is in
+      u32 slot = 0;
+      Option<T> value;
+    };
+
+    static constexpr u32 NONE = timer_wheel::helper::NONE;
+    static constexpr u32 FIRING = timer_wheel::helper::FIRING;
+    static constexpr u32 HEADS = timer_wheel::helper::HEADS;
+
+    // the list heads & then the links of 'timers', in step
+    Vec<Link> links;
+    Vec<Timer> timers;
+    // one bit per slot with timers in it, for every level
+    std::array<u64, timer_wheel::LEVELS> occupied{};
+    Tick elapsed;
+    u32 free = NONE;
+    usize count = 0;
+
+    struct Expiration {
+      usize level;
+      usize slot;
+      Tick deadline;
+    };
+
+    [[nodiscard]] __always_inline auto timer(const u32 link) -> Timer& { return timers[link - HEADS]; }
+
+    [[nodiscard]] __always_inline auto is_empty_list(const u32 head) const -> bool { return links[head].next == head; }
+
+    __always_inline auto link_back(const u32 head, const u32 link) -> void {
+      const u32 last = links[head].prev;
+      links[link] = Link{last, head};
+      links[last].next = link;
+      links[head].prev = link;
+    }
+
+    __always_inline auto unlink(const u32 link) -> void {
+      const auto [prev, next] = links[link];
+      links[prev].next = next;
+      links[next].prev = prev;
+    }
+
+    /**
+     * @brief Puts a timer in the slot its deadline falls in, seen from the current time
+     */
+    auto place(const u32 link) -> void {
+      Timer &entry = timer(link);
+      // a deadline already passed is due at the current tick
+      const Tick deadline = std::max(entry.deadline, elapsed);
+      const usize level = deadline == elapsed ? 0 : (std::bit_width(deadline ^ elapsed) - 1) / timer_wheel::SLOT_BITS;
+      const usize slot = (deadline >> (level * timer_wheel::SLOT_BITS)) & (timer_wheel::SLOTS - 1);
+      entry.slot = static_cast<u32>(level * timer_wheel::SLOTS + slot);
+      link_back(entry.slot, link);
+      occupied[level] |= u64{1} << slot;
+    }
+
+    /**
+     * @brief Takes a timer out of its slot
+     */
+    auto remove(const u32 link) -> void {
+      unlink(link);
+      // also right for a timer on the firing list, its slot was emptied & so has no bit either way
+      if (const u32 slot = timer(link).slot; is_empty_list(slot)) {
+        occupied[slot / timer_wheel::SLOTS] &= ~(u64{1} << (slot % timer_wheel::SLOTS));
+      }
+    }
+
+    auto release(const u32 link) -> void {
+      Timer &entry = timer(link);
+      entry.value = crab::none;
+      entry.generation++;
+      links[link].next = free;
+      free = link;
+      count--;
+    }
+
+    /**
+     * @brief The first slot with timers in it & the tick it starts at. Every timer in a level is due after every
+     * one in the levels below it, & after the current time, so that is the lowest occupied slot of the lowest
+     * level with any.
+     */
+    [[nodiscard]] auto next_expiration() const -> Option<Expiration> {
+      for (usize level = 0; level < timer_wheel::LEVELS; level++) {
+        if (occupied[level] == 0) continue;
+        const usize shift = level * timer_wheel::SLOT_BITS;
+        const usize slot = static_cast<usize>(std::countr_zero(occupied[level]));
+        debug_assert(slot >= ((elapsed >> shift) & (timer_wheel::SLOTS - 1)), "Timer wheel slot behind the time");
+        // the ticks above this level are the current ones
+        const usize above = shift + timer_wheel::SLOT_BITS;
+        const Tick start = above < std::numeric_limits<Tick>::digits ? elapsed >> above << above : 0;
+        return crab::some(Expiration{level, slot, start | static_cast<Tick>(slot) << shift});
+      }
+      return crab::none;
+    }
+
+  public:
+    /**
+     * @brief Stable reference to a scheduled timer, safe to use after the timer fired or was cancelled (it then
+     * refers to nothing), even once its slot holds another timer
+     */
+    class Handle {
+      friend class TimerWheel;
+
+      u32 link;
+      u32 generation;
+
+      Handle(const u32 link, const u32 generation) : link{link}, generation{generation} {}
+
+    public:
+      [[nodiscard]] friend auto operator==(const Handle &, const Handle &) -> bool = default;
+    };
+
+    /**
+     * @brief An empty wheel whose current time is 'now'
+     */
+    explicit TimerWheel(const Tick now = 0) : links(HEADS), elapsed{now} {
+      for (u32 head = 0; head < HEADS; head++) links[head] = Link{head, head};
+    }
+
+    /**
+     * @brief The current time, the 'now' of the last advance
+     */
+    [[nodiscard]] auto now() const -> Tick { return elapsed; }
+
+    /**
+     * @brief Number of timers scheduled & not yet fired nor cancelled
+     */
+    [[nodiscard]] auto size() const -> usize { return count; }
+
+    [[nodiscard]] auto is_empty() const -> bool { return count == 0; }
+
+    /**
+     * @brief Schedules 'value' to fire at 'deadline', a deadline not after now() fires on the next advance
+     */
+    auto schedule(const Tick deadline, T value) -> Handle {
+      u32 link;
+      if (free != NONE) {
+        link = free;
+        free = links[link].next;
+      } else {
+        debug_assert(links.size() < NONE, "TimerWheel holds up to 2^32 - 1 timers");
+        link = static_cast<u32>(links.size());
+        links.emplace_back();
+        timers.emplace_back();
+      }
+      Timer &entry = timer(link);
+      entry.deadline = deadline;
+      entry.value = crab::some(std::move(value));
+      place(link);
+      count++;
+      return Handle{link, entry.generation};
+    }
+
+    /**
+     * @brief Schedules 'value' to fire 'delay' ticks from now()
+     */
+    auto schedule_after(const Tick delay, T value) -> Handle { return schedule(elapsed + delay, std::move(value)); }
+
+    /**
+     * @brief Whether the timer of 'handle' has neither fired nor been cancelled
+     */
+    [[nodiscard]] auto is_pending(const Handle handle) const -> bool {
+      return handle.link - HEADS < timers.size() and timers[handle.link - HEADS].generation == handle.generation;
+    }
+
+    /**
+     * @brief The deadline of the timer of 'handle', if it is pending
+     */
+    [[nodiscard]] auto deadline(const Handle handle) const -> Option<Tick> {
+      if (not is_pending(handle)) return crab::none;
+      return crab::some(timers[handle.link - HEADS].deadline);
+    }
+
+    /**
+     * @brief Stops the timer of 'handle' from firing & gives back its value, none if it already fired or was
+     * cancelled
+     */
+    auto cancel(const Handle handle) -> Option<T> {
+      if (not is_pending(handle)) return crab::none;
+      remove(handle.link);
+      Option<T> value = crab::some(timer(handle.link).value.take_unchecked());
+      release(handle.link);
+      return value;
+    }
+
+    /**
+     * @brief Removes every timer without firing them, handles to them stop matching
+     */
+    auto clear() -> void {
+      for (u32 head = 0; head < HEADS; head++) {
+        for (u32 link = links[head].next; link != head;) {
+          const u32 next = links[link].next;
+          release(link);
+          link = next;
+        }
+        links[head] = Link{head, head};
+      }
+      occupied = {};
+    }
+
+    /**
+     * @brief A tick at or before the earliest deadline, exact if that is in the same block of 64 ticks as now().
+     * Sleeping until then & advancing is how an event loop waits for as long as it can.
+     */
+    [[nodiscard]] auto next_deadline() const -> Option<Tick> {
+      auto next = next_expiration();
+      if (next.is_none()) return crab::none;
+      return crab::some(next.get_unchecked().deadline);
+    }
+
+    /**
+     * @brief Moves the current time to 'now' (not before now()), calling 'on_expired(T&&)' for every timer due by
+     * then in order of deadline, & tells how many fired. 'on_expired' may schedule & cancel timers, ones due by
+     * 'now' fire in this same call.
+     */
+    template<typename F>
+      requires std::invocable<F&, T&&>
+    auto advance(const Tick now, F &&on_expired) -> usize {
+      debug_assert(now >= elapsed, "TimerWheel cannot go back in time");
+      usize fired = 0;
+      while (true) {
+        const auto next = next_expiration();
+        if (next.is_none() or next.get_unchecked().deadline > now) break;
+        const auto [level, slot, deadline] = next.get_unchecked();
+        elapsed = deadline;
+
+        // move the slot's list over to the firing list, which callbacks can cancel timers from too
+        const u32 head = static_cast<u32>(level * timer_wheel::SLOTS + slot);
+        links[links[head].next].prev = FIRING;
+        links[links[head].prev].next = FIRING;
+        links[FIRING] = links[head];
+        links[head] = Link{head, head};
+        occupied[level] &= ~(u64{1} << slot);
+
+        while (not is_empty_list(FIRING)) {
+          const u32 link = links[FIRING].next;
+          unlink(link);
+          Timer &entry = timer(link);
+          if (entry.deadline > elapsed) {
+            // due later within this slot's span, into a finer slot
+            place(link);
+            continue;
+          }
+          T value = entry.value.take_unchecked();
+          release(link);
+          std::invoke(on_expired, std::move(value));
+          fired++;
+        }
+      }
+      elapsed = now;
+      return fired;
+    }
+
+    /**
+     * @brief advance() for callable values, calling every timer due by 'now'
+     */
+    auto advance(const Tick now) -> usize requires std::invocable<T&> {
+      return advance(now, [](T &&callback) { std::invoke(callback); });
+    }
+  };
+}
@@ -0,0 +1,688 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <type_traits>
+
+#include "preamble.hpp"
+#include "result.hpp"
+#include "crab/debug.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace crab::utf {
+  /**
+   * @brief Input that is not valid in the encoding of 'Unit', offset() is the index of the first code unit of the
+   * invalid sequence, everything before it is valid.
+   */
+  template<typename Unit>
+  class DecodeError final : public Error {
+    usize position;
+
+  public:
+    explicit DecodeError(const usize position) : position{position} {}
+
+    [[nodiscard]] auto offset() const -> usize { return position; }
+
+    [[nodiscard]] auto what() const -> String override {
+      if constexpr (sizeof(Unit) == 1) return std::format("invalid UTF-8 at byte {}", position);
+      else if constexpr (sizeof(Unit) == 2) return std::format("invalid UTF-16 at code unit {}", position);
+      else return std::format("invalid UTF-32 at code unit {}", position);
+    }
+  };
+
+  using Utf8Error = DecodeError<char8>;
+  using Utf16Error = DecodeError<char16>;
+  using Utf32Error = DecodeError<char32>;
+
+  // WideString is UTF-16 on Windows & UTF-32 everywhere else
+  using WideError = std::conditional_t<sizeof(widechar) == 2, Utf16Error, Utf32Error>;
+}
+
+namespace crab::utf::helper {
+  // decode() result for an invalid sequence
+  inline constexpr u32 INVALID = ~u32{0};
+
+  [[nodiscard]] __always_inline constexpr auto is_continuation(const u8 byte) -> bool { return (byte & 0xc0) == 0x80; }
+
+  /**
+   * @brief Value of a code unit, wchar_t is signed on some platforms
+   */
+  template<typename Unit>
+  [[nodiscard]] __always_inline constexpr auto value_of(const Unit unit) -> u32 {
+    return static_cast<u32>(static_cast<std::make_unsigned_t<Unit>>(unit));
+  }
+
+  /**
+   * @brief Decodes the sequence at 'i' & moves 'i' past it, INVALID (leaving 'i' as is) if it is not valid UTF-8:
+   * overlong, surrogate, above U+10FFFF, truncated or a stray continuation byte
+   */
+  [[nodiscard]] __always_inline auto decode(const u8 *data, const usize len, usize &i) -> u32 {
+    const u8 lead = data[i];
+    const usize remaining = len - i;
+    if (lead < 0x80) {
+      i++;
+      return lead;
+    }
+
+    // continuation bytes & the overlong 0xc0 / 0xc1
+    if (lead < 0xc2) return INVALID;
+
+    if (lead < 0xe0) {
+      if (remaining < 2 or not is_continuation(data[i + 1])) return INVALID;
+      const u32 point = u32{lead & 0x1fu} << 6 | (data[i + 1] & 0x3fu);
+      i += 2;
+      return point;
+    }
+
+    if (lead < 0xf0) {
+      if (remaining < 3) return INVALID;
+      // 0xe0 would be overlong below 0xa0, 0xed a surrogate above 0x9f
+      const u8 second = data[i + 1];
+      const u8 low = lead == 0xe0 ? 0xa0 : 0x80;
+      const u8 high = lead == 0xed ? 0x9f : 0xbf;
+      if (second < low or second > high or not is_continuation(data[i + 2])) return INVALID;
+      const u32 point = u32{lead & 0x0fu} << 12 | u32{second & 0x3fu} << 6 | (data[i + 2] & 0x3fu);
+      i += 3;
+      return point;
+    }
+
+    if (lead < 0xf5) {
+      if (remaining < 4) return INVALID;
+      // 0xf0 would be overlong below 0x90, 0xf4 above U+10FFFF past 0x8f
+      const u8 second = data[i + 1];
+      const u8 low = lead == 0xf0 ? 0x90 : 0x80;
+      const u8 high = lead == 0xf4 ? 0x8f : 0xbf;
+      if (second < low or second > high or not is_continuation(data[i + 2]) or not is_continuation(data[i + 3])) {
+        return INVALID;
+      }
+      const u32 point = u32{lead & 0x07u} << 18 | u32{second & 0x3fu} << 12 | u32{data[i + 2] & 0x3fu} << 6
+        | (data[i + 3] & 0x3fu);
+      i += 4;
+      return point;
+    }
+
+    return INVALID;
+  }
+
+  /**
+   * @brief Offset of the first invalid sequence at or after 'from' (which must start a sequence), 'len' if there is
+   * none. ASCII is skipped a word at a time.
+   */
+  [[nodiscard]] inline auto scalar_valid_up_to(const u8 *data, const usize len, usize from = 0) -> usize {
+    while (from < len) {
+      if (len - from >= sizeof(u64)) {
+        u64 word;
+        std::memcpy(&word, data + from, sizeof(word));
+        if ((word & 0x8080'8080'8080'8080) == 0) {
+          from += sizeof(word);
+          continue;
+        }
+      }
+      if (const usize start = from; decode(data, len, from) == INVALID) return start;
+    }
+    return len;
+  }
+
+  /**
+   * @brief 16 or 32 byte vector operations the lookup validator is written against
+   */
+  #if defined(__AVX2__)
+  struct Avx2 {
+    using Vector = __m256i;
+    static constexpr usize WIDTH = 32;
+
+    [[nodiscard]] __always_inline static auto load(const u8 *from) -> Vector {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from));
+    }
+
+    [[nodiscard]] __always_inline static auto splat(const u8 value) -> Vector {
+      return _mm256_set1_epi8(static_cast<char>(value));
+    }
+
+    [[nodiscard]] __always_inline static auto table(const __m128i entries) -> Vector {
+      return _mm256_broadcastsi128_si256(entries);
+    }
+
+    [[nodiscard]] __always_inline static auto lookup(const Vector table, const Vector nibbles) -> Vector {
+      return _mm256_shuffle_epi8(table, nibbles);
+    }
+
+    [[nodiscard]] __always_inline static auto high_nibbles(const Vector v) -> Vector {
+      return _mm256_and_si256(_mm256_srli_epi16(v, 4), splat(0x0f));
+    }
+
+    [[nodiscard]] __always_inline static auto low_nibbles(const Vector v) -> Vector {
+      return _mm256_and_si256(v, splat(0x0f));
+    }
+
+    /**
+     * @brief 'input' shifted by N bytes towards the end, with the last N bytes of 'previous' moving in
+     */
+    template<i32 N>
+    [[nodiscard]] __always_inline static auto previous(const Vector input, const Vector previous) -> Vector {
+      return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+    }
+
+    [[nodiscard]] __always_inline static auto saturating_sub(const Vector a, const Vector b) -> Vector {
+      return _mm256_subs_epu8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_and(const Vector a, const Vector b) -> Vector {
+      return _mm256_and_si256(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_or(const Vector a, const Vector b) -> Vector {
+      return _mm256_or_si256(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_xor(const Vector a, const Vector b) -> Vector {
+      return _mm256_xor_si256(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto is_ascii(const Vector v) -> bool { return _mm256_movemask_epi8(v) == 0; }
+
+    [[nodiscard]] __always_inline static auto is_zero(const Vector v) -> bool { return _mm256_testz_si256(v, v); }
+
+    /**
+     * @brief Largest byte allowed in each position of the last vector of the input, a lead byte in the last three
+     * bytes needs more bytes after it
+     */
+    [[nodiscard]] __always_inline static auto max_last_bytes() -> Vector {
+      return _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1)
+      );
+    }
+  };
+  #endif
+
+  #if defined(__SSSE3__)
+  struct Sse {
+    using Vector = __m128i;
+    static constexpr usize WIDTH = 16;
+
+    [[nodiscard]] __always_inline static auto load(const u8 *from) -> Vector {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(from));
+    }
+
+    [[nodiscard]] __always_inline static auto splat(const u8 value) -> Vector {
+      return _mm_set1_epi8(static_cast<char>(value));
+    }
+
+    [[nodiscard]] __always_inline static auto table(const __m128i entries) -> Vector { return entries; }
+
+    [[nodiscard]] __always_inline static auto lookup(const Vector table, const Vector nibbles) -> Vector {
+      return _mm_shuffle_epi8(table, nibbles);
+    }
+
+    [[nodiscard]] __always_inline static auto high_nibbles(const Vector v) -> Vector {
+      return _mm_and_si128(_mm_srli_epi16(v, 4), splat(0x0f));
+    }
+
+    [[nodiscard]] __always_inline static auto low_nibbles(const Vector v) -> Vector {
+      return _mm_and_si128(v, splat(0x0f));
+    }
+
+    template<i32 N>
+    [[nodiscard]] __always_inline static auto previous(const Vector input, const Vector previous) -> Vector {
+      return _mm_alignr_epi8(input, previous, 16 - N);
+    }
+
+    [[nodiscard]] __always_inline static auto saturating_sub(const Vector a, const Vector b) -> Vector {
+      return _mm_subs_epu8(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_and(const Vector a, const Vector b) -> Vector {
+      return _mm_and_si128(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_or(const Vector a, const Vector b) -> Vector {
+      return _mm_or_si128(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto bit_xor(const Vector a, const Vector b) -> Vector {
+      return _mm_xor_si128(a, b);
+    }
+
+    [[nodiscard]] __always_inline static auto is_ascii(const Vector v) -> bool { return _mm_movemask_epi8(v) == 0; }
+
+    [[nodiscard]] __always_inline static auto is_zero(const Vector v) -> bool {
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xffff;
+    }
+
+    [[nodiscard]] __always_inline static auto max_last_bytes() -> Vector {
+      return _mm_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1)
+      );
+    }
+  };
+  #endif
+
+  #if defined(__SSSE3__)
+  // error classes of a pair of bytes, the pair is invalid if all three lookups agree on one of them
+  inline constexpr u8 TOO_SHORT = 1 << 0; // lead byte followed by ASCII or another lead
+  inline constexpr u8 TOO_LONG = 1 << 1; // ASCII followed by a continuation
+  inline constexpr u8 OVERLONG_3 = 1 << 2; // 0xe0 followed by 0x80..0x9f
+  inline constexpr u8 TOO_LARGE = 1 << 3; // 0xf4 followed by 0x90.. or 0xf5..
+  inline constexpr u8 SURROGATE = 1 << 4; // 0xed followed by 0xa0..
+  inline constexpr u8 OVERLONG_2 = 1 << 5; // 0xc0 / 0xc1
+  inline constexpr u8 TOO_LARGE_1000 = 1 << 6; // 0xf5.. followed by 0x80..0x8f
+  inline constexpr u8 OVERLONG_4 = 1 << 6; // 0xf0 followed by 0x80..0x8f
+  inline constexpr u8 TWO_CONTINUATIONS = 1 << 7; // valid only as the 3rd / 4th byte of a sequence
+  // classes decided by the first byte's high nibble alone
+  inline constexpr u8 CARRY = TOO_SHORT | TOO_LONG | TWO_CONTINUATIONS;
+
+  /**
+   * @brief Error classes of every pair of adjacent bytes (Keiser & Lemire), through three 16 entry table lookups
+   * keyed by nibbles
+   */
+  template<typename Simd>
+  [[nodiscard]] __always_inline auto special_cases(
+    const typename Simd::Vector input,
+    const typename Simd::Vector previous_1
+  ) -> typename Simd::Vector {
+    const auto byte_1_high = Simd::table(_mm_setr_epi8(
+      // ASCII
+      TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+      // continuation
+      TWO_CONTINUATIONS, TWO_CONTINUATIONS, TWO_CONTINUATIONS, TWO_CONTINUATIONS,
+      // 0xc_, 0xd_, 0xe_, 0xf_ leads
+      TOO_SHORT | OVERLONG_2,
+      TOO_SHORT,
+      TOO_SHORT | OVERLONG_3 | SURROGATE,
+      static_cast<char>(TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4)
+    ));
+    const auto byte_1_low = Simd::table(_mm_setr_epi8(
+      static_cast<char>(CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4),
+      static_cast<char>(CARRY | OVERLONG_2),
+      static_cast<char>(CARRY),
+      static_cast<char>(CARRY),
+      static_cast<char>(CARRY | TOO_LARGE),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000),
+      static_cast<char>(CARRY | TOO_LARGE | TOO_LARGE_1000)
+    ));
+    const auto byte_2_high = Simd::table(_mm_setr_epi8(
+      // ASCII
+      TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+      // 0x8_, 0x9_, 0xa_, 0xb_ continuations
+      static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4),
+      static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | OVERLONG_3 | TOO_LARGE),
+      static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | SURROGATE | TOO_LARGE),
+      static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | SURROGATE | TOO_LARGE),
+      // leads
+      TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+    ));
+
+    return Simd::bit_and(
+      Simd::bit_and(
+        Simd::lookup(byte_1_high, Simd::high_nibbles(previous_1)),
+        Simd::lookup(byte_1_low, Simd::low_nibbles(previous_1))
+      ),
+      Simd::lookup(byte_2_high, Simd::high_nibbles(input))
+    );
+  }
+
+  /**
+   * @brief Non zero where 'input' (following 'previous') is not valid UTF-8
+   */
+  template<typename Simd>
+  [[nodiscard]] __always_inline auto check_vector(
+    const typename Simd::Vector input,
+    const typename Simd::Vector previous
+  ) -> typename Simd::Vector {
+    const auto cases = special_cases<Simd>(input, Simd::template previous<1>(input, previous));
+    // two continuations in a row are expected exactly as the 3rd & 4th byte after a 3 / 4 byte lead
+    const auto third = Simd::saturating_sub(Simd::template previous<2>(input, previous), Simd::splat(0xe0 - 0x80));
+    const auto fourth = Simd::saturating_sub(Simd::template previous<3>(input, previous), Simd::splat(0xf0 - 0x80));
+    const auto expected_continuations = Simd::bit_and(Simd::bit_or(third, fourth), Simd::splat(0x80));
+    return Simd::bit_xor(expected_continuations, cases);
+  }
+
+  /**
+   * @brief Offset of the first error of a vector the SIMD check rejected. Everything before it was valid, so the
+   * sequence at fault starts at most 3 bytes earlier, at the first lead byte from there on.
+   */
+  [[nodiscard]] inline auto locate_error(const u8 *data, const usize len, const usize vector_start) -> usize {
+    usize start = vector_start < 3 ? 0 : vector_start - 3;
+    while (start < vector_start and is_continuation(data[start])) start++;
+    return scalar_valid_up_to(data, len, start);
+  }
+
+  template<typename Simd>
+  [[nodiscard]] auto simd_valid_up_to(const u8 *data, const usize len) -> usize {
+    using Vector = typename Simd::Vector;
+    constexpr usize WIDTH = Simd::WIDTH;
+
+    Vector previous = Simd::splat(0);
+    // lead bytes at the end of the previous vector that are still waiting for continuations
+    Vector incomplete = Simd::splat(0);
+    usize i = 0;
+
+    for (; i + WIDTH <= len; i += WIDTH) {
+      const Vector input = Simd::load(data + i);
+      if (Simd::is_ascii(input)) {
+        if (not Simd::is_zero(incomplete)) return locate_error(data, len, i);
+      } else {
+        if (not Simd::is_zero(check_vector<Simd>(input, previous))) return locate_error(data, len, i);
+        incomplete = Simd::saturating_sub(input, Simd::max_last_bytes());
+      }
+      previous = input;
+    }
+
+    if (i == len) return Simd::is_zero(incomplete) ? len : locate_error(data, len, i);
+
+    // the tail padded with ASCII zeros, a truncated sequence at the end shows up as TOO_SHORT
+    alignas(WIDTH) u8 tail[WIDTH]{};
+    std::memcpy(tail, data + i, len - i);
+    if (not Simd::is_zero(check_vector<Simd>(Simd::load(tail), previous))) return locate_error(data, len, i);
+    return len;
+  }
+  #endif
+
+  [[nodiscard]] inline auto valid_up_to(const u8 *data, const usize len) -> usize {
+    #if defined(__AVX2__)
+    return simd_valid_up_to<Avx2>(data, len);
+    #elif defined(__SSSE3__)
+    return simd_valid_up_to<Sse>(data, len);
+    #else
+    return scalar_valid_up_to(data, len);
+    #endif
+  }
+
+  #if defined(__AVX2__)
+  inline constexpr usize ASCII_BLOCK = 32;
+  #elif defined(__SSE2__)
+  inline constexpr usize ASCII_BLOCK = 16;
+  #else
+  inline constexpr usize ASCII_BLOCK = 8;
+  #endif
+
+  /**
+   * @brief Widens ASCII_BLOCK bytes to 16 / 32 bit code units, false (writing nothing) unless all are ASCII
+   */
+  template<typename Unit>
+  [[nodiscard]] __always_inline auto widen_ascii(const u8 *from, Unit *to) -> bool {
+    #if defined(__AVX2__)
+    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from));
+    if (_mm256_movemask_epi8(bytes) != 0) return false;
+    auto *out = reinterpret_cast<__m256i*>(to);
+    if constexpr (sizeof(Unit) == 2) {
+      _mm256_storeu_si256(out, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+      _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+    } else {
+      for (usize i = 0; i < 4; i++) {
+        const __m128i eight = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(from + i * 8));
+        _mm256_storeu_si256(out + i, _mm256_cvtepu8_epi32(eight));
+      }
+    }
+    return true;
+    #elif defined(__SSE2__)
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from));
+    if (_mm_movemask_epi8(bytes) != 0) return false;
+    auto *out = reinterpret_cast<__m128i*>(to);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+    const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+    if constexpr (sizeof(Unit) == 2) {
+      _mm_storeu_si128(out, low);
+      _mm_storeu_si128(out + 1, high);
+    } else {
+      _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+      _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+      _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+      _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+    }
+    return true;
+    #else
+    u64 word;
+    std::memcpy(&word, from, sizeof(word));
+    if ((word & 0x8080'8080'8080'8080) != 0) return false;
+    for (usize i = 0; i < ASCII_BLOCK; i++) to[i] = from[i];
+    return true;
+    #endif
+  }
+
+  // code units narrowed at once
+  inline constexpr usize NARROW_BLOCK = 16;
+
+  /**
+   * @brief Narrows NARROW_BLOCK code units to bytes, false (writing nothing) unless all are ASCII
+   */
+  template<typename Unit>
+  [[nodiscard]] __always_inline auto narrow_ascii(const Unit *from, char *to) -> bool {
+    #if defined(__SSE2__)
+    const auto *in = reinterpret_cast<const __m128i*>(from);
+    __m128i low, high;
+    if constexpr (sizeof(Unit) == 2) {
+      low = _mm_loadu_si128(in);
+      high = _mm_loadu_si128(in + 1);
+    } else {
+      low = _mm_packs_epi32(_mm_loadu_si128(in), _mm_loadu_si128(in + 1));
+      high = _mm_packs_epi32(_mm_loadu_si128(in + 2), _mm_loadu_si128(in + 3));
+      // packs saturates, a unit above 0x7fff must not turn into an ASCII lookalike
+      const __m128i wide = _mm_or_si128(
+        _mm_or_si128(_mm_loadu_si128(in), _mm_loadu_si128(in + 1)),
+        _mm_or_si128(_mm_loadu_si128(in + 2), _mm_loadu_si128(in + 3))
+      );
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(wide, 7), _mm_setzero_si128())) != 0xffff) return false;
+    }
+    const __m128i above_ascii = _mm_srli_epi16(_mm_or_si128(low, high), 7);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(above_ascii, _mm_setzero_si128())) != 0xffff) return false;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(to), _mm_packus_epi16(low, high));
+    return true;
+    #else
+    for (usize i = 0; i < NARROW_BLOCK; i++) {
+      if (value_of(from[i]) >= 0x80) return false;
+    }
+    for (usize i = 0; i < NARROW_BLOCK; i++) to[i] = static_cast<char>(from[i]);
+    return true;
+    #endif
+  }
+
+  template<typename Unit>
+  [[nodiscard]] auto utf8_to_units(const u8 *data, const usize len, Unit *out) -> Result<usize, Utf8Error> {
+    Unit *cursor = out;
+    usize i = 0;
+    while (i < len) {
+      if (data[i] < 0x80) {
+        for (; len - i >= ASCII_BLOCK and widen_ascii(data + i, cursor); i += ASCII_BLOCK) cursor += ASCII_BLOCK;
+        for (; i < len and data[i] < 0x80; i++) *cursor++ = static_cast<Unit>(data[i]);
+        continue;
+      }
+
+      const usize start = i;
+      const u32 point = decode(data, len, i);
+      if (point == INVALID) return Utf8Error{start};
+
+      if (sizeof(Unit) == 2 and point >= 0x10000) {
+        *cursor++ = static_cast<Unit>(0xd800 + ((point - 0x10000) >> 10));
+        *cursor++ = static_cast<Unit>(0xdc00 + (point & 0x3ff));
+      } else {
+        *cursor++ = static_cast<Unit>(point);
+      }
+    }
+    return static_cast<usize>(cursor - out);
+  }
+
+  __always_inline auto encode(const u32 point, char *&cursor) -> void {
+    if (point < 0x80) {
+      *cursor++ = static_cast<char>(point);
+    } else if (point < 0x800) {
+      *cursor++ = static_cast<char>(0xc0 | point >> 6);
+      *cursor++ = static_cast<char>(0x80 | (point & 0x3f));
+    } else if (point < 0x10000) {
+      *cursor++ = static_cast<char>(0xe0 | point >> 12);
+      *cursor++ = static_cast<char>(0x80 | (point >> 6 & 0x3f));
+      *cursor++ = static_cast<char>(0x80 | (point & 0x3f));
+    } else {
+      *cursor++ = static_cast<char>(0xf0 | point >> 18);
+      *cursor++ = static_cast<char>(0x80 | (point >> 12 & 0x3f));
+      *cursor++ = static_cast<char>(0x80 | (point >> 6 & 0x3f));
+      *cursor++ = static_cast<char>(0x80 | (point & 0x3f));
+    }
+  }
+
+  /**
+   * @brief UTF-16 (2 byte units) or UTF-32 (4 byte units) to UTF-8
+   */
+  template<typename Unit>
+  [[nodiscard]] auto units_to_utf8(const Unit *data, const usize len, char *out) -> Result<usize, DecodeError<Unit>> {
+    char *cursor = out;
+    usize i = 0;
+    while (i < len) {
+      if (value_of(data[i]) < 0x80) {
+        for (; len - i >= NARROW_BLOCK and narrow_ascii(data + i, cursor); i += NARROW_BLOCK) cursor += NARROW_BLOCK;
+        for (; i < len and value_of(data[i]) < 0x80; i++) *cursor++ = static_cast<char>(data[i]);
+        continue;
+      }
+
+      u32 point = value_of(data[i]);
+      if ((point & 0xfffff800) == 0xd800) {
+        // in UTF-16 only a high surrogate followed by a low one is valid, UTF-32 has no surrogates
+        if (sizeof(Unit) != 2 or point > 0xdbff or i + 1 == len or (value_of(data[i + 1]) & 0xfc00) != 0xdc00) {
+          return DecodeError<Unit>{i};
+        }
+        point = 0x10000 + ((point - 0xd800) << 10) + (value_of(data[i + 1]) - 0xdc00);
+        i++;
+      } else if (point > 0x10ffff) {
+        return DecodeError<Unit>{i};
+      }
+      encode(point, cursor);
+      i++;
+    }
+    return static_cast<usize>(cursor - out);
+  }
+
+  [[nodiscard]] __always_inline auto bytes(const StringView text) -> const u8* {
+    return reinterpret_cast<const u8*>(text.data());
+  }
+}
+
+namespace crab::utf {
+  /**
+   * @brief Checks that 'text' is valid UTF-8 (no overlongs, surrogates or code points past U+10FFFF), 32 or 16
+   * bytes at a time with AVX2 / SSSE3 (Keiser & Lemire's lookup algorithm), a word at a time otherwise.
+   */
+  [[nodiscard]] inline auto validate(const StringView text) -> Result<unit, Utf8Error> {
+    const usize valid = helper::valid_up_to(helper::bytes(text), text.size());
+    if (valid != text.size()) return Utf8Error{valid};
+    return unit{};
+  }
+
+  [[nodiscard]] inline auto is_valid(const StringView text) -> bool {
+    return helper::valid_up_to(helper::bytes(text), text.size()) == text.size();
+  }
+
+  /**
+   * @brief UTF-16 code units needed for valid UTF-8 'text' (an upper bound if it is invalid)
+   */
+  [[nodiscard]] inline auto utf16_length(const StringView text) -> usize {
+    usize units = 0;
+    // every non continuation byte starts a code point, 4 byte sequences need a surrogate pair
+    for (const char c: text) units += (static_cast<i8>(c) > -65) + (static_cast<u8>(c) >= 0xf0);
+    return units;
+  }
+
+  /**
+   * @brief Code points in valid UTF-8 'text' (an upper bound if it is invalid)
+   */
+  [[nodiscard]] inline auto utf32_length(const StringView text) -> usize {
+    usize points = 0;
+    for (const char c: text) points += static_cast<i8>(c) > -65;
+    return points;
+  }
+
+  /**
+   * @brief UTF-8 bytes needed for UTF-16 'text'
+   */
+  [[nodiscard]] inline auto utf8_length(const Span<const char16> text) -> usize {
+    usize bytes = 0;
+    // a surrogate pair is 4 bytes, 2 per surrogate
+    for (const char16 unit: text) bytes += 1 + (unit >= 0x80) + (unit >= 0x800) - ((unit & 0xf800) == 0xd800);
+    return bytes;
+  }
+
+  /**
+   * @brief UTF-8 bytes needed for UTF-32 'text'
+   */
+  [[nodiscard]] inline auto utf8_length(const Span<const char32> text) -> usize {
+    usize bytes = 0;
+    for (const char32 point: text) bytes += 1 + (point >= 0x80) + (point >= 0x800) + (point >= 0x10000);
+    return bytes;
+  }
+
+  /**
+   * @brief Transcodes UTF-8 into 'out', which needs room for utf16_length(text) units (text.size() always
+   * suffices). Returns the units written, or where the input stopped being valid UTF-8.
+   */
+  [[nodiscard]] inline auto utf8_to_utf16(const StringView text, const Span<char16> out) -> Result<usize, Utf8Error> {
+    // utf16_length counts invalid leads like 0xff as surrogate pairs, so either bound is enough on its own
+    debug_assert(out.size() >= std::min(utf16_length(text), text.size()), "Output is too small");
+    return helper::utf8_to_units(helper::bytes(text), text.size(), out.data());
+  }
+
+  /**
+   * @brief Transcodes UTF-8 into 'out', which needs room for utf32_length(text) code points
+   */
+  [[nodiscard]] inline auto utf8_to_utf32(const StringView text, const Span<char32> out) -> Result<usize, Utf8Error> {
+    debug_assert(out.size() >= utf32_length(text), "Output is too small");
+    return helper::utf8_to_units(helper::bytes(text), text.size(), out.data());
+  }
+
+  /**
+   * @brief Transcodes UTF-16 into 'out', which needs room for utf8_length(text) bytes (3 per unit always
+   * suffices). Unpaired surrogates are an error.
+   */
+  [[nodiscard]] inline auto utf16_to_utf8(const Span<const char16> text, const Span<char> out)
+    -> Result<usize, Utf16Error> {
+    debug_assert(out.size() >= utf8_length(text), "Output is too small");
+    return helper::units_to_utf8(text.data(), text.size(), out.data());
+  }
+
+  /**
+   * @brief Transcodes UTF-32 into 'out', which needs room for utf8_length(text) bytes (4 per code point always
+   * suffices). Surrogates & values past U+10FFFF are an error.
+   */
+  [[nodiscard]] inline auto utf32_to_utf8(const Span<const char32> text, const Span<char> out)
+    -> Result<usize, Utf32Error> {
+    debug_assert(out.size() >= utf8_length(text), "Output is too small");
+    return helper::units_to_utf8(text.data(), text.size(), out.data());
+  }
+
+  /**
+   * @brief UTF-8 to a WideString (UTF-32, or UTF-16 where wchar_t is 2 bytes), in place of std::wstring_convert
+   */
+  [[nodiscard]] inline auto to_wide(const StringView text) -> Result<WideString, Utf8Error> {
+    WideString wide(sizeof(widechar) == 2 ? utf16_length(text) : utf32_length(text), L'\0');
+    auto written = helper::utf8_to_units(helper::bytes(text), text.size(), wide.data());
+    if (written.is_err()) return written.take_err_unchecked();
+    wide.resize(written.take_unchecked());
+    return wide;
+  }
+
+  /**
+   * @brief WideString (UTF-32, or UTF-16 where wchar_t is 2 bytes) to UTF-8
+   */
+  [[nodiscard]] inline auto from_wide(const WideStringView wide) -> Result<String, WideError> {
+    String text(wide.size() * (sizeof(widechar) == 2 ? 3 : 4), '\0');
+    auto written = helper::units_to_utf8(wide.data(), wide.size(), text.data());
+    if (written.is_err()) return WideError{written.get_err_unchecked().offset()};
+    text.resize(written.take_unchecked());
+    return text;
+  }
+}
@@ -0,0 +1,132 @@
+#include "../include/crab/epoch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace crab::epoch {
+  namespace {
+    /**
+     * @brief Amount of retirements between attempts to advance the epoch & free the limbo list
+     */
+    constexpr usize COLLECT_INTERVAL = 64;
+
+    struct Retired {
+      void *object;
+      Dropper drop;
+      u64 epoch;
+    };
+
+    struct Participant {
+      // (epoch << 1) | 1 while pinned, 0 while not
+      std::atomic<u64> state{0};
+      usize pins = 0;
+      usize since_collect = 0;
+      Vec<Retired> limbo;
+    };
+
+    std::atomic<u64> global_epoch{1};
+
+    std::mutex registry_lock;
+    Vec<Participant*> registry;
+    Vec<Retired> orphans;
+
+    /**
+     * @brief Frees every entry that was retired at least two epochs before 'epoch'
+     */
+    auto free_expired(Vec<Retired> &list, const u64 epoch) -> void {
+      const auto expired = std::partition(
+        list.begin(),
+        list.end(),
+        [epoch](const Retired &retired) { return retired.epoch + 2 > epoch; }
+      );
+
+      for (auto it = expired; it != list.end(); ++it) {
+        it->drop(it->object);
+      }
+      list.erase(expired, list.end());
+    }
+
+    /**
+     * @brief Moves the global epoch forward if every pinned thread has observed the current one, registry_lock
+     * must be held.
+     */
+    auto advance_locked() -> u64 {
+      u64 epoch = global_epoch.load(std::memory_order_seq_cst);
+
+      for (const Participant *participant: registry) {
+        const u64 state = participant->state.load(std::memory_order_seq_cst);
+        if ((state & 1) != 0 and (state >> 1) != epoch) {
+          return epoch;
+        }
+      }
+
+      if (global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst)) {
+        epoch++;
+      }
+      free_expired(orphans, epoch);
+      return epoch;
+    }
+
+    auto try_advance() -> u64 {
+      const std::unique_lock lock{registry_lock, std::try_to_lock};
+      if (not lock.owns_lock()) return global_epoch.load(std::memory_order_seq_cst);
+      return advance_locked();
+    }
+
+    struct LocalHandle {
+      Participant *participant = new Participant{};
+
+      LocalHandle() {
+        const std::lock_guard lock{registry_lock};
+        registry.push_back(participant);
+      }
+
+      LocalHandle(const LocalHandle &) = delete;
+
+      LocalHandle& operator=(const LocalHandle &) = delete;
+
+      ~LocalHandle() {
+        const std::lock_guard lock{registry_lock};
+        std::erase(registry, participant);
+        orphans.insert(orphans.end(), participant->limbo.begin(), participant->limbo.end());
+        delete participant;
+
+        // when no other thread is pinned two advances free everything this thread left behind
+        advance_locked();
+        advance_locked();
+      }
+    };
+
+    thread_local LocalHandle local;
+  }
+
+  Guard::Guard() {
+    Participant &participant = *local.participant;
+    if (participant.pins++ == 0) {
+      participant.state.store((global_epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+  }
+
+  Guard::~Guard() {
+    Participant &participant = *local.participant;
+    if (--participant.pins == 0) {
+      participant.state.store(0, std::memory_order_release);
+    }
+  }
+
+  auto Guard::retire(void *object, const Dropper drop) const -> void {
+    Participant &participant = *local.participant;
+    participant.limbo.push_back(Retired{object, drop, global_epoch.load(std::memory_order_seq_cst)});
+
+    if (++participant.since_collect >= COLLECT_INTERVAL) {
+      participant.since_collect = 0;
+      free_expired(participant.limbo, try_advance());
+    }
+  }
+
+  auto collect() -> void {
+    free_expired(local.participant->limbo, try_advance());
+  }
+}
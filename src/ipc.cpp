@@ -0,0 +1,459 @@
+#include "../include/ipc.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "../include/crab/debug.hpp"
+
+namespace crab::ipc {
+  namespace {
+    constexpr u64 MAGIC = 0x314c'4e43'4350'4942; // "BIPCCNL1"
+
+    // the ring can't grow past what the 30 bit record sizes can describe
+    constexpr usize MAX_CAPACITY = usize{1} << 30;
+
+    // record header states, 0 means the record was reserved but not published yet
+    constexpr u32 COMMITTED = u32{1} << 31;
+    constexpr u32 SKIP = u32{1} << 30;
+    constexpr u32 SIZE_MASK = SKIP - 1;
+
+    [[nodiscard]] auto record_bytes(const usize payload) -> usize {
+      return RECORD_HEADER_BYTES + (payload + RECORD_HEADER_BYTES - 1) / RECORD_HEADER_BYTES * RECORD_HEADER_BYTES;
+    }
+
+    [[nodiscard]] auto state_of(u8 *header) -> std::atomic_ref<u32> {
+      return std::atomic_ref<u32>{*reinterpret_cast<u32*>(header)};
+    }
+
+    // sleeps while 'word' holds 'expected', may return spuriously
+    auto wait(std::atomic<u32> &word, const u32 expected) -> void {
+      #ifdef __linux__
+      ::syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+      #else
+      if (word.load() == expected) std::this_thread::yield();
+      #endif
+    }
+
+    template<typename T>
+    [[nodiscard]] auto failed_with(const Result<T, IpcError> &result, const IpcError::Kind kind) -> bool {
+      return result.is_err() and result.get_err_unchecked().kind() == kind;
+    }
+
+    auto wake_all(std::atomic<u32> &word) -> void {
+      #ifdef __linux__
+      ::syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+      #else
+      (void) word;
+      #endif
+    }
+  }
+
+  /**
+   * @brief Start of the shared mapping, positions only ever grow & are masked into the ring.
+   *
+   * Sleeping uses an event counter per direction, a side that is about to sleep announces it in '*_waiting',
+   * loads the counter, checks the ring again & only then waits on the counter, the other side bumps the counter
+   * after publishing & wakes if anyone announced itself (so a wake up can't be lost in between).
+   */
+  struct alignas(64) Control {
+    u64 magic;
+    u64 capacity;
+
+    // producers claim [reserved, reserved + n) with a CAS
+    alignas(64) std::atomic<u64> reserved{0};
+
+    // everything before this was released by the consumer & zeroed
+    alignas(64) std::atomic<u64> consumed{0};
+
+    alignas(64) std::atomic<u32> commits{0};
+    std::atomic<u32> consumer_waiting{0};
+
+    alignas(64) std::atomic<u32> releases{0};
+    std::atomic<u32> producers_waiting{0};
+
+    std::atomic<u32> closed{0};
+
+    [[nodiscard]] auto mask() const -> u64 { return capacity - 1; }
+
+    auto notify_consumer() -> void {
+      commits.fetch_add(1);
+      if (consumer_waiting.load() != 0) wake_all(commits);
+    }
+
+    auto notify_producers() -> void {
+      releases.fetch_add(1);
+      if (producers_waiting.load() != 0) wake_all(releases);
+    }
+
+    // hands [start, end) of the ring at 'data' back to the producers
+    auto release(u8 *data, const u64 start, const u64 end) -> void {
+      // producers rely on unpublished headers reading as 0, wherever the next records end up
+      const u64 offset = start & mask();
+      const u64 length = end - start;
+      const u64 first = std::min(length, capacity - offset);
+      std::memset(data + offset, 0, first);
+      std::memset(data, 0, length - first);
+
+      consumed.store(end, std::memory_order_release);
+      notify_producers();
+    }
+  };
+
+  static_assert(std::atomic<u64>::is_always_lock_free and std::atomic<u32>::is_always_lock_free);
+
+  IpcError::IpcError(const Kind kind, const i32 code) : error_kind{kind}, error_code{code} {}
+
+  auto IpcError::what() const -> String {
+    switch (error_kind) {
+      case Kind::Empty:
+        return "Channel is empty";
+      case Kind::Full:
+        return "Channel is full";
+      case Kind::TooLarge:
+        return "Message or channel is too large";
+      case Kind::Closed:
+        return "Channel is closed";
+      case Kind::Format:
+        return "Shared memory does not hold a channel";
+      case Kind::System:
+        return String{"System call failed: "} + std::strerror(error_code);
+    }
+    return "Unknown IpcError";
+  }
+
+  Reservation::Reservation(Control *control, u8 *header, const Span<u8> payload)
+    : control{control}, header{header}, payload{payload} {}
+
+  Reservation::Reservation(Reservation &&from) noexcept
+    : control{std::exchange(from.control, nullptr)}, header{from.header}, payload{from.payload} {}
+
+  auto Reservation::operator=(Reservation &&from) noexcept -> Reservation& {
+    if (this != &from) {
+      this->~Reservation();
+      control = std::exchange(from.control, nullptr);
+      header = from.header;
+      payload = from.payload;
+    }
+    return *this;
+  }
+
+  Reservation::~Reservation() {
+    // abandoned, the consumer has to skip the space instead of waiting for it forever
+    if (control) publish(SKIP | static_cast<u32>(record_bytes(payload.size())));
+  }
+
+  auto Reservation::publish(const u32 state) -> void {
+    state_of(header).store(state, std::memory_order_release);
+    control->notify_consumer();
+    control = nullptr;
+  }
+
+  auto Reservation::commit() -> void {
+    debug_assert(control, "Reservation was already committed");
+    publish(COMMITTED | static_cast<u32>(payload.size()));
+  }
+
+  Producer::Producer(Control *control, u8 *data) : control{control}, data{data} {}
+
+  auto Producer::try_reserve(const usize bytes) const -> Result<Reservation, IpcError> {
+    if (control->closed.load(std::memory_order_acquire)) return IpcError{IpcError::Kind::Closed};
+    if (bytes > control->capacity / 2 - RECORD_HEADER_BYTES) return IpcError{IpcError::Kind::TooLarge};
+
+    const u64 capacity = control->capacity;
+    const u64 record = record_bytes(bytes);
+
+    u64 tail = control->reserved.load(std::memory_order_relaxed);
+    u64 padding;
+    while (true) {
+      // records never wrap, the rest of the ring is skipped instead
+      const u64 offset = tail & control->mask();
+      padding = offset + record > capacity ? capacity - offset : 0;
+
+      const u64 head = control->consumed.load(std::memory_order_acquire);
+      if (head > tail) {
+        // 'tail' is older than what the consumer already released
+        tail = control->reserved.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (tail + padding + record - head > capacity) return IpcError{IpcError::Kind::Full};
+
+      if (control->reserved.compare_exchange_weak(tail, tail + padding + record, std::memory_order_relaxed)) break;
+    }
+
+    if (padding != 0) {
+      state_of(data + (tail & control->mask())).store(SKIP | static_cast<u32>(padding), std::memory_order_release);
+    }
+
+    u8 *header = data + ((tail + padding) & control->mask());
+    return Reservation{control, header, Span<u8>{header + RECORD_HEADER_BYTES, bytes}};
+  }
+
+  auto Producer::reserve(const usize bytes) const -> Result<Reservation, IpcError> {
+    while (true) {
+      if (auto reservation = try_reserve(bytes); not failed_with(reservation, IpcError::Kind::Full)) {
+        return reservation;
+      }
+
+      control->producers_waiting.fetch_add(1);
+      const u32 seen = control->releases.load();
+      if (auto reservation = try_reserve(bytes); not failed_with(reservation, IpcError::Kind::Full)) {
+        control->producers_waiting.fetch_sub(1);
+        return reservation;
+      }
+
+      wait(control->releases, seen);
+      control->producers_waiting.fetch_sub(1);
+    }
+  }
+
+  auto Producer::send(const Span<const u8> message) const -> Result<unit, IpcError> {
+    Result<Reservation, IpcError> reserved = reserve(message.size());
+    if (reserved.is_err()) return reserved.take_err_unchecked();
+
+    Reservation reservation = reserved.take_unchecked();
+    std::memcpy(reservation.bytes().data(), message.data(), message.size());
+    reservation.commit();
+    return unit{};
+  }
+
+  Message::Message(Control *control, u8 *data, const u64 start, const u64 end, const Span<const u8> payload)
+    : control{control}, data{data}, start{start}, end{end}, payload{payload} {}
+
+  Message::Message(Message &&from) noexcept
+    : control{std::exchange(from.control, nullptr)},
+      data{from.data},
+      start{from.start},
+      end{from.end},
+      payload{from.payload} {}
+
+  auto Message::operator=(Message &&from) noexcept -> Message& {
+    if (this != &from) {
+      this->~Message();
+      control = std::exchange(from.control, nullptr);
+      data = from.data;
+      start = from.start;
+      end = from.end;
+      payload = from.payload;
+    }
+    return *this;
+  }
+
+  Message::~Message() {
+    if (control == nullptr) return;
+
+    debug_assert(
+      control->consumed.load(std::memory_order_relaxed) == start,
+      "Messages have to be dropped in the order they were received"
+    );
+
+    control->release(data, start, end);
+  }
+
+  Consumer::Consumer(Control *control, u8 *data)
+    : control{control}, data{data}, cursor{control->consumed.load(std::memory_order_acquire)} {}
+
+  auto Consumer::try_receive() -> Result<Message, IpcError> {
+    const u64 start = cursor;
+    u64 position = cursor;
+
+    while (true) {
+      u8 *header = data + (position & control->mask());
+      // a ring full of skipped records would otherwise lead back to 'start'
+      const u32 state = position - start < control->capacity ? state_of(header).load(std::memory_order_acquire) : 0;
+      const u32 size = state & SIZE_MASK;
+
+      if (state == 0) {
+        // skipped records are only released by the message after them, without one they're released here
+        if (position != start and control->consumed.load(std::memory_order_relaxed) == start) {
+          control->release(data, start, position);
+          cursor = position;
+        }
+
+        const bool drained = control->reserved.load(std::memory_order_acquire) == position;
+        if (drained and control->closed.load(std::memory_order_acquire)) return IpcError{IpcError::Kind::Closed};
+        return IpcError{IpcError::Kind::Empty};
+      }
+
+      if (state & SKIP) {
+        if (size < RECORD_HEADER_BYTES or size > control->capacity) return IpcError{IpcError::Kind::Format};
+        position += size;
+        continue;
+      }
+
+      if (size > control->capacity / 2 - RECORD_HEADER_BYTES) return IpcError{IpcError::Kind::Format};
+
+      cursor = position + record_bytes(size);
+      return Message{control, data, start, cursor, Span<const u8>{header + RECORD_HEADER_BYTES, size}};
+    }
+  }
+
+  auto Consumer::receive() -> Result<Message, IpcError> {
+    while (true) {
+      if (auto message = try_receive(); not failed_with(message, IpcError::Kind::Empty)) return message;
+
+      control->consumer_waiting.store(1);
+      const u32 seen = control->commits.load();
+      if (auto message = try_receive(); not failed_with(message, IpcError::Kind::Empty)) {
+        control->consumer_waiting.store(0);
+        return message;
+      }
+
+      wait(control->commits, seen);
+      control->consumer_waiting.store(0);
+    }
+  }
+
+  Channel::Channel(const i32 fd, u8 *mapping, const usize mapping_bytes)
+    : fd{fd}, mapping{mapping}, mapping_bytes{mapping_bytes} {}
+
+  auto Channel::map(const i32 fd, const Option<usize> capacity) -> Result<Channel, IpcError> {
+    // owns 'fd' from here on, so every early return closes it
+    Channel channel{fd, nullptr, 0};
+
+    usize bytes;
+    if (capacity.is_some()) {
+      bytes = sizeof(Control) + capacity.get_unchecked();
+      if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) return IpcError{IpcError::Kind::System, errno};
+    } else {
+      struct stat status{};
+      if (::fstat(fd, &status) != 0) return IpcError{IpcError::Kind::System, errno};
+      bytes = static_cast<usize>(status.st_size);
+      if (bytes < sizeof(Control) + MIN_CAPACITY) return IpcError{IpcError::Kind::Format};
+    }
+
+    void *address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) return IpcError{IpcError::Kind::System, errno};
+
+    channel.mapping = static_cast<u8*>(address);
+    channel.mapping_bytes = bytes;
+
+    if (capacity.is_some()) {
+      Control *control = ::new(address) Control{};
+      control->capacity = capacity.get_unchecked();
+      std::atomic_ref{control->magic}.store(MAGIC, std::memory_order_release);
+    } else {
+      Control *control = channel.control();
+      if (
+        std::atomic_ref{control->magic}.load(std::memory_order_acquire) != MAGIC
+        or control->capacity != bytes - sizeof(Control)
+        or not std::has_single_bit(control->capacity)
+      ) {
+        return IpcError{IpcError::Kind::Format};
+      }
+    }
+
+    return channel;
+  }
+
+  namespace {
+    [[nodiscard]] auto ring_capacity(const usize requested) -> Result<usize, IpcError> {
+      if (requested > MAX_CAPACITY) return IpcError{IpcError::Kind::TooLarge};
+      return std::bit_ceil(std::max(requested, MIN_CAPACITY));
+    }
+  }
+
+  auto Channel::create(const StringView name, const usize capacity) -> Result<Channel, IpcError> {
+    Result<usize, IpcError> rounded = ring_capacity(capacity);
+    if (rounded.is_err()) return rounded.take_err_unchecked();
+
+    const String path{name};
+    const i32 fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0) return IpcError{IpcError::Kind::System, errno};
+
+    Result<Channel, IpcError> channel = map(fd, crab::some(rounded.take_unchecked()));
+    if (channel.is_err()) ::shm_unlink(path.c_str());
+    return channel;
+  }
+
+  auto Channel::open(const StringView name) -> Result<Channel, IpcError> {
+    const String path{name};
+    const i32 fd = ::shm_open(path.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) return IpcError{IpcError::Kind::System, errno};
+
+    return map(fd, crab::none);
+  }
+
+  auto Channel::unlink(const StringView name) -> Result<unit, IpcError> {
+    if (::shm_unlink(String{name}.c_str()) != 0) return IpcError{IpcError::Kind::System, errno};
+    return unit{};
+  }
+
+  auto Channel::anonymous(const usize capacity) -> Result<Channel, IpcError> {
+    Result<usize, IpcError> rounded = ring_capacity(capacity);
+    if (rounded.is_err()) return rounded.take_err_unchecked();
+
+    #ifdef __linux__
+    const i32 fd = ::memfd_create("crab-ipc", MFD_CLOEXEC);
+    #else
+    const String path = "/crab-ipc-" + std::to_string(::getpid()) + "-" + std::to_string(reinterpret_cast<uptr>(&rounded));
+    const i32 fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) ::shm_unlink(path.c_str());
+    #endif
+    if (fd < 0) return IpcError{IpcError::Kind::System, errno};
+
+    return map(fd, crab::some(rounded.take_unchecked()));
+  }
+
+  auto Channel::from_fd(const i32 fd) -> Result<Channel, IpcError> {
+    return map(fd, crab::none);
+  }
+
+  Channel::Channel(Channel &&from) noexcept
+    : fd{std::exchange(from.fd, -1)},
+      mapping{std::exchange(from.mapping, nullptr)},
+      mapping_bytes{std::exchange(from.mapping_bytes, 0)} {}
+
+  auto Channel::operator=(Channel &&from) noexcept -> Channel& {
+    if (this != &from) {
+      this->~Channel();
+      fd = std::exchange(from.fd, -1);
+      mapping = std::exchange(from.mapping, nullptr);
+      mapping_bytes = std::exchange(from.mapping_bytes, 0);
+    }
+    return *this;
+  }
+
+  Channel::~Channel() {
+    if (mapping) ::munmap(mapping, mapping_bytes);
+    if (fd >= 0) ::close(fd);
+    mapping = nullptr;
+    fd = -1;
+  }
+
+  auto Channel::control() const -> Control* { return std::launder(reinterpret_cast<Control*>(mapping)); }
+
+  auto Channel::data() const -> u8* { return mapping + sizeof(Control); }
+
+  auto Channel::capacity() const -> usize { return control()->capacity; }
+
+  auto Channel::max_message_size() const -> usize { return capacity() / 2 - RECORD_HEADER_BYTES; }
+
+  auto Channel::producer() const -> Producer { return Producer{control(), data()}; }
+
+  auto Channel::consumer() const -> Consumer { return Consumer{control(), data()}; }
+
+  auto Channel::close() const -> void {
+    control()->closed.store(1);
+    control()->notify_consumer();
+    control()->notify_producers();
+  }
+
+  auto Channel::is_closed() const -> bool { return control()->closed.load(std::memory_order_acquire) != 0; }
+}
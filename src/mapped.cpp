@@ -0,0 +1,100 @@
+#include "../include/crab/mapped.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace crab::mapped {
+  IoError::IoError(const StringView operation, const i32 error_code)
+    : operation{operation}, error_code{error_code} {}
+
+  auto IoError::what() const -> String {
+    return String{operation} + " failed: " + std::strerror(error_code);
+  }
+
+  File::File(const i32 fd) : fd{fd} {}
+
+  auto File::open(const std::filesystem::path &path) -> Result<File, IoError> {
+    const i32 fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return IoError{"open", errno};
+
+    // owns the descriptor from here on, so every early return closes it
+    File file{fd};
+
+    struct stat status{};
+    if (::fstat(fd, &status) != 0) return IoError{"fstat", errno};
+    if (not S_ISREG(status.st_mode)) return IoError{"open", EINVAL};
+
+    if (status.st_size > 0) {
+      void *address = ::mmap(nullptr, static_cast<usize>(status.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (address == MAP_FAILED) return IoError{"mmap", errno};
+
+      file.address = static_cast<u8*>(address);
+      file.bytes = static_cast<usize>(status.st_size);
+    }
+
+    return file;
+  }
+
+  File::File(File &&from) noexcept
+    : fd{std::exchange(from.fd, -1)},
+      address{std::exchange(from.address, nullptr)},
+      bytes{std::exchange(from.bytes, 0)} {}
+
+  auto File::operator=(File &&from) noexcept -> File& {
+    if (this != &from) {
+      this->~File();
+      fd = std::exchange(from.fd, -1);
+      address = std::exchange(from.address, nullptr);
+      bytes = std::exchange(from.bytes, 0);
+    }
+    return *this;
+  }
+
+  File::~File() {
+    unmap();
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+  }
+
+  auto File::unmap() -> void {
+    if (address) ::munmap(address, bytes);
+    address = nullptr;
+    bytes = 0;
+  }
+
+  auto File::resize(const usize new_bytes) -> Result<unit, IoError> {
+    if (::ftruncate(fd, static_cast<off_t>(new_bytes)) != 0) return IoError{"ftruncate", errno};
+
+    #ifdef __linux__
+    if (address and new_bytes > 0) {
+      void *moved = ::mremap(address, bytes, new_bytes, MREMAP_MAYMOVE);
+      if (moved == MAP_FAILED) return IoError{"mremap", errno};
+
+      address = static_cast<u8*>(moved);
+      bytes = new_bytes;
+      return unit{};
+    }
+    #endif
+
+    unmap();
+    if (new_bytes == 0) return unit{};
+
+    void *mapped = ::mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) return IoError{"mmap", errno};
+
+    address = static_cast<u8*>(mapped);
+    bytes = new_bytes;
+    return unit{};
+  }
+
+  auto File::flush() const -> Result<unit, IoError> {
+    if (address and ::msync(address, bytes, MS_SYNC) != 0) return IoError{"msync", errno};
+    return unit{};
+  }
+}
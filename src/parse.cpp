@@ -0,0 +1,464 @@
+#include "../include/parse.hpp"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <format>
+
+namespace crab {
+  ParseError::ParseError(const Kind kind, const usize position) : error_kind{kind}, byte{position} {}
+
+  auto ParseError::in_field(const usize index) const -> ParseError {
+    ParseError error = *this;
+    error.field_index = crab::some(index);
+    return error;
+  }
+
+  auto ParseError::what() const -> String {
+    String message;
+    switch (error_kind) {
+      case Kind::Empty:
+        message = "cannot parse a number from empty text";
+        break;
+      case Kind::InvalidDigit:
+        message = std::format("invalid digit at byte {}", byte);
+        break;
+      case Kind::OutOfRange:
+        message = "number out of range for the type";
+        break;
+    }
+    if (field_index.is_some()) return std::format("field {}: {}", field_index.get_unchecked(), message);
+    return message;
+  }
+}
+
+namespace crab::parsing::helper {
+  namespace {
+    using Kind = ParseError::Kind;
+
+    // decimal significands with more digits may not fit a u64 & are left to the slow path
+    constexpr usize MAX_DIGITS = 19;
+
+    // range of the power of five table
+    constexpr i64 SMALLEST_POWER_OF_FIVE = -342;
+    constexpr i64 LARGEST_POWER_OF_FIVE = 308;
+
+    /**
+     * @brief Text split into sign, decimal significand & exponent: value = mantissa * 10^exponent
+     */
+    struct Decimal {
+      enum class Special : u8 { Finite, Infinity, NaN, Invalid };
+
+      u64 mantissa = 0;
+      i64 exponent = 0;
+      bool negative = false;
+      // more than MAX_DIGITS significant digits, 'mantissa' is unusable
+      bool too_many_digits = false;
+      Special special = Special::Finite;
+      // where the number starts after the sign
+      usize unsigned_start = 0;
+      // why & where the text is not a number, for Special::Invalid
+      Kind error = Kind::Empty;
+      usize error_position = 0;
+
+      [[nodiscard]] static auto invalid(const Kind kind, const usize position) -> Decimal {
+        Decimal decimal;
+        decimal.special = Special::Invalid;
+        decimal.error = kind;
+        decimal.error_position = position;
+        return decimal;
+      }
+    };
+
+    [[nodiscard]] auto is_digit(const char c) -> bool { return static_cast<u8>(c - '0') <= 9; }
+
+    /**
+     * @brief Case insensitive comparison against a lowercase word
+     */
+    [[nodiscard]] auto equals_lowercase(const char *from, const char *end, const StringView word) -> bool {
+      if (static_cast<usize>(end - from) != word.size()) return false;
+      for (const char c: word) {
+        if ((*from++ | 0x20) != c) return false;
+      }
+      return true;
+    }
+
+    /**
+     * @brief Consumes digits at 'cursor' into 'mantissa', 8 at a time while possible
+     */
+    __always_inline auto consume_digits(const char *&cursor, const char *end, u64 &mantissa) -> void {
+      while (end - cursor >= 8) {
+        const u64 chunk = load_eight(cursor);
+        if (not is_eight_digits(chunk)) break;
+        mantissa = mantissa * 100'000'000 + eight_digits(chunk);
+        cursor += 8;
+      }
+      for (; cursor != end and is_digit(*cursor); cursor++) {
+        mantissa = mantissa * 10 + static_cast<u8>(*cursor - '0');
+      }
+    }
+
+    /**
+     * @brief Splits 'text' into sign, significand & exponent. Failures are reported as Special::Invalid instead of
+     * through a Result, which costs measurably on this path.
+     */
+    [[nodiscard]] auto scan(const StringView text) -> Decimal {
+      const char *const begin = text.data();
+      const char *const end = begin + text.size();
+      const char *cursor = begin;
+
+      if (cursor == end) return Decimal::invalid(Kind::Empty, 0);
+
+      Decimal decimal;
+      if (*cursor == '+' or *cursor == '-') {
+        decimal.negative = *cursor == '-';
+        cursor++;
+      }
+      decimal.unsigned_start = static_cast<usize>(cursor - begin);
+
+      if (cursor != end and not is_digit(*cursor) and *cursor != '.') {
+        if (equals_lowercase(cursor, end, "inf") or equals_lowercase(cursor, end, "infinity")) {
+          decimal.special = Decimal::Special::Infinity;
+          return decimal;
+        }
+        if (equals_lowercase(cursor, end, "nan")) {
+          decimal.special = Decimal::Special::NaN;
+          return decimal;
+        }
+        return Decimal::invalid(Kind::InvalidDigit, decimal.unsigned_start);
+      }
+
+      // leading zeros are not significant
+      const char *const integer_start = cursor;
+      while (cursor != end and *cursor == '0') cursor++;
+      const char *const significant_start = cursor;
+      consume_digits(cursor, end, decimal.mantissa);
+      const char *const integer_end = cursor;
+      usize significant = static_cast<usize>(integer_end - significant_start);
+      bool any_digits = integer_end != integer_start;
+
+      if (cursor != end and *cursor == '.') {
+        const char *const fraction_start = ++cursor;
+        // zeros right after the point are only significant behind other digits
+        if (significant == 0) {
+          while (cursor != end and *cursor == '0') cursor++;
+        }
+        const char *const fraction_significant = cursor;
+        consume_digits(cursor, end, decimal.mantissa);
+        significant += static_cast<usize>(cursor - fraction_significant);
+        decimal.exponent = -static_cast<i64>(cursor - fraction_start);
+        any_digits = any_digits or cursor != fraction_start;
+      }
+
+      if (not any_digits) return Decimal::invalid(Kind::InvalidDigit, static_cast<usize>(cursor - begin));
+
+      if (cursor != end and (*cursor | 0x20) == 'e') {
+        cursor++;
+        bool negative_exponent = false;
+        if (cursor != end and (*cursor == '+' or *cursor == '-')) {
+          negative_exponent = *cursor == '-';
+          cursor++;
+        }
+        if (cursor == end or not is_digit(*cursor)) {
+          return Decimal::invalid(Kind::InvalidDigit, static_cast<usize>(cursor - begin));
+        }
+
+        i64 exponent = 0;
+        for (; cursor != end and is_digit(*cursor); cursor++) {
+          // anything this large is 0 or infinity anyway, stop before overflowing
+          if (exponent < 0x1000'0000) exponent = exponent * 10 + (*cursor - '0');
+        }
+        decimal.exponent += negative_exponent ? -exponent : exponent;
+      }
+
+      if (cursor != end) return Decimal::invalid(Kind::InvalidDigit, static_cast<usize>(cursor - begin));
+
+      decimal.too_many_digits = significant > MAX_DIGITS;
+      return decimal;
+    }
+
+    /**
+     * @brief Layout of an IEEE binary floating point type, with the constants Eisel-Lemire needs
+     */
+    template<typename F>
+    struct Binary {};
+
+    template<>
+    struct Binary<float> {
+      using Bits = u32;
+      static constexpr i32 MANTISSA_BITS = 23;
+      static constexpr i32 MINIMUM_EXPONENT = -127;
+      static constexpr i32 INFINITE_POWER = 0xff;
+      static constexpr i64 MIN_ROUND_TO_EVEN = -17;
+      static constexpr i64 MAX_ROUND_TO_EVEN = 10;
+      static constexpr i64 SMALLEST_POWER_OF_TEN = -65;
+      static constexpr i64 LARGEST_POWER_OF_TEN = 38;
+    };
+
+    template<>
+    struct Binary<double> {
+      using Bits = u64;
+      static constexpr i32 MANTISSA_BITS = 52;
+      static constexpr i32 MINIMUM_EXPONENT = -1023;
+      static constexpr i32 INFINITE_POWER = 0x7ff;
+      static constexpr i64 MIN_ROUND_TO_EVEN = -4;
+      static constexpr i64 MAX_ROUND_TO_EVEN = 23;
+      static constexpr i64 SMALLEST_POWER_OF_TEN = -342;
+      static constexpr i64 LARGEST_POWER_OF_TEN = 308;
+    };
+
+    // big unsigned integer as little endian 64 bit limbs, only used to build the table
+    using Limbs = std::array<u64, 18>;
+
+    /**
+     * @brief The 128 most significant bits of 'value' (shifted so the top bit is set), truncated
+     */
+    constexpr auto top_bits(const Limbs &value) -> std::pair<u64, u64> {
+      usize top = value.size() - 1;
+      while (value[top] == 0) top--;
+
+      const auto limb = [&](const usize i, const usize below) -> u64 { return i >= below ? value[i - below] : 0; };
+      const i32 shift = std::countl_zero(value[top]);
+      const auto shifted = [&](const usize below) -> u64 {
+        const u64 word = limb(top, below);
+        return shift == 0 ? word : word << shift | limb(top, below + 1) >> (64 - shift);
+      };
+      return {shifted(0), shifted(1)};
+    }
+
+    /**
+     * @brief 5^q normalized to 128 bits for q in [-342, 308] as (high, low) pairs: truncated for q >= 0 & for
+     * q < -27, rounded up for the q in [-27, -1] where the algorithm relies on it.
+     */
+    constexpr auto powers_of_five() -> std::array<u64, 2 * (LARGEST_POWER_OF_FIVE - SMALLEST_POWER_OF_FIVE + 1)> {
+      std::array<u64, 2 * (LARGEST_POWER_OF_FIVE - SMALLEST_POWER_OF_FIVE + 1)> table{};
+
+      // floor(2^1088 / 5^q), still 294 bits wide at q = 342
+      Limbs reciprocal{};
+      reciprocal.back() = 1;
+      for (i64 q = 1; q <= -SMALLEST_POWER_OF_FIVE; q++) {
+        unsigned __int128 remainder = 0;
+        for (usize i = reciprocal.size(); i-- > 0;) {
+          const unsigned __int128 current = remainder << 64 | reciprocal[i];
+          reciprocal[i] = static_cast<u64>(current / 5);
+          remainder = current % 5;
+        }
+
+        auto [high, low] = top_bits(reciprocal);
+        if (q <= 27 and ++low == 0) high++;
+        const auto index = static_cast<usize>(2 * (-q - SMALLEST_POWER_OF_FIVE));
+        table[index] = high;
+        table[index + 1] = low;
+      }
+
+      Limbs power{};
+      power.front() = 1;
+      for (i64 q = 0; q <= LARGEST_POWER_OF_FIVE; q++) {
+        if (q > 0) {
+          u64 carry = 0;
+          for (u64 &limb: power) {
+            const unsigned __int128 current = static_cast<unsigned __int128>(limb) * 5 + carry;
+            limb = static_cast<u64>(current);
+            carry = static_cast<u64>(current >> 64);
+          }
+        }
+
+        const auto [high, low] = top_bits(power);
+        const auto index = static_cast<usize>(2 * (q - SMALLEST_POWER_OF_FIVE));
+        table[index] = high;
+        table[index + 1] = low;
+      }
+      return table;
+    }
+
+    constexpr auto POWERS_OF_FIVE = powers_of_five();
+
+    struct Product {
+      u64 high;
+      u64 low;
+    };
+
+    [[nodiscard]] __always_inline auto multiply(const u64 a, const u64 b) -> Product {
+      const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+      return {static_cast<u64>(product >> 64), static_cast<u64>(product)};
+    }
+
+    /**
+     * @brief Eisel-Lemire: the correctly rounded bits of 'mantissa' * 10^'exponent' from a 128 bit approximation of
+     * 5^exponent, 'mantissa' must be non zero.
+     */
+    template<typename F>
+    [[nodiscard]] auto eisel_lemire(u64 mantissa, const i64 exponent) -> typename Binary<F>::Bits {
+      using Format = Binary<F>;
+      using Bits = typename Format::Bits;
+
+      if (exponent < Format::SMALLEST_POWER_OF_TEN) return 0;
+      if (exponent > Format::LARGEST_POWER_OF_TEN) return Bits{Format::INFINITE_POWER} << Format::MANTISSA_BITS;
+
+      const i32 leading_zeros = std::countl_zero(mantissa);
+      mantissa <<= leading_zeros;
+
+      // 3 more bits than the mantissa has are enough to round, unless those are all ones
+      const auto index = static_cast<usize>(2 * (exponent - SMALLEST_POWER_OF_FIVE));
+      constexpr u64 PRECISION_MASK = ~u64{0} >> (Format::MANTISSA_BITS + 3);
+      Product product = multiply(mantissa, POWERS_OF_FIVE[index]);
+      if ((product.high & PRECISION_MASK) == PRECISION_MASK) {
+        const Product lower = multiply(mantissa, POWERS_OF_FIVE[index + 1]);
+        product.low += lower.high;
+        if (lower.high > product.low) product.high++;
+      }
+
+      const auto upper_bit = static_cast<i32>(product.high >> 63);
+      const i32 shift = upper_bit + 64 - Format::MANTISSA_BITS - 3;
+      u64 bits = product.high >> shift;
+      // floor(log2(10^exponent)) + 63
+      const auto power_of_two = static_cast<i32>(((152'170 + 65'536) * exponent >> 16) + 63);
+      i32 power = power_of_two + upper_bit - leading_zeros - Format::MINIMUM_EXPONENT;
+
+      if (power <= 0) {
+        // subnormal, or zero if it is more than 64 bits below the smallest exponent
+        if (-power + 1 >= 64) return 0;
+        bits >>= -power + 1;
+        bits += bits & 1;
+        bits >>= 1;
+        // rounding up can make it normal again
+        power = bits < u64{1} << Format::MANTISSA_BITS ? 0 : 1;
+        return static_cast<Bits>(static_cast<u64>(power) << Format::MANTISSA_BITS | bits);
+      }
+
+      // exactly half way between two floats, round to even instead of up
+      if (product.low <= 1 and exponent >= Format::MIN_ROUND_TO_EVEN and exponent <= Format::MAX_ROUND_TO_EVEN
+        and (bits & 3) == 1 and bits << shift == product.high) {
+        bits &= ~u64{1};
+      }
+
+      bits += bits & 1;
+      bits >>= 1;
+      if (bits >= u64{2} << Format::MANTISSA_BITS) {
+        bits = u64{1} << Format::MANTISSA_BITS;
+        power++;
+      }
+      bits &= ~(u64{1} << Format::MANTISSA_BITS);
+
+      if (power >= Format::INFINITE_POWER) return Bits{Format::INFINITE_POWER} << Format::MANTISSA_BITS;
+      return static_cast<Bits>(static_cast<u64>(power) << Format::MANTISSA_BITS | bits);
+    }
+
+    /**
+     * @brief Largest power of ten that is exact in F
+     */
+    template<typename F>
+    consteval auto max_exact_power_of_ten() -> i64 {
+      // 10^e = 2^e * 5^e is exact while 5^e fits the significand
+      constexpr i32 digits = std::numeric_limits<F>::digits;
+      constexpr u64 limit = digits >= 64 ? ~u64{0} : u64{1} << digits;
+      i64 exponent = 0;
+      for (u64 power = 5; power <= limit; power *= 5) {
+        exponent++;
+        if (power > limit / 5) break;
+      }
+      return exponent;
+    }
+
+    template<typename F>
+    consteval auto exact_powers_of_ten() -> std::array<F, max_exact_power_of_ten<F>() + 1> {
+      std::array<F, max_exact_power_of_ten<F>() + 1> powers{};
+      F power = 1;
+      for (F &entry: powers) {
+        entry = power;
+        power *= 10;
+      }
+      return powers;
+    }
+
+    template<typename F>
+    constexpr auto EXACT_POWERS_OF_TEN = exact_powers_of_ten<F>();
+
+    /**
+     * @brief Clinger's fast path: an exact significand times an exact power of ten is rounded once, correctly
+     */
+    template<typename F>
+    [[nodiscard]] __always_inline auto fast_path(const Decimal &decimal) -> Option<F> {
+      constexpr i32 digits = std::numeric_limits<F>::digits;
+      constexpr u64 max_mantissa = digits >= 64 ? ~u64{0} : u64{1} << digits;
+      constexpr i64 max_exponent = max_exact_power_of_ten<F>();
+
+      if (decimal.too_many_digits or decimal.mantissa > max_mantissa) return crab::none;
+      if (decimal.exponent < -max_exponent or decimal.exponent > max_exponent) return crab::none;
+
+      F value = static_cast<F>(decimal.mantissa);
+      if (decimal.exponent < 0) {
+        value /= EXACT_POWERS_OF_TEN<F>[static_cast<usize>(-decimal.exponent)];
+      } else {
+        value *= EXACT_POWERS_OF_TEN<F>[static_cast<usize>(decimal.exponent)];
+      }
+      return crab::some(decimal.negative ? -value : value);
+    }
+
+    /**
+     * @brief Zero & infinity from non zero finite text mean the value does not fit F
+     */
+    template<typename F>
+    [[nodiscard]] auto checked(const F value) -> Result<F, ParseError> {
+      if (value == 0 or value == std::numeric_limits<F>::infinity() or value == -std::numeric_limits<F>::infinity()) {
+        return ParseError{Kind::OutOfRange, 0};
+      }
+      return value;
+    }
+
+    /**
+     * @brief Everything the fast algorithms can not decide, through the standard library
+     */
+    template<typename F>
+    [[nodiscard]] auto slow_path(const StringView text, const Decimal &decimal) -> Result<F, ParseError> {
+      F value{};
+      const auto [end, error] = std::from_chars(text.data() + decimal.unsigned_start, text.data() + text.size(), value);
+      if (error == std::errc::result_out_of_range) return ParseError{Kind::OutOfRange, 0};
+      if (error != std::errc{} or end != text.data() + text.size()) {
+        return ParseError{Kind::InvalidDigit, static_cast<usize>(end - text.data())};
+      }
+      return checked(decimal.negative ? -value : value);
+    }
+
+    template<typename F>
+    [[nodiscard]] auto parse_binary(const StringView text) -> Result<F, ParseError> {
+      const Decimal decimal = scan(text);
+
+      switch (decimal.special) {
+        case Decimal::Special::Invalid:
+          return ParseError{decimal.error, decimal.error_position};
+        case Decimal::Special::Infinity:
+          return decimal.negative ? -std::numeric_limits<F>::infinity() : std::numeric_limits<F>::infinity();
+        case Decimal::Special::NaN:
+          return decimal.negative ? -std::numeric_limits<F>::quiet_NaN() : std::numeric_limits<F>::quiet_NaN();
+        case Decimal::Special::Finite:
+          break;
+      }
+
+      if (not decimal.too_many_digits and decimal.mantissa == 0) return decimal.negative ? F{-0.0} : F{0.0};
+
+      if (const Option<F> value = fast_path<F>(decimal); value.is_some()) return value.get_unchecked();
+
+      if constexpr (requires { typename Binary<F>::Bits; }) {
+        if (not decimal.too_many_digits) {
+          const auto bits = eisel_lemire<F>(decimal.mantissa, decimal.exponent);
+          const F value = std::bit_cast<F>(bits);
+          return checked(decimal.negative ? -value : value);
+        }
+      }
+      return slow_path<F>(text, decimal);
+    }
+  }
+
+  auto parse_float(const StringView text) -> Result<float, ParseError> {
+    return parse_binary<float>(text);
+  }
+
+  auto parse_double(const StringView text) -> Result<double, ParseError> {
+    return parse_binary<double>(text);
+  }
+
+  auto parse_long_double(const StringView text) -> Result<long double, ParseError> {
+    return parse_binary<long double>(text);
+  }
+}
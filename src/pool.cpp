@@ -0,0 +1,83 @@
+#include "../include/crab/pool.hpp"
+
+#include <array>
+#include <new>
+
+namespace crab::pool {
+  namespace {
+    /**
+     * @brief Upper bound of blocks each size class keeps around so that a thread that only frees does not hoard
+     */
+    constexpr usize MAX_CACHED_PER_CLASS = 512;
+
+    constexpr usize CLASS_COUNT = MAX_POOLED_SIZE / SIZE_CLASS;
+
+    struct FreeBlock {
+      FreeBlock *next;
+    };
+
+    struct ThreadCache {
+      std::array<FreeBlock*, CLASS_COUNT> heads{};
+      std::array<usize, CLASS_COUNT> counts{};
+
+      ThreadCache() = default;
+
+      ThreadCache(const ThreadCache &) = delete;
+
+      ThreadCache& operator=(const ThreadCache &) = delete;
+
+      ~ThreadCache();
+    };
+
+    thread_local ThreadCache cache;
+
+    // trivially destructible so it can still be read after 'cache' was destroyed during thread exit
+    thread_local bool cache_alive = true;
+
+    ThreadCache::~ThreadCache() {
+      cache_alive = false;
+      for (FreeBlock *&head: heads) {
+        while (head) {
+          ::operator delete(std::exchange(head, head->next));
+        }
+      }
+    }
+
+    auto size_class(const usize bytes) -> usize {
+      return (bytes + SIZE_CLASS - 1) / SIZE_CLASS - 1;
+    }
+  }
+
+  auto allocate(const usize bytes) -> void* {
+    if (bytes == 0 or bytes > MAX_POOLED_SIZE or not cache_alive) {
+      return ::operator new(bytes == 0 ? 1 : bytes);
+    }
+
+    const usize index = size_class(bytes);
+    if (FreeBlock *block = cache.heads[index]) {
+      cache.heads[index] = block->next;
+      cache.counts[index]--;
+      return block;
+    }
+
+    return ::operator new((index + 1) * SIZE_CLASS);
+  }
+
+  auto deallocate(void *block, const usize bytes) -> void {
+    if (block == nullptr) return;
+
+    if (bytes == 0 or bytes > MAX_POOLED_SIZE or not cache_alive) {
+      ::operator delete(block);
+      return;
+    }
+
+    const usize index = size_class(bytes);
+    if (cache.counts[index] >= MAX_CACHED_PER_CLASS) {
+      ::operator delete(block);
+      return;
+    }
+
+    cache.heads[index] = ::new(block) FreeBlock{cache.heads[index]};
+    cache.counts[index]++;
+  }
+}
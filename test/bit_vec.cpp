@@ -0,0 +1,93 @@
+#include <bit_vec.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("BitVec", "[bit_vec]") {
+  SECTION("Get, Set & Push") {
+    crab::BitVec bits{70};
+    REQUIRE(bits.length() == 70);
+    REQUIRE(bits.count_ones() == 0);
+
+    bits.set(3);
+    bits.set(69);
+    REQUIRE(bits.get(3));
+    REQUIRE_FALSE(bits.get(4));
+    REQUIRE(bits.count_ones() == 2);
+
+    bits.reset(3);
+    REQUIRE_FALSE(bits.get(3));
+
+    bits.push(true);
+    REQUIRE(bits.length() == 71);
+    REQUIRE(bits.get(70));
+
+    bits.invert();
+    REQUIRE(bits.count_ones() == 69);
+    REQUIRE(bits.words().back() >> (71 % 64) == 0);
+
+    bits.resize(200, true);
+    REQUIRE(bits.count_ones() == 69 + 129);
+  }
+
+  SECTION("Bulk Operations") {
+    std::mt19937_64 rng{1};
+    crab::BitVec a{1'000}, b{1'000};
+    Vec<bool> expected_a(1'000), expected_b(1'000);
+    for (usize i = 0; i < 1'000; i++) {
+      expected_a[i] = rng() % 3 == 0;
+      expected_b[i] = rng() % 2 == 0;
+      a.set(i, expected_a[i]);
+      b.set(i, expected_b[i]);
+    }
+
+    const crab::BitVec both = a & b;
+    const crab::BitVec either = a | b;
+    const crab::BitVec one = a ^ b;
+    crab::BitVec only_a = a;
+    only_a.and_not(b);
+
+    for (usize i = 0; i < 1'000; i++) {
+      REQUIRE(both.get(i) == (expected_a[i] and expected_b[i]));
+      REQUIRE(either.get(i) == (expected_a[i] or expected_b[i]));
+      REQUIRE(one.get(i) == (expected_a[i] != expected_b[i]));
+      REQUIRE(only_a.get(i) == (expected_a[i] and not expected_b[i]));
+    }
+  }
+
+  SECTION("Iterating Set Bits") {
+    crab::BitVec bits{300};
+    const Vec<usize> set{0, 63, 64, 128, 200, 299};
+    for (const usize i: set) bits.set(i);
+
+    Vec<usize> found;
+    for (const usize i: bits.ones()) found.push_back(i);
+    REQUIRE(found == set);
+
+    REQUIRE(bits.find_next_set(1).take_unchecked() == 63);
+    REQUIRE(bits.find_next_set(201).take_unchecked() == 299);
+    REQUIRE(crab::BitVec{100}.first_set().is_none());
+  }
+
+  SECTION("Rank & Select") {
+    std::mt19937_64 rng{2};
+    crab::BitVec bits{100'000};
+    for (usize i = 0; i < bits.length(); i++) {
+      bits.set(i, rng() % 7 == 0);
+    }
+
+    const crab::RankSelect index = bits.rank_select();
+    REQUIRE(index.count_ones() == bits.count_ones());
+
+    usize rank = 0;
+    for (usize i = 0; i < bits.length(); i++) {
+      REQUIRE(index.rank(i) == rank);
+      if (bits.get(i)) {
+        REQUIRE(index.select(rank).take_unchecked() == i);
+        rank++;
+      }
+    }
+    REQUIRE(index.rank(bits.length()) == rank);
+    REQUIRE(index.select(rank).is_none());
+  }
+}
@@ -0,0 +1,136 @@
+#include <btree.hpp>
+
+#include <map>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+static auto padded(const usize i) -> String {
+  const String digits = std::to_string(i);
+  return String(8 - digits.size(), '0') + digits;
+}
+
+TEST_CASE("BTreeMap", "[btree]") {
+  SECTION("Insert & Get") {
+    crab::BTreeMap<i32, String> map;
+    REQUIRE(map.is_empty());
+    REQUIRE(map.get(10).is_none());
+
+    REQUIRE(map.insert(10, "ten").is_none());
+    REQUIRE(map.insert(5, "five").is_none());
+    REQUIRE(map.length() == 2);
+
+    REQUIRE(map.get(10).is_some());
+    REQUIRE(*map.get(10).take_unchecked() == "ten");
+
+    Option<String> previous = map.insert(10, "TEN");
+    REQUIRE(previous.is_some());
+    REQUIRE(previous.take_unchecked() == "ten");
+    REQUIRE(map.length() == 2);
+
+    map.get_mut(5).take_unchecked()->append("!");
+    REQUIRE(*map.get(5).take_unchecked() == "five!");
+  }
+
+  SECTION("Matches std::map under random inserts & removals") {
+    crab::BTreeMap<u64, u64> map;
+    std::map<u64, u64> expected;
+    std::mt19937_64 rng{42};
+
+    for (usize i = 0; i < 50'000; i++) {
+      const u64 key = rng() % 5'000;
+      if (rng() % 3 == 0) {
+        const auto removed = map.remove(key);
+        const bool existed = expected.erase(key) == 1;
+        REQUIRE(removed.is_some() == existed);
+      } else {
+        map.insert(key, i);
+        expected[key] = i;
+      }
+    }
+
+    REQUIRE(map.length() == expected.size());
+
+    auto it = expected.begin();
+    for (const auto [key, value]: map) {
+      REQUIRE(it != expected.end());
+      REQUIRE(key == it->first);
+      REQUIRE(value == it->second);
+      ++it;
+    }
+    REQUIRE(it == expected.end());
+
+    for (const auto &[key, value]: expected) {
+      REQUIRE(map.remove(key).take_unchecked() == value);
+    }
+    REQUIRE(map.is_empty());
+    REQUIRE(map.begin() == map.end());
+  }
+
+  SECTION("Range Queries") {
+    crab::BTreeMap<i32, i32> map;
+    for (i32 i = 0; i < 1'000; i += 2) {
+      map.insert(i, i * 10);
+    }
+
+    i32 expected = 100;
+    for (const auto [key, value]: map.range(crab::range(99, 201))) {
+      REQUIRE(key == expected);
+      REQUIRE(value == key * 10);
+      expected += 2;
+    }
+    REQUIRE(expected == 202);
+
+    REQUIRE(map.range(5'000, 6'000).empty());
+    REQUIRE(map.range(10, 10).empty());
+    REQUIRE(*map.first_key().take_unchecked() == 0);
+    REQUIRE(*map.last_key().take_unchecked() == 998);
+  }
+
+  SECTION("Bulk Load") {
+    Vec<std::pair<String, usize>> entries;
+    for (usize i = 0; i < 10'000; i++) {
+      entries.emplace_back(padded(i), i);
+    }
+
+    auto map = crab::BTreeMap<String, usize>::from_sorted(std::move(entries));
+    REQUIRE(map.length() == 10'000);
+
+    for (usize i = 0; i < 10'000; i += 37) {
+      REQUIRE(*map.get(padded(i)).take_unchecked() == i);
+    }
+
+    for (usize i = 0; i < 10'000; i += 2) {
+      REQUIRE(map.remove(padded(i)).is_some());
+    }
+    REQUIRE(map.length() == 5'000);
+
+    usize expected = 1;
+    for (const auto [key, value]: map) {
+      REQUIRE(value == expected);
+      expected += 2;
+    }
+  }
+}
+
+TEST_CASE("BTreeSet", "[btree]") {
+  crab::BTreeSet<u32> set{5, 3, 9, 1};
+
+  REQUIRE(set.length() == 4);
+  REQUIRE(set.contains(3));
+  REQUIRE_FALSE(set.contains(4));
+  REQUIRE_FALSE(set.insert(3));
+  REQUIRE(set.insert(4));
+  REQUIRE(set.remove(9));
+  REQUIRE_FALSE(set.remove(9));
+
+  Vec<u32> keys{set.begin(), set.end()};
+  REQUIRE(keys == Vec<u32>{1, 3, 4, 5});
+
+  const Vec<u32> sorted{2, 4, 6, 8, 10};
+  const auto bulk = crab::BTreeSet<u32>::from_sorted(sorted);
+  Vec<u32> between;
+  for (const u32 key: bulk.range(crab::range(4u, 9u))) {
+    between.push_back(key);
+  }
+  REQUIRE(between == Vec<u32>{4, 6, 8});
+}
@@ -0,0 +1,164 @@
+#include <bytes.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  auto span_of(const Vec<u8> &bytes) -> Span<const u8> { return bytes; }
+}
+
+TEST_CASE("ByteCursor", "[bytes]") {
+  const Vec<u8> bytes{0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09};
+
+  SECTION("Byte Order") {
+    crab::ByteCursor cursor{bytes};
+    REQUIRE(cursor.read_be<u16>().take_unchecked() == 0x0102);
+    REQUIRE(cursor.read_le<u16>().take_unchecked() == 0x0403);
+    REQUIRE(cursor.read_be<u32>().take_unchecked() == 0x0506'0708);
+    REQUIRE(cursor.read<u8>().take_unchecked() == 0x09);
+    REQUIRE(cursor.is_empty());
+    REQUIRE(cursor.offset() == 9);
+
+    crab::ByteCursor again{bytes};
+    REQUIRE(again.read_le<u64>().take_unchecked() == 0x0807'0605'0403'0201);
+    REQUIRE(crab::ByteCursor{bytes}.read_be<u64>().take_unchecked() == 0x0102'0304'0506'0708);
+  }
+
+  SECTION("Floats") {
+    crab::ByteWriter writer;
+    writer.write_be(1.5);
+    writer.write_le(-2.25f);
+    REQUIRE(writer.bytes()[0] == 0x3f);
+
+    crab::ByteCursor cursor{writer.bytes()};
+    REQUIRE(cursor.read_be<double>().take_unchecked() == 1.5);
+    REQUIRE(cursor.read_le<float>().take_unchecked() == -2.25f);
+  }
+
+  SECTION("Unexpected End") {
+    crab::ByteCursor cursor{bytes};
+    REQUIRE(cursor.skip(6).is_ok());
+
+    auto error = cursor.read_be<u32>();
+    REQUIRE(error.is_err());
+    REQUIRE(error.take_err_unchecked().offset() == 6);
+    // a failed read consumes nothing
+    REQUIRE(cursor.offset() == 6);
+    REQUIRE(cursor.read_slice(4).is_err());
+    REQUIRE(cursor.unchecked(4).is_err());
+    REQUIRE(cursor.skip(4).is_err());
+    REQUIRE(cursor.remaining() == 3);
+    REQUIRE(crab::ByteCursor{Span<const u8>{}}.read<u8>().is_err());
+  }
+
+  SECTION("Slices") {
+    crab::ByteCursor cursor{bytes};
+    REQUIRE(cursor.skip(2).is_ok());
+    const Span<const u8> slice = cursor.read_slice(3).take_unchecked();
+    REQUIRE(slice.data() == bytes.data() + 2);
+    REQUIRE(slice.size() == 3);
+    REQUIRE(cursor.read_slice(0).take_unchecked().empty());
+    REQUIRE(cursor.offset() == 5);
+  }
+
+  SECTION("Unchecked") {
+    crab::ByteCursor cursor{bytes};
+    auto fields = cursor.unchecked(7).take_unchecked();
+    REQUIRE(cursor.offset() == 7);
+    REQUIRE(fields.read_be<u16>() == 0x0102);
+    REQUIRE(fields.read<u8>() == 0x03);
+    REQUIRE(fields.read_slice(2).size() == 2);
+    REQUIRE(fields.read_le<u16>() == 0x0706);
+    REQUIRE(fields.remaining() == 0);
+    REQUIRE(cursor.read_be<u16>().take_unchecked() == 0x0809);
+  }
+}
+
+TEST_CASE("Varints", "[bytes]") {
+  SECTION("Known Encodings") {
+    // protobuf's examples
+    REQUIRE(crab::ByteCursor{span_of({0x96, 0x01})}.read_varint().take_unchecked() == 150);
+    REQUIRE(crab::ByteCursor{span_of({0x00})}.read_varint<u32>().take_unchecked() == 0);
+    REQUIRE(crab::ByteCursor{span_of({0xac, 0x02, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff})}.read_varint<u16>()
+      .take_unchecked() == 300);
+
+    crab::ByteWriter writer;
+    writer.write_varint(u64{300});
+    REQUIRE(writer.bytes().size() == 2);
+    REQUIRE(writer.bytes()[0] == 0xac);
+    REQUIRE(writer.bytes()[1] == 0x02);
+
+    writer.clear();
+    writer.write_zigzag(i32{-1});
+    writer.write_zigzag(i32{1});
+    writer.write_zigzag(i64{-2});
+    REQUIRE(writer.take() == Vec<u8>{0x01, 0x02, 0x03});
+  }
+
+  SECTION("Overflow") {
+    // 256 does not fit a u8
+    auto too_big = crab::ByteCursor{span_of({0x80, 0x02, 0, 0, 0, 0, 0, 0, 0})}.read_varint<u8>();
+    REQUIRE(too_big.take_err_unchecked().kind() == crab::DecodeError::Kind::Overflow);
+    // 2^64 needs an 11th bit in the 10th byte
+    const Vec<u8> eleven{0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02};
+    REQUIRE(crab::ByteCursor{eleven}.read_varint().take_err_unchecked().kind() == crab::DecodeError::Kind::Overflow);
+    const Vec<u8> endless(12, 0x80);
+    REQUIRE(crab::ByteCursor{endless}.read_varint().take_err_unchecked().kind() == crab::DecodeError::Kind::Overflow);
+    // a varint cut off by the end of the input
+    const Vec<u8> truncated{0x01, 0x80, 0x80};
+    crab::ByteCursor cut{truncated};
+    REQUIRE(cut.read_varint().take_unchecked() == 1);
+    auto end = cut.read_varint();
+    REQUIRE(end.take_err_unchecked().kind() == crab::DecodeError::Kind::UnexpectedEnd);
+    REQUIRE(cut.offset() == 1);
+  }
+
+  SECTION("Round Trip") {
+    std::mt19937_64 rng{117};
+    Vec<u64> unsigned_values{0, 1, 127, 128, 16'383, 16'384, ~u64{0}, ~u64{0} >> 1, u64{1} << 56};
+    Vec<i64> signed_values{0, -1, 1, -64, 64, std::numeric_limits<i64>::min(), std::numeric_limits<i64>::max()};
+    for (usize i = 0; i < 2'000; i++) {
+      // every length of encoding
+      unsigned_values.push_back(rng() >> (rng() % 64));
+      signed_values.push_back(static_cast<i64>(rng()) >> (rng() % 64));
+    }
+
+    crab::ByteWriter writer;
+    for (usize i = 0; i < unsigned_values.size(); i++) {
+      writer.write_varint(unsigned_values[i]);
+      writer.write_zigzag(signed_values[i % signed_values.size()]);
+      writer.write_varint(static_cast<u32>(unsigned_values[i]));
+    }
+    writer.write_zigzag(std::numeric_limits<i8>::min());
+
+    crab::ByteCursor cursor{writer.bytes()};
+    for (usize i = 0; i < unsigned_values.size(); i++) {
+      REQUIRE(cursor.read_varint().take_unchecked() == unsigned_values[i]);
+      REQUIRE(cursor.read_zigzag().take_unchecked() == signed_values[i % signed_values.size()]);
+      REQUIRE(cursor.read_varint<u32>().take_unchecked() == static_cast<u32>(unsigned_values[i]));
+    }
+    REQUIRE(cursor.read_zigzag<i8>().take_unchecked() == std::numeric_limits<i8>::min());
+    REQUIRE(cursor.is_empty());
+  }
+}
+
+TEST_CASE("ByteWriter", "[bytes]") {
+  crab::ByteWriter writer{16};
+  writer.write_be(u16{0xcafe});
+  writer.write_le(u32{0xdead'beef});
+  writer.write(u8{7});
+  const Vec<u8> payload{1, 2, 3};
+  writer.write_bytes(payload);
+  REQUIRE(writer.length() == 10);
+  REQUIRE(writer.take() == Vec<u8>{0xca, 0xfe, 0xef, 0xbe, 0xad, 0xde, 7, 1, 2, 3});
+  REQUIRE(writer.length() == 0);
+
+  // growing past the initial room & writing again after clear
+  for (u32 i = 0; i < 100; i++) writer.write_le(i);
+  REQUIRE(writer.bytes().size() == 400);
+  REQUIRE(crab::ByteCursor{writer.bytes().subspan(396)}.read_le<u32>().take_unchecked() == 99);
+  writer.clear();
+  writer.write_varint(u32{5});
+  REQUIRE(writer.bytes().size() == 1);
+  REQUIRE(writer.bytes()[0] == 5);
+}
@@ -0,0 +1,28 @@
+# Fails if a crab_codegen_ function in ASSEMBLY (GNU as syntax, x86-64) branches, selects (cmov), calls or references
+# std::bad_variant_access. Run by ctest as: cmake -DASSEMBLY=<file.s> -P check.cmake
+file(STRINGS ${ASSEMBLY} lines)
+
+set(function "")
+set(checked 0)
+set(failures "")
+foreach (line IN LISTS lines)
+  if (line MATCHES "^(crab_codegen_[a-z_]+):")
+    set(function ${CMAKE_MATCH_1})
+    math(EXPR checked "${checked} + 1")
+  elseif (function AND line MATCHES "^[ \t]+\\.size[ \t]+${function},")
+    # the end of the function, after its .cold part (if any)
+    set(function "")
+  elseif (function AND line MATCHES "^[ \t]+(j[a-z]+|cmov[a-z]+|call|ud2)([ \t]|$)|bad_variant_access")
+    string(STRIP "${line}" instruction)
+    list(APPEND failures "${function}: ${instruction}")
+  endif ()
+endforeach ()
+
+if (checked EQUAL 0)
+  message(FATAL_ERROR "No crab_codegen_ functions found in ${ASSEMBLY}")
+endif ()
+if (failures)
+  list(JOIN failures "\n  " report)
+  message(FATAL_ERROR "Unchecked accessors left branches or throws in release code:\n  ${report}")
+endif ()
+message(STATUS "${checked} functions are straight line code")
@@ -0,0 +1,40 @@
+/**
+ * Compiled to assembly in release mode by the codegen test (see check.cmake), every crab_codegen_ function must be
+ * straight line code: the preconditions of the unchecked accessors are assumed, so there is nothing left to branch
+ * on, throw (std::bad_variant_access) or call.
+ */
+#include <box.hpp>
+#include <option.hpp>
+#include <result.hpp>
+
+namespace {
+  class Failure final : public crab::Error {
+  public:
+    [[nodiscard]] auto what() const -> String override { return "failure"; }
+  };
+
+  struct Left {
+    i64 left = 0;
+  };
+
+  struct Right {
+    i64 right = 0;
+  };
+
+  struct Both final : Left, Right {};
+}
+
+extern "C" {
+  auto crab_codegen_option_get(Option<i32> &option) -> i32 { return option.get_unchecked(); }
+
+  auto crab_codegen_option_take(Option<i64> &option) -> i64 { return option.take_unchecked(); }
+
+  auto crab_codegen_result_get(const Result<i32, Failure> &result) -> i32 { return result.get_unchecked(); }
+
+  auto crab_codegen_result_take(Result<i64, Failure> &result) -> i64 { return result.take_unchecked(); }
+
+  auto crab_codegen_result_get_err(Result<i32, Failure> &result) -> Failure* { return &result.get_err_unchecked(); }
+
+  // converting to the second base adjusts the pointer, which needs a null check unless the Box is known to own one
+  auto crab_codegen_box_base(Box<Both> &box) -> Right* { return box.as_ptr(); }
+}
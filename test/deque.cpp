@@ -0,0 +1,93 @@
+#include <deque.hpp>
+#include <box.hpp>
+
+#include <deque>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+
+TEST_CASE("Deque", "[deque]") {
+  SECTION("Growing While Wrapped") {
+    crab::Deque<i32> deque;
+    REQUIRE(deque.capacity() == 0);
+    REQUIRE(deque.pop_front().is_none());
+
+    for (i32 i = 0; i < 6; i++) deque.push_back(i);
+    REQUIRE(deque.pop_front().take_unchecked() == 0);
+    REQUIRE(deque.pop_front().take_unchecked() == 1);
+    for (i32 i = 6; i < 10; i++) deque.push_back(i);
+    REQUIRE(deque.capacity() == 8);
+
+    // wrapped around, the next push has to grow & unwrap
+    deque.push_back(10);
+    REQUIRE(deque.capacity() == 16);
+    REQUIRE(Vec<i32>{deque.begin(), deque.end()} == Vec<i32>{2, 3, 4, 5, 6, 7, 8, 9, 10});
+    REQUIRE(deque.as_spans().second.empty());
+  }
+
+  SECTION("Matches std::deque") {
+    std::mt19937 rng{7};
+    crab::Deque<u32> deque;
+    std::deque<u32> expected;
+
+    for (usize step = 0; step < 100'000; step++) {
+      const u32 value = rng();
+      switch (value % 5) {
+        case 0:
+          deque.push_front(value);
+          expected.push_front(value);
+          break;
+        case 1:
+        case 2:
+          deque.push_back(value);
+          expected.push_back(value);
+          break;
+        case 3: {
+          const Option<u32> popped = deque.pop_front();
+          REQUIRE(popped.is_some() == not expected.empty());
+          if (popped.is_some()) {
+            REQUIRE(popped.get_unchecked() == expected.front());
+            expected.pop_front();
+          }
+          break;
+        }
+        default: {
+          const Option<u32> popped = deque.pop_back();
+          REQUIRE(popped.is_some() == not expected.empty());
+          if (popped.is_some()) {
+            REQUIRE(popped.get_unchecked() == expected.back());
+            expected.pop_back();
+          }
+          break;
+        }
+      }
+    }
+
+    REQUIRE(deque.length() == expected.size());
+    REQUIRE(std::equal(deque.begin(), deque.end(), expected.begin(), expected.end()));
+  }
+
+  SECTION("Copy & Move") {
+    crab::Deque<String> deque{"a", "b", "c"};
+    deque.push_front("z");
+
+    const crab::Deque<String> copy = deque;
+    REQUIRE(Vec<String>{copy.begin(), copy.end()} == Vec<String>{"z", "a", "b", "c"});
+
+    crab::Deque<String> moved = std::move(deque);
+    REQUIRE(deque.is_empty());
+    REQUIRE(moved.length() == 4);
+
+    moved = copy;
+    REQUIRE(moved[0] == "z");
+    moved.clear();
+    REQUIRE(moved.is_empty());
+  }
+
+  SECTION("Move Only Elements") {
+    crab::Deque<Box<i32>> deque;
+    for (i32 i = 0; i < 100; i++) deque.push_back(crab::make_box<i32>(i));
+    for (i32 i = 0; i < 50; i++) REQUIRE(*deque.pop_front().take_unchecked() == i);
+    REQUIRE(*deque.back().take_unchecked().get_ref() == 99);
+  }
+}
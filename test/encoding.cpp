@@ -0,0 +1,269 @@
+#include <encoding.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+using crab::encoding::Base64;
+using crab::encoding::Case;
+
+namespace {
+  auto to_string(const Box<u8[]> &text) -> String {
+    return String{reinterpret_cast<const char*>(text.as_ptr()), text.length()};
+  }
+
+  auto to_vec(const Box<u8[]> &bytes) -> Vec<u8> { return Vec<u8>{bytes.as_ptr(), bytes.as_ptr() + bytes.length()}; }
+
+  auto random_bytes(std::mt19937_64 &rng, const usize len) -> Vec<u8> {
+    Vec<u8> bytes(len);
+    for (u8 &byte: bytes) byte = static_cast<u8>(rng());
+    return bytes;
+  }
+
+  using crab::encoding::DecodeError;
+  #if defined(__SSSE3__)
+  using crab::encoding::helper::Sse;
+  #endif
+  #if defined(__AVX2__)
+  using crab::encoding::helper::Avx2;
+  #endif
+
+  auto hex_decoders(const String &text) -> Result<Vec<u8>, DecodeError> {
+    const auto *data = reinterpret_cast<const u8*>(text.data());
+    Vec<u8> expected(text.size() / 2);
+    auto scalar = crab::encoding::helper::scalar_hex_decode(data, text.size(), expected.data());
+
+    // every decoder that is compiled in must agree with the scalar one, writing nothing past the decoded length
+    [[maybe_unused]] const auto check = [&](const Result<usize, DecodeError> &decoded, const Vec<u8> &out) {
+      REQUIRE(decoded.is_ok() == scalar.is_ok());
+      if (scalar.is_ok()) {
+        REQUIRE(decoded.get_unchecked() == scalar.get_unchecked());
+        REQUIRE(out == expected);
+      } else {
+        REQUIRE(decoded.get_err_unchecked().offset() == scalar.get_err_unchecked().offset());
+      }
+    };
+    #if defined(__SSSE3__)
+    Vec<u8> sse(text.size() / 2);
+    check(crab::encoding::helper::simd_hex_decode<Sse>(data, text.size(), sse.data()), sse);
+    #endif
+    #if defined(__AVX2__)
+    Vec<u8> avx2(text.size() / 2);
+    check(crab::encoding::helper::simd_hex_decode<Avx2>(data, text.size(), avx2.data()), avx2);
+    #endif
+
+    if (scalar.is_err()) return scalar.take_err_unchecked();
+    return expected;
+  }
+
+  auto base64_decoders(const String &text, const Base64 variant) -> Result<Vec<u8>, DecodeError> {
+    const auto *data = reinterpret_cast<const u8*>(text.data());
+    const usize len = crab::encoding::base64_decoded_length(text);
+    Vec<u8> expected(len);
+    auto scalar = crab::encoding::helper::scalar_base64_decode(data, text.size(), expected.data(), variant);
+
+    [[maybe_unused]] const auto check = [&](const Result<usize, DecodeError> &decoded, const Vec<u8> &out) {
+      REQUIRE(decoded.is_ok() == scalar.is_ok());
+      if (scalar.is_ok()) {
+        REQUIRE(decoded.get_unchecked() == scalar.get_unchecked());
+        REQUIRE(out == expected);
+      } else {
+        REQUIRE(decoded.get_err_unchecked().offset() == scalar.get_err_unchecked().offset());
+      }
+    };
+    #if defined(__SSSE3__)
+    Vec<u8> sse(len);
+    check(crab::encoding::helper::simd_base64_decode<Sse>(data, text.size(), sse.data(), variant), sse);
+    #endif
+    #if defined(__AVX2__)
+    Vec<u8> avx2(len);
+    check(crab::encoding::helper::simd_base64_decode<Avx2>(data, text.size(), avx2.data(), variant), avx2);
+    #endif
+
+    if (scalar.is_err()) return scalar.take_err_unchecked();
+    REQUIRE(scalar.get_unchecked() == len);
+    return expected;
+  }
+}
+
+TEST_CASE("Hex", "[encoding]") {
+  SECTION("Encode") {
+    const Vec<u8> bytes{0x00, 0x1f, 0xa0, 0xff, 0x7e};
+    REQUIRE(to_string(crab::encoding::hex_encode(bytes)) == "001fa0ff7e");
+    REQUIRE(to_string(crab::encoding::hex_encode(bytes, Case::Upper)) == "001FA0FF7E");
+    REQUIRE(to_string(crab::encoding::hex_encode(Span<const u8>{})).empty());
+
+    Vec<u8> out(crab::encoding::hex_encoded_length(bytes.size()) + 1, '.');
+    REQUIRE(crab::encoding::hex_encode(bytes, out) == 10);
+    REQUIRE(String{out.begin(), out.end()} == "001fa0ff7e.");
+  }
+
+  SECTION("Decode") {
+    const Box<u8[]> bytes = crab::encoding::hex_decode("001fA0Ff7e").take_unchecked();
+    REQUIRE(to_vec(bytes) == Vec<u8>{0x00, 0x1f, 0xa0, 0xff, 0x7e});
+    REQUIRE(crab::encoding::hex_decode("").take_unchecked().length() == 0);
+
+    Vec<u8> out(4);
+    REQUIRE(crab::encoding::hex_decode("deadbeef", out).take_unchecked() == 4);
+    REQUIRE(out == Vec<u8>{0xde, 0xad, 0xbe, 0xef});
+  }
+
+  SECTION("Invalid") {
+    REQUIRE(crab::encoding::hex_decode("00g0").take_err_unchecked().offset() == 2);
+    REQUIRE(crab::encoding::hex_decode("000 ").take_err_unchecked().offset() == 3);
+    REQUIRE(crab::encoding::hex_decode("0x12").take_err_unchecked().offset() == 1);
+    // odd length, the missing digit is at the end
+    REQUIRE(crab::encoding::hex_decode("abc").take_err_unchecked().offset() == 3);
+    // every byte that is not a digit, in each place of a SIMD block
+    for (usize c = 0; c < 256; c++) {
+      if (crab::encoding::helper::HEX_VALUES[c] != crab::encoding::helper::INVALID) continue;
+      for (usize at = 0; at < 100; at += 7) {
+        String text(100, 'a');
+        text[at] = static_cast<char>(c);
+        REQUIRE(hex_decoders(text).take_err_unchecked().offset() == at);
+      }
+    }
+  }
+
+  SECTION("Round Trips") {
+    std::mt19937_64 rng{125};
+    for (usize len = 0; len < 300; len++) {
+      const Vec<u8> bytes = random_bytes(rng, len);
+      for (const Case letters: {Case::Lower, Case::Upper}) {
+        const String text = to_string(crab::encoding::hex_encode(bytes, letters));
+        Vec<u8> expected(text.size());
+        crab::encoding::helper::scalar_hex_encode(bytes.data(), bytes.size(), expected.data(), letters);
+        REQUIRE(text == String{expected.begin(), expected.end()});
+        REQUIRE(hex_decoders(text).take_unchecked() == bytes);
+      }
+    }
+  }
+
+  SECTION("Error") {
+    const auto error = crab::encoding::hex_decode("zz").take_err_unchecked();
+    REQUIRE(error.offset() == 0);
+    REQUIRE(error.what() == "invalid encoded text at byte 0");
+  }
+}
+
+TEST_CASE("Base64", "[encoding]") {
+  const auto encode = [](const StringView text, const Base64 variant) {
+    return to_string(crab::encoding::base64_encode(crab::encoding::helper::bytes(text), variant));
+  };
+  const auto decode = [](const StringView text, const Base64 variant) {
+    const Box<u8[]> bytes = crab::encoding::base64_decode(text, variant).take_unchecked();
+    return to_string(bytes);
+  };
+
+  SECTION("RFC 4648 Vectors") {
+    const std::pair<StringView, StringView> vectors[] = {
+      {"", ""},
+      {"f", "Zg=="},
+      {"fo", "Zm8="},
+      {"foo", "Zm9v"},
+      {"foob", "Zm9vYg=="},
+      {"fooba", "Zm9vYmE="},
+      {"foobar", "Zm9vYmFy"},
+    };
+    for (const auto &[bytes, text]: vectors) {
+      REQUIRE(encode(bytes, Base64::Standard) == text);
+      REQUIRE(decode(text, Base64::Standard) == bytes);
+      // url is not padded, both decode with or without it
+      const StringView unpadded = text.substr(0, text.find('='));
+      REQUIRE(encode(bytes, Base64::Url) == unpadded);
+      REQUIRE(decode(unpadded, Base64::Standard) == bytes);
+      REQUIRE(decode(unpadded, Base64::Url) == bytes);
+      REQUIRE(decode(text, Base64::Url) == bytes);
+    }
+  }
+
+  SECTION("Alphabets") {
+    const String bytes{"\xfb\xff\xbf\xfb\xef\xbe", 6};
+    REQUIRE(encode(bytes, Base64::Standard) == "+/+/++++");
+    REQUIRE(encode(bytes, Base64::Url) == "-_-_----");
+    REQUIRE(decode("-_-_----", Base64::Url) == bytes);
+    REQUIRE(crab::encoding::base64_decode("-_-_----", Base64::Standard).take_err_unchecked().offset() == 0);
+    REQUIRE(crab::encoding::base64_decode("+/+/++++", Base64::Url).take_err_unchecked().offset() == 0);
+  }
+
+  SECTION("Lengths") {
+    for (usize len = 0; len < 10; len++) {
+      REQUIRE(crab::encoding::base64_encoded_length(len) % 4 == 0);
+      REQUIRE(crab::encoding::base64_encoded_length(len, Base64::Url) == (len * 4 + 2) / 3);
+    }
+    REQUIRE(crab::encoding::base64_decoded_length("Zm9vYg==") == 4);
+    REQUIRE(crab::encoding::base64_decoded_length("Zm9vYg") == 4);
+    REQUIRE(crab::encoding::base64_decoded_length("Zm9vYmE=") == 5);
+    REQUIRE(crab::encoding::base64_decoded_length("") == 0);
+  }
+
+  SECTION("Buffers") {
+    const Vec<u8> bytes{'h', 'i', '!', '?'};
+    Vec<u8> text(crab::encoding::base64_encoded_length(bytes.size()));
+    REQUIRE(crab::encoding::base64_encode(bytes, text) == 8);
+    REQUIRE(String{text.begin(), text.end()} == "aGkhPw==");
+
+    Vec<u8> out(crab::encoding::base64_decoded_length(text));
+    REQUIRE(crab::encoding::base64_decode(Span<const u8>{text}, out).take_unchecked() == 4);
+    REQUIRE(out == bytes);
+  }
+
+  SECTION("Invalid") {
+    const auto offset = [](const StringView text) {
+      return base64_decoders(String{text}, Base64::Standard).take_err_unchecked().offset();
+    };
+    REQUIRE(offset("Zm9v Yg==") == 4);
+    REQUIRE(offset("Zm9v\nYmFy") == 4);
+    // a single character left over encodes no whole byte
+    REQUIRE(offset("Zm9vY") == 5);
+    REQUIRE(offset("Zm9vY===") == 5);
+    REQUIRE(offset("=") == 0);
+    // padding only at the very end, & all of it
+    REQUIRE(offset("Zg==Zg==") == 4);
+    REQUIRE(offset("Zg=a") == 3);
+    REQUIRE(offset("Zg=") == 3);
+    REQUIRE(offset("Zm8==") == 4);
+    // bits past the last byte must be zero
+    REQUIRE(offset("Zh==") == 1);
+    REQUIRE(offset("Zm9=") == 2);
+    REQUIRE(offset("Zh") == 1);
+
+    for (const Base64 variant: {Base64::Standard, Base64::Url}) {
+      const auto &values = crab::encoding::helper::BASE64_VALUES[static_cast<usize>(variant)];
+      for (usize c = 0; c < 256; c++) {
+        // padding is only out of place once more text follows it
+        if (values[c] != crab::encoding::helper::INVALID or c == '=') continue;
+        for (usize at = 0; at < 100; at += 7) {
+          String text(100, 'Q');
+          text[at] = static_cast<char>(c);
+          REQUIRE(base64_decoders(text, variant).take_err_unchecked().offset() == at);
+        }
+      }
+    }
+  }
+
+  SECTION("Round Trips") {
+    std::mt19937_64 rng{125};
+    for (usize len = 0; len < 300; len++) {
+      const Vec<u8> bytes = random_bytes(rng, len);
+      for (const Base64 variant: {Base64::Standard, Base64::Url}) {
+        const String text = to_string(crab::encoding::base64_encode(bytes, variant));
+        REQUIRE(text.size() == crab::encoding::base64_encoded_length(len, variant));
+        Vec<u8> expected(text.size());
+        crab::encoding::helper::scalar_base64_encode(bytes.data(), bytes.size(), expected.data(), variant);
+        REQUIRE(text == String{expected.begin(), expected.end()});
+        REQUIRE(base64_decoders(text, variant).take_unchecked() == bytes);
+      }
+    }
+  }
+
+  SECTION("Random Corruption") {
+    std::mt19937_64 rng{125};
+    for (usize round = 0; round < 3'000; round++) {
+      const Vec<u8> bytes = random_bytes(rng, rng() % 200);
+      String text = to_string(crab::encoding::base64_encode(bytes));
+      if (text.empty()) continue;
+      for (usize flips = 1 + rng() % 3; flips > 0; flips--) text[rng() % text.size()] = static_cast<char>(rng());
+      (void) base64_decoders(text, Base64::Standard);
+    }
+  }
+}
@@ -0,0 +1,213 @@
+#include <filter.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  /**
+   * @brief Distinct keys, the first 'inserted' of them inserted & the rest only used as misses
+   */
+  auto make_keys(const usize count, const u64 seed) -> Vec<u64> {
+    std::mt19937_64 rng{seed};
+    Set<u64> unique;
+    Vec<u64> keys;
+    while (keys.size() < count) {
+      if (const u64 key = rng(); unique.insert(key).second) keys.push_back(key);
+    }
+    return keys;
+  }
+
+  template<typename Filter>
+  auto false_positive_rate(const Filter &filter, const Span<const u64> misses) -> f64 {
+    usize found = 0;
+    for (const u64 key: misses) found += filter.contains(key);
+    return static_cast<f64>(found) / static_cast<f64>(misses.size());
+  }
+}
+
+TEST_CASE("BloomFilter", "[filter]") {
+  constexpr usize INSERTED = 100'000;
+  const Vec<u64> keys = make_keys(2 * INSERTED, 121);
+  const Span<const u64> inserted = Span{keys}.first(INSERTED);
+  const Span<const u64> misses = Span{keys}.subspan(INSERTED);
+
+  SECTION("No False Negatives") {
+    crab::BloomFilter<u64> filter{INSERTED};
+    for (const u64 key: inserted) filter.insert(key);
+    for (const u64 key: inserted) REQUIRE(filter.contains(key));
+  }
+
+  SECTION("False Positive Rate") {
+    for (const f64 target: {0.1, 0.01, 0.001}) {
+      crab::BloomFilter<u64> filter{INSERTED, target};
+      for (const u64 key: inserted) filter.insert(key);
+      const f64 measured = false_positive_rate(filter, misses);
+      REQUIRE(measured < target * 1.5);
+      REQUIRE(measured > target / 4);
+    }
+
+    crab::BloomFilter<u64> empty{INSERTED};
+    REQUIRE(false_positive_rate(empty, misses) == 0);
+  }
+
+  SECTION("Strings") {
+    crab::BloomFilter<String> filter{100, 0.001};
+    for (usize i = 0; i < 100; i++) filter.insert("crab " + std::to_string(i));
+    for (usize i = 0; i < 100; i++) REQUIRE(filter.contains("crab " + std::to_string(i)));
+    REQUIRE_FALSE(filter.contains("lobster"));
+
+    filter.clear();
+    REQUIRE_FALSE(filter.contains("crab 0"));
+  }
+
+  SECTION("Bulk Contains") {
+    crab::BloomFilter<u64> filter{INSERTED};
+    for (const u64 key: inserted) filter.insert(key);
+
+    // a length that leaves a partial batch
+    const Span<const u64> probes = Span{keys}.subspan(INSERTED - 1'000, 2'003);
+    Vec<u8> found(probes.size() + 1, 2);
+    const usize count = filter.contains_many(probes, Span{reinterpret_cast<bool*>(found.data()), probes.size()});
+
+    usize expected = 0;
+    for (usize i = 0; i < probes.size(); i++) {
+      REQUIRE(static_cast<bool>(found[i]) == filter.contains(probes[i]));
+      expected += found[i];
+    }
+    REQUIRE(count == expected);
+    REQUIRE(count >= 1'000);
+    REQUIRE(found.back() == 2);
+  }
+
+  SECTION("Serialization") {
+    crab::BloomFilter<u64> filter{1'000};
+    for (const u64 key: inserted.first(1'000)) filter.insert(key);
+    const Vec<u8> bytes = filter.serialize();
+    REQUIRE(bytes.size() == 13 + filter.memory());
+
+    auto read = crab::BloomFilter<u64>::deserialize(bytes);
+    REQUIRE(read.is_ok());
+    const crab::BloomFilter<u64> copy = read.take_unchecked();
+    REQUIRE(copy.memory() == filter.memory());
+    for (const u64 key: keys) REQUIRE(copy.contains(key) == filter.contains(key));
+
+    auto truncated = crab::BloomFilter<u64>::deserialize(Span{bytes}.first(bytes.size() - 1));
+    REQUIRE(truncated.take_err_unchecked().kind() == crab::DecodeError::Kind::UnexpectedEnd);
+
+    Vec<u8> corrupted = bytes;
+    corrupted[0] = 'X';
+    auto wrong = crab::BloomFilter<u64>::deserialize(corrupted);
+    REQUIRE(wrong.take_err_unchecked().kind() == crab::DecodeError::Kind::Invalid);
+
+    auto cuckoo = crab::CuckooFilter<u64>::deserialize(bytes);
+    REQUIRE(cuckoo.take_err_unchecked().kind() == crab::DecodeError::Kind::Invalid);
+  }
+}
+
+TEST_CASE("CuckooFilter", "[filter]") {
+  constexpr usize INSERTED = 100'000;
+  const Vec<u64> keys = make_keys(2 * INSERTED, 122);
+  const Span<const u64> inserted = Span{keys}.first(INSERTED);
+  const Span<const u64> misses = Span{keys}.subspan(INSERTED);
+
+  SECTION("Insert & Remove") {
+    crab::CuckooFilter<String> filter{16};
+    REQUIRE(filter.insert("crab"));
+    REQUIRE(filter.insert("shell"));
+    REQUIRE(filter.contains("crab"));
+    REQUIRE(filter.size() == 2);
+
+    REQUIRE(filter.remove("crab"));
+    REQUIRE_FALSE(filter.contains("crab"));
+    REQUIRE(filter.contains("shell"));
+    REQUIRE_FALSE(filter.remove("crab"));
+
+    // every insert of a key is counted, one remove undoes one insert
+    REQUIRE(filter.insert("reef"));
+    REQUIRE(filter.insert("reef"));
+    REQUIRE(filter.remove("reef"));
+    REQUIRE(filter.contains("reef"));
+    REQUIRE(filter.remove("reef"));
+    REQUIRE_FALSE(filter.contains("reef"));
+    REQUIRE(filter.size() == 1);
+  }
+
+  SECTION("No False Negatives") {
+    crab::CuckooFilter<u64> filter{INSERTED};
+    for (const u64 key: inserted) REQUIRE(filter.insert(key));
+    for (const u64 key: inserted) REQUIRE(filter.contains(key));
+
+    // remove every other key, the rest must still be found
+    for (usize i = 0; i < INSERTED; i += 2) REQUIRE(filter.remove(inserted[i]));
+    for (usize i = 1; i < INSERTED; i += 2) REQUIRE(filter.contains(inserted[i]));
+    REQUIRE(filter.size() == INSERTED / 2);
+  }
+
+  SECTION("False Positive Rate") {
+    crab::CuckooFilter<u64> filter{INSERTED};
+    for (const u64 key: inserted) filter.insert(key);
+    REQUIRE(false_positive_rate(filter, misses) < crab::CuckooFilter<u64>::false_positive_rate());
+
+    crab::CuckooFilter<u64, std::hash<u64>, u8> small{INSERTED};
+    for (const u64 key: inserted) small.insert(key);
+    REQUIRE(small.memory() * 2 == filter.memory());
+    const f64 measured = false_positive_rate(small, misses);
+    REQUIRE(measured < crab::CuckooFilter<u64, std::hash<u64>, u8>::false_positive_rate());
+    REQUIRE(measured > 0.005);
+  }
+
+  SECTION("Full") {
+    crab::CuckooFilter<u64> filter{1'000};
+    usize accepted = 0;
+    while (accepted < keys.size() and filter.insert(keys[accepted])) accepted++;
+
+    REQUIRE(filter.is_full());
+    REQUIRE(accepted > filter.capacity() * 9 / 10);
+    REQUIRE(accepted == filter.size());
+    for (usize i = 0; i < accepted; i++) REQUIRE(filter.contains(keys[i]));
+
+    // freeing a slot makes room for the fingerprint that did not fit
+    REQUIRE(filter.remove(keys[0]));
+    REQUIRE_FALSE(filter.is_full());
+    for (usize i = 1; i < accepted; i++) REQUIRE(filter.contains(keys[i]));
+  }
+
+  SECTION("Bulk Contains") {
+    crab::CuckooFilter<u64> filter{INSERTED};
+    for (const u64 key: inserted) filter.insert(key);
+
+    const Span<const u64> probes = Span{keys}.subspan(INSERTED - 1'000, 2'003);
+    Vec<u8> found(probes.size());
+    const usize count = filter.contains_many(probes, Span{reinterpret_cast<bool*>(found.data()), probes.size()});
+
+    usize expected = 0;
+    for (usize i = 0; i < probes.size(); i++) {
+      REQUIRE(static_cast<bool>(found[i]) == filter.contains(probes[i]));
+      expected += found[i];
+    }
+    REQUIRE(count == expected);
+  }
+
+  SECTION("Serialization") {
+    crab::CuckooFilter<u64> filter{1'000};
+    usize accepted = 0;
+    while (filter.insert(keys[accepted])) accepted++;
+    REQUIRE(filter.is_full());
+
+    const Vec<u8> bytes = filter.serialize();
+    auto read = crab::CuckooFilter<u64>::deserialize(bytes);
+    REQUIRE(read.is_ok());
+    crab::CuckooFilter<u64> copy = read.take_unchecked();
+    REQUIRE(copy.size() == accepted);
+    REQUIRE(copy.is_full());
+    for (const u64 key: Span{keys}.first(3 * accepted)) REQUIRE(copy.contains(key) == filter.contains(key));
+    REQUIRE(copy.remove(keys[0]));
+    REQUIRE_FALSE(copy.is_full());
+
+    auto truncated = crab::CuckooFilter<u64>::deserialize(Span{bytes}.first(bytes.size() - 1));
+    REQUIRE(truncated.take_err_unchecked().kind() == crab::DecodeError::Kind::UnexpectedEnd);
+
+    auto narrower = crab::CuckooFilter<u64, std::hash<u64>, u8>::deserialize(bytes);
+    REQUIRE(narrower.take_err_unchecked().kind() == crab::DecodeError::Kind::Invalid);
+  }
+}
@@ -0,0 +1,69 @@
+#include <flat_map.hpp>
+
+#include <map>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("FlatMap", "[flat_map]") {
+  SECTION("Insert & Get") {
+    crab::FlatMap<String, i32> map;
+    REQUIRE(map.is_empty());
+    REQUIRE(map.insert("b", 2).is_none());
+    REQUIRE(map.insert("a", 1).is_none());
+    REQUIRE(map.insert("c", 3).is_none());
+    REQUIRE(map.insert("b", 20).take_unchecked() == 2);
+
+    REQUIRE(map.length() == 3);
+    REQUIRE(*map.get("b").take_unchecked() == 20);
+    REQUIRE(map.get("d").is_none());
+
+    *map.get_mut("a").take_unchecked() = 10;
+    REQUIRE(map.values()[0] == 10);
+    REQUIRE(map.keys()[2] == "c");
+
+    REQUIRE(map.remove("a").take_unchecked() == 10);
+    REQUIRE(map.remove("a").is_none());
+    REQUIRE(map.keys().front() == "b");
+  }
+
+  SECTION("Batch insert matches std::map") {
+    std::mt19937 rng{7};
+    crab::FlatMap<u32, u32> map;
+    std::map<u32, u32> expected;
+
+    for (usize round = 0; round < 10; round++) {
+      Vec<std::pair<u32, u32>> batch;
+      for (u32 i = 0; i < 50; i++) {
+        const u32 key = rng() % 200;
+        batch.emplace_back(key, i + static_cast<u32>(round) * 100);
+        expected[key] = i + static_cast<u32>(round) * 100;
+      }
+      map.insert_batch(std::move(batch));
+    }
+
+    REQUIRE(map.length() == expected.size());
+    auto it = expected.begin();
+    for (const auto [key, value]: map) {
+      REQUIRE(key == it->first);
+      REQUIRE(value == it->second);
+      ++it;
+    }
+
+    for (u32 key = 0; key < 200; key++) {
+      REQUIRE(map.contains(key) == expected.contains(key));
+    }
+  }
+}
+
+TEST_CASE("FlatSet", "[flat_map]") {
+  crab::FlatSet<i64> set{5, -3, 9, 5};
+  REQUIRE(set.length() == 3);
+  REQUIRE(set.contains(-3));
+  REQUIRE_FALSE(set.insert(9));
+  REQUIRE(set.insert(0));
+  REQUIRE(set.remove(5));
+
+  set.insert_batch({100, -3, 50});
+  REQUIRE(Vec<i64>{set.begin(), set.end()} == Vec<i64>{-3, 0, 9, 50, 100});
+  REQUIRE(set.as_span().size() == 5);
+}
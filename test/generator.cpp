@@ -0,0 +1,134 @@
+#include <box.hpp>
+#include <generator.hpp>
+
+#include <ranges>
+#include <stdexcept>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  auto iota(const u32 max) -> crab::Generator<u32> {
+    for (u32 i = 0; i < max; i++) co_yield i;
+  }
+
+  auto naturals() -> crab::Generator<u64> {
+    for (u64 i = 0;; i++) co_yield i;
+  }
+
+  auto elements(const Vec<String> &strings) -> crab::Generator<const String&> {
+    for (const String &string: strings) co_yield string;
+  }
+
+  auto elements_mut(Vec<String> &strings) -> crab::Generator<String&> {
+    for (String &string: strings) co_yield string;
+  }
+
+  auto boxes(const i32 count) -> crab::Generator<Box<i32>> {
+    for (i32 i = 0; i < count; i++) co_yield crab::make_box<i32>(i);
+  }
+
+  auto throws_after(const u32 count) -> crab::Generator<u32> {
+    for (u32 i = 0; i < count; i++) co_yield i;
+    throw std::runtime_error{"done"};
+  }
+
+  struct Tracked {
+    usize *alive;
+
+    explicit Tracked(usize *alive) : alive{alive} { ++*alive; }
+
+    ~Tracked() { --*alive; }
+  };
+
+  auto tracked(usize *alive) -> crab::Generator<u32> {
+    const Tracked guard{alive};
+    for (u32 i = 0;; i++) co_yield i;
+  }
+}
+
+static_assert(std::ranges::input_range<crab::Generator<u32>>);
+static_assert(std::ranges::view<crab::Generator<u32>>);
+static_assert(std::ranges::input_range<crab::Generator<const String&>>);
+
+TEST_CASE("Generator", "[generator]") {
+  SECTION("Range For") {
+    Vec<u32> values;
+    for (const u32 value: iota(5)) values.push_back(value);
+    REQUIRE(values == Vec<u32>{0, 1, 2, 3, 4});
+
+    usize count = 0;
+    for ([[maybe_unused]] const u32 value: iota(0)) count++;
+    REQUIRE(count == 0);
+  }
+
+  SECTION("Next") {
+    auto generator = iota(2);
+    REQUIRE(generator.next().take_unchecked() == 0);
+    REQUIRE(generator.next().take_unchecked() == 1);
+    REQUIRE(generator.next().is_none());
+    REQUIRE(generator.is_done());
+    REQUIRE(generator.next().is_none());
+  }
+
+  SECTION("Ranges Adaptors") {
+    Vec<u64> squares;
+    for (const u64 value: naturals()
+      | std::views::filter([](const u64 i) { return i % 2 == 1; })
+      | std::views::transform([](const u64 i) { return i * i; })
+      | std::views::take(4)) {
+      squares.push_back(value);
+    }
+    REQUIRE(squares == Vec<u64>{1, 9, 25, 49});
+  }
+
+  SECTION("References Are Not Copied") {
+    Vec<String> strings{"a", "bb", "ccc"};
+
+    usize i = 0;
+    for (const String &string: elements(strings)) REQUIRE(&string == &strings[i++]);
+    REQUIRE(i == 3);
+
+    auto generator = elements(strings);
+    const Ref<String> first = generator.next().take_unchecked();
+    REQUIRE(first.as_ptr() == &strings[0]);
+
+    for (String &string: elements_mut(strings)) string += "!";
+    REQUIRE(strings == Vec<String>{"a!", "bb!", "ccc!"});
+
+    auto mutable_generator = elements_mut(strings);
+    RefMut<String> second = mutable_generator.next().take_unchecked();
+    *second = "x";
+    REQUIRE(strings[0] == "x");
+  }
+
+  SECTION("Move Only Values") {
+    auto generator = boxes(3);
+    i32 expected = 0;
+    while (auto box = generator.next()) REQUIRE(*box.take_unchecked() == expected++);
+    REQUIRE(expected == 3);
+
+    Vec<Box<i32>> collected;
+    for (Box<i32> &&box: boxes(2)) collected.push_back(std::move(box));
+    REQUIRE(*collected[1] == 1);
+  }
+
+  SECTION("Exceptions Propagate") {
+    auto generator = throws_after(2);
+    REQUIRE(generator.next().take_unchecked() == 0);
+    REQUIRE(generator.next().take_unchecked() == 1);
+    REQUIRE_THROWS_AS(generator.next(), std::runtime_error);
+    REQUIRE(generator.is_done());
+  }
+
+  SECTION("Abandoned Generators Clean Up") {
+    usize alive = 0;
+    {
+      auto generator = tracked(&alive);
+      REQUIRE(generator.next().take_unchecked() == 0);
+      REQUIRE(alive == 1);
+
+      crab::Generator<u32> moved = std::move(generator);
+      REQUIRE(moved.next().take_unchecked() == 1);
+    }
+    REQUIRE(alive == 0);
+  }
+}
@@ -0,0 +1,216 @@
+#include <heap.hpp>
+
+#include <box.hpp>
+#include <queue>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  using MinQueue = std::priority_queue<u64, Vec<u64>, std::greater<>>;
+
+  /**
+   * @brief Random pushes & pops, checked against std::priority_queue
+   */
+  template<usize D>
+  auto check_against_std(const u64 seed) -> void {
+    std::mt19937_64 rng{seed};
+    crab::DaryHeap<u64, D> heap;
+    MinQueue expected;
+    for (usize i = 0; i < 20'000; i++) {
+      if (rng() % 3 != 0) {
+        const u64 value = rng() % 1'000;
+        heap.push(value);
+        expected.push(value);
+      } else if (not expected.empty()) {
+        REQUIRE(heap.peek().take_unchecked() == expected.top());
+        REQUIRE(heap.pop().take_unchecked() == expected.top());
+        expected.pop();
+      }
+      REQUIRE(heap.size() == expected.size());
+    }
+    while (not expected.empty()) {
+      REQUIRE(heap.pop().take_unchecked() == expected.top());
+      expected.pop();
+    }
+    REQUIRE(heap.pop().is_none());
+  }
+
+  /**
+   * @brief Random graph as adjacency lists of (vertex, weight)
+   */
+  auto make_graph(const usize vertices, const usize degree, const u64 seed) -> Vec<Vec<std::pair<u32, u32>>> {
+    std::mt19937_64 rng{seed};
+    Vec<Vec<std::pair<u32, u32>>> edges(vertices);
+    for (auto &out: edges) {
+      for (usize i = 0; i < degree; i++) out.emplace_back(rng() % vertices, 1 + rng() % 100);
+    }
+    return edges;
+  }
+}
+
+TEST_CASE("DaryHeap", "[heap]") {
+  SECTION("Order") {
+    check_against_std<2>(1);
+    check_against_std<4>(2);
+    check_against_std<8>(3);
+    check_against_std<5>(4);
+  }
+
+  SECTION("Empty") {
+    crab::DaryHeap<i32> heap;
+    REQUIRE(heap.is_empty());
+    REQUIRE(heap.peek().is_none());
+    REQUIRE(heap.pop().is_none());
+
+    heap.push(1);
+    heap.clear();
+    REQUIRE(heap.pop().is_none());
+  }
+
+  SECTION("Compare") {
+    crab::DaryHeap<String, 4, std::greater<>> heap;
+    for (const char *word: {"crab", "shell", "reef", "claw"}) heap.push(word);
+    REQUIRE(heap.pop().take_unchecked() == "shell");
+    REQUIRE(heap.pop().take_unchecked() == "reef");
+    REQUIRE(heap.pop().take_unchecked() == "crab");
+    REQUIRE(heap.pop().take_unchecked() == "claw");
+  }
+
+  SECTION("Move Only") {
+    constexpr auto by_value = [](const Box<i32> &a, const Box<i32> &b) { return *a < *b; };
+    crab::DaryHeap<Box<i32>, 4, decltype(by_value)> heap{by_value};
+    for (const i32 value: {5, 3, 9, 1}) heap.push(crab::make_box<i32>(value));
+    REQUIRE(*heap.pop().take_unchecked() == 1);
+    REQUIRE(*heap.pop().take_unchecked() == 3);
+    REQUIRE(heap.size() == 2);
+  }
+
+  SECTION("Children On A Cache Line") {
+    crab::heap::helper::ChildAlignedAllocator<u64> eight;
+    u64 *words = eight.allocate(100);
+    // children of the root, then of node 1 & so on, start lines when D * 8 bytes is one
+    REQUIRE(reinterpret_cast<uptr>(words + 1) % crab::heap::CACHE_LINE == 0);
+    REQUIRE(reinterpret_cast<uptr>(words + 8 * 1 + 1) % crab::heap::CACHE_LINE == 0);
+    eight.deallocate(words, 100);
+
+    crab::heap::helper::ChildAlignedAllocator<std::pair<u64, u64>> sixteen;
+    auto *pairs = sixteen.allocate(100);
+    REQUIRE(reinterpret_cast<uptr>(pairs + 4 * 3 + 1) % crab::heap::CACHE_LINE == 0);
+    sixteen.deallocate(pairs, 100);
+  }
+}
+
+TEST_CASE("IndexedDaryHeap", "[heap]") {
+  SECTION("Decrease Key") {
+    crab::IndexedDaryHeap<u32> heap{10};
+    for (usize id = 0; id < 10; id++) heap.push(id, static_cast<u32>(100 + id));
+    REQUIRE(heap.contains(7));
+    REQUIRE(*heap.priority(7).take_unchecked() == 107);
+
+    heap.decrease_key(7, 1);
+    heap.decrease_key(3, 2);
+    REQUIRE_FALSE(heap.push_or_decrease(5, 200));
+    REQUIRE(heap.push_or_decrease(5, 3));
+
+    REQUIRE(heap.pop().take_unchecked() == std::pair<usize, u32>{7, 1});
+    REQUIRE(heap.pop().take_unchecked() == std::pair<usize, u32>{3, 2});
+    REQUIRE(heap.pop().take_unchecked() == std::pair<usize, u32>{5, 3});
+    REQUIRE_FALSE(heap.contains(7));
+    REQUIRE(heap.priority(7).is_none());
+
+    // popped ids can come back
+    REQUIRE(heap.push_or_decrease(7, 0));
+    REQUIRE(heap.pop().take_unchecked().first == 7);
+
+    heap.clear();
+    REQUIRE(heap.is_empty());
+    REQUIRE_FALSE(heap.contains(0));
+    REQUIRE(heap.pop().is_none());
+  }
+
+  SECTION("Dijkstra") {
+    constexpr usize VERTICES = 2'000;
+    const auto edges = make_graph(VERTICES, 6, 122);
+
+    // reference: lazy deletion over std::priority_queue
+    Vec<u64> expected(VERTICES, std::numeric_limits<u64>::max());
+    std::priority_queue<std::pair<u64, u32>, Vec<std::pair<u64, u32>>, std::greater<>> queue;
+    expected[0] = 0;
+    queue.emplace(0, 0);
+    while (not queue.empty()) {
+      const auto [distance, vertex] = queue.top();
+      queue.pop();
+      if (distance != expected[vertex]) continue;
+      for (const auto &[to, weight]: edges[vertex]) {
+        if (distance + weight < expected[to]) queue.emplace(expected[to] = distance + weight, to);
+      }
+    }
+
+    Vec<u64> distances(VERTICES, std::numeric_limits<u64>::max());
+    Vec<bool> done(VERTICES);
+    crab::IndexedDaryHeap<u64> frontier{VERTICES};
+    frontier.push(0, 0);
+    for (auto next = frontier.pop(); next.is_some(); next = frontier.pop()) {
+      const auto [vertex, distance] = next.take_unchecked();
+      REQUIRE_FALSE(done[vertex]);
+      done[vertex] = true;
+      distances[vertex] = distance;
+      for (const auto &[to, weight]: edges[vertex]) {
+        if (not done[to]) frontier.push_or_decrease(to, distance + weight);
+      }
+    }
+    REQUIRE(distances == expected);
+  }
+}
+
+TEST_CASE("RadixHeap", "[heap]") {
+  SECTION("Monotone Workload") {
+    std::mt19937_64 rng{123};
+    crab::RadixHeap<u64, u32> heap;
+    MinQueue expected;
+    u64 now = 0;
+    for (u32 i = 0; i < 20'000; i++) {
+      if (rng() % 3 != 0) {
+        // any key not before the last one popped, at times far ahead
+        const u64 key = now + (rng() % 8 == 0 ? rng() >> 4 : rng() % 1'000);
+        heap.push(key, i);
+        expected.push(key);
+      } else if (not expected.empty()) {
+        const auto [key, value] = heap.pop().take_unchecked();
+        REQUIRE(key == expected.top());
+        expected.pop();
+        now = key;
+        REQUIRE(heap.minimum() == now);
+      }
+      REQUIRE(heap.size() == expected.size());
+    }
+    while (not expected.empty()) {
+      REQUIRE(heap.pop().take_unchecked().first == expected.top());
+      expected.pop();
+    }
+    REQUIRE(heap.pop().is_none());
+  }
+
+  SECTION("Values") {
+    crab::RadixHeap<u32, String> heap;
+    heap.push(30, "late");
+    heap.push(10, "early");
+    heap.push(20, "middle");
+    REQUIRE(heap.pop().take_unchecked().second == "early");
+    heap.push(10, "now");
+    REQUIRE(heap.pop().take_unchecked() == std::pair<u32, String>{10, "now"});
+    REQUIRE(heap.pop().take_unchecked().second == "middle");
+    REQUIRE(heap.pop().take_unchecked().second == "late");
+    REQUIRE(heap.is_empty());
+
+    heap.clear();
+    heap.push(0, "again");
+    REQUIRE(heap.pop().take_unchecked().second == "again");
+  }
+
+  SECTION("Full Key Range") {
+    crab::RadixHeap<u8> heap;
+    for (const u8 key: {255, 0, 128, 127, 1}) heap.push(key);
+    for (const u8 key: {0, 1, 127, 128, 255}) REQUIRE(heap.pop().take_unchecked().first == key);
+  }
+}
@@ -0,0 +1,132 @@
+#include <incremental.hpp>
+
+#include <stdexcept>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("incremental::Database", "[incremental]") {
+  crab::incremental::Database db;
+
+  SECTION("Memoization") {
+    const auto a = db.input<i32>(2);
+    const auto b = db.input<i32>(3);
+    const auto sum = db.query<u8>([=](u8) { return *a.get() + *b.get(); });
+
+    REQUIRE(*sum(0) == 5);
+    REQUIRE(*sum(0) == 5);
+    REQUIRE(sum.executions() == 1);
+
+    a.set(10);
+    REQUIRE(*sum(0) == 13);
+    REQUIRE(sum.executions() == 2);
+
+    // an equal value is not a change
+    const auto revision = db.revision();
+    b.set(3);
+    REQUIRE(db.revision() == revision);
+    REQUIRE(*sum(0) == 13);
+    REQUIRE(sum.executions() == 2);
+  }
+
+  SECTION("Keys") {
+    const auto base = db.input<i32>(100);
+    const auto offset = db.query<i32>([=](const i32 key) { return *base.get() + key; });
+    REQUIRE(*offset(1) == 101);
+    REQUIRE(*offset(2) == 102);
+    REQUIRE(*offset(1) == 101);
+    REQUIRE(offset.executions() == 2);
+  }
+
+  SECTION("Only The Affected Subgraph") {
+    Vec<crab::incremental::Input<i64>> values;
+    for (i64 i = 0; i < 100; i++) values.push_back(db.input<i64>(i));
+    const auto square = db.query<usize>([=](const usize i) { return *values[i].get() * *values[i].get(); });
+    const auto total = db.query<u8>([=](u8) {
+      i64 sum = 0;
+      for (usize i = 0; i < values.size(); i++) sum += *square(i);
+      return sum;
+    });
+
+    REQUIRE(*total(0) == 328'350);
+    REQUIRE(square.executions() == 100);
+
+    values[7].set(-7);
+    // (-7)^2 == 7^2, total is verified without running again
+    REQUIRE(*total(0) == 328'350);
+    REQUIRE(square.executions() == 101);
+    REQUIRE(total.executions() == 1);
+
+    values[7].set(8);
+    REQUIRE(*total(0) == 328'350 - 49 + 64);
+    REQUIRE(square.executions() == 102);
+    REQUIRE(total.executions() == 2);
+  }
+
+  SECTION("Early Cutoff") {
+    const auto text = db.input<String>("crab");
+    const auto length = db.query<u8>([=](u8) { return text.get()->size(); });
+    const auto doubled = db.query<u8>([=](u8) { return *length(0) * 2; });
+
+    const Rc<usize> first = doubled(0);
+    REQUIRE(*first == 8);
+
+    text.set("reef");
+    const Rc<usize> second = doubled(0);
+    REQUIRE(length.executions() == 2);
+    REQUIRE(doubled.executions() == 1);
+    // an unchanged value keeps its allocation
+    REQUIRE(first.raw_ptr() == second.raw_ptr());
+
+    text.set("shell");
+    REQUIRE(*doubled(0) == 10);
+    REQUIRE(doubled.executions() == 2);
+  }
+
+  SECTION("Dynamic Dependencies") {
+    const auto use_left = db.input<bool>(true);
+    const auto left = db.input<i32>(1);
+    const auto right = db.input<i32>(2);
+    const auto pick = db.query<u8>([=](u8) { return *use_left.get() ? *left.get() : *right.get(); });
+
+    REQUIRE(*pick(0) == 1);
+    right.set(20);
+    REQUIRE(*pick(0) == 1);
+    REQUIRE(pick.executions() == 1);
+
+    use_left.set(false);
+    REQUIRE(*pick(0) == 20);
+    left.set(10);
+    REQUIRE(*pick(0) == 20);
+    REQUIRE(pick.executions() == 2);
+  }
+
+  SECTION("Deep Chains") {
+    const auto seed = db.input<u64>(1);
+    // the query refers to itself through a handle declared before it exists
+    Option<crab::incremental::Query<u32, u64>> chain;
+    chain = db.query<u32>([&](const u32 depth) -> u64 {
+      return depth == 0 ? *seed.get() : *chain.get_unchecked()(depth - 1) + 1;
+    });
+
+    REQUIRE(*chain.get_unchecked()(1'000) == 1'001);
+    seed.set(5);
+    REQUIRE(*chain.get_unchecked()(1'000) == 1'005);
+    REQUIRE(chain.get_unchecked().executions() == 2'002);
+  }
+
+  SECTION("Throwing Queries") {
+    const auto input = db.input<i32>(-1);
+    const auto checked = db.query<u8>([=](u8) {
+      if (*input.get() < 0) throw std::invalid_argument{"negative"};
+      return *input.get();
+    });
+    const auto doubled = db.query<u8>([=](u8) { return *checked(0) * 2; });
+
+    REQUIRE_THROWS_AS(doubled(0), std::invalid_argument);
+    // neither query is left half computed, so the database takes new inputs & recomputes both
+    REQUIRE_THROWS_AS(doubled(0), std::invalid_argument);
+    input.set(21);
+    REQUIRE(*doubled(0) == 42);
+    REQUIRE(*checked(0) == 21);
+    REQUIRE(checked.executions() == 1);
+  }
+}
@@ -0,0 +1,220 @@
+#include <ipc.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  using crab::ipc::IpcError;
+
+  auto bytes_of(const StringView text) -> Span<const u8> {
+    return {reinterpret_cast<const u8*>(text.data()), text.size()};
+  }
+
+  auto text_of(const Span<const u8> bytes) -> StringView {
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+  }
+
+  template<typename T>
+  auto error_kind(Result<T, IpcError> result) -> IpcError::Kind {
+    return result.take_err_unchecked().kind();
+  }
+}
+
+TEST_CASE("ipc::Channel", "[ipc]") {
+  SECTION("Send & Receive") {
+    const auto channel = crab::ipc::Channel::anonymous(0).take_unchecked();
+    REQUIRE(channel.capacity() == crab::ipc::MIN_CAPACITY);
+
+    const crab::ipc::Producer producer = channel.producer();
+    crab::ipc::Consumer consumer = channel.consumer();
+    REQUIRE(error_kind(consumer.try_receive()) == IpcError::Kind::Empty);
+
+    REQUIRE(producer.send(bytes_of("hello")).is_ok());
+    REQUIRE(producer.send(bytes_of("")).is_ok());
+
+    {
+      auto reservation = producer.reserve(5).take_unchecked();
+      std::memcpy(reservation.bytes().data(), "world", 5);
+      reservation.commit();
+    }
+
+    // abandoned reservations are skipped
+    (void) producer.reserve(100).take_unchecked();
+
+    REQUIRE(text_of(consumer.receive().take_unchecked().bytes()) == "hello");
+    REQUIRE(consumer.receive().take_unchecked().bytes().empty());
+    REQUIRE(text_of(consumer.try_receive().take_unchecked().bytes()) == "world");
+    REQUIRE(error_kind(consumer.try_receive()) == IpcError::Kind::Empty);
+  }
+
+  SECTION("Wrap Around, Held Messages & Full") {
+    const auto channel = crab::ipc::Channel::anonymous(4096).take_unchecked();
+    const crab::ipc::Producer producer = channel.producer();
+    crab::ipc::Consumer consumer = channel.consumer();
+
+    REQUIRE(error_kind(producer.try_reserve(channel.max_message_size() + 1)) == IpcError::Kind::TooLarge);
+
+    std::mt19937 rng{12};
+    u32 sent = 0, received = 0;
+    for (usize round = 0; round < 2'000; round++) {
+      // a burst until the ring is full
+      while (true) {
+        const usize size = sizeof(u32) + 1 + rng() % 600;
+        auto reservation = producer.try_reserve(size);
+        if (reservation.is_err()) {
+          REQUIRE(reservation.get_err_unchecked().kind() == IpcError::Kind::Full);
+          break;
+        }
+        auto reserved = reservation.take_unchecked();
+        std::memset(reserved.bytes().data(), static_cast<i32>(sent & 0xff), size);
+        std::memcpy(reserved.bytes().data(), &sent, sizeof(u32));
+        reserved.commit();
+        sent++;
+        if (rng() % 4 == 0) break;
+      }
+
+      // hold a few messages at once before dropping them in order
+      Vec<crab::ipc::Message> held;
+      while (held.size() < 3) {
+        auto message = consumer.try_receive();
+        if (message.is_err()) break;
+        held.push_back(message.take_unchecked());
+      }
+
+      for (crab::ipc::Message &held_message: held) {
+        const crab::ipc::Message message = std::move(held_message);
+        u32 sequence;
+        std::memcpy(&sequence, message.bytes().data(), sizeof(u32));
+        REQUIRE(sequence == received);
+        REQUIRE(message.bytes().back() == (received & 0xff));
+        received++;
+      }
+    }
+
+    while (consumer.try_receive().is_ok()) received++;
+    REQUIRE(received == sent);
+    REQUIRE(sent > 2'000);
+  }
+
+  SECTION("Abandoned Reservations") {
+    const auto channel = crab::ipc::Channel::anonymous(4096).take_unchecked();
+    const crab::ipc::Producer producer = channel.producer();
+    crab::ipc::Consumer consumer = channel.consumer();
+
+    // polling the consumer gives the space of dropped reservations back, without any message in between
+    for (usize i = 0; i < 4 * channel.capacity() / 64; i++) {
+      if (producer.try_reserve(64).is_ok()) continue;
+
+      REQUIRE(error_kind(producer.try_reserve(64)) == IpcError::Kind::Full);
+      REQUIRE(error_kind(consumer.try_receive()) == IpcError::Kind::Empty);
+      REQUIRE(producer.try_reserve(64).is_ok());
+    }
+
+    // a ring that is nothing but skipped records
+    while (producer.try_reserve(channel.max_message_size()).is_ok()) {}
+    REQUIRE(error_kind(consumer.try_receive()) == IpcError::Kind::Empty);
+
+    REQUIRE(producer.send(bytes_of("still flowing")).is_ok());
+    REQUIRE(text_of(consumer.try_receive().take_unchecked().bytes()) == "still flowing");
+  }
+
+  SECTION("Close") {
+    const auto channel = crab::ipc::Channel::anonymous(0).take_unchecked();
+    crab::ipc::Consumer consumer = channel.consumer();
+
+    REQUIRE(channel.producer().send(bytes_of("last")).is_ok());
+    channel.close();
+    REQUIRE(channel.is_closed());
+
+    REQUIRE(error_kind(channel.producer().send(bytes_of("late"))) == IpcError::Kind::Closed);
+    REQUIRE(text_of(consumer.receive().take_unchecked().bytes()) == "last");
+    REQUIRE(error_kind(consumer.receive()) == IpcError::Kind::Closed);
+  }
+
+  SECTION("Named") {
+    const String name = "/crab-ipc-test-" + std::to_string(::getpid());
+    const auto created = crab::ipc::Channel::create(name, 10'000).take_unchecked();
+    REQUIRE(created.capacity() == 16'384);
+    REQUIRE(error_kind(crab::ipc::Channel::create(name, 10'000)) == IpcError::Kind::System);
+
+    // a second mapping of the same memory
+    const auto opened = crab::ipc::Channel::open(name).take_unchecked();
+    REQUIRE(crab::ipc::Channel::unlink(name).is_ok());
+    REQUIRE(error_kind(crab::ipc::Channel::open(name)) == IpcError::Kind::System);
+
+    REQUIRE(created.producer().send(bytes_of("across")).is_ok());
+    REQUIRE(text_of(opened.consumer().receive().take_unchecked().bytes()) == "across");
+  }
+
+  SECTION("Many Producer Threads") {
+    constexpr u32 THREADS = 4;
+    constexpr u32 PER_THREAD = 20'000;
+
+    const auto channel = crab::ipc::Channel::anonymous(1 << 14).take_unchecked();
+    std::atomic<u32> failures{0};
+    Vec<std::thread> producers;
+    for (u32 thread = 0; thread < THREADS; thread++) {
+      producers.emplace_back([&channel, &failures, thread] {
+        const crab::ipc::Producer producer = channel.producer();
+        for (u32 i = 0; i < PER_THREAD; i++) {
+          const u32 message[2]{thread, i};
+          if (producer.send({reinterpret_cast<const u8*>(message), sizeof(message)}).is_err()) failures++;
+        }
+      });
+    }
+
+    crab::ipc::Consumer consumer = channel.consumer();
+    Vec<u32> next(THREADS, 0);
+    for (u32 i = 0; i < THREADS * PER_THREAD; i++) {
+      const auto message = consumer.receive().take_unchecked();
+      u32 payload[2];
+      std::memcpy(payload, message.bytes().data(), sizeof(payload));
+      // per producer order is kept
+      REQUIRE(payload[1] == next[payload[0]]++);
+    }
+
+    for (std::thread &thread: producers) thread.join();
+    REQUIRE(failures == 0);
+    REQUIRE(error_kind(consumer.try_receive()) == IpcError::Kind::Empty);
+  }
+
+  SECTION("Across Processes") {
+    constexpr u32 COUNT = 50'000;
+    const auto channel = crab::ipc::Channel::anonymous(1 << 12).take_unchecked();
+
+    const pid_t child = ::fork();
+    REQUIRE(child >= 0);
+    if (child == 0) {
+      const crab::ipc::Producer producer = channel.producer();
+      for (u32 i = 0; i < COUNT; i++) {
+        if (producer.send({reinterpret_cast<const u8*>(&i), sizeof(i)}).is_err()) ::_exit(1);
+      }
+      channel.close();
+      ::_exit(0);
+    }
+
+    crab::ipc::Consumer consumer = channel.consumer();
+    u32 expected = 0;
+    while (true) {
+      auto message = consumer.receive();
+      if (message.is_err()) {
+        REQUIRE(message.get_err_unchecked().kind() == IpcError::Kind::Closed);
+        break;
+      }
+      u32 value;
+      std::memcpy(&value, message.get_unchecked().bytes().data(), sizeof(value));
+      REQUIRE(value == expected++);
+    }
+    REQUIRE(expected == COUNT);
+
+    i32 status = 0;
+    REQUIRE(::waitpid(child, &status, 0) == child);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+  }
+}
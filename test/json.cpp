@@ -0,0 +1,290 @@
+#include <json.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  using Kind = crab::json::JsonError::Kind;
+  using Type = crab::json::Value::Type;
+
+  auto parsed(const StringView text) -> crab::json::Document { return crab::json::parse(text).take_unchecked(); }
+
+  auto error_of(const StringView text) -> crab::json::JsonError { return crab::json::parse(text).take_err_unchecked(); }
+
+  /**
+   * @brief Random document tree, serialised with random whitespace & escapes
+   */
+  struct Node {
+    Type type = Type::Null;
+    i64 number = 0;
+    String text;
+    Vec<String> keys;
+    Vec<Node> children;
+  };
+
+  auto random_string(std::mt19937_64 &rng) -> String {
+    constexpr StringView pieces[]{"a", "crab", "\"", "\\", "/", "\n", "\t", "é", "🦀", " ", "{", "]", ":", ","};
+    String text;
+    for (usize i = rng() % (rng() % 4 == 0 ? 80 : 6); i > 0; i--) text += pieces[rng() % std::size(pieces)];
+    return text;
+  }
+
+  auto random_node(std::mt19937_64 &rng, const u32 depth) -> Node {
+    Node node;
+    switch (depth == 0 ? rng() % 4 : rng() % 6) {
+      case 0: node.type = rng() % 2 == 0 ? Type::Null : Type::Bool;
+        node.number = static_cast<i64>(rng() % 2);
+        break;
+      case 1: node.type = Type::Number;
+        node.number = static_cast<i64>(rng()) >> (rng() % 64);
+        break;
+      case 2:
+      case 3: node.type = Type::String;
+        node.text = random_string(rng);
+        break;
+      case 4: node.type = Type::Array;
+        for (usize i = rng() % 5; i > 0; i--) node.children.push_back(random_node(rng, depth - 1));
+        break;
+      default: node.type = Type::Object;
+        for (usize i = rng() % 5; i > 0; i--) {
+          node.keys.push_back("k" + std::to_string(i) + (rng() % 3 == 0 ? random_string(rng) : ""));
+          node.children.push_back(random_node(rng, depth - 1));
+        }
+    }
+    return node;
+  }
+
+  auto write_string(std::mt19937_64 &rng, const String &text, String &out) -> void {
+    out += '"';
+    for (const char c: text) {
+      if (c == '"' or c == '\\') {
+        out += '\\';
+        out += c;
+      } else if (c == '\n') {
+        out += rng() % 2 == 0 ? "\\n" : "\\u000a";
+      } else if (c == '\t') {
+        out += "\\t";
+      } else if (c == '/' and rng() % 2 == 0) {
+        out += "\\/";
+      } else {
+        out += c;
+      }
+    }
+    out += '"';
+  }
+
+  auto write(std::mt19937_64 &rng, const Node &node, String &out) -> void {
+    const auto space = [&] { out.append(rng() % 3 == 0 ? rng() % 70 : 0, " \n\t\r"[rng() % 4]); };
+    space();
+    switch (node.type) {
+      case Type::Null: out += "null";
+        break;
+      case Type::Bool: out += node.number == 1 ? "true" : "false";
+        break;
+      case Type::Number: out += std::to_string(node.number);
+        break;
+      case Type::String: write_string(rng, node.text, out);
+        break;
+      case Type::Array:
+        out += '[';
+        for (usize i = 0; i < node.children.size(); i++) {
+          if (i > 0) out += ',';
+          write(rng, node.children[i], out);
+        }
+        space();
+        out += ']';
+        break;
+      case Type::Object:
+        out += '{';
+        for (usize i = 0; i < node.children.size(); i++) {
+          if (i > 0) out += ',';
+          space();
+          write_string(rng, node.keys[i], out);
+          space();
+          out += ':';
+          write(rng, node.children[i], out);
+        }
+        space();
+        out += '}';
+        break;
+    }
+    space();
+  }
+
+  auto check(const crab::json::Value value, const Node &node) -> void {
+    REQUIRE(value.type() == node.type);
+    switch (node.type) {
+      case Type::Null: break;
+      case Type::Bool: REQUIRE(value.as_bool().take_unchecked() == (node.number == 1));
+        break;
+      case Type::Number: REQUIRE(value.as<i64>().take_unchecked() == node.number);
+        break;
+      case Type::String: REQUIRE(value.as_string().take_unchecked() == node.text);
+        break;
+      case Type::Array: {
+        REQUIRE(value.length() == node.children.size());
+        usize i = 0;
+        for (const crab::json::Value element: value.elements()) check(element, node.children[i++]);
+        break;
+      }
+      case Type::Object: {
+        REQUIRE(value.length() == node.children.size());
+        usize i = 0;
+        for (const crab::json::Member member: value.members()) {
+          // keys were written with escapes, the raw key only matches when there are none
+          if (node.keys[i].find_first_of("\"\\\n\t/") == String::npos) {
+            REQUIRE(member.key == node.keys[i]);
+            check(value[node.keys[i]].take_unchecked(), node.children[i]);
+          }
+          check(member.value, node.children[i++]);
+        }
+        break;
+      }
+    }
+  }
+}
+
+TEST_CASE("json navigation", "[json]") {
+  const auto document = parsed(R"( {
+    "name": "crab", "legs": 10, "weight": -1.5e2, "wild": true, "owner": null,
+    "tags": ["sea", "shell", []], "home": {"ocean": "pacific", "depth": {"max": 200}}
+  } )");
+
+  SECTION("Scalars") {
+    REQUIRE(document.root().type() == Type::Object);
+    REQUIRE(document["name"].take_unchecked().as_string_view().take_unchecked() == "crab");
+    REQUIRE(document["legs"].take_unchecked().as<u8>().take_unchecked() == 10);
+    REQUIRE(document["weight"].take_unchecked().as<double>().take_unchecked() == -150.0);
+    REQUIRE(document["wild"].take_unchecked().as_bool().take_unchecked());
+    REQUIRE(document["owner"].take_unchecked().is_null());
+    REQUIRE(document["missing"].is_none());
+  }
+
+  SECTION("Containers") {
+    const auto tags = document["tags"].take_unchecked();
+    REQUIRE(tags.length() == 3);
+    REQUIRE(tags.at(1).take_unchecked().as_string_view().take_unchecked() == "shell");
+    REQUIRE(tags.at(2).take_unchecked().length() == 0);
+    REQUIRE(tags.at(3).is_none());
+    REQUIRE(tags["sea"].is_none());
+    REQUIRE(tags.raw() == R"(["sea", "shell", []])");
+
+    const auto depth = document["home"].take_unchecked()["depth"].take_unchecked();
+    REQUIRE(depth["max"].take_unchecked().as<i32>().take_unchecked() == 200);
+    REQUIRE(document.root().length() == 7);
+
+    Vec<StringView> keys;
+    for (const crab::json::Member member: document.root().members()) keys.push_back(member.key);
+    REQUIRE(keys == Vec<StringView>{"name", "legs", "weight", "wild", "owner", "tags", "home"});
+    REQUIRE(document["legs"].take_unchecked().members().next().is_none());
+  }
+
+  SECTION("Top Level Scalars") {
+    REQUIRE(parsed("42").root().as<i32>().take_unchecked() == 42);
+    REQUIRE(parsed(" \"x\" ").root().as_string_view().take_unchecked() == "x");
+    REQUIRE(parsed("false").root().as_bool().take_unchecked() == false);
+  }
+}
+
+TEST_CASE("json values", "[json]") {
+  SECTION("Strings") {
+    const auto document = parsed(R"(["plain", "a\"b\\c\/d\n", "é☃🦀", "🦀", ""])");
+    const auto strings = document.root();
+    REQUIRE(strings.at(0).take_unchecked().as_string().take_unchecked() == "plain");
+    REQUIRE(strings.at(1).take_unchecked().as_string().take_unchecked() == "a\"b\\c/d\n");
+    REQUIRE(strings.at(1).take_unchecked().as_string_view().take_err_unchecked().kind() == Kind::Escaped);
+    REQUIRE(strings.at(2).take_unchecked().as_string().take_unchecked() == "é☃🦀");
+    REQUIRE(strings.at(3).take_unchecked().as_string_view().take_unchecked() == "🦀");
+    REQUIRE(strings.at(4).take_unchecked().as_string_view().take_unchecked().empty());
+
+    const auto escaped = parsed(R"("\u00e9\u2603\ud83e\udd80\u0041")");
+    REQUIRE(escaped.root().as_string().take_unchecked() == "é☃🦀A");
+  }
+
+  SECTION("Bad Escapes") {
+    for (const StringView text: {R"("\x")", R"("\u12")", R"("\u12g4")", R"("\ud83e")", R"("\ud83ex")", R"("\udd80")"}) {
+      const auto error = parsed(text).root().as_string().take_err_unchecked();
+      REQUIRE(error.kind() == Kind::InvalidEscape);
+      REQUIRE(error.offset() == 1);
+    }
+  }
+
+  SECTION("Numbers") {
+    const auto numbers = parsed("[0, -0, 1.5, 1e3, -12345678901234, 300, 01, 1., -, 1e, 2x, -01]");
+    REQUIRE(numbers.root().at(0).take_unchecked().as<u32>().take_unchecked() == 0);
+    REQUIRE(numbers.root().at(2).take_unchecked().as<float>().take_unchecked() == 1.5f);
+    REQUIRE(numbers.root().at(3).take_unchecked().as<double>().take_unchecked() == 1000.0);
+    REQUIRE(numbers.root().at(4).take_unchecked().as<i64>().take_unchecked() == -12'345'678'901'234);
+
+    REQUIRE(numbers.root().at(2).take_unchecked().as<i32>().take_err_unchecked().kind() == Kind::WrongType);
+    REQUIRE(numbers.root().at(5).take_unchecked().as<u8>().take_err_unchecked().kind() == Kind::OutOfRange);
+    REQUIRE(numbers.root().at(4).take_unchecked().as<u32>().take_err_unchecked().kind() == Kind::WrongType);
+    for (usize i = 6; i < 12; i++) {
+      REQUIRE(numbers.root().at(i).take_unchecked().as<double>().take_err_unchecked().kind() == Kind::InvalidNumber);
+    }
+  }
+
+  SECTION("Wrong Types") {
+    const auto document = parsed(R"({"s": "1", "n": 1, "a": []})");
+    REQUIRE(document["s"].take_unchecked().as<i32>().take_err_unchecked().kind() == Kind::WrongType);
+    REQUIRE(document["n"].take_unchecked().as_string().take_err_unchecked().kind() == Kind::WrongType);
+    REQUIRE(document["a"].take_unchecked().as_bool().take_err_unchecked().offset() == 24);
+  }
+}
+
+TEST_CASE("json errors", "[json]") {
+  const std::pair<StringView, usize> syntax[]{
+    {"", 0},
+    {"   ", 3},
+    {"{", 1},
+    {"[1, 2", 5},
+    {"[1, 2}", 5},
+    {"{\"a\" 1}", 5},
+    {"{\"a\": 1,}", 8},
+    {"[1,]", 3},
+    {"[,1]", 1},
+    {"{1: 2}", 1},
+    {"1 2", 2},
+    {"[] []", 3},
+    {"[tru]", 1},
+    {"[nul1]", 1},
+    {"\"abc", 4},
+    {"[\"ab\"c]", 5},
+    {"[\"a\tb\"]", 3},
+    {"]", 0},
+    {"[.5]", 1},
+    {"[+1]", 1},
+  };
+  for (const auto &[text, offset]: syntax) {
+    const auto error = error_of(text);
+    REQUIRE(error.kind() == Kind::Syntax);
+    REQUIRE(error.offset() == offset);
+  }
+
+  REQUIRE(error_of("[\"\xc3\"]").kind() == Kind::InvalidUtf8);
+  REQUIRE(error_of("[\"\xc3\"]").offset() == 2);
+  REQUIRE(error_of("{\"a\": tru}").what() == "syntax error at byte 6");
+}
+
+TEST_CASE("json random documents", "[json]") {
+  std::mt19937_64 rng{16};
+  for (usize round = 0; round < 1'000; round++) {
+    const Node node = random_node(rng, 4);
+    String text;
+    write(rng, node, text);
+    INFO(text);
+    check(parsed(text).root(), node);
+  }
+
+  // runs of backslashes & escaped quotes at every alignment around the 64 byte blocks
+  for (usize prefix = 50; prefix < 140; prefix++) {
+    for (usize backslashes = 1; backslashes <= 6; backslashes++) {
+      const String escapes = String(backslashes * 2, '\\') + "\\\"";
+      const String text = "[\"" + String(prefix, 'x') + escapes + "\", \"" + escapes + "\"]";
+      const auto document = parsed(text);
+      const String expected = String(backslashes, '\\') + "\"";
+      REQUIRE(document.root().at(0).take_unchecked().as_string().take_unchecked() == String(prefix, 'x') + expected);
+      REQUIRE(document.root().at(1).take_unchecked().as_string().take_unchecked() == expected);
+    }
+  }
+}
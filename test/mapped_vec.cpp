@@ -0,0 +1,103 @@
+#include <mapped_vec.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  struct Point {
+    f32 x, y;
+    u32 id;
+  };
+
+  /**
+   * @brief Unique path in the temp directory that is removed again at the end of the test
+   */
+  struct TempPath {
+    std::filesystem::path path;
+
+    explicit TempPath(const StringView name)
+      : path{std::filesystem::temp_directory_path() / (String{name} + "-" + std::to_string(::getpid()))} {
+      std::filesystem::remove(path);
+    }
+
+    ~TempPath() { std::filesystem::remove(path); }
+  };
+}
+
+TEST_CASE("MappedVec", "[mapped_vec]") {
+  SECTION("Persists Across Reopens") {
+    const TempPath temp{"crab-mapped-vec-points"};
+
+    {
+      auto vec = crab::MappedVec<Point>::open(temp.path).take_unchecked();
+      REQUIRE(vec.is_empty());
+      REQUIRE(vec.capacity() >= crab::mapped::MIN_CAPACITY);
+
+      for (u32 i = 0; i < 10'000; i++) REQUIRE(vec.push(Point{static_cast<f32>(i), -1.f, i}).is_ok());
+      REQUIRE(vec.length() == 10'000);
+      REQUIRE(vec.capacity() >= 10'000);
+      REQUIRE(vec.flush().is_ok());
+    }
+
+    auto reopened = crab::MappedVec<Point>::open(temp.path).take_unchecked();
+    REQUIRE(reopened.length() == 10'000);
+    for (u32 i = 0; i < 10'000; i++) {
+      REQUIRE(reopened[i].id == i);
+      REQUIRE(reopened[i].x == static_cast<f32>(i));
+    }
+
+    REQUIRE(reopened.pop().take_unchecked().id == 9'999);
+    reopened.truncate(10);
+    REQUIRE(reopened.length() == 10);
+    REQUIRE(reopened.shrink_to_fit().is_ok());
+    REQUIRE(reopened.capacity() == 10);
+    REQUIRE(reopened.as_span().back().id == 9);
+  }
+
+  SECTION("Extend & Resize") {
+    const TempPath temp{"crab-mapped-vec-u64"};
+    auto vec = crab::MappedVec<u64>::open(temp.path).take_unchecked();
+
+    const Vec<u64> values{1, 2, 3, 4, 5};
+    REQUIRE(vec.extend(values).is_ok());
+    REQUIRE(Vec<u64>(vec.begin(), vec.end()) == values);
+
+    REQUIRE(vec.resize(1'000, 7).is_ok());
+    REQUIRE(vec.length() == 1'000);
+    REQUIRE(vec[4] == 5);
+    REQUIRE(vec[999] == 7);
+
+    for (u64 &value: vec.as_span_mut()) value *= 2;
+    REQUIRE(vec[0] == 2);
+
+    vec.clear();
+    REQUIRE(vec.is_empty());
+    REQUIRE(vec.pop().is_none());
+  }
+
+  SECTION("Rejects Foreign Files") {
+    const TempPath temp{"crab-mapped-vec-foreign"};
+
+    {
+      auto vec = crab::MappedVec<u32>::open(temp.path).take_unchecked();
+      REQUIRE(vec.push(1).is_ok());
+    }
+
+    // different element type
+    REQUIRE(crab::MappedVec<u64>::open(temp.path).is_err());
+    REQUIRE(crab::MappedVec<u32>::open(temp.path).take_unchecked().length() == 1);
+
+    // not a MappedVec at all
+    {
+      std::ofstream stream{temp.path, std::ios::trunc};
+      stream << "definitely not a vec";
+    }
+    REQUIRE(crab::MappedVec<u32>::open(temp.path).is_err());
+
+    // directories can't be mapped
+    const auto error = crab::MappedVec<u32>::open(std::filesystem::temp_directory_path()).take_err_unchecked();
+    REQUIRE_FALSE(error.what().empty());
+  }
+}
@@ -0,0 +1,194 @@
+#include <ndarray.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  template<typename T, usize Rank>
+  auto iota(const crab::nd::Shape<Rank> &shape) -> crab::NDArray<T, Rank> {
+    crab::NDArray<T, Rank> array{shape};
+    for (usize i = 0; i < array.size(); i++) array.data()[i] = static_cast<T>(i);
+    return array;
+  }
+}
+
+TEST_CASE("NDArray", "[ndarray]") {
+  SECTION("Storage") {
+    crab::NDArray<f32, 3> array{{2, 3, 4}};
+    REQUIRE(array.size() == 24);
+    REQUIRE(reinterpret_cast<uptr>(array.data()) % 64 == 0);
+    for (const f32 value: array.as_span()) REQUIRE(value == 0);
+
+    array(1, 2, 3) = 5;
+    REQUIRE(array.data()[23] == 5);
+    REQUIRE(array.view().strides() == crab::nd::Shape<3>{12, 4, 1});
+
+    const crab::NDArray<f32, 3> copy = array;
+    array.fill(1);
+    REQUIRE(copy(1, 2, 3) == 5);
+    REQUIRE(array(0, 0, 0) == 1);
+
+    const crab::NDArray<i32, 1> filled{{5}, 7};
+    REQUIRE(filled(4) == 7);
+  }
+
+  SECTION("Views") {
+    auto matrix = iota<i32, 2>({4, 6});
+    const auto view = matrix.view();
+
+    const auto columns = view.slice(1, 1, 6, 2);
+    REQUIRE(columns.shape() == crab::nd::Shape<2>{4, 3});
+    REQUIRE(columns(2, 1) == 15);
+    REQUIRE(not columns.is_contiguous());
+
+    const auto row = view.select(0, 2);
+    REQUIRE(row.shape() == crab::nd::Shape<1>{6});
+    REQUIRE(row(5) == 17);
+    REQUIRE(row.is_contiguous());
+    const auto column = view.select(1, 4);
+    REQUIRE(column(3) == 22);
+
+    const auto transposed = view.transpose();
+    REQUIRE(transposed.shape() == crab::nd::Shape<2>{6, 4});
+    REQUIRE(transposed(5, 1) == view(1, 5));
+
+    // views share the elements
+    columns(0, 0) = -1;
+    REQUIRE(matrix(0, 1) == -1);
+
+    auto cube = iota<i32, 3>({2, 3, 4});
+    const auto permuted = cube.view().permute({2, 0, 1});
+    REQUIRE(permuted.shape() == crab::nd::Shape<3>{4, 2, 3});
+    REQUIRE(permuted(3, 1, 2) == cube(1, 2, 3));
+    REQUIRE(cube.view().slice(0, 1, 1).size() == 0);
+  }
+
+  SECTION("Broadcast") {
+    const auto bias = iota<f32, 1>({3});
+    const auto rows = bias.view().broadcast_to(crab::nd::Shape<2>{4, 3}).take_unchecked();
+    REQUIRE(rows.strides() == crab::nd::Shape<2>{0, 1});
+    REQUIRE(rows(3, 2) == 2);
+
+    const auto column = iota<f32, 2>({4, 1});
+    const auto columns = column.view().broadcast_to(crab::nd::Shape<2>{4, 3}).take_unchecked();
+    REQUIRE(columns(2, 0) == 2);
+    REQUIRE(columns(2, 2) == 2);
+
+    REQUIRE(bias.view().broadcast_to(crab::nd::Shape<2>{4, 5}).is_none());
+    REQUIRE(column.view().broadcast_to(crab::nd::Shape<2>{3, 3}).is_none());
+  }
+}
+
+TEST_CASE("NDArray expressions", "[ndarray]") {
+  SECTION("Arithmetic") {
+    const auto a = iota<f32, 2>({3, 37});
+    const auto b = iota<f32, 2>({3, 37});
+    const crab::NDArray<f32, 2> c = a * b + 2 - a / 4;
+    const crab::NDArray<f32, 2> d = 1.f - (-a);
+    for (usize i = 0; i < 3; i++) {
+      for (usize j = 0; j < 37; j++) {
+        REQUIRE(c(i, j) == a(i, j) * b(i, j) + 2 - a(i, j) / 4);
+        REQUIRE(d(i, j) == 1 + a(i, j));
+      }
+    }
+  }
+
+  SECTION("Map & Zip") {
+    const auto a = iota<f64, 1>({10});
+    // a generic lambda also runs on vectors, a typed one (and f64) only on elements
+    const crab::NDArray<f64, 1> squares = crab::nd::map(a, [](const auto x) { return x * x; });
+    const crab::NDArray<f32, 1> halves = crab::nd::map(iota<i32, 1>({10}), [](const i32 x) { return x / 2.f; });
+    const crab::NDArray<f64, 1> larger = crab::nd::zip(a, squares, [](const f64 x, const f64 y) { return x > y ? x : y; });
+    const auto floats = iota<f32, 1>({10});
+    const auto generic = crab::nd::map(floats, [](const auto x) { return x * x; });
+    const auto typed = crab::nd::map(floats, [](const f32 x) { return x * x; });
+    STATIC_REQUIRE(decltype(generic.row({}))::VECTOR);
+    STATIC_REQUIRE(not decltype(typed.row({}))::VECTOR);
+    STATIC_REQUIRE(not decltype(crab::nd::map(a, [](const auto x) { return x * x; }).row({}))::VECTOR);
+    REQUIRE(crab::NDArray<f32, 1>{generic}(3) == crab::NDArray<f32, 1>{typed}(3));
+    REQUIRE(squares(9) == 81);
+    REQUIRE(halves(3) == 1.5f);
+    REQUIRE(larger(0) == 0);
+    REQUIRE(larger(9) == 81);
+  }
+
+  SECTION("Integers") {
+    const crab::NDArray<u8, 1> bytes{{40}, 200};
+    // u8 arithmetic wraps like it does in vector lanes instead of promoting
+    const crab::NDArray<u8, 1> sums = bytes + bytes;
+    REQUIRE(sums(39) == 144);
+
+    const auto values = iota<i32, 1>({100});
+    const crab::NDArray<i32, 1> quotients = (values - 50) / 7;
+    REQUIRE(quotients(0) == -7);
+    REQUIRE(quotients(99) == 7);
+  }
+
+  SECTION("Strided & Broadcast Operands") {
+    const auto a = iota<f32, 2>({5, 9});
+    const auto b = iota<f32, 2>({9, 5});
+    const auto bias = iota<f32, 1>({9});
+    const crab::NDArray<f32, 2> c = a + b.view().transpose() * bias.view().broadcast_to(a.shape()).take_unchecked();
+    for (usize i = 0; i < 5; i++) {
+      for (usize j = 0; j < 9; j++) REQUIRE(c(i, j) == a(i, j) + b(j, i) * bias(j));
+    }
+
+    // more than a tile of rows & columns, with partial tiles at both ends
+    const auto tall = iota<i32, 3>({2, 150, 37});
+    const crab::NDArray<i32, 3> sum = tall.view().permute({0, 2, 1}) + 1;
+    for (usize k = 0; k < 2; k++) {
+      for (usize i = 0; i < 37; i++) {
+        for (usize j = 0; j < 150; j++) REQUIRE(sum(k, i, j) == tall(k, j, i) + 1);
+      }
+    }
+  }
+
+  SECTION("Assign Into Views") {
+    auto matrix = iota<i32, 2>({4, 6});
+    // every other column, a strided destination
+    matrix.view().slice(1, 0, 6, 2).assign(matrix.view().slice(1, 1, 6, 2) * 10);
+    REQUIRE(matrix(0, 0) == 10);
+    REQUIRE(matrix(0, 1) == 1);
+    REQUIRE(matrix(3, 4) == 230);
+
+    matrix.view().select(0, 1).fill(-1);
+    REQUIRE(matrix(1, 5) == -1);
+    REQUIRE(matrix(2, 5) == 17);
+
+    matrix.assign(matrix * 2);
+    REQUIRE(matrix(2, 5) == 34);
+  }
+
+  SECTION("Random Against Loops") {
+    std::mt19937_64 rng{118};
+    for (usize round = 0; round < 200; round++) {
+      const crab::nd::Shape<3> shape{1 + rng() % 4, 1 + rng() % 5, 1 + rng() % 40};
+      crab::NDArray<f32, 3> a{shape}, b{{shape[2], shape[1], shape[0]}};
+      for (f32 &x: a.as_span()) x = static_cast<f32>(rng() % 1000);
+      for (f32 &x: b.as_span()) x = static_cast<f32>(rng() % 1000);
+      const auto row = iota<f32, 1>({shape[2]});
+      const auto broadcast = row.view().broadcast_to(shape).take_unchecked();
+
+      const crab::NDArray<f32, 3> c = (a - broadcast) * 3 + b.view().transpose() / 2;
+      for (usize i = 0; i < shape[0]; i++) {
+        for (usize j = 0; j < shape[1]; j++) {
+          for (usize k = 0; k < shape[2]; k++) {
+            REQUIRE(c(i, j, k) == (a(i, j, k) - row(k)) * 3 + b(k, j, i) / 2);
+          }
+        }
+      }
+    }
+  }
+}
+
+#if defined(__cpp_lib_mdspan)
+TEST_CASE("NDArray & std::mdspan", "[ndarray]") {
+  auto matrix = iota<f32, 2>({3, 4});
+  const auto span = matrix.view().transpose().to_mdspan();
+  REQUIRE(span.extent(0) == 4);
+  REQUIRE(span[2, 1] == matrix(1, 2));
+
+  const crab::nd::View<f32, 2> back{matrix.to_mdspan()};
+  REQUIRE(back(2, 3) == 11);
+}
+#endif
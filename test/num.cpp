@@ -0,0 +1,150 @@
+#include <num.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  template<typename T>
+  using limits = std::numeric_limits<T>;
+
+  /**
+   * @brief Reference saturating result computed in a wider type
+   */
+  template<typename T, typename Wide = std::conditional_t<std::is_signed_v<T>, i64, u64>>
+  auto clamp_wide(const Wide value) -> T {
+    return static_cast<T>(std::clamp<Wide>(value, limits<T>::min(), limits<T>::max()));
+  }
+
+  template<typename T>
+  auto check_bulk(const usize len) -> void {
+    std::mt19937_64 rng{len};
+    Vec<T> a(len), b(len);
+    for (usize i = 0; i < len; i++) {
+      // full range values, so a large share of the lanes saturates
+      a[i] = static_cast<T>(rng());
+      b[i] = static_cast<T>(rng());
+    }
+
+    Vec<T> sum = a, difference = a;
+    crab::saturating_add<T>(sum, b);
+    crab::saturating_sub<T>(difference, b);
+
+    for (usize i = 0; i < len; i++) {
+      REQUIRE(sum[i] == crab::saturating_add(a[i], b[i]));
+      REQUIRE(difference[i] == crab::saturating_sub(a[i], b[i]));
+    }
+  }
+}
+
+TEST_CASE("Checked Arithmetic", "[num]") {
+  SECTION("Add & Sub") {
+    REQUIRE(crab::checked_add<u8>(200, 55).take_unchecked() == 255);
+    REQUIRE(crab::checked_add<u8>(200, 56).is_none());
+    REQUIRE(crab::checked_add<i32>(limits<i32>::max(), 1).is_none());
+    REQUIRE(crab::checked_add<i32>(limits<i32>::min(), -1).is_none());
+    REQUIRE(crab::checked_add<i32>(-5, 3).take_unchecked() == -2);
+
+    REQUIRE(crab::checked_sub<u32>(3, 4).is_none());
+    REQUIRE(crab::checked_sub<u32>(4, 4).take_unchecked() == 0);
+    REQUIRE(crab::checked_sub<i64>(limits<i64>::min(), 1).is_none());
+  }
+
+  SECTION("Mul & Div") {
+    REQUIRE(crab::checked_mul<u16>(256, 255).take_unchecked() == 65'280);
+    REQUIRE(crab::checked_mul<u16>(256, 256).is_none());
+    REQUIRE(crab::checked_mul<i32>(-65'536, 32'768).take_unchecked() == limits<i32>::min());
+    REQUIRE(crab::checked_mul<i32>(65'536, 32'768).is_none());
+
+    REQUIRE(crab::checked_div<u32>(7, 2).take_unchecked() == 3);
+    REQUIRE(crab::checked_div<u32>(7, 0).is_none());
+    REQUIRE(crab::checked_div<i32>(limits<i32>::min(), -1).is_none());
+    REQUIRE(crab::checked_div<i32>(-7, 2).take_unchecked() == -3);
+  }
+
+  SECTION("Against Wide Reference") {
+    std::mt19937 rng{7};
+    for (usize i = 0; i < 10'000; i++) {
+      const auto a = static_cast<i16>(rng()), b = static_cast<i16>(rng());
+      const i64 sum = i64{a} + b, product = i64{a} * b;
+      const bool sum_fits = sum >= limits<i16>::min() and sum <= limits<i16>::max();
+      const bool product_fits = product >= limits<i16>::min() and product <= limits<i16>::max();
+      REQUIRE(crab::checked_add(a, b).is_some() == sum_fits);
+      REQUIRE(crab::checked_mul(a, b).is_some() == product_fits);
+      REQUIRE(crab::saturating_add(a, b) == clamp_wide<i16>(sum));
+      REQUIRE(crab::saturating_sub(a, b) == clamp_wide<i16>(i64{a} - b));
+      REQUIRE(crab::saturating_mul(a, b) == clamp_wide<i16>(product));
+    }
+  }
+}
+
+TEST_CASE("Wrapping", "[num]") {
+  using W8 = crab::Wrapping<u8>;
+  REQUIRE((W8{250} + W8{10}).get() == 4);
+  REQUIRE((W8{3} - W8{5}).get() == 254);
+  REQUIRE((W8{16} * W8{17}).get() == 16);
+  REQUIRE((-W8{1}).get() == 255);
+
+  using W32 = crab::Wrapping<i32>;
+  REQUIRE((W32{limits<i32>::max()} + W32{1}).get() == limits<i32>::min());
+  REQUIRE((W32{limits<i32>::min()} / W32{-1}).get() == limits<i32>::min());
+  REQUIRE((-W32{limits<i32>::min()}).get() == limits<i32>::min());
+
+  W32 hash{17};
+  for (i32 i = 0; i < 100; i++) hash = hash * W32{31} + W32{i};
+  REQUIRE(hash > W32{limits<i32>::min()});
+  REQUIRE(W32{1} < W32{2});
+  REQUIRE(W32{} == W32{0});
+
+  static_assert((crab::Wrapping<u16>{65'535} + crab::Wrapping<u16>{2}).get() == 1);
+}
+
+TEST_CASE("Saturating", "[num]") {
+  using S8 = crab::Saturating<u8>;
+  REQUIRE((S8{250} + S8{10}).get() == 255);
+  REQUIRE((S8{3} - S8{5}).get() == 0);
+  REQUIRE((S8{16} * S8{17}).get() == 255);
+
+  using S32 = crab::Saturating<i32>;
+  REQUIRE((S32{limits<i32>::max()} + S32{1}).get() == limits<i32>::max());
+  REQUIRE((S32{limits<i32>::min()} - S32{1}).get() == limits<i32>::min());
+  REQUIRE((S32{limits<i32>::min()} * S32{-2}).get() == limits<i32>::max());
+  REQUIRE((S32{limits<i32>::max()} * S32{-2}).get() == limits<i32>::min());
+  REQUIRE((S32{limits<i32>::min()} / S32{-1}).get() == limits<i32>::max());
+  REQUIRE((-S32{limits<i32>::min()}).get() == limits<i32>::max());
+
+  S32 level{0};
+  for (i32 i = 0; i < 100; i++) level += S32{limits<i32>::max() / 10};
+  REQUIRE(level.get() == limits<i32>::max());
+  level -= S32{limits<i32>::max()};
+  REQUIRE(level == S32{0});
+
+  static_assert((crab::Saturating<i8>{100} + crab::Saturating<i8>{100}).get() == 127);
+}
+
+TEST_CASE("Bulk Saturating", "[num]") {
+  // lengths around the vector width to hit the scalar tail
+  for (const usize len: {0, 1, 15, 16, 17, 31, 32, 33, 100, 1'000}) {
+    check_bulk<u8>(len);
+    check_bulk<i8>(len);
+    check_bulk<u16>(len);
+    check_bulk<i16>(len);
+    check_bulk<u32>(len);
+    check_bulk<i32>(len);
+    check_bulk<u64>(len);
+    check_bulk<i64>(len);
+  }
+
+  SECTION("Clamps") {
+    Vec<u8> pixels{0, 100, 200, 255};
+    const Vec<u8> gain{10, 100, 100, 1};
+    crab::saturating_add<u8>(pixels, gain);
+    REQUIRE(pixels == Vec<u8>{10, 200, 255, 255});
+
+    Vec<i16> samples{-32'000, 0, 32'000};
+    const Vec<i16> offset{1'000, -1'000, -1'000};
+    crab::saturating_sub<i16>(samples, offset);
+    REQUIRE(samples == Vec<i16>{-32'768, 1'000, 32'767});
+  }
+}
@@ -0,0 +1,106 @@
+#include <packed_vec.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  auto random_values(const usize count, const u32 bits, const u64 seed) -> Vec<u32> {
+    std::mt19937_64 rng{seed};
+    Vec<u32> values(count);
+    for (u32 &value: values) value = static_cast<u32>(rng() & ((u64{1} << bits) - 1));
+    return values;
+  }
+}
+
+TEST_CASE("PackedVec", "[packed_vec]") {
+  SECTION("Fixed Width Get & Set") {
+    crab::PackedVec<11> vec{100};
+    REQUIRE(vec.bits() == 11);
+    REQUIRE(vec.length() == 100);
+    REQUIRE(vec.get(99) == 0);
+
+    for (usize i = 0; i < 100; i++) vec.set(i, static_cast<u32>(i * 20 % 2048));
+    for (usize i = 0; i < 100; i++) REQUIRE(vec[i] == i * 20 % 2048);
+
+    // neighbours straddling a word boundary are left untouched
+    vec.set(5, 2047);
+    REQUIRE(vec[4] == 80);
+    REQUIRE(vec[5] == 2047);
+    REQUIRE(vec[6] == 120);
+
+    vec.push(7);
+    REQUIRE(vec.length() == 101);
+    REQUIRE(vec[100] == 7);
+  }
+
+  SECTION("Every Width Round Trips") {
+    for (u32 bits = 0; bits <= 32; bits++) {
+      const Vec<u32> values = random_values(1'000, bits, bits);
+      const auto vec = crab::PackedVec<>::from_values(values, bits);
+      REQUIRE(vec.bits() == bits);
+
+      for (usize i = 0; i < values.size(); i++) REQUIRE(vec.get(i) == values[i]);
+      REQUIRE(vec.to_vec() == values);
+
+      // unaligned bulk decode
+      Vec<u32> middle(500);
+      vec.unpack(123, middle);
+      REQUIRE(std::equal(middle.begin(), middle.end(), values.begin() + 123));
+
+      REQUIRE(Vec<u32>(vec.begin(), vec.end()) == values);
+    }
+  }
+
+  SECTION("Smallest Width") {
+    const Vec<u32> values{1, 5, 1'000, 3};
+    const auto vec = crab::PackedVec<>::from_values(values);
+    REQUIRE(vec.bits() == 10);
+    REQUIRE(vec.to_vec() == values);
+    REQUIRE(crab::packed::bits_for(0) == 0);
+    REQUIRE(crab::packed::bits_for(0xffff'ffff) == 32);
+  }
+}
+
+TEST_CASE("PackedFrameVec", "[packed_vec]") {
+  std::mt19937_64 rng{3};
+  Vec<u32> values;
+  // clustered around large bases, with a single wide block in the middle
+  for (usize i = 0; i < 1'000; i++) values.push_back(4'000'000'000u + static_cast<u32>(i / 128 * 1'000 + rng() % 500));
+  values[500] = 7;
+
+  const auto vec = crab::PackedFrameVec::from_values(values);
+  REQUIRE(vec.length() == values.size());
+  for (usize i = 0; i < values.size(); i++) REQUIRE(vec[i] == values[i]);
+  REQUIRE(vec.to_vec() == values);
+  REQUIRE(Vec<u32>(vec.begin(), vec.end()) == values);
+
+  Vec<u32> middle(300);
+  vec.unpack(250, middle);
+  REQUIRE(std::equal(middle.begin(), middle.end(), values.begin() + 250));
+
+  REQUIRE(vec.memory_bytes() < values.size() * sizeof(u32));
+  REQUIRE(crab::PackedFrameVec::from_values({}).is_empty());
+}
+
+TEST_CASE("PackedDeltaVec", "[packed_vec]") {
+  std::mt19937_64 rng{4};
+  Vec<u32> values;
+  u32 current = 1'000;
+  for (usize i = 0; i < 1'000; i++) {
+    current += static_cast<u32>(rng() % 40);
+    values.push_back(current);
+  }
+
+  const auto vec = crab::PackedDeltaVec::from_values(values);
+  REQUIRE(vec.length() == values.size());
+  for (usize i = 0; i < values.size(); i++) REQUIRE(vec[i] == values[i]);
+  REQUIRE(vec.to_vec() == values);
+  REQUIRE(Vec<u32>(vec.begin(), vec.end()) == values);
+
+  Vec<u32> middle(300);
+  vec.unpack(250, middle);
+  REQUIRE(std::equal(middle.begin(), middle.end(), values.begin() + 250));
+
+  // gaps below 64 need 6 bits per value
+  REQUIRE(vec.memory_bytes() < values.size());
+}
@@ -0,0 +1,209 @@
+#include <parse.hpp>
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  using Kind = crab::ParseError::Kind;
+
+  template<typename T>
+  auto error_kind(Result<T, crab::ParseError> result) -> Kind {
+    return result.take_err_unchecked().kind();
+  }
+
+  template<typename T>
+  auto parsed(const StringView text) -> T {
+    return crab::parse<T>(text).take_unchecked();
+  }
+
+  template<typename T>
+  auto check_limits() -> void {
+    REQUIRE(parsed<T>(std::to_string(std::numeric_limits<T>::max())) == std::numeric_limits<T>::max());
+    REQUIRE(parsed<T>(std::to_string(std::numeric_limits<T>::min())) == std::numeric_limits<T>::min());
+
+    // one past either end
+    String above = std::to_string(std::numeric_limits<T>::max());
+    above.back()++;
+    REQUIRE(error_kind(crab::parse<T>(above)) == Kind::OutOfRange);
+    if constexpr (std::is_signed_v<T>) {
+      String below = std::to_string(std::numeric_limits<T>::min());
+      below.back()++;
+      REQUIRE(error_kind(crab::parse<T>(below)) == Kind::OutOfRange);
+    }
+  }
+
+  /**
+   * @brief Shortest round trip text of 'value' must parse back to exactly the same bits
+   */
+  template<typename F>
+  auto check_round_trip(const F value) -> void {
+    char buffer[64];
+    const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    REQUIRE(error == std::errc{});
+    const F result = parsed<F>({buffer, end});
+    REQUIRE(std::bit_cast<std::conditional_t<sizeof(F) == 4, u32, u64>>(result)
+      == std::bit_cast<std::conditional_t<sizeof(F) == 4, u32, u64>>(value));
+  }
+
+  /**
+   * @brief Must agree with std::from_chars, including on the error
+   */
+  template<typename F>
+  auto check_against_standard(const StringView text) -> void {
+    F expected{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), expected);
+    auto result = crab::parse<F>(text);
+    if (error == std::errc::result_out_of_range) {
+      REQUIRE(error_kind(std::move(result)) == Kind::OutOfRange);
+    } else {
+      REQUIRE(result.take_unchecked() == expected);
+    }
+  }
+}
+
+TEST_CASE("parse integers", "[parse]") {
+  SECTION("Values") {
+    REQUIRE(parsed<i32>("0") == 0);
+    REQUIRE(parsed<i32>("-0") == 0);
+    REQUIRE(parsed<i32>("+42") == 42);
+    REQUIRE(parsed<i32>("-42") == -42);
+    REQUIRE(parsed<u8>("000000000000000000000000255") == 255);
+    REQUIRE(parsed<u64>("12345678") == 12'345'678);
+    REQUIRE(parsed<u64>("1234567890123456") == 1'234'567'890'123'456);
+    REQUIRE(parsed<u64>("12345678901234567890") == 12'345'678'901'234'567'890u);
+    REQUIRE(parsed<i64>("-1234567890123456789") == -1'234'567'890'123'456'789);
+  }
+
+  SECTION("Limits") {
+    check_limits<u8>();
+    check_limits<i8>();
+    check_limits<u16>();
+    check_limits<i16>();
+    check_limits<u32>();
+    check_limits<i32>();
+    check_limits<u64>();
+    check_limits<i64>();
+
+    REQUIRE(error_kind(crab::parse<u64>("20000000000000000000")) == Kind::OutOfRange);
+    REQUIRE(error_kind(crab::parse<u64>("99999999999999999999")) == Kind::OutOfRange);
+    REQUIRE(error_kind(crab::parse<u64>("100000000000000000000")) == Kind::OutOfRange);
+    REQUIRE(error_kind(crab::parse<u32>("99999999999999999999999999999999")) == Kind::OutOfRange);
+  }
+
+  SECTION("Errors") {
+    REQUIRE(error_kind(crab::parse<i32>("")) == Kind::Empty);
+    REQUIRE(error_kind(crab::parse<i32>("-")) == Kind::InvalidDigit);
+    REQUIRE(error_kind(crab::parse<u32>("-1")) == Kind::InvalidDigit);
+    REQUIRE(error_kind(crab::parse<i32>(" 1")) == Kind::InvalidDigit);
+    REQUIRE(error_kind(crab::parse<i32>("1.0")) == Kind::InvalidDigit);
+
+    // found inside the 8 & 16 digit chunks
+    const auto error = crab::parse<u64>("1234567890123x567").take_err_unchecked();
+    REQUIRE(error.kind() == Kind::InvalidDigit);
+    REQUIRE(error.position() == 13);
+    REQUIRE(crab::parse<u64>("12345/78").take_err_unchecked().position() == 5);
+    REQUIRE(crab::parse<u64>("12345:78").take_err_unchecked().position() == 5);
+  }
+
+  SECTION("Random Against std::to_string") {
+    std::mt19937_64 rng{3};
+    for (usize i = 0; i < 100'000; i++) {
+      const u64 bits = rng();
+      // every length of number
+      const u64 value = bits >> (rng() % 64);
+      REQUIRE(parsed<u64>(std::to_string(value)) == value);
+      REQUIRE(parsed<i64>(std::to_string(static_cast<i64>(bits))) == static_cast<i64>(bits));
+      REQUIRE(parsed<i32>(std::to_string(static_cast<i32>(bits))) == static_cast<i32>(bits));
+    }
+  }
+}
+
+TEST_CASE("parse floats", "[parse]") {
+  SECTION("Values") {
+    REQUIRE(parsed<double>("0") == 0.0);
+    REQUIRE(std::signbit(parsed<double>("-0.0")));
+    REQUIRE(parsed<double>("1.5") == 1.5);
+    REQUIRE(parsed<double>("+.25") == 0.25);
+    REQUIRE(parsed<double>("3.") == 3.0);
+    REQUIRE(parsed<double>("-1e3") == -1000.0);
+    REQUIRE(parsed<double>("1E-2") == 0.01);
+    REQUIRE(parsed<double>("0.000000000000000000000000000001") == 1e-30);
+    REQUIRE(parsed<double>("123456789012345678901234567890") == 123456789012345678901234567890.0);
+    REQUIRE(parsed<double>("2.2250738585072014e-308") == std::numeric_limits<double>::min());
+    REQUIRE(parsed<double>("4.9406564584124654e-324") == std::numeric_limits<double>::denorm_min());
+    REQUIRE(parsed<double>("1.7976931348623157e308") == std::numeric_limits<double>::max());
+    REQUIRE(parsed<float>("3.4028235e38") == std::numeric_limits<float>::max());
+    REQUIRE(parsed<float>("0.1") == 0.1f);
+    REQUIRE(parsed<f64>("0.1") == 0.1L);
+    REQUIRE(parsed<f64>("1e4000") == std::strtold("1e4000", nullptr));
+
+    REQUIRE(std::isinf(parsed<double>("inf")));
+    REQUIRE(parsed<double>("-Infinity") == -std::numeric_limits<double>::infinity());
+    REQUIRE(std::isnan(parsed<float>("NaN")));
+  }
+
+  SECTION("Errors") {
+    REQUIRE(error_kind(crab::parse<double>("")) == Kind::Empty);
+    REQUIRE(error_kind(crab::parse<double>(".")) == Kind::InvalidDigit);
+    REQUIRE(error_kind(crab::parse<double>("-")) == Kind::InvalidDigit);
+    REQUIRE(error_kind(crab::parse<double>("1e")) == Kind::InvalidDigit);
+    REQUIRE(error_kind(crab::parse<double>("1e+")) == Kind::InvalidDigit);
+    REQUIRE(error_kind(crab::parse<double>("infinite")) == Kind::InvalidDigit);
+    REQUIRE(crab::parse<double>("1.5x").take_err_unchecked().position() == 3);
+    REQUIRE(crab::parse<double>("1,5").take_err_unchecked().position() == 1);
+
+    REQUIRE(error_kind(crab::parse<double>("1e309")) == Kind::OutOfRange);
+    REQUIRE(error_kind(crab::parse<double>("-1e-400")) == Kind::OutOfRange);
+    REQUIRE(error_kind(crab::parse<float>("1e39")) == Kind::OutOfRange);
+    REQUIRE(error_kind(crab::parse<double>("1e99999999999999999999")) == Kind::OutOfRange);
+    REQUIRE(parsed<double>("0e99999999999999999999") == 0.0);
+  }
+
+  SECTION("Round Trips") {
+    std::mt19937_64 rng{5};
+    for (usize i = 0; i < 200'000; i++) {
+      const u64 bits = rng();
+      if (const auto value = std::bit_cast<double>(bits); std::isfinite(value) and value != 0) {
+        check_round_trip(value);
+      }
+      if (const auto value = std::bit_cast<float>(static_cast<u32>(bits)); std::isfinite(value) and value != 0) {
+        check_round_trip(value);
+      }
+    }
+  }
+
+  SECTION("Random Digits Against std::from_chars") {
+    std::mt19937_64 rng{9};
+    for (usize i = 0; i < 100'000; i++) {
+      // up to 25 significant digits, to also cover the slow path
+      String text = std::to_string(rng() >> (rng() % 64));
+      if (rng() % 2 == 0) text += std::to_string(rng() % 1'000'000);
+      if (const usize point = rng() % (text.size() + 1); point < text.size()) text.insert(point, ".");
+      text += "e" + std::to_string(static_cast<i32>(rng() % 700) - 350);
+      check_against_standard<double>(text);
+      check_against_standard<float>(text);
+    }
+  }
+}
+
+TEST_CASE("parse_column", "[parse]") {
+  const Vec<StringView> fields{"1", "-2", "30", "400"};
+  const Box<i32[]> values = crab::parse_column<i32>(fields).take_unchecked();
+  REQUIRE(values.length() == 4);
+  REQUIRE(values[0] == 1);
+  REQUIRE(values[1] == -2);
+  REQUIRE(values[3] == 400);
+
+  const Vec<StringView> prices{"1.25", "2.5", "x", "4"};
+  const auto error = crab::parse_column<double>(prices).take_err_unchecked();
+  REQUIRE(error.kind() == Kind::InvalidDigit);
+  REQUIRE(error.field().take_unchecked() == 2);
+  REQUIRE(error.what() == "field 2: invalid digit at byte 0");
+
+  REQUIRE(crab::parse_column<u8>({}).take_unchecked().length() == 0);
+}
@@ -34,7 +34,9 @@ TEST_CASE("Pattern Matchin", "[pattern]") {
 
       REQUIRE(state);
       REQUIRE(opt.is_none());
+      #if DEBUG
       REQUIRE_THROWS(opt.get_unchecked());
+      #endif
 
       REQUIRE_NOTHROW(
         crab::if_some(
@@ -93,13 +95,17 @@ TEST_CASE("Pattern Matchin", "[pattern]") {
 
     REQUIRE(v == 42);
 
+    #if DEBUG
     REQUIRE_THROWS(result.ensure_valid());
     REQUIRE_THROWS(result.take_unchecked());
     REQUIRE_THROWS(result.take_err_unchecked());
+    #endif
 
     result = err(TestError{"huh"});
 
+    #if DEBUG
     REQUIRE_THROWS(result.get_unchecked());
+    #endif
     REQUIRE_NOTHROW(result.get_err_unchecked());
 
     v = 0;
@@ -126,9 +132,11 @@ TEST_CASE("Pattern Matchin", "[pattern]") {
     );
 
     REQUIRE(v == 420);
+    #if DEBUG
     REQUIRE_THROWS(result.ensure_valid());
     REQUIRE_THROWS(result.get_unchecked());
     REQUIRE_THROWS(result.get_err_unchecked());
+    #endif
 
     v = 0;
 
@@ -17,10 +17,28 @@ struct Bruh : Huh {
   explicit Bruh(const i32 v) : Huh{v} {}
 };
 
+struct Tag {
+  String name;
+  i32 weight;
+
+  auto operator==(const Tag &) const -> bool = default;
+};
+
+template<>
+struct std::hash<Tag> {
+  auto operator()(const Tag &tag) const -> usize { return std::hash<String>{}(tag.name) ^ tag.weight; }
+};
+
 TEST_CASE("Rc") {
   SECTION("String") {
     Rc<String> a = crab::make_rc<String>("what");
   }
+  SECTION("Scalar") {
+    const Rc<i32> a = crab::make_rc<i32>(7);
+    const Rc<i32> b = a;
+    REQUIRE(*b == 7);
+    REQUIRE(not a.is_unique());
+  }
   SECTION("Downcast") {
     Rc<Bruh> original = crab::make_rc<Bruh>(42);
 
@@ -34,4 +52,59 @@ TEST_CASE("Rc") {
     REQUIRE(returned.is_some());
     REQUIRE(crab::unwrap(std::move(returned))->v == 42);
   }
+  SECTION("Copy Assign") {
+    const Rc<i32> a = crab::make_rc<i32>(1);
+    Rc<i32> b = crab::make_rc<i32>(2);
+    b = a;
+    REQUIRE(*b == 1);
+    REQUIRE(not a.is_unique());
+    b = crab::make_rc<i32>(3);
+    REQUIRE(a.is_unique());
+  }
+}
+
+TEST_CASE("Interned Rc") {
+  SECTION("Shared") {
+    const Rc<Tag> a = crab::make_rc_interned<Tag>("crab", 1);
+    const Rc<Tag> b = crab::make_rc_interned<Tag>("crab", 1);
+    const Rc<Tag> c = crab::make_rc_interned<Tag>("crab", 2);
+    REQUIRE(a.ptr_eq(b));
+    REQUIRE_FALSE(a.ptr_eq(c));
+    REQUIRE(*c == Tag{"crab", 2});
+
+    // not interned, equal but a value of its own
+    const Rc<Tag> d = crab::make_rc<Tag>("crab", 1);
+    REQUIRE(*d == *a);
+    REQUIRE_FALSE(d.ptr_eq(a));
+  }
+
+  SECTION("Dead Entries") {
+    crab::rc::InternTable<String> table;
+    const Rc<String> kept = table.intern("kept");
+    for (usize i = 0; i < 10; i++) (void) table.intern("dropped " + std::to_string(i));
+    REQUIRE(table.size() == 11);
+    REQUIRE(table.purge() == 10);
+    REQUIRE(table.size() == 1);
+    REQUIRE(kept.is_unique() == false);
+
+    // a dropped value comes back as a new one, a kept one is still shared
+    REQUIRE(table.intern("kept").ptr_eq(kept));
+    REQUIRE(*table.intern("dropped 3") == "dropped 3");
+    REQUIRE(table.size() == 2);
+  }
+
+  SECTION("Table Stays Small") {
+    crab::rc::InternTable<u64> table;
+    Vec<Rc<u64>> live;
+    for (u64 i = 0; i < 100'000; i++) {
+      Rc<u64> value = table.intern(i);
+      // one value in 100 is kept, the rest die right away
+      if (i % 100 == 0) live.push_back(std::move(value));
+    }
+    REQUIRE(table.size() < 4 * live.size() + 64);
+    const usize before = table.size();
+    REQUIRE(table.purge() == before - live.size());
+    REQUIRE(table.size() == live.size());
+    for (u64 i = 0; i < 100'000; i += 100) REQUIRE(table.intern(i).ptr_eq(live[i / 100]));
+  }
 }
@@ -26,24 +26,30 @@ TEST_CASE("Result", "[result]") {
     REQUIRE(result.get_unchecked() == 10);
     REQUIRE(result.take_unchecked() == 10);
 
+    #if DEBUG
     REQUIRE_THROWS(result.get_unchecked());
     REQUIRE_THROWS(result.get_err_unchecked());
     REQUIRE_THROWS(result.take_unchecked());
     REQUIRE_THROWS(result.take_err_unchecked());
+    #endif
 
     result = err(Error{});
     REQUIRE(result.is_err());
     REQUIRE_FALSE(result.is_ok());
+    #if DEBUG
     REQUIRE_THROWS(result.get_unchecked());
+    #endif
     REQUIRE_NOTHROW(result.get_err_unchecked());
 
     Error err;
     REQUIRE_NOTHROW(result.ensure_valid());
     REQUIRE_NOTHROW(err = crab::unwrap_err(std::move(result)));
 
+    #if DEBUG
     REQUIRE_THROWS(result.ensure_valid());
     REQUIRE_THROWS(crab::unwrap_err(std::move(result)));
     REQUIRE_THROWS(crab::unwrap(std::move(result)));
+    #endif
 
     result = crab::ok<u32>(42);
     REQUIRE_NOTHROW(result.ensure_valid());
@@ -74,14 +80,18 @@ TEST_CASE("Result", "[result]") {
     REQUIRE(huh.get_unchecked() == 20);
 
     std::ignore = huh.map([](const i32 a) { return a * 2; });
+    #if DEBUG
     REQUIRE_THROWS(huh.get_unchecked());
+    #endif
 
     huh = Error{};
     huh = huh.map([](const i32 a) { return a * 2; });
     REQUIRE(huh.is_err());
 
     std::ignore = huh.take_err_unchecked();
+    #if DEBUG
     REQUIRE_THROWS(std::ignore = huh.map([](const i32 a) { return a * 2; }));
+    #endif
   }
 
   SECTION("fold") {
@@ -0,0 +1,76 @@
+#include <ring_buffer.hpp>
+#include <box.hpp>
+
+#include <numeric>
+#include <catch2/catch_test_macros.hpp>
+
+
+TEST_CASE("RingBuffer", "[ring_buffer]") {
+  SECTION("Push & Pop") {
+    crab::RingBuffer<i32, 4> ring;
+    REQUIRE(ring.is_empty());
+    REQUIRE(ring.pop_front().is_none());
+    REQUIRE(ring.pop_back().is_none());
+    REQUIRE(ring.front().is_none());
+
+    ring.push_back(2);
+    ring.push_back(3);
+    ring.push_front(1);
+    REQUIRE(ring.length() == 3);
+    REQUIRE(*ring.front().take_unchecked() == 1);
+    REQUIRE(*ring.back().take_unchecked() == 3);
+    REQUIRE(ring[1] == 2);
+
+    ring.push_back(4);
+    REQUIRE(ring.is_full());
+
+    REQUIRE(ring.pop_front().take_unchecked() == 1);
+    REQUIRE(ring.pop_back().take_unchecked() == 4);
+    REQUIRE(ring.length() == 2);
+  }
+
+  SECTION("Overwriting") {
+    crab::RingBuffer<i32, 4> ring;
+    for (i32 i = 0; i < 4; i++) REQUIRE(ring.push_overwrite(i).is_none());
+
+    for (i32 i = 4; i < 100; i++) {
+      REQUIRE(ring.push_overwrite(i).take_unchecked() == i - 4);
+      REQUIRE(ring.length() == 4);
+      REQUIRE(ring[0] == i - 3);
+      REQUIRE(ring[3] == i);
+    }
+  }
+
+  SECTION("Spans & Iteration") {
+    crab::RingBuffer<i32, 8> ring;
+    for (i32 i = 0; i < 13; i++) (void) ring.push_overwrite(i);
+
+    // contents wrap around the end of the storage
+    const auto [first, second] = ring.as_spans();
+    REQUIRE(first.size() + second.size() == 8);
+    REQUIRE(not second.empty());
+
+    Vec<i32> joined{first.begin(), first.end()};
+    joined.insert(joined.end(), second.begin(), second.end());
+    REQUIRE(joined == Vec<i32>{5, 6, 7, 8, 9, 10, 11, 12});
+    REQUIRE(Vec<i32>{ring.begin(), ring.end()} == joined);
+    REQUIRE(std::accumulate(ring.begin(), ring.end(), 0) == 68);
+    REQUIRE(ring.end() - ring.begin() == 8);
+    REQUIRE(ring.begin()[2] == 7);
+
+    for (auto [a, b] = ring.as_spans_mut(); i32 &value: a) value = 0;
+    REQUIRE(ring[0] == 0);
+  }
+
+  SECTION("Non Trivial Elements") {
+    crab::RingBuffer<Box<i32>, 2> ring;
+    ring.push_back(crab::make_box<i32>(1));
+    ring.push_back(crab::make_box<i32>(2));
+    REQUIRE(*ring.push_overwrite(crab::make_box<i32>(3)).take_unchecked() == 1);
+
+    crab::RingBuffer<Box<i32>, 2> moved{std::move(ring)};
+    REQUIRE(ring.is_empty());
+    REQUIRE(*moved[0] == 2);
+    REQUIRE(*moved.pop_back().take_unchecked() == 3);
+  }
+}
@@ -0,0 +1,232 @@
+#include <roaring.hpp>
+
+#include <cstring>
+#include <random>
+#include <set>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  /**
+   * @brief Mix of a sparse chunk, a dense chunk & a chunk of long runs so every container pairing is hit
+   */
+  auto random_values(const u64 seed) -> std::set<u32> {
+    std::mt19937_64 rng{seed};
+    std::set<u32> values;
+    for (usize i = 0; i < 300; i++) values.insert(static_cast<u32>(rng() % (1 << 16)));
+    for (usize i = 0; i < 30'000; i++) values.insert((1 << 16) + static_cast<u32>(rng() % (1 << 16)));
+    for (usize run = 0; run < 20; run++) {
+      const u32 start = (2 << 16) + static_cast<u32>(rng() % 60'000);
+      for (u32 i = 0; i < 2'000; i++) values.insert(start + i);
+    }
+    for (usize i = 0; i < 100; i++) values.insert(static_cast<u32>(rng()));
+    return values;
+  }
+
+  auto from_set(const std::set<u32> &values) -> crab::RoaringBitmap {
+    const Vec<u32> sorted(values.begin(), values.end());
+    return crab::RoaringBitmap::from_sorted(sorted);
+  }
+
+  auto to_vec(const std::set<u32> &values) -> Vec<u32> { return {values.begin(), values.end()}; }
+}
+
+TEST_CASE("RoaringBitmap", "[roaring]") {
+  SECTION("Insert, Remove & Contains") {
+    crab::RoaringBitmap set;
+    REQUIRE(set.is_empty());
+    REQUIRE(set.min().is_none());
+
+    REQUIRE(set.insert(5));
+    REQUIRE_FALSE(set.insert(5));
+    REQUIRE(set.insert(0xffff'ffff));
+    REQUIRE(set.insert(70'000));
+    REQUIRE(set.contains(5));
+    REQUIRE(set.contains(70'000));
+    REQUIRE_FALSE(set.contains(6));
+    REQUIRE(set.cardinality() == 3);
+    REQUIRE(set.min().take_unchecked() == 5);
+    REQUIRE(set.max().take_unchecked() == 0xffff'ffff);
+
+    REQUIRE(set.remove(70'000));
+    REQUIRE_FALSE(set.remove(70'000));
+    REQUIRE(set.container_count() == 2);
+  }
+
+  SECTION("Array & Bitmap Containers") {
+    crab::RoaringBitmap set;
+    for (u32 i = 0; i < 10'000; i++) set.insert(i * 3);
+    REQUIRE(set.container(0).kind == crab::roaring::Kind::Bitmap);
+    REQUIRE(set.cardinality() == 10'000);
+
+    for (u32 i = 0; i < 10'000; i++) {
+      REQUIRE(set.contains(i * 3));
+      REQUIRE_FALSE(set.contains(i * 3 + 1));
+    }
+
+    for (u32 i = 0; i < 8'000; i++) set.remove(i * 3);
+    REQUIRE(set.cardinality() == 2'000);
+    REQUIRE(set.container(0).kind == crab::roaring::Kind::Array);
+    REQUIRE(set.to_vec().front() == 24'000);
+  }
+
+  SECTION("Run Containers") {
+    crab::RoaringBitmap set;
+    set.insert_range(Range<u32>{100, 200'000});
+    REQUIRE(set.cardinality() == 199'900);
+    REQUIRE(set.container(0).kind == crab::roaring::Kind::Run);
+    REQUIRE(set.contains(100));
+    REQUIRE(set.contains(199'999));
+    REQUIRE_FALSE(set.contains(99));
+    REQUIRE_FALSE(set.contains(200'000));
+
+    // splitting & joining runs
+    REQUIRE(set.remove(1'000));
+    REQUIRE_FALSE(set.contains(1'000));
+    REQUIRE(set.container(0).runs().size() == 2);
+    REQUIRE(set.insert(1'000));
+    REQUIRE(set.container(0).runs().size() == 1);
+    REQUIRE(set.remove(100));
+    REQUIRE(set.insert(99));
+    REQUIRE(set.insert(100));
+    REQUIRE(set.min().take_unchecked() == 99);
+    REQUIRE(set.max().take_unchecked() == 199'999);
+    REQUIRE(set.cardinality() == 199'901);
+
+    crab::RoaringBitmap dense;
+    for (u32 i = 0; i < 50'000; i++) dense.insert(i);
+    REQUIRE(dense.container(0).kind == crab::roaring::Kind::Bitmap);
+    dense.optimize();
+    REQUIRE(dense.container(0).kind == crab::roaring::Kind::Run);
+    REQUIRE(dense.cardinality() == 50'000);
+  }
+
+  SECTION("Iteration") {
+    const std::set<u32> expected = random_values(1);
+    crab::RoaringBitmap set = from_set(expected);
+
+    REQUIRE(Vec<u32>(set.begin(), set.end()) == to_vec(expected));
+    REQUIRE(set.to_vec() == to_vec(expected));
+
+    set.optimize();
+    REQUIRE(Vec<u32>(set.begin(), set.end()) == to_vec(expected));
+    REQUIRE(set.cardinality() == expected.size());
+  }
+
+  SECTION("Set Operations") {
+    const std::set<u32> a = random_values(2);
+    const std::set<u32> b = random_values(3);
+
+    Vec<u32> both, either, only_a, one;
+    std::ranges::set_intersection(a, b, std::back_inserter(both));
+    std::ranges::set_union(a, b, std::back_inserter(either));
+    std::ranges::set_difference(a, b, std::back_inserter(only_a));
+    std::ranges::set_symmetric_difference(a, b, std::back_inserter(one));
+
+    for (const bool optimize_a: {false, true}) {
+      for (const bool optimize_b: {false, true}) {
+        crab::RoaringBitmap x = from_set(a);
+        crab::RoaringBitmap y = from_set(b);
+        if (optimize_a) x.optimize();
+        if (optimize_b) y.optimize();
+
+        REQUIRE((x & y).to_vec() == both);
+        REQUIRE((x | y).to_vec() == either);
+        REQUIRE((x - y).to_vec() == only_a);
+        REQUIRE((x ^ y).to_vec() == one);
+        REQUIRE((x & x) == x);
+        REQUIRE((x - x).is_empty());
+      }
+    }
+  }
+
+  SECTION("Serialization") {
+    const std::set<u32> expected = random_values(4);
+    crab::RoaringBitmap set = from_set(expected);
+    set.optimize();
+
+    const Vec<u8> bytes = set.serialize();
+    REQUIRE(bytes.size() == set.serialized_size());
+
+    auto opened = crab::RoaringView::from_bytes(bytes);
+    REQUIRE(opened.is_ok());
+    const crab::RoaringView view = opened.take_unchecked();
+
+    REQUIRE(view.cardinality() == expected.size());
+    REQUIRE(Vec<u32>(view.begin(), view.end()) == to_vec(expected));
+    for (const u32 value: expected) REQUIRE(view.contains(value));
+    REQUIRE(view.to_bitmap() == set);
+
+    const crab::RoaringBitmap other = from_set(random_values(5));
+    REQUIRE(crab::roaring::intersect(view, other) == (set & other));
+    REQUIRE(crab::roaring::unite(other, view) == (set | other));
+  }
+
+  SECTION("Rejecting Malformed Buffers") {
+    const crab::RoaringBitmap set{1, 2, 3, 100'000};
+    Vec<u8> bytes = set.serialize();
+
+    REQUIRE(crab::RoaringView::from_bytes(Span<const u8>{bytes}.first(4)).is_err());
+
+    // the last container's two byte array is padded to eight bytes
+    Vec<u8> truncated = bytes;
+    truncated.resize(bytes.size() - 7);
+    REQUIRE(crab::RoaringView::from_bytes(truncated).is_err());
+
+    bytes[0] ^= 1;
+    REQUIRE(crab::RoaringView::from_bytes(bytes).is_err());
+    bytes[0] ^= 1;
+
+    // kind of the first container
+    bytes[10] = 7;
+    REQUIRE(crab::RoaringView::from_bytes(bytes).is_err());
+
+    REQUIRE(crab::RoaringView::from_bytes(crab::RoaringBitmap{}.serialize()).is_ok());
+  }
+
+  SECTION("Rejecting Corrupt Containers") {
+    // a single container, its payload right after the header & the one descriptor
+    constexpr usize PAYLOAD = 8 + 16;
+    const auto serialize = [](const Vec<u32> &values, const crab::roaring::Kind kind) {
+      crab::RoaringBitmap set = crab::RoaringBitmap::from_sorted(values);
+      set.optimize();
+      Vec<u8> bytes = set.serialize();
+      REQUIRE(crab::RoaringView::from_bytes(bytes).take_unchecked().container(0).kind == kind);
+      return bytes;
+    };
+    const auto write_u16 = [](Vec<u8> &bytes, const usize at, const u16 value) {
+      std::memcpy(bytes.data() + at, &value, sizeof(value));
+    };
+
+    Vec<u8> array = serialize({1, 5, 9}, crab::roaring::Kind::Array);
+    write_u16(array, PAYLOAD, 9);
+    REQUIRE(crab::RoaringView::from_bytes(array).is_err());
+    write_u16(array, PAYLOAD, 5);
+    REQUIRE(crab::RoaringView::from_bytes(array).is_err());
+
+    Vec<u32> even;
+    for (u32 value = 0; value < 10'000; value += 2) even.push_back(value);
+    Vec<u8> bitmap = serialize(even, crab::roaring::Kind::Bitmap);
+    std::fill(bitmap.begin() + PAYLOAD, bitmap.end(), 0);
+    REQUIRE(crab::RoaringView::from_bytes(bitmap).is_err());
+
+    // runs [0, 999] & [2000, 2999], each a start & a length one less than the values it holds
+    Vec<u32> ranges;
+    for (u32 value = 0; value < 1'000; value++) ranges.push_back(value);
+    for (u32 value = 2'000; value < 3'000; value++) ranges.push_back(value);
+    const Vec<u8> runs = serialize(ranges, crab::roaring::Kind::Run);
+
+    Vec<u8> past_end = runs;
+    write_u16(past_end, PAYLOAD + 4, 0xfff0);
+    REQUIRE(crab::RoaringView::from_bytes(past_end).is_err());
+
+    Vec<u8> overlapping = runs;
+    write_u16(overlapping, PAYLOAD + 4, 500);
+    REQUIRE(crab::RoaringView::from_bytes(overlapping).is_err());
+
+    Vec<u8> miscounted = runs;
+    write_u16(miscounted, PAYLOAD + 2, 998);
+    REQUIRE(crab::RoaringView::from_bytes(miscounted).is_err());
+
+    REQUIRE(crab::RoaringView::from_bytes(runs).is_ok());
+  }
+}
@@ -0,0 +1,83 @@
+#include <skip_list.hpp>
+
+#include <thread>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("ConcurrentSkipList", "[skip_list]") {
+  SECTION("Single Threaded") {
+    crab::ConcurrentSkipList<i32, String> list;
+    REQUIRE(list.is_empty());
+
+    REQUIRE(list.insert(3, "three"));
+    REQUIRE(list.insert(1, "one"));
+    REQUIRE(list.insert(2, "two"));
+    REQUIRE_FALSE(list.insert(2, "deux"));
+
+    REQUIRE(list.length() == 3);
+    REQUIRE(list.get(2).take_unchecked() == "two");
+    REQUIRE(list.get(4).is_none());
+
+    {
+      const crab::epoch::Guard guard{};
+      REQUIRE(*list.get(1, guard).take_unchecked() == "one");
+    }
+
+    REQUIRE(list.remove(2));
+    REQUIRE_FALSE(list.remove(2));
+    REQUIRE_FALSE(list.contains(2));
+
+    Vec<i32> keys;
+    for (const auto [key, value]: list.scan()) {
+      keys.push_back(*key);
+    }
+    REQUIRE(keys == Vec<i32>{1, 3});
+  }
+
+  SECTION("Concurrent inserts, removals & scans") {
+    crab::ConcurrentSkipList<u64, u64> list;
+    constexpr u64 THREADS = 4;
+    constexpr u64 PER_THREAD = 20'000;
+
+    Vec<std::thread> threads;
+    for (u64 t = 0; t < THREADS; t++) {
+      threads.emplace_back([&list, t] {
+        for (u64 i = 0; i < PER_THREAD; i++) {
+          const u64 key = i * THREADS + t;
+          list.insert(key, key * 2);
+          // remove every odd key again once it has been inserted
+          if (key % 2 == 1) list.remove(key);
+        }
+      });
+    }
+
+    // Catch2 assertions are not thread safe, so the scanning thread only records whether it saw a bad entry
+    std::atomic<bool> scan_consistent{true};
+    threads.emplace_back([&list, &scan_consistent] {
+      for (usize round = 0; round < 50; round++) {
+        u64 previous = 0;
+        bool first = true;
+        for (const auto [key, value]: list.range(1'000, 50'000)) {
+          if (*value != *key * 2 or (not first and *key <= previous) or *key < 1'000 or *key >= 50'000) {
+            scan_consistent = false;
+          }
+          previous = *key;
+          first = false;
+        }
+      }
+    });
+
+    for (std::thread &thread: threads) thread.join();
+
+    REQUIRE(scan_consistent);
+
+    REQUIRE(list.length() == THREADS * PER_THREAD / 2);
+
+    u64 expected = 0;
+    for (const auto [key, value]: list.scan()) {
+      REQUIRE(*key == expected);
+      REQUIRE(*value == expected * 2);
+      expected += 2;
+    }
+    REQUIRE(expected == THREADS * PER_THREAD);
+  }
+}
@@ -0,0 +1,60 @@
+#include <static_search_index.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("StaticSearchIndex", "[static_search_index]") {
+  SECTION("Matches std::lower_bound") {
+    std::mt19937_64 rng{8};
+
+    for (const usize size: {0uz, 1uz, 2uz, 3uz, 15uz, 16uz, 17uz, 100uz, 1'023uz, 1'024uz, 5'000uz}) {
+      Vec<u32> sorted(size);
+      // plenty of duplicates
+      for (u32 &value: sorted) value = static_cast<u32>(rng() % (size * 2 + 1));
+      std::sort(sorted.begin(), sorted.end());
+
+      const crab::StaticSearchIndex<u32> index{sorted};
+      REQUIRE(index.length() == size);
+      REQUIRE(index.is_empty() == (size == 0));
+
+      Vec<u32> keys;
+      for (u32 key = 0; key <= size * 2 + 2; key++) keys.push_back(key);
+
+      Vec<usize> batched(keys.size());
+      index.lower_bound_batch(keys, batched);
+
+      for (usize i = 0; i < keys.size(); i++) {
+        const auto expected = static_cast<usize>(std::lower_bound(sorted.begin(), sorted.end(), keys[i]) - sorted.begin());
+        REQUIRE(index.lower_bound(keys[i]) == expected);
+        REQUIRE(batched[i] == expected);
+      }
+
+      for (usize i = 0; i < size; i++) REQUIRE(index.value(i) == sorted[i]);
+    }
+  }
+
+  SECTION("Find") {
+    const Vec<i32> sorted{-7, -2, 0, 3, 3, 3, 10, 42};
+    const crab::StaticSearchIndex<i32> index{sorted};
+
+    REQUIRE(index.find(3).get_unchecked() == 3);
+    REQUIRE(index.find(-7).get_unchecked() == 0);
+    REQUIRE(index.find(42).get_unchecked() == 7);
+    REQUIRE(index.find(4).is_none());
+    REQUIRE(index.find(-100).is_none());
+    REQUIRE(index.find(100).is_none());
+    REQUIRE(index.contains(10));
+    REQUIRE_FALSE(index.contains(11));
+  }
+
+  SECTION("Custom Comparator & Wide Keys") {
+    const Vec<String> sorted{"pear", "melon", "kiwi", "fig", "apple"};
+    const crab::StaticSearchIndex<String, std::greater<>> index{sorted};
+
+    REQUIRE(index.lower_bound("zebra") == 0);
+    REQUIRE(index.lower_bound("lemon") == 2);
+    REQUIRE(index.lower_bound("aardvark") == 5);
+    REQUIRE(index.find("fig").get_unchecked() == 3);
+    REQUIRE(index.value(1) == "melon");
+  }
+}
@@ -0,0 +1,117 @@
+#include <strings.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  template<typename Tokens>
+  auto collect(Tokens tokens) -> Vec<String> {
+    Vec<String> pieces;
+    for (const StringView piece: tokens) pieces.emplace_back(piece);
+    return pieces;
+  }
+
+  /**
+   * @brief Straightforward std::string_view based split, what the SIMD one must agree with
+   */
+  auto reference_split(const StringView text, const StringView delimiter) -> Vec<String> {
+    Vec<String> pieces;
+    usize start = 0;
+    for (usize at; (at = text.find(delimiter, start)) != StringView::npos; start = at + delimiter.size()) {
+      pieces.emplace_back(text.substr(start, at - start));
+    }
+    pieces.emplace_back(text.substr(start));
+    return pieces;
+  }
+}
+
+TEST_CASE("split", "[strings]") {
+  SECTION("Byte") {
+    REQUIRE(collect(crab::split("a,b,,c", ',')) == Vec<String>{"a", "b", "", "c"});
+    REQUIRE(collect(crab::split(",a,", ',')) == Vec<String>{"", "a", ""});
+    REQUIRE(collect(crab::split("", ',')) == Vec<String>{""});
+    REQUIRE(collect(crab::split("abc", ',')) == Vec<String>{"abc"});
+  }
+
+  SECTION("String") {
+    REQUIRE(collect(crab::split("a, b, c", ", ")) == Vec<String>{"a", "b", "c"});
+    REQUIRE(collect(crab::split("a::::b", "::")) == Vec<String>{"a", "", "b"});
+    REQUIRE(collect(crab::split("x", "xyz")) == Vec<String>{"x"});
+  }
+
+  SECTION("Next & Remainder") {
+    auto pieces = crab::split("key=value=more", '=');
+    REQUIRE(pieces.next().take_unchecked() == "key");
+    REQUIRE(pieces.remainder().take_unchecked() == "value=more");
+    REQUIRE(pieces.next().take_unchecked() == "value");
+    REQUIRE(pieces.next().take_unchecked() == "more");
+    REQUIRE(pieces.next().is_none());
+    REQUIRE(pieces.remainder().is_none());
+    REQUIRE(pieces.next().is_none());
+  }
+
+  SECTION("Any") {
+    REQUIRE(collect(crab::split_any("a,b;c d", ",; ")) == Vec<String>{"a", "b", "c", "d"});
+    // more delimiters than are compared a vector at a time
+    const String text = "0a1b2c3d4e5f6g7h8i9j" + String(40, 'k') + "!";
+    REQUIRE(collect(crab::split_any(text, "0123456789!")).size() == 12);
+    REQUIRE(collect(crab::split_any(text, "!")) == Vec<String>{text.substr(0, text.size() - 1), ""});
+  }
+
+  SECTION("Random Against std::string_view::find") {
+    std::mt19937_64 rng{21};
+    for (usize round = 0; round < 2'000; round++) {
+      // few distinct letters so that delimiters & near misses are common, long enough to cross vectors
+      String text(rng() % 300, '\0');
+      for (char &c: text) c = static_cast<char>('a' + rng() % 3);
+      String delimiter(1 + rng() % 4, '\0');
+      for (char &c: delimiter) c = static_cast<char>('a' + rng() % 3);
+
+      REQUIRE(collect(crab::split(text, delimiter)) == reference_split(text, delimiter));
+      REQUIRE(collect(crab::split(text, delimiter[0])) == reference_split(text, delimiter.substr(0, 1)));
+    }
+  }
+}
+
+TEST_CASE("split_whitespace & lines", "[strings]") {
+  SECTION("Whitespace") {
+    REQUIRE(collect(crab::split_whitespace("  a \t\nbb\r\f\vccc  ")) == Vec<String>{"a", "bb", "ccc"});
+    REQUIRE(collect(crab::split_whitespace("")).empty());
+    REQUIRE(collect(crab::split_whitespace(" \n\t ")).empty());
+
+    String text;
+    Vec<String> words;
+    for (usize i = 0; i < 50; i++) {
+      words.push_back(String(i % 37 + 1, static_cast<char>('a' + i % 26)));
+      text += words.back() + String(i % 41 + 1, i % 2 == 0 ? ' ' : '\n');
+    }
+    REQUIRE(collect(crab::split_whitespace(text)) == words);
+  }
+
+  SECTION("Lines") {
+    REQUIRE(collect(crab::lines("one\ntwo\r\nthree")) == Vec<String>{"one", "two", "three"});
+    REQUIRE(collect(crab::lines("one\n\ntwo\n")) == Vec<String>{"one", "", "two"});
+    REQUIRE(collect(crab::lines("")).empty());
+    REQUIRE(collect(crab::lines("\n")) == Vec<String>{""});
+    // a lone '\r' at the very end is not a line ending
+    REQUIRE(collect(crab::lines("a\r")) == Vec<String>{"a\r"});
+  }
+}
+
+TEST_CASE("find & contains", "[strings]") {
+  REQUIRE(crab::find("hello world", "world").take_unchecked() == 6);
+  REQUIRE(crab::find("hello world", 'o').take_unchecked() == 4);
+  REQUIRE(crab::find("hello", "").take_unchecked() == 0);
+  REQUIRE(crab::find("hello", "hello!").is_none());
+  REQUIRE(crab::find("", 'x').is_none());
+  REQUIRE(crab::contains("crab crab crab", "b c"));
+  REQUIRE(not crab::contains("crab crab crab", "crabs"));
+  REQUIRE(crab::contains("abc", 'c'));
+
+  const String long_text = String(1000, 'a') + "ab" + String(100, 'a');
+  REQUIRE(crab::find(long_text, "ab").take_unchecked() == 1000);
+  REQUIRE(crab::find(long_text, "aab").take_unchecked() == 999);
+  REQUIRE(crab::find(long_text, 'b').take_unchecked() == 1001);
+  REQUIRE(crab::find(long_text, "ba").take_unchecked() == 1001);
+  REQUIRE(crab::find(long_text, "bb").is_none());
+}
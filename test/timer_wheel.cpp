@@ -0,0 +1,190 @@
+#include <timer_wheel.hpp>
+
+#include <map>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("TimerWheel", "[timer_wheel]") {
+  SECTION("Fires In Order") {
+    crab::TimerWheel<u32> wheel;
+    for (const u64 deadline: {70, 5, 4'100, 64, 5, 300'000}) wheel.schedule(deadline, static_cast<u32>(deadline));
+    REQUIRE(wheel.size() == 6);
+
+    Vec<u32> fired;
+    const auto record = [&](const u32 value) { fired.push_back(value); };
+    REQUIRE(wheel.advance(4, record) == 0);
+    REQUIRE(wheel.advance(64, record) == 3);
+    REQUIRE(fired == Vec<u32>{5, 5, 64});
+    REQUIRE(wheel.now() == 64);
+
+    REQUIRE(wheel.advance(1'000'000, record) == 3);
+    REQUIRE(fired == Vec<u32>{5, 5, 64, 70, 4'100, 300'000});
+    REQUIRE(wheel.is_empty());
+    REQUIRE(wheel.next_deadline().is_none());
+  }
+
+  SECTION("Cancel") {
+    crab::TimerWheel<String> wheel{1'000};
+    const auto keep = wheel.schedule_after(10, "keep");
+    const auto drop = wheel.schedule_after(10, "drop");
+    const auto later = wheel.schedule_after(100'000, "later");
+    REQUIRE(wheel.deadline(drop).take_unchecked() == 1'010);
+
+    REQUIRE(wheel.cancel(drop).take_unchecked() == "drop");
+    REQUIRE_FALSE(wheel.is_pending(drop));
+    REQUIRE(wheel.cancel(drop).is_none());
+    REQUIRE(wheel.cancel(later).take_unchecked() == "later");
+    REQUIRE(wheel.size() == 1);
+
+    // the slot of 'drop' is reused, its handle still refers to nothing
+    const auto reused = wheel.schedule_after(20, "reused");
+    REQUIRE_FALSE(wheel.is_pending(drop));
+    REQUIRE_FALSE(reused == drop);
+    REQUIRE(wheel.cancel(drop).is_none());
+
+    Vec<String> fired;
+    wheel.advance(2'000, [&](String value) { fired.push_back(std::move(value)); });
+    REQUIRE(fired == Vec<String>{"keep", "reused"});
+    REQUIRE_FALSE(wheel.is_pending(keep));
+    REQUIRE(wheel.cancel(keep).is_none());
+  }
+
+  SECTION("Past Deadlines") {
+    crab::TimerWheel<u32> wheel{500};
+    wheel.schedule(10, 1);
+    wheel.schedule(500, 2);
+    REQUIRE(wheel.next_deadline().take_unchecked() == 500);
+    REQUIRE(wheel.advance(500, [](u32) {}) == 2);
+  }
+
+  SECTION("Next Deadline") {
+    // exact within the block of 64 ticks now() is in
+    crab::TimerWheel<u32> wheel{100};
+    wheel.schedule(120, 0);
+    REQUIRE(wheel.next_deadline().take_unchecked() == 120);
+
+    // a far deadline is only known to its slot's start, which is not after it
+    crab::TimerWheel<u32> far;
+    far.schedule(1'000'000, 0);
+    const u64 bound = far.next_deadline().take_unchecked();
+    REQUIRE(bound <= 1'000'000);
+    REQUIRE(far.advance(bound, [](u32) {}) == 0);
+    REQUIRE(far.next_deadline().take_unchecked() > bound);
+  }
+
+  SECTION("Callbacks") {
+    crab::TimerWheel<std::function<void()>> wheel;
+    usize calls = 0;
+    wheel.schedule(3, [&] { calls++; });
+    wheel.schedule(3, [&] { calls += 10; });
+    REQUIRE(wheel.advance(3) == 2);
+    REQUIRE(calls == 11);
+  }
+
+  SECTION("Callbacks Reschedule & Cancel") {
+    crab::TimerWheel<u32> wheel;
+    Vec<u32> fired;
+    // timers due at the same tick fire in the order they were scheduled
+    wheel.schedule(64, 1);
+    const auto victim = wheel.schedule(64, 99);
+    const auto on_expired = [&](const u32 value) {
+      fired.push_back(value);
+      if (value == 1) {
+        REQUIRE(wheel.cancel(victim).take_unchecked() == 99);
+        // due within the same advance, & one past it
+        wheel.schedule_after(10, 2);
+        wheel.schedule_after(1'000, 3);
+      }
+    };
+    REQUIRE(wheel.advance(100, on_expired) == 2);
+    REQUIRE(fired == Vec<u32>{1, 2});
+    REQUIRE(wheel.size() == 1);
+    REQUIRE(wheel.advance(1'064, on_expired) == 1);
+    REQUIRE(fired == Vec<u32>{1, 2, 3});
+  }
+
+  SECTION("Clear") {
+    crab::TimerWheel<u32> wheel;
+    const auto handle = wheel.schedule(10, 1);
+    wheel.schedule(100'000, 2);
+    wheel.clear();
+    REQUIRE(wheel.is_empty());
+    REQUIRE_FALSE(wheel.is_pending(handle));
+    REQUIRE(wheel.advance(1'000'000, [](u32) {}) == 0);
+  }
+
+  SECTION("Full Tick Range") {
+    constexpr u64 MAX = std::numeric_limits<u64>::max();
+    crab::TimerWheel<u32> wheel{MAX - 100};
+    wheel.schedule(MAX, 1);
+    wheel.schedule(MAX - 50, 2);
+    Vec<u32> fired;
+    REQUIRE(wheel.advance(MAX, [&](const u32 value) { fired.push_back(value); }) == 2);
+    REQUIRE(fired == Vec<u32>{2, 1});
+
+    crab::TimerWheel<u32> from_zero;
+    from_zero.schedule(MAX, 1);
+    from_zero.schedule(u64{1} << 63, 2);
+    fired.clear();
+    REQUIRE(from_zero.advance(MAX, [&](const u32 value) { fired.push_back(value); }) == 2);
+    REQUIRE(fired == Vec<u32>{2, 1});
+  }
+
+  SECTION("Against std::multimap") {
+    std::mt19937_64 rng{123};
+    crab::TimerWheel<u32> wheel;
+    std::multimap<u64, u32> expected;
+    Vec<crab::TimerWheel<u32>::Handle> handles;
+    Vec<std::multimap<u64, u32>::iterator> positions;
+    Vec<bool> pending;
+
+    u64 now = 0;
+    for (usize step = 0; step < 20'000; step++) {
+      switch (rng() % 4) {
+        case 0:
+        case 1: {
+          // mostly short timeouts, some far ones
+          const u64 deadline = now + (rng() % 8 == 0 ? rng() % 10'000'000 : rng() % 300);
+          const u32 id = static_cast<u32>(handles.size());
+          handles.push_back(wheel.schedule(deadline, id));
+          positions.push_back(expected.emplace(deadline, id));
+          pending.push_back(true);
+          break;
+        }
+        case 2: {
+          if (handles.empty()) break;
+          const usize id = rng() % handles.size();
+          const auto cancelled = wheel.cancel(handles[id]);
+          REQUIRE(cancelled.is_some() == pending[id]);
+          if (pending[id]) {
+            expected.erase(positions[id]);
+            pending[id] = false;
+          }
+          break;
+        }
+        default: {
+          now += rng() % 8 == 0 ? rng() % 100'000 : rng() % 50;
+          Vec<std::pair<u64, u32>> fired;
+          wheel.advance(now, [&](const u32 id) {
+            REQUIRE(pending[id]);
+            pending[id] = false;
+            fired.emplace_back(positions[id]->first, id);
+          });
+          // same timers, in order of deadline
+          Vec<std::pair<u64, u32>> due;
+          while (not expected.empty() and expected.begin()->first <= now) {
+            due.emplace_back(*expected.begin());
+            expected.erase(expected.begin());
+          }
+          REQUIRE(fired.size() == due.size());
+          for (usize i = 0; i < fired.size(); i++) REQUIRE(fired[i].first == due[i].first);
+          std::ranges::sort(fired);
+          std::ranges::sort(due);
+          REQUIRE(fired == due);
+        }
+      }
+      REQUIRE(wheel.size() == expected.size());
+      if (not expected.empty()) REQUIRE(wheel.next_deadline().take_unchecked() <= expected.begin()->first);
+    }
+  }
+}
@@ -0,0 +1,199 @@
+#include <utf.hpp>
+
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+
+namespace {
+  auto encode(const u32 point) -> String {
+    String text(4, '\0');
+    char *cursor = text.data();
+    crab::utf::helper::encode(point, cursor);
+    text.resize(static_cast<usize>(cursor - text.data()));
+    return text;
+  }
+
+  /**
+   * @brief Random valid UTF-8 with a mix of 1 to 4 byte sequences & long ASCII runs
+   */
+  auto random_text(std::mt19937_64 &rng, const usize points) -> std::pair<String, Vec<u32>> {
+    String text;
+    Vec<u32> decoded;
+    for (usize i = 0; i < points; i++) {
+      u32 point;
+      switch (rng() % 5) {
+        case 0: point = 0x80 + rng() % (0x800 - 0x80);
+          break;
+        case 1: point = 0x800 + rng() % (0x10000 - 0x800);
+          break;
+        case 2: point = 0x10000 + rng() % (0x110000 - 0x10000);
+          break;
+        default: point = rng() % 0x80;
+      }
+      if (point >= 0xd800 and point < 0xe000) point = 'x';
+      text += encode(point);
+      decoded.push_back(point);
+    }
+    return {text, decoded};
+  }
+
+  /**
+   * @brief Every validator that is compiled in must agree with the scalar one
+   */
+  auto check_validators(const String &text) -> usize {
+    const auto *data = reinterpret_cast<const u8*>(text.data());
+    const usize expected = crab::utf::helper::scalar_valid_up_to(data, text.size());
+    #if defined(__SSSE3__)
+    REQUIRE(crab::utf::helper::simd_valid_up_to<crab::utf::helper::Sse>(data, text.size()) == expected);
+    #endif
+    #if defined(__AVX2__)
+    REQUIRE(crab::utf::helper::simd_valid_up_to<crab::utf::helper::Avx2>(data, text.size()) == expected);
+    #endif
+    REQUIRE(crab::utf::is_valid(text) == (expected == text.size()));
+    return expected;
+  }
+}
+
+TEST_CASE("utf::validate", "[utf]") {
+  SECTION("Valid") {
+    REQUIRE(crab::utf::validate("").is_ok());
+    REQUIRE(crab::utf::validate("plain ascii").is_ok());
+    REQUIRE(crab::utf::validate("crab 🦀 krabbe κάβουρας 螃蟹").is_ok());
+
+    // every code point on its own, & all of them in one string
+    String all;
+    for (u32 point = 0; point < 0x110000; point++) {
+      if (point >= 0xd800 and point < 0xe000) continue;
+      all += encode(point);
+    }
+    REQUIRE(check_validators(all) == all.size());
+  }
+
+  SECTION("Invalid Sequences") {
+    const std::pair<StringView, usize> cases[]{
+      {"\x80", 0}, // stray continuation
+      {"a\xbf", 1},
+      {"\xc0\x80", 0}, // overlong NUL
+      {"\xc1\xbf", 0},
+      {"\xe0\x80\x80", 0}, // overlong 3 byte
+      {"\xe0\x9f\xbf", 0},
+      {"\xed\xa0\x80", 0}, // surrogate
+      {"\xed\xbf\xbf", 0},
+      {"\xf0\x80\x80\x80", 0}, // overlong 4 byte
+      {"\xf0\x8f\xbf\xbf", 0},
+      {"\xf4\x90\x80\x80", 0}, // past U+10FFFF
+      {"\xf5\x80\x80\x80", 0},
+      {"\xff", 0},
+      {"ab\xc3", 2}, // truncated at the end
+      {"ab\xe2\x82", 2},
+      {"ab\xf0\x9f\xa6", 2},
+      {"\xc3(", 0}, // missing continuation
+      {"\xe2\x28\xa1", 0},
+      {"\xc3\xa9\x80", 2}, // one continuation too many
+      {"\xf0\x9f\xa6\x80\x80", 4},
+    };
+
+    for (const auto &[sequence, offset]: cases) {
+      REQUIRE(crab::utf::validate(sequence).take_err_unchecked().offset() == offset);
+
+      // at every position around vector boundaries, behind valid multi byte text
+      for (usize prefix = 0; prefix < 70; prefix++) {
+        String text = String(prefix % 3, 'a');
+        while (text.size() < prefix) text += "é";
+        const usize start = text.size();
+        text += sequence;
+        REQUIRE(check_validators(text) == start + offset);
+        text += String(40, 'z');
+        REQUIRE(check_validators(text) == start + offset);
+      }
+    }
+  }
+
+  SECTION("Random Corruption") {
+    std::mt19937_64 rng{14};
+    for (usize round = 0; round < 3'000; round++) {
+      auto [text, decoded] = random_text(rng, 1 + rng() % 200);
+      REQUIRE(check_validators(text) == text.size());
+
+      for (usize flips = 1 + rng() % 3; flips > 0; flips--) text[rng() % text.size()] = static_cast<char>(rng());
+      check_validators(text);
+    }
+  }
+
+  SECTION("Error") {
+    const auto error = crab::utf::validate("ok\xff").take_err_unchecked();
+    REQUIRE(error.offset() == 2);
+    REQUIRE(error.what() == "invalid UTF-8 at byte 2");
+  }
+}
+
+TEST_CASE("utf transcoding", "[utf]") {
+  SECTION("Round Trips") {
+    std::mt19937_64 rng{15};
+    for (usize round = 0; round < 2'000; round++) {
+      const auto [text, decoded] = random_text(rng, rng() % 300);
+
+      Vec<char32> utf32(crab::utf::utf32_length(text));
+      REQUIRE(utf32.size() == decoded.size());
+      REQUIRE(crab::utf::utf8_to_utf32(text, utf32).take_unchecked() == decoded.size());
+      REQUIRE(std::equal(utf32.begin(), utf32.end(), decoded.begin()));
+
+      Vec<char16> utf16(crab::utf::utf16_length(text));
+      REQUIRE(crab::utf::utf8_to_utf16(text, utf16).take_unchecked() == utf16.size());
+
+      String back(crab::utf::utf8_length(Span<const char16>{utf16}), '\0');
+      REQUIRE(back.size() == text.size());
+      REQUIRE(crab::utf::utf16_to_utf8(utf16, back).take_unchecked() == text.size());
+      REQUIRE(back == text);
+
+      REQUIRE(crab::utf::utf8_length(Span<const char32>{utf32}) == text.size());
+      std::fill(back.begin(), back.end(), '\0');
+      REQUIRE(crab::utf::utf32_to_utf8(utf32, back).take_unchecked() == text.size());
+      REQUIRE(back == text);
+    }
+  }
+
+  SECTION("Surrogate Pairs") {
+    Vec<char16> utf16(4);
+    REQUIRE(crab::utf::utf8_to_utf16("🦀a", utf16).take_unchecked() == 3);
+    REQUIRE(utf16[0] == 0xd83e);
+    REQUIRE(utf16[1] == 0xdd80);
+    REQUIRE(utf16[2] == 'a');
+  }
+
+  SECTION("Invalid Input") {
+    Vec<char16> utf16(16);
+    REQUIRE(crab::utf::utf8_to_utf16("abc\xed\xa0\x80", utf16).take_err_unchecked().offset() == 3);
+    // text.size() units are enough even when utf16_length over counts invalid leads
+    for (const StringView invalid: {"\xff", "\xf5", "a\xf8" "b", "\xf0"}) {
+      Vec<char16> exact(invalid.size());
+      REQUIRE(crab::utf::utf8_to_utf16(invalid, exact).is_err());
+    }
+
+    String out(64, '\0');
+    const Vec<char16> lone_high{'a', 0xd83e, 'b'};
+    REQUIRE(crab::utf::utf16_to_utf8(lone_high, out).take_err_unchecked().offset() == 1);
+    const Vec<char16> lone_low{'a', 'b', 0xdd80};
+    REQUIRE(crab::utf::utf16_to_utf8(lone_low, out).take_err_unchecked().offset() == 2);
+    const Vec<char16> truncated{'a', 0xd83e};
+    REQUIRE(crab::utf::utf16_to_utf8(truncated, out).take_err_unchecked().offset() == 1);
+
+    Vec<char32> utf32(40, 'a');
+    utf32[5] = 0x110000;
+    REQUIRE(crab::utf::utf32_to_utf8(utf32, out).take_err_unchecked().offset() == 5);
+    utf32[5] = 0xdfff;
+    REQUIRE(crab::utf::utf32_to_utf8(utf32, out).take_err_unchecked().offset() == 5);
+    // must not saturate into something that looks like ASCII
+    utf32[5] = 0x10041;
+    REQUIRE(crab::utf::utf32_to_utf8(utf32, out).take_unchecked() == 39 + 4);
+  }
+
+  SECTION("WideString") {
+    const WideString wide = crab::utf::to_wide("crab 🦀 κάβουρας").take_unchecked();
+    REQUIRE(wide == L"crab 🦀 κάβουρας");
+    REQUIRE(crab::utf::from_wide(wide).take_unchecked() == "crab 🦀 κάβουρας");
+    REQUIRE(crab::utf::to_wide("bad \xc3").take_err_unchecked().offset() == 4);
+
+    const WideString long_ascii(100, L'w');
+    REQUIRE(crab::utf::from_wide(long_ascii).take_unchecked() == String(100, 'w'));
+  }
+}